@@ -0,0 +1,74 @@
+#ifndef ASYNCHTTPENGINE_HPP
+#define ASYNCHTTPENGINE_HPP
+
+#include "HttpTransport.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Event-driven HTTP engine on top of curl_multi. One I/O thread drives every transfer, so
+// hundreds of requests can be in flight without a thread each; HTTP/2 requests to the same
+// host are multiplexed over a shared connection.
+// Completion callbacks run on the I/O thread and must return quickly.
+class AsyncHttpEngine {
+public:
+    using RequestId = std::uint64_t;
+    using Callback = std::function<void(HttpTransport::Response)>;
+
+    struct Options {
+        // The request fails with a timeout once this passes, in addition to the request's own timeout.
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+    };
+
+    static constexpr long kMaxConnectionsPerHost = 8;
+    static constexpr long kMaxTotalConnections = 64;
+
+    static AsyncHttpEngine& shared();
+    // Stops the shared engine, if it was started, failing whatever is still in flight.
+    // Called before curl_global_cleanup.
+    static void shutdown_shared();
+
+    AsyncHttpEngine();
+    ~AsyncHttpEngine();
+    AsyncHttpEngine(const AsyncHttpEngine&) = delete;
+    AsyncHttpEngine& operator=(const AsyncHttpEngine&) = delete;
+
+    RequestId submit(HttpTransport::Request request, Callback on_complete, Options options = {});
+    std::future<HttpTransport::Response> fetch(HttpTransport::Request request,
+                                               Options options = {},
+                                               RequestId* id = nullptr);
+    // Fails the request with "Cancelled" if it has not completed yet.
+    void cancel(RequestId id);
+    void shutdown();
+
+private:
+    struct Transfer;
+
+    void ensure_started();
+    void run();
+    void start_transfer(std::unique_ptr<Transfer> transfer);
+    void finish_transfer(CURL* easy, const std::string& error);
+
+    CURLM* multi_{nullptr};
+    std::thread io_thread_;
+    std::mutex mutex_;
+    std::deque<std::unique_ptr<Transfer>> queued_;
+    std::vector<RequestId> cancelled_;
+    bool stopping_{false};
+    bool started_{false};
+    RequestId next_id_{1};
+    // Owned by the I/O thread.
+    std::unordered_map<CURL*, std::unique_ptr<Transfer>> active_;
+};
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef CATEGORIZATIONDIALOG_HPP
 #define CATEGORIZATIONDIALOG_HPP
 
+#include "MovableCategorizedFile.hpp"
+#include "MoveJournal.hpp"
 #include "Types.hpp"
 
 #include <QDialog>
@@ -8,7 +10,10 @@
 
 #include <memory>
 #include <optional>
+#include <string>
 #include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <spdlog/logger.h>
 
@@ -18,6 +23,8 @@ class QEvent;
 class QPushButton;
 class QTableView;
 class QCheckBox;
+class QComboBox;
+class QLabel;
 class QStandardItem;
 
 class CategorizationDialog : public QDialog
@@ -36,6 +43,7 @@ public:
     void test_trigger_confirm();
     void test_trigger_undo();
     bool test_undo_enabled() const;
+    void test_set_duplicate_action(DuplicateAction action);
 #endif
 
     bool is_dialog_valid() const;
@@ -51,10 +59,13 @@ private:
         Moved,
         Skipped,
         NotSelected,
-        Preview
+        Preview,
+        Duplicate
     };
 
     static constexpr int kStatusRole = Qt::UserRole + 100;
+    static constexpr std::size_t kJournalBatchSize = 64;
+    static constexpr unsigned kMaxLinkWorkers = 8;
 
     struct MoveRecord {
         int row_index;
@@ -62,6 +73,14 @@ private:
         std::string destination_path;
         std::uintmax_t size_bytes{0};
         std::time_t mtime{0};
+        SortMode mode{SortMode::Move};
+    };
+    struct PendingMove {
+        int row_index;
+        std::string file_name;
+        std::string source;
+        std::string destination;
+        MovableCategorizedFile file;
     };
     struct PreviewRecord {
         std::string source;
@@ -97,7 +116,8 @@ private:
                               const std::string& source,
                               const std::string& destination,
                               std::uintmax_t size_bytes,
-                              std::time_t mtime);
+                              std::time_t mtime,
+                              SortMode mode);
     void handle_selected_row(int row_index,
                              const std::string& file_name,
                              const std::string& category,
@@ -105,11 +125,38 @@ private:
                              const std::string& base_dir,
                              std::vector<std::string>& files_not_moved,
                              bool dry_run);
-    void persist_move_plan();
+    void flush_pending_moves(const std::string& base_dir, std::vector<std::string>& files_not_moved);
+    void ensure_move_journal(const std::string& base_dir);
+    // Journals the intents of a duplicate's steps, in the order they run, before the first one does.
+    // A step that sends a file to the trash has an empty destination.
+    std::optional<std::uint64_t> journal_duplicate_steps(const std::vector<MoveJournal::Intent>& steps);
+    // Records the first `completed` steps as done, with their trash locations filled in, and the
+    // rest as failed, and adds the done ones to the undo history. A row_index of -1 marks a file
+    // that is not in the table.
+    void record_duplicate_steps(int row_index,
+                                std::optional<std::uint64_t> first_seq,
+                                const std::vector<MoveJournal::Intent>& steps,
+                                std::size_t completed);
+    void finish_move_journal();
     bool undo_move_history();
     void update_status_after_undo();
-    bool move_file_back(const std::string& source, const std::string& destination);
-    void remove_empty_parent_directories(const std::string& destination);
+    bool move_file_back(const MoveRecord& record);
+    SortMode selected_sort_mode() const;
+    DuplicateAction selected_duplicate_action() const;
+    void plan_duplicates(const std::vector<std::tuple<bool, std::string, std::string, std::string>>& rows,
+                         const std::string& base_dir,
+                         DuplicateAction action);
+    // Whether source may be resolved against kept_copy: the bytes must match before anything is
+    // trashed or relinked, since duplicate groups only share a 64-bit hash.
+    bool confirm_duplicate(const std::string& source, const std::string& kept_copy) const;
+    bool resolve_duplicate(int row_index,
+                           const std::string& source,
+                           const std::string& kept_copy,
+                           const std::string& category,
+                           const std::string& subcategory);
+    void mark_duplicate(int row);
+    std::string destination_root(const std::string& base_dir) const;
+    void place_pending_files(std::vector<MovableCategorizedFile::PlaceResult>& outcomes, SortMode mode);
     void set_preview_status(int row, const std::string& destination);
     void update_preview_column(int row);
     std::optional<std::string> compute_preview_path(int row) const;
@@ -131,9 +178,20 @@ private:
     QCheckBox* select_all_checkbox{nullptr};
     QCheckBox* show_subcategories_checkbox{nullptr};
     QCheckBox* dry_run_checkbox{nullptr};
+    QLabel* sort_mode_label{nullptr};
+    QComboBox* sort_mode_combo{nullptr};
+    QLabel* duplicate_label{nullptr};
+    QComboBox* duplicate_combo{nullptr};
     QPushButton* undo_button{nullptr};
 
     std::vector<MoveRecord> move_history_;
+    std::vector<PendingMove> pending_moves_;
+    std::vector<std::pair<std::string, std::string>> placed_links_;
+    SortMode active_sort_mode_{SortMode::Move};
+    DuplicateAction active_duplicate_action_{DuplicateAction::None};
+    // Source of each selected file whose contents are already kept elsewhere -> the kept copy.
+    std::unordered_map<std::string, std::string> duplicate_copies_;
+    std::unique_ptr<MoveJournal> move_journal_;
     std::vector<PreviewRecord> dry_run_plan_;
 
     bool updating_select_all{false};
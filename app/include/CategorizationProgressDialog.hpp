@@ -6,6 +6,7 @@
 #include <string>
 
 class MainApp;
+class QLabel;
 class QPlainTextEdit;
 class QPushButton;
 class QEvent;
@@ -18,6 +19,8 @@ public:
     void show();
     void hide();
     void append_text(const std::string& text);
+    // Local model throughput so far; an empty summary hides the line.
+    void set_inference_summary(const std::string& summary);
 
 protected:
     void changeEvent(QEvent* event) override;
@@ -29,6 +32,7 @@ private:
 
     MainApp* main_app;
     QPlainTextEdit* text_view{nullptr};
+    QLabel* inference_label{nullptr};
     QPushButton* stop_button{nullptr};
 };
 
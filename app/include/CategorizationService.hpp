@@ -17,6 +17,8 @@
 
 class Settings;
 class ILLMClient;
+class LLMCancelToken;
+class OpenAIBatchClient;
 namespace spdlog { class logger; }
 
 class CategorizationService {
@@ -42,6 +44,19 @@ public:
         const RecategorizationCallback& recategorization_callback,
         std::function<std::unique_ptr<ILLMClient>()> llm_factory) const;
 
+    // OpenAI batch mode: queues the entries as Batch API jobs instead of sending one request each.
+    // Entries already known from the cache are stored directly. Returns the submitted batch ids.
+    std::vector<std::string> submit_remote_batch(OpenAIBatchClient& client,
+                                                 const std::vector<FileEntry>& files,
+                                                 const ProgressCallback& progress_callback) const;
+    // Polls every open batch job and stores the results of the ones that have finished.
+    // Returns the number of categorizations written.
+    std::size_t collect_remote_batches(OpenAIBatchClient& client,
+                                       const ProgressCallback& progress_callback) const;
+
+    // OpenAI accepts at most 50,000 requests per batch.
+    static constexpr std::size_t kMaxBatchRequests = 50000;
+
 private:
     using CategoryPair = std::pair<std::string, std::string>;
     using HintHistory = std::deque<CategoryPair>;
@@ -97,7 +112,8 @@ private:
                                               const std::string& item_name,
                                               const std::string& item_path,
                                               FileType file_type,
-                                              const std::string& consistency_context) const;
+                                              const std::string& consistency_context,
+                                              std::shared_ptr<LLMCancelToken> cancel) const;
 
     std::string build_whitelist_context() const;
     std::string build_category_language_context() const;
@@ -127,6 +143,24 @@ private:
         const ProgressCallback& progress_callback,
         const std::string& consistency_context) const;
 
+    // Remote replies that are invalid or below the configured confidence get one more attempt.
+    bool needs_second_opinion(const DatabaseManager::ResolvedCategory& resolved) const;
+    // Asks the escalation model (or the same client when none is set) and keeps the better answer.
+    DatabaseManager::ResolvedCategory ask_again(
+        ILLMClient& llm,
+        const DatabaseManager::ResolvedCategory& first,
+        const std::string& item_name,
+        const std::string& item_path,
+        FileType file_type,
+        const ProgressCallback& progress_callback,
+        const std::string& consistency_context) const;
+
+    // Reads a structured JSON reply or a "<category> : <subcategory>" line, resolves it against the
+    // taxonomy and applies the whitelist. Returns taxonomy_id -1 when the labels are unusable.
+    DatabaseManager::ResolvedCategory resolve_llm_reply(const std::string& reply,
+                                                        const std::string& item_name,
+                                                        const ProgressCallback& progress_callback) const;
+
     void emit_progress_message(const ProgressCallback& progress_callback,
                                std::string_view source,
                                const std::string& item_name,
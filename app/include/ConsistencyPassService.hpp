@@ -5,8 +5,10 @@
 #include "Types.hpp"
 
 #include <atomic>
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -23,42 +25,113 @@ public:
                            std::shared_ptr<spdlog::logger> logger);
 
     void set_prompt_logging_enabled(bool enabled);
+    // Chunks sent at the same time, each on its own client from the factory. Use 1 for clients
+    // that cannot share the hardware (local models).
+    void set_max_parallel(std::size_t max_parallel);
+    // Delta mode sends only the items select_drifting_items picks instead of the whole folder.
+    void set_delta_mode(bool enabled);
+    // A dry run asks the model and reports what it would change, but saves nothing.
+    void set_dry_run(bool enabled);
 
-    void run(std::vector<CategorizedFile>& categorized_files,
-             std::vector<CategorizedFile>& newly_categorized_files,
-             std::function<std::unique_ptr<ILLMClient>()> llm_factory,
-             std::atomic<bool>& stop_flag,
-             const ProgressCallback& progress_callback) const;
+    // One relabelling proposed by the model; `id` is the item's full path.
+    struct Change {
+        std::string id;
+        std::string file_name;
+        std::string from_category;
+        std::string from_subcategory;
+        std::string to_category;
+        std::string to_subcategory;
+    };
+
+    // Items [begin, end) go into one prompt; max_tokens bounds the reply.
+    struct ChunkRange {
+        std::size_t begin{0};
+        std::size_t end{0};
+        int max_tokens{0};
+    };
+
+    // Splits the items into prompts that fit the context window. Each item costs its own prompt
+    // line plus its expected reply line, on top of the fixed instructions and taxonomy.
+    static std::vector<ChunkRange> plan_chunks(const std::vector<const CategorizedFile*>& items,
+                                               const std::string& taxonomy_json,
+                                               std::size_t context_tokens,
+                                               const std::function<std::size_t(const std::string&)>& count_tokens);
+
+    // Items worth another look: the new ones, those whose label occurs only once among several
+    // items, and those whose category or subcategory is a near-duplicate of a more common one
+    // ("Document" next to "Documents", "Invoices" next to "Invoces").
+    static std::vector<const CategorizedFile*> select_drifting_items(
+        const std::vector<CategorizedFile>& items,
+        const std::vector<CategorizedFile>& new_items);
+
+    // The taxonomy entries worth showing alongside `chunk`, at most `limit` of them: first those
+    // sharing words with the items' names and current labels (an item's own label counts most),
+    // then the most used ones to fill the remaining places.
+    static std::vector<std::pair<std::string, std::string>> select_relevant_taxonomy(
+        const std::vector<const CategorizedFile*>& chunk,
+        const std::vector<DatabaseManager::TaxonomyLabel>& taxonomy,
+        std::size_t limit);
+
+    // Taxonomy entries sent with each chunk.
+    static constexpr std::size_t kTaxonomyContextEntries = 30;
+    // Used when the client does not report its context length.
+    static constexpr std::size_t kDefaultContextTokens = 4096;
+    // Keeps one bad reply from discarding too much work, however large the context.
+    static constexpr std::size_t kMaxChunkItems = 40;
+
+    // Returns the changes that were saved, or in a dry run the ones that would have been.
+    // Each chunk's changes are saved in one transaction, so an interrupted pass never leaves
+    // a chunk half applied.
+    std::vector<Change> run(std::vector<CategorizedFile>& categorized_files,
+                            std::vector<CategorizedFile>& newly_categorized_files,
+                            std::function<std::unique_ptr<ILLMClient>()> llm_factory,
+                            std::atomic<bool>& stop_flag,
+                            const ProgressCallback& progress_callback) const;
+    // Saves the changes a dry run returned, all in one transaction. On failure nothing is saved
+    // and the items keep their labels.
+    bool apply_changes(const std::vector<Change>& changes,
+                       std::vector<CategorizedFile>& categorized_files,
+                       std::vector<CategorizedFile>& newly_categorized_files,
+                       const ProgressCallback& progress_callback) const;
 
 private:
     std::unique_ptr<ILLMClient> create_llm(std::function<std::unique_ptr<ILLMClient>()> llm_factory) const;
-    void process_chunks(ILLMClient& llm,
-                        const std::vector<std::pair<std::string, std::string>>& taxonomy,
-                        std::vector<CategorizedFile>& categorized_files,
+    void process_chunks(std::vector<std::unique_ptr<ILLMClient>>& clients,
+                        const std::vector<ChunkRange>& chunks,
+                        const std::vector<DatabaseManager::TaxonomyLabel>& taxonomy,
+                        const std::vector<const CategorizedFile*>& items,
                         std::unordered_map<std::string, CategorizedFile*>& items_by_key,
                         std::unordered_map<std::string, CategorizedFile*>& new_items_by_key,
                         std::atomic<bool>& stop_flag,
-                        const ProgressCallback& progress_callback) const;
+                        const ProgressCallback& progress_callback,
+                        std::vector<Change>& changes) const;
+    // Asks the model without holding apply_mutex, then applies the reply while holding it.
     void process_chunk(const std::vector<const CategorizedFile*>& chunk,
-                       size_t start_index,
-                       size_t end_index,
+                       const ChunkRange& range,
                        size_t total_items,
                        ILLMClient& llm,
-                       const std::vector<std::pair<std::string, std::string>>& taxonomy,
+                       const std::vector<DatabaseManager::TaxonomyLabel>& taxonomy,
                        std::unordered_map<std::string, CategorizedFile*>& items_by_key,
                        std::unordered_map<std::string, CategorizedFile*>& new_items_by_key,
-                       const ProgressCallback& progress_callback) const;
+                       const ProgressCallback& progress_callback,
+                       std::mutex& apply_mutex,
+                       std::vector<Change>& changes) const;
     void log_chunk_items(const std::vector<const CategorizedFile*>& chunk, const char* stage) const;
-    bool apply_harmonized_response(const std::string& response,
-                                   const std::vector<const CategorizedFile*>& chunk,
-                                   std::unordered_map<std::string, CategorizedFile*>& items_by_key,
-                                   std::unordered_map<std::string, CategorizedFile*>& new_items_by_key,
-                                   const ProgressCallback& progress_callback,
-                                   DatabaseManager& db_manager) const;
+    // The relabellings in the reply; nullopt when the reply cannot be read at all.
+    std::optional<std::vector<Change>> collect_changes(const std::string& response,
+                                                       const std::vector<const CategorizedFile*>& chunk,
+                                                       std::unordered_map<std::string, CategorizedFile*>& items_by_key) const;
+    bool commit_changes(const std::vector<Change>& changes,
+                        std::unordered_map<std::string, CategorizedFile*>& items_by_key,
+                        std::unordered_map<std::string, CategorizedFile*>& new_items_by_key,
+                        const ProgressCallback& progress_callback) const;
 
     DatabaseManager& db_manager;
     std::shared_ptr<spdlog::logger> logger;
     mutable bool prompt_logging_enabled{false};
+    std::size_t max_parallel{1};
+    bool delta_mode{false};
+    bool dry_run{false};
 };
 
 #endif
@@ -2,6 +2,7 @@
 #define DATABASEMANAGER_HPP
 
 #include "Types.hpp"
+#include <cstdint>
 #include <string>
 #include <map>
 #include <vector>
@@ -19,6 +20,7 @@ public:
         int taxonomy_id;
         std::string category;
         std::string subcategory;
+        std::optional<double> confidence{};
     };
 
     ResolvedCategory resolve_category(const std::string& category,
@@ -29,6 +31,22 @@ public:
                                                    const std::string& dir_path,
                                                    const ResolvedCategory& resolved,
                                                    bool used_consistency_hints);
+    struct CategorizationUpdate {
+        std::string file_name;
+        std::string file_type;
+        std::string dir_path;
+        ResolvedCategory resolved;
+        bool used_consistency_hints{false};
+        // The entry the file was filed under before, recounted along with the new one.
+        int previous_taxonomy_id{0};
+    };
+    // Writes every row in one transaction and recounts each affected taxonomy entry once.
+    // Rows without a confidence keep the stored one. Nothing is written when any row fails.
+    bool apply_categorization_updates(const std::vector<CategorizationUpdate>& updates);
+    // Like apply_categorization_updates, but each `resolved` comes in holding the raw labels and
+    // is replaced by resolve_category's result inside the same transaction, so a failed write
+    // leaves no new taxonomy entries or aliases behind either.
+    bool resolve_and_apply_categorization_updates(std::vector<CategorizationUpdate>& updates);
     std::vector<std::string> get_dir_contents_from_db(const std::string &dir_path);
     bool remove_file_categorization(const std::string& dir_path,
                                     const std::string& file_name,
@@ -42,6 +60,13 @@ public:
     void increment_taxonomy_frequency(int taxonomy_id);
     std::vector<std::pair<std::string, std::string>>
         get_taxonomy_snapshot(std::size_t max_entries) const;
+    struct TaxonomyLabel {
+        std::string category;
+        std::string subcategory;
+        int frequency{0};
+    };
+    // Every taxonomy entry with the number of files filed under it, most used first.
+    std::vector<TaxonomyLabel> get_taxonomy_labels() const;
     std::vector<std::pair<std::string, std::string>>
         get_recent_categories_for_extension(const std::string& extension,
                                             FileType file_type,
@@ -49,6 +74,38 @@ public:
     bool clear_directory_categorizations(const std::string& dir_path);
     std::optional<bool> get_directory_categorization_style(const std::string& dir_path) const;
 
+    // Content hashes remembered per path; only valid while size and mtime still match.
+    struct FileHashes {
+        std::int64_t size{0};
+        std::int64_t mtime{0};
+        std::uint64_t partial{0};
+        std::uint64_t full{0}; // 0 until the whole file has been hashed
+    };
+    std::unordered_map<std::string, FileHashes> get_file_hashes(const std::vector<std::string>& paths) const;
+    bool store_file_hashes(const std::vector<std::pair<std::string, FileHashes>>& entries);
+
+    // OpenAI batch jobs awaiting results, kept so a submitted batch survives an app restart.
+    struct BatchJob {
+        std::string batch_id;
+        std::string model;
+        std::string status;
+        std::int64_t submitted_at{0};
+    };
+    struct BatchItem {
+        std::string custom_id;
+        std::string dir_path;
+        std::string file_name;
+        FileType type{FileType::File};
+    };
+    bool record_batch_job(const BatchJob& job, const std::vector<BatchItem>& items);
+    bool update_batch_job_status(const std::string& batch_id, const std::string& status);
+    // Jobs whose results have not been collected yet.
+    std::vector<BatchJob> get_open_batch_jobs() const;
+    std::vector<BatchItem> get_batch_items(const std::string& batch_id) const;
+    // Names of items in dir_path or a folder below it that belong to open jobs, so they are not
+    // submitted twice.
+    std::vector<std::string> get_pending_batch_file_names(const std::string& dir_path) const;
+
 private:
     struct TaxonomyEntry {
         int id;
@@ -60,6 +117,8 @@ private:
 
     void initialize_schema();
     void initialize_taxonomy_schema();
+    void initialize_hash_cache_schema();
+    void initialize_batch_schema();
     void load_taxonomy_cache();
     std::string normalize_label(const std::string& input) const;
     static double string_similarity(const std::string& a, const std::string& b);
@@ -85,6 +144,8 @@ private:
                               const std::string& norm_category,
                               const std::string& norm_subcategory);
     const TaxonomyEntry* find_taxonomy_entry(int taxonomy_id) const;
+    // The body of apply_categorization_updates; the caller owns the transaction.
+    bool write_categorization_updates(const std::vector<CategorizationUpdate>& updates);
 
     std::map<std::string, std::string> cached_results;
     std::string get_cached_category(const std::string &file_name);
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+class DatabaseManager;
+
+// Finds files with identical contents. Candidates are narrowed in three passes (same size,
+// then same partial fingerprint, then same full hash), so most files are never read in full.
+// Hashes are remembered in the database and reused while a file's size and mtime are unchanged.
+class DuplicateFinder {
+public:
+    using Group = std::vector<std::filesystem::path>;
+
+    explicit DuplicateFinder(DatabaseManager* hash_cache = nullptr, unsigned worker_count = 0);
+
+    // Groups of two or more files with identical contents, each in input order.
+    // Empty files, directories and unreadable files never form a group.
+    std::vector<Group> find_groups(const std::vector<std::filesystem::path>& files) const;
+
+    // True when both files can be read and hold the same bytes. Groups only share a 64-bit hash,
+    // so callers compare the files before trashing or relinking one of them.
+    static bool same_contents(const std::filesystem::path& lhs, const std::filesystem::path& rhs);
+
+private:
+    DatabaseManager* hash_cache_;
+    unsigned worker_count_;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <set>
+#include <utility>
+
+// Collects directories touched by an undo and removes the ones left empty in a single
+// deepest-first pass. Parents are revisited only when one of their children was removed,
+// so every directory is checked at most once no matter how many files it held.
+class EmptyDirectoryPruner {
+public:
+    // Directories at or above boundary are never removed. An empty boundary means no limit.
+    explicit EmptyDirectoryPruner(std::filesystem::path boundary = {});
+
+    void add(const std::filesystem::path& directory);
+    std::size_t prune();
+
+private:
+    bool within_boundary(const std::filesystem::path& directory) const;
+
+    std::filesystem::path boundary_;
+    // Ordered by depth, deepest first.
+    std::set<std::pair<std::size_t, std::filesystem::path>, std::greater<>> pending_;
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+// Cheap content fingerprint used to confirm a file is still the one that was moved.
+// Hashes the file size together with a sample from the start and the end of the file,
+// so it costs at most two small reads regardless of file size.
+class FileFingerprint {
+public:
+    static constexpr std::size_t kSampleBytes = 4096;
+    // Files up to this size are fully covered by the partial fingerprint.
+    static constexpr std::uintmax_t kFullyCoveredBytes = 2 * kSampleBytes;
+
+    static std::optional<std::uint64_t> partial(const std::filesystem::path& path);
+    // Hash of the whole file, read through a memory mapping in fixed-size windows.
+    static std::optional<std::uint64_t> full(const std::filesystem::path& path);
+};
@@ -0,0 +1,83 @@
+#ifndef HTTPTRANSPORT_HPP
+#define HTTPTRANSPORT_HPP
+
+#include <curl/curl.h>
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Process-wide libcurl transport for remote LLM and provider calls.
+// Easy handles are pooled so their live connections stay open between requests, and all
+// handles share one DNS cache and TLS session cache, so repeat calls to the same host skip
+// the name lookup and the full TLS handshake.
+class HttpTransport {
+public:
+    enum class Method {Get, Post};
+
+    struct Request {
+        Method method{Method::Get};
+        std::string url;
+        std::vector<std::string> headers;
+        std::string body;
+        long timeout_seconds{0};
+        bool follow_redirects{false};
+        // When set, body bytes of a successful reply are handed over as they arrive instead of
+        // being collected in Response::body. Returning false stops the transfer. Error replies
+        // (HTTP 4xx/5xx) are still collected in Response::body.
+        std::function<bool(std::string_view)> on_data;
+    };
+
+    struct Response {
+        long status{0};
+        std::string body;
+        // Transport failure (DNS, connect, TLS, timeout); empty when an HTTP response arrived.
+        std::string error;
+
+        bool ok() const { return error.empty(); }
+    };
+
+    static HttpTransport& shared();
+
+    HttpTransport(const HttpTransport&) = delete;
+    HttpTransport& operator=(const HttpTransport&) = delete;
+
+    Response perform(const Request& request);
+
+    // Applies the shared caches and connection defaults to a handle owned elsewhere.
+    void configure_handle(CURL* handle) const;
+
+    // Where a transfer's body goes: into `body`, or through request->on_data when that is set.
+    // Must outlive the transfer; `aborted` records that on_data stopped it.
+    struct WriteTarget {
+        const Request* request{nullptr};
+        std::string* body{nullptr};
+        bool aborted{false};
+        CURL* handle{nullptr};
+    };
+    static void set_write_target(CURL* handle, WriteTarget& target);
+
+    static constexpr std::size_t kMaxIdleHandles = 16;
+    static constexpr const char* kAbortedByReceiver = "Stopped by receiver";
+
+private:
+    HttpTransport();
+    ~HttpTransport();
+
+    CURL* acquire_handle();
+    void release_handle(CURL* handle);
+
+    static void lock_share(CURL* handle, curl_lock_data data, curl_lock_access access, void* user);
+    static void unlock_share(CURL* handle, curl_lock_data data, void* user);
+
+    CURLSH* share_{nullptr};
+    std::array<std::mutex, CURL_LOCK_DATA_LAST> share_locks_;
+    std::mutex pool_mutex_;
+    std::vector<CURL*> idle_handles_;
+};
+
+#endif
@@ -1,6 +1,60 @@
 #pragma once
 #include "Types.hpp"
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+
+// Passed to the asynchronous calls so a caller that stops waiting can abandon the request.
+// The client registers what cancelling means for it; a handler registered after cancel() runs at once.
+class LLMCancelToken {
+public:
+    void cancel()
+    {
+        std::function<void()> handler;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (cancelled_) {
+                return;
+            }
+            cancelled_ = true;
+            handler = std::move(handler_);
+        }
+        if (handler) {
+            handler();
+        }
+    }
+
+    bool cancelled() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cancelled_;
+    }
+
+    void set_handler(std::function<void()> handler)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!cancelled_) {
+                handler_ = std::move(handler);
+                return;
+            }
+        }
+        if (handler) {
+            handler();
+        }
+    }
+
+private:
+    mutable std::mutex mutex_;
+    bool cancelled_{false};
+    std::function<void()> handler_;
+};
 
 class ILLMClient {
 public:
@@ -12,4 +66,52 @@ public:
     virtual std::string complete_prompt(const std::string& prompt,
                                         int max_tokens) = 0;
     virtual void set_prompt_logging_enabled(bool enabled) = 0;
+
+    // Tokens the model can attend to per request; 0 when the client does not know.
+    virtual std::size_t context_length() const { return 0; }
+    // Token count of `text` for this model. The default estimate assumes about four characters per token.
+    virtual std::size_t count_tokens(const std::string& text) const { return (text.size() + 3) / 4; }
+
+    // Asynchronous variants. Remote clients override these to run on the shared request engine;
+    // the defaults run the blocking call on a detached thread so a caller that stops waiting is never blocked.
+    // Cancelling `cancel` fails a request still in flight; the blocking defaults cannot be interrupted.
+    virtual std::future<std::string> categorize_file_async(const std::string& file_name,
+                                                           const std::string& file_path,
+                                                           FileType file_type,
+                                                           const std::string& consistency_context,
+                                                           std::shared_ptr<LLMCancelToken> cancel = {})
+    {
+        (void)cancel;
+        return run_detached([this, file_name, file_path, file_type, consistency_context]() {
+            return categorize_file(file_name, file_path, file_type, consistency_context);
+        });
+    }
+
+    virtual std::future<std::string> complete_prompt_async(const std::string& prompt,
+                                                           int max_tokens,
+                                                           std::shared_ptr<LLMCancelToken> cancel = {})
+    {
+        (void)cancel;
+        return run_detached([this, prompt, max_tokens]() { return complete_prompt(prompt, max_tokens); });
+    }
+
+protected:
+    template <typename Fn>
+    static std::future<std::string> run_detached(Fn&& fn)
+    {
+        auto promise = std::make_shared<std::promise<std::string>>();
+        std::future<std::string> future = promise->get_future();
+        std::thread([promise, fn = std::forward<Fn>(fn)]() mutable {
+            try {
+                promise->set_value(fn());
+            } catch (...) {
+                try {
+                    promise->set_exception(std::current_exception());
+                } catch (...) {
+                    // no-op
+                }
+            }
+        }).detach();
+        return future;
+    }
 };
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// llama.cpp counters of one local generation, from llama_perf_context and the context size.
+struct InferenceSample {
+    int prompt_tokens{0};
+    double prompt_eval_ms{0.0};
+    int generated_tokens{0};
+    double eval_ms{0.0};
+    int kv_cells_used{0};
+    int kv_cells_total{0};
+    // As configured for the model: -1 lets llama.cpp decide, 0 keeps every layer on the CPU.
+    int gpu_layers{0};
+    int model_layers{0};
+};
+
+// Local generations of the current analysis run, summed so the progress dialog can show where
+// the time goes: prompt evaluation, token generation, a full KV cache or layers left on the CPU.
+class InferenceStats {
+public:
+    struct Totals {
+        std::uint64_t requests{0};
+        std::uint64_t prompt_tokens{0};
+        double prompt_eval_ms{0.0};
+        std::uint64_t generated_tokens{0};
+        double eval_ms{0.0};
+        int kv_peak_used{0};
+        int kv_cells_total{0};
+        int gpu_layers{0};
+        int model_layers{0};
+
+        double prompt_tokens_per_second() const;
+        double generated_tokens_per_second() const;
+    };
+
+    static InferenceStats& instance();
+
+    void add(const InferenceSample& sample);
+    Totals totals() const;
+    void reset();
+
+    // One line such as "12 request(s): prompt 3840 tok at 812.4 tok/s, ..."; empty before the first request.
+    static std::string describe(const Totals& totals);
+
+private:
+    InferenceStats() = default;
+
+    mutable std::mutex mutex_;
+    Totals totals_;
+};
@@ -0,0 +1,49 @@
+#ifndef JSONVIEW_HPP
+#define JSONVIEW_HPP
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// On-demand, read-only view of a JSON value inside a buffer it does not own (typically a
+// response body). Constructing a view from a document validates its structure in one scan
+// without allocating; member and element lookups then return narrower views, and only the
+// leaves that are read get decoded. The buffer must outlive every view taken from it.
+class JsonView {
+public:
+    enum class Kind {Missing, Null, Bool, Number, String, Array, Object};
+
+    JsonView() = default;
+    // An empty view is returned for malformed documents or trailing garbage.
+    static JsonView parse(std::string_view document);
+
+    Kind kind() const;
+    bool valid() const { return !text_.empty(); }
+    bool is_object() const { return kind() == Kind::Object; }
+    bool is_array() const { return kind() == Kind::Array; }
+    bool is_string() const { return kind() == Kind::String; }
+    bool is_number() const { return kind() == Kind::Number; }
+
+    // Missing members, out of range indexes and lookups on the wrong kind give an empty view.
+    JsonView operator[](std::string_view key) const;
+    JsonView operator[](std::size_t index) const;
+    bool has(std::string_view key) const { return (*this)[key].valid(); }
+    void for_each_element(const std::function<void(const JsonView&)>& visit) const;
+
+    std::optional<std::string> as_string() const;
+    std::optional<double> as_number() const;
+    std::optional<bool> as_bool() const;
+    std::string string_or(std::string fallback) const { return as_string().value_or(std::move(fallback)); }
+
+    // The value exactly as it appears in the buffer.
+    std::string_view raw() const { return text_; }
+
+private:
+    explicit JsonView(std::string_view text) : text_(text) {}
+
+    std::string_view text_;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef JSONWRITER_HPP
+#define JSONWRITER_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Streaming JSON writer that appends to a caller-owned buffer, so request bodies are built in
+// one pass without a DOM and the buffer can be cleared and reused. Commas between members and
+// elements are inserted automatically; strings are escaped per RFC 8259, control characters included.
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out);
+
+    JsonWriter& begin_object();
+    JsonWriter& end_object();
+    JsonWriter& begin_array();
+    JsonWriter& end_array();
+    JsonWriter& key(std::string_view name);
+
+    JsonWriter& value(std::string_view text);
+    JsonWriter& value(const char* text) { return value(std::string_view(text)); }
+    JsonWriter& value(const std::string& text) { return value(std::string_view(text)); }
+    JsonWriter& value(bool flag);
+    JsonWriter& value(double number); // non-finite numbers are written as null
+    template <typename Int,
+              typename = std::enable_if_t<std::is_integral_v<Int> && !std::is_same_v<Int, bool>>>
+    JsonWriter& value(Int number)
+    {
+        if constexpr (std::is_signed_v<Int>) {
+            return integer(static_cast<std::int64_t>(number));
+        } else {
+            return unsigned_integer(static_cast<std::uint64_t>(number));
+        }
+    }
+    JsonWriter& null();
+    // Appends an already serialized JSON value as is.
+    JsonWriter& raw(std::string_view json);
+
+    static void append_escaped(std::string& out, std::string_view text);
+
+private:
+    JsonWriter& integer(std::int64_t number);
+    JsonWriter& unsigned_integer(std::uint64_t number);
+    void before_value();
+
+    std::string& out_;
+    std::vector<bool> has_items_;
+    bool after_key_{false};
+};
+
+#endif
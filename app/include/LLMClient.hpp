@@ -1,8 +1,11 @@
 #ifndef LLMCLIENT_HPP
 #define LLMCLIENT_HPP
 
+#include "HttpTransport.hpp"
 #include "ILLMClient.hpp"
 #include <Types.hpp>
+#include <future>
+#include <optional>
 #include <string>
 
 class LLMClient : public ILLMClient {
@@ -16,10 +19,48 @@ public:
     std::string complete_prompt(const std::string& prompt,
                                 int max_tokens) override;
     void set_prompt_logging_enabled(bool enabled) override;
+    std::future<std::string> categorize_file_async(const std::string& file_name,
+                                                   const std::string& file_path,
+                                                   FileType file_type,
+                                                   const std::string& consistency_context,
+                                                   std::shared_ptr<LLMCancelToken> cancel = {}) override;
+    std::future<std::string> complete_prompt_async(const std::string& prompt,
+                                                   int max_tokens,
+                                                   std::shared_ptr<LLMCancelToken> cancel = {}) override;
+
+    // Request pieces shared with the batch path, which sends the same chat completion bodies offline.
+    static std::string make_categorization_prompt(const std::string& file_name,
+                                                  const std::string& file_path,
+                                                  FileType file_type,
+                                                  const std::string& consistency_context);
+    // Asks for a JSON schema reply with category, subcategory and confidence. Streamed bodies are
+    // read as server-sent events and the stream is closed as soon as the reply object is complete.
+    static std::string make_categorization_body(const std::string& model,
+                                                const std::string& prompt,
+                                                bool request_logprobs = false,
+                                                bool stream = false);
+
+    // Categorization replies are JSON objects: {"category", "subcategory", "confidence"}.
+    // Returns nullopt for plain "<category> : <subcategory>" replies from other clients.
+    struct CategoryReply {
+        std::string category;
+        std::string subcategory;
+        std::optional<double> confidence;
+    };
+    static std::optional<CategoryReply> parse_category_reply(const std::string& reply);
+    // The reply string for a chat completion response body; with logprobs present, the confidence
+    // is the joint probability of the label tokens instead of the model's own estimate.
+    static std::string category_reply_from_response(const std::string& response_body);
+
+    void set_request_logprobs(bool enabled);
 
 private:
     std::string api_key;
-    std::string send_api_request(std::string json_payload);
+    HttpTransport::Request build_api_request(std::string json_payload) const;
+    std::string send_api_request(std::string json_payload, bool structured_reply);
+    std::future<std::string> send_api_request_async(std::string json_payload,
+                                                    bool structured_reply,
+                                                    std::shared_ptr<LLMCancelToken> cancel);
     std::string make_payload(const std::string &file_name,
                              const std::string &file_path,
                                 const FileType file_type,
@@ -29,6 +70,7 @@ private:
                                      int max_tokens) const;
     std::string effective_model() const;
     bool prompt_logging_enabled{false};
+    bool request_logprobs{false};
     std::string last_prompt;
     std::string model;
 };
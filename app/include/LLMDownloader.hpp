@@ -72,6 +72,8 @@ private:
     std::function<void(const std::string&)> on_download_error;
 
     bool resumable{false};
+    // Digest the segmented download verified, recorded in the model store without rehashing.
+    std::string verified_sha256;
     long long real_content_length{0};
     std::string download_destination;
 
@@ -84,8 +86,14 @@ private:
     void set_download_destination();
     void parse_headers();
     void perform_download();
+    // Several Range requests side by side, for servers that accept them and report a size.
+    bool use_segmented_download() const;
+    void perform_segmented_download();
+    std::string published_sha256() const;
+    void report_progress(long long downloaded);
     void mark_download_resumable();
     void notify_download_complete();
+    void register_downloaded_model();
     void setup_common_curl_options(CURL *curl);
     void setup_header_curl_options(CURL *curl);
     void setup_download_curl_options(CURL *curl, FILE *fp, long resume_offset);
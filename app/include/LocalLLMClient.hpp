@@ -1,9 +1,13 @@
 #pragma once
 
 #include "ILLMClient.hpp"
+#include "InferenceStats.hpp"
 #include "Types.hpp"
 #include "llama.h"
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace spdlog { class logger; }
@@ -25,6 +29,14 @@ public:
     std::string complete_prompt(const std::string& prompt,
                                 int max_tokens) override;
     void set_prompt_logging_enabled(bool enabled) override;
+    std::size_t context_length() const override;
+    std::size_t count_tokens(const std::string& text) const override;
+
+    // llama.cpp counters of the most recent generate_response call.
+    InferenceSample last_inference() const;
+
+    // Transformer block count from the GGUF metadata, or nullopt when the file does not say.
+    static std::optional<int32_t> read_block_count(const std::string& model_path);
 
 private:
     void load_model_if_needed();
@@ -42,4 +54,7 @@ private:
     std::string sanitize_output(std::string &output);
     llama_context_params ctx_params;
     bool prompt_logging_enabled{false};
+    int gpu_layers{0};
+    int model_layers{0};
+    InferenceSample last_sample;
 };
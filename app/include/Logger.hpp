@@ -5,12 +5,43 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/rotating_file_sink.h>
+#include <chrono>
+#include <cstddef>
+#include <set>
 #include <string>
 
+// How the core, db and ui loggers are built. Read from the environment because logging starts
+// before the settings file is loaded:
+//   AI_FILE_SORTER_LOG_LEVEL     trace, debug, info (default), warn, err, critical or off
+//   AI_FILE_SORTER_LOG_CONSOLE   1/0; defaults to on when stdout is a terminal or --console-log is given
+//   AI_FILE_SORTER_LOG_FILES     comma-separated loggers with a rotating file: core,db,ui (default) or none
+//   AI_FILE_SORTER_LOG_ASYNC     0 writes on the calling thread
+//   AI_FILE_SORTER_LOG_QUEUE     async queue length in messages
+//   AI_FILE_SORTER_LOG_OVERFLOW  drop (default) discards the oldest queued message, block waits for room
+struct LogOptions {
+    enum class Overflow { DropOldest, Block };
+
+    spdlog::level::level_enum level{spdlog::level::info};
+    bool console{false};
+    std::set<std::string> file_sinks{"core", "db", "ui"};
+    bool async{true};
+    std::size_t queue_size{8192};
+    Overflow overflow{Overflow::DropOldest};
+    // Files are written in batches: immediately from this level up, otherwise every interval.
+    spdlog::level::level_enum flush_level{spdlog::level::warn};
+    std::chrono::seconds flush_interval{2};
+
+    // `development_mode` lowers the default level to debug.
+    static LogOptions from_environment(bool console_requested, bool development_mode);
+};
+
 class Logger {
 public:
     static std::string get_log_directory();
     static void setup_loggers();
+    static void setup_loggers(const LogOptions& options);
+    // Drains the async queue; loggers are gone afterwards.
+    static void shutdown();
     static std::shared_ptr<spdlog::logger> get_logger(const std::string &name);
     static std::string get_log_file_path(const std::string &log_dir, const std::string &log_name);
 
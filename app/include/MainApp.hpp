@@ -26,12 +26,14 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <thread>
 #include <unordered_set>
 #include <unordered_map>
 #include <vector>
 
+class ModelStore;
 class QAction;
 class QCheckBox;
 class QRadioButton;
@@ -135,9 +137,19 @@ private:
     void record_categorized_metrics(int count);
     SupportPromptResult show_support_prompt_dialog(int categorized_files);
     void undo_last_run();
+    void show_undo_history();
+    void start_undo(const QString& plan_path, const UndoManager::UndoOptions& options);
+    void finish_undo(const QString& plan_path, bool whole_run, const UndoManager::UndoResult& res);
+    void set_undo_actions_enabled(bool enabled);
+    void wait_for_undo();
     bool perform_undo_from_plan(const QString& plan_path);
+    void recover_interrupted_sorts();
 
     std::unique_ptr<ILLMClient> make_llm_client();
+    // The recorded quantization of a default model that fits the machine's memory best.
+    std::string resolve_default_model(const std::string& path);
+    // Cascade over the downloaded local models and the selected model; null when fewer than two are usable.
+    std::unique_ptr<ILLMClient> make_provider_router();
     void notify_recategorization_reset(const std::vector<CategorizedFile>& entries,
                                        const std::string& reason);
     void notify_recategorization_reset(const CategorizedFile& entry,
@@ -204,6 +216,7 @@ private:
     QAction* paste_action{nullptr};
     QAction* delete_action{nullptr};
     QAction* undo_last_run_action{nullptr};
+    QAction* undo_history_action{nullptr};
     QAction* toggle_explorer_action{nullptr};
     QAction* toggle_llm_action{nullptr};
     QAction* manage_whitelists_action{nullptr};
@@ -242,12 +255,17 @@ private:
     ConsistencyPassService consistency_pass_service;
     ResultsCoordinator results_coordinator;
     UndoManager undo_manager_;
+    std::mutex model_store_mutex_;
+    std::unique_ptr<ModelStore> model_store_;
+    std::string announced_model_substitution_;
     bool development_mode_{false};
     bool development_prompt_logging_enabled_{false};
 
     FileScanOptions file_scan_options{FileScanOptions::None};
     std::thread analyze_thread;
     std::atomic<bool> stop_analysis{false};
+    std::thread undo_thread_;
+    bool undo_in_progress_{false};
     bool analysis_in_progress_{false};
     bool status_is_ready_{true};
     bool suppress_explorer_sync_{false};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Per-stage latency of the categorization pipeline. Every stage keeps a count, a sum and a
+// log-linear histogram (16 buckets per power of two, so quantiles are within about 6%) in relaxed
+// atomics, which makes recording cheap enough to stay on in release builds. Reports are written
+// as JSON and Prometheus text; a Chrome trace (chrome://tracing, Perfetto) of every timed span is
+// kept only while tracing is switched on.
+class Metrics {
+public:
+    enum class Stage {
+        Scan,
+        CacheLookup,
+        PromptBuild,
+        Tokenize,
+        PromptEval,
+        Decode,
+        Sanitize,
+        ResolveCategory,
+        DbWrite,
+        Move,
+        Count
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Summary {
+        std::uint64_t count{0};
+        std::uint64_t total_ns{0};
+        std::uint64_t min_ns{0};
+        std::uint64_t max_ns{0};
+        std::uint64_t p50_ns{0};
+        std::uint64_t p90_ns{0};
+        std::uint64_t p99_ns{0};
+    };
+
+    // Records the span from construction to destruction (or stop()).
+    class Timer {
+    public:
+        explicit Timer(Stage stage);
+        ~Timer();
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        void stop();
+
+    private:
+        Stage stage_;
+        Clock::time_point start_;
+        bool running_{true};
+    };
+
+    static Metrics& instance();
+    static const char* stage_name(Stage stage);
+
+    void record(Stage stage, Clock::time_point start, Clock::time_point end);
+    Summary summary(Stage stage) const;
+    // Clears the counters and the trace so the next report covers one run.
+    void reset();
+
+    void set_tracing_enabled(bool enabled);
+    bool tracing_enabled() const;
+    // Where flush() writes metrics.json, metrics.prom and, while tracing, trace.json; empty disables it.
+    void set_report_directory(std::string directory);
+    bool flush() const;
+
+    std::string to_json() const;
+    std::string to_prometheus() const;
+    std::string to_chrome_trace() const;
+
+    static constexpr std::size_t kBucketCount = 976;
+    static std::size_t bucket_index(std::uint64_t value_ns);
+    // Midpoint of the values that fall into `index`.
+    static std::uint64_t bucket_value(std::size_t index);
+
+private:
+    Metrics() = default;
+
+    struct StageData {
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> total_ns{0};
+        std::atomic<std::uint64_t> min_ns{UINT64_MAX};
+        std::atomic<std::uint64_t> max_ns{0};
+        std::array<std::atomic<std::uint64_t>, kBucketCount> buckets{};
+    };
+
+    struct TraceEvent {
+        Stage stage;
+        std::uint32_t thread;
+        std::uint64_t start_us;
+        std::uint64_t duration_us;
+    };
+
+    static constexpr std::size_t kStageCount = static_cast<std::size_t>(Stage::Count);
+    // Caps the trace at a few tens of megabytes of JSON; later spans are only counted.
+    static constexpr std::size_t kMaxTraceEvents = 1 << 20;
+
+    std::array<StageData, kStageCount> stages_{};
+    std::atomic<bool> tracing_{false};
+    mutable std::mutex mutex_;
+    std::vector<TraceEvent> trace_;
+    std::uint64_t dropped_trace_events_{0};
+    std::string report_directory_;
+    Clock::time_point epoch_{Clock::now()};
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Memory a local model may use. Zero means unknown or absent.
+struct MemoryBudget {
+    std::uint64_t ram_bytes{0};
+    std::uint64_t vram_bytes{0};
+
+    // Available system memory and free CUDA memory on this machine.
+    static MemoryBudget detect();
+};
+
+// Index of the local model files, keyed by the SHA-256 of their contents and kept as
+// model-store.json in the model directory. Files stay ordinary files where the app and the
+// custom LLM entries expect them, so llama.cpp keeps memory-mapping them; a second download of
+// the same content inside the store directory is replaced by a hard link to the first.
+class ModelStore {
+public:
+    struct Record {
+        std::string digest;
+        std::string path;
+        std::uint64_t size{0};
+        std::int64_t mtime{0};
+        // Quantization from the file name, e.g. "Q4_K_M"; empty when the name does not say.
+        std::string quantization;
+        // Model name without the quantization, shared by every variant of one model.
+        std::string family;
+        int block_count{0};
+        std::string source;
+    };
+
+    explicit ModelStore(std::string root_dir);
+
+    // Records `path`, hashing it unless `digest` is given. A path whose size and modification
+    // time still match its record is not hashed again. Returns nullopt when the file is missing.
+    std::optional<Record> register_model(const std::string& path,
+                                         const std::string& source = {},
+                                         const std::string& digest = {});
+
+    // Reads the index again, picking up files another instance recorded since.
+    void reload();
+
+    std::vector<Record> records() const;
+    std::optional<Record> find_by_path(const std::string& path) const;
+    // Every recorded file with this content; more than one means duplicates outside the store.
+    std::vector<Record> find_by_digest(const std::string& digest) const;
+    std::vector<Record> variants_of(const std::string& family) const;
+
+    // The variant of `path`'s model that runs best within `budget`, or `path` itself when no
+    // other variant is recorded.
+    std::string resolve_for_budget(const std::string& path, const MemoryBudget& budget) const;
+
+    // Highest-quality variant that fits entirely in VRAM, else in RAM and VRAM together,
+    // else the smallest one.
+    static std::optional<Record> choose_variant(const std::vector<Record>& variants, const MemoryBudget& budget);
+    static std::string quantization_from_name(const std::string& file_name);
+    static std::string family_from_name(const std::string& file_name);
+    // Approximate bits per weight of a llama.cpp quantization; 0 when unknown.
+    static double bits_per_weight(const std::string& quantization);
+    // Memory needed to run a model file: its weights plus room for the context.
+    static std::uint64_t estimated_footprint(std::uint64_t file_size);
+
+    std::string index_path() const;
+
+private:
+    void load();
+    void save() const;
+
+    std::string root_dir_;
+    std::vector<Record> records_;
+};
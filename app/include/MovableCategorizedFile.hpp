@@ -1,8 +1,12 @@
 #ifndef MOVABLECATEGORIZEDFILE_HPP
 #define MOVABLECATEGORIZEDFILE_HPP
 
+#include "Types.hpp"
+
 #include <string>
 #include <filesystem>
+#include <utility>
+#include <vector>
 
 class MovableCategorizedFile {
 public:
@@ -11,6 +15,8 @@ public:
         std::string destination;
     };
 
+    enum class PlaceResult {Placed, AlreadyPlaced, Failed};
+
     MovableCategorizedFile();
     MovableCategorizedFile(const std::string& dir_path,
                            const std::string& cat,
@@ -19,6 +25,11 @@ public:
     ~MovableCategorizedFile();
     void create_cat_dirs(bool use_subcategory);
     bool move_file(bool use_subcategory);
+    // Moves the file, or links it into the category tree for the link modes. A link that
+    // already points at the file is left alone so re-runs only touch what changed.
+    PlaceResult place_file(bool use_subcategory, SortMode mode);
+    // Builds the category tree under root instead of the file's own directory.
+    void set_destination_root(const std::string& root);
     PreviewPaths preview_move_paths(bool use_subcategory) const;
 
     std::string get_subcategory_path() const;
@@ -31,6 +42,19 @@ public:
     void set_category(std::string& category);
     void set_subcategory(std::string& subcategory);
 
+    static bool create_link(const std::filesystem::path& source,
+                            const std::filesystem::path& link,
+                            SortMode mode);
+    static bool is_link_to(const std::filesystem::path& link,
+                           const std::filesystem::path& source,
+                           SortMode mode);
+    // Folder that receives the link tree for a sort of base_dir: a sibling named "<folder> (sorted)".
+    static std::string link_mirror_root(const std::string& base_dir);
+    // Removes links under mirror_root that point at one of the placed sources from another
+    // location (left over from an earlier categorization) or whose target no longer exists.
+    static std::size_t remove_stale_links(const std::filesystem::path& mirror_root,
+                                          const std::vector<std::pair<std::string, std::string>>& placed_links);
+
 private:
     struct MovePaths {
         std::filesystem::path source;
@@ -42,11 +66,16 @@ private:
     bool destination_is_available(const std::filesystem::path& destination_path) const;
     bool perform_move(const std::filesystem::path& source_path,
                       const std::filesystem::path& destination_path) const;
+    PlaceResult perform_link(const std::filesystem::path& source_path,
+                             const std::filesystem::path& destination_path,
+                             SortMode mode) const;
+    void update_destination_paths();
 
     std::string file_name;
     std::string dir_path;
     std::string category;
     std::string subcategory;
+    std::string destination_root;
     std::filesystem::path category_path;
     std::filesystem::path subcategory_path;
     std::filesystem::path destination_path;
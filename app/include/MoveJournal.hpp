@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <spdlog/logger.h>
+
+#include "Types.hpp"
+
+// Append-only binary journal of file moves for a single sort run.
+// Move intents are written (and fsync'ed) before each batch of renames; results are appended
+// afterwards and become durable with the next batch or when the run is marked complete.
+// A journal without a completion record belongs to an interrupted run and can be replayed.
+// An intent with an empty destination moves its source to the trash; where it landed is only
+// known afterwards and is recorded with the result.
+// Completed journals double as the undo log for the run.
+class MoveJournal {
+public:
+    struct Intent {
+        std::string source;
+        std::string destination;
+        std::string category;
+        std::string subcategory;
+        SortMode mode{SortMode::Move};
+    };
+
+    enum class State {
+        Pending,
+        Moved,
+        Failed
+    };
+
+    struct Record {
+        std::uint64_t seq{0};
+        std::string source;
+        std::string destination;
+        std::string category;
+        std::string subcategory;
+        SortMode mode{SortMode::Move};
+        std::uintmax_t size_bytes{0};
+        std::time_t mtime{0};
+        // FileFingerprint::partial of the moved file, or 0 when none was recorded.
+        std::uint64_t fingerprint{0};
+        State state{State::Pending};
+    };
+
+    struct Summary {
+        std::string base_dir;
+        std::int64_t created_at{0};
+        bool complete{false};
+        std::uint64_t intent_count{0};
+        std::uint64_t moved_count{0};
+    };
+
+    struct Contents {
+        std::string base_dir;
+        std::int64_t created_at{0};
+        bool complete{false};
+        std::vector<Record> records;
+    };
+
+    static constexpr const char* kFilePrefix = "move_journal_";
+    static constexpr const char* kFileSuffix = ".aifj";
+
+    ~MoveJournal();
+    MoveJournal(const MoveJournal&) = delete;
+    MoveJournal& operator=(const MoveJournal&) = delete;
+
+    static std::unique_ptr<MoveJournal> create(const std::string& journal_dir,
+                                               const std::string& base_dir,
+                                               const std::shared_ptr<spdlog::logger>& logger);
+    static std::unique_ptr<MoveJournal> open_existing(const std::string& path,
+                                                      const std::shared_ptr<spdlog::logger>& logger);
+
+    // Appends intents and syncs them to disk. Returns the sequence number of the first intent.
+    std::optional<std::uint64_t> append_intents(const std::vector<Intent>& intents);
+    // A non-empty destination replaces the intent's, for moves whose target was not known up front.
+    bool record_moved(std::uint64_t seq, std::uintmax_t size_bytes, std::time_t mtime,
+                      std::uint64_t fingerprint = 0, const std::string& destination = {});
+    bool record_failed(std::uint64_t seq);
+    bool mark_complete();
+
+    const std::string& path() const { return path_; }
+    std::uint64_t intent_count() const { return next_seq_; }
+
+    // Loads the whole journal. Prefer for_each_record for large runs.
+    static std::optional<Contents> read(const std::string& path);
+    static std::optional<Summary> read_summary(const std::string& path);
+    // Streams records in intent order with their final state, keeping only per-record state in memory.
+    // The visitor returns false to stop early.
+    static bool for_each_record(const std::string& path,
+                                const std::function<bool(const Record&)>& visitor,
+                                Summary* summary = nullptr);
+    static bool is_journal_file(const std::string& path);
+
+private:
+    MoveJournal(std::FILE* file,
+                std::string path,
+                std::uint64_t next_seq,
+                std::shared_ptr<spdlog::logger> logger);
+
+    bool write_record(std::uint8_t type, const std::string& payload);
+    bool sync();
+
+    std::FILE* file_{nullptr};
+    std::string path_;
+    std::uint64_t next_seq_{0};
+    std::shared_ptr<spdlog::logger> logger_;
+};
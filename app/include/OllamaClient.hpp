@@ -0,0 +1,93 @@
+#ifndef OLLAMACLIENT_HPP
+#define OLLAMACLIENT_HPP
+
+#include "AsyncHttpEngine.hpp"
+#include "HttpTransport.hpp"
+#include "ILLMClient.hpp"
+#include "Types.hpp"
+
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+// Client for Ollama's native /api/chat endpoint, local or hosted.
+// Categorization replies are constrained with a JSON schema and streamed, so the request is
+// closed as soon as the reply object is complete. keep_alive keeps the model
+// resident between requests, and at most max_parallel requests are in flight at once so the
+// server's OLLAMA_NUM_PARALLEL slots are filled without queueing behind each other.
+class OllamaClient : public ILLMClient {
+public:
+    static constexpr const char* kDefaultBaseUrl = "http://localhost:11434";
+    static constexpr const char* kDefaultKeepAlive = "30m";
+    static constexpr std::size_t kDefaultMaxParallel = 4;
+
+    OllamaClient(std::string base_url, std::string model, std::string api_key = "");
+
+    std::string categorize_file(const std::string& file_name,
+                                const std::string& file_path,
+                                FileType file_type,
+                                const std::string& consistency_context) override;
+    std::string complete_prompt(const std::string& prompt,
+                                int max_tokens) override;
+    void set_prompt_logging_enabled(bool enabled) override;
+    std::future<std::string> categorize_file_async(const std::string& file_name,
+                                                   const std::string& file_path,
+                                                   FileType file_type,
+                                                   const std::string& consistency_context,
+                                                   std::shared_ptr<LLMCancelToken> cancel = {}) override;
+    std::future<std::string> complete_prompt_async(const std::string& prompt,
+                                                   int max_tokens,
+                                                   std::shared_ptr<LLMCancelToken> cancel = {}) override;
+
+    // Ollama duration string ("30m", "1h") or seconds; "-1" keeps the model loaded indefinitely.
+    void set_keep_alive(std::string keep_alive);
+    // Clamped to at least 1. Defaults to OLLAMA_NUM_PARALLEL when set in the environment.
+    void set_max_parallel(std::size_t max_parallel);
+    std::size_t max_parallel() const;
+    void set_timeout(int seconds);
+
+    // Turns a categorization reply ({"category": ..., "subcategory": ...}) into "<category> : <subcategory>".
+    // Replies that are not the expected object are returned unchanged.
+    static std::string format_category_reply(const std::string& content);
+
+private:
+    struct Queued {
+        HttpTransport::Request request;
+        AsyncHttpEngine::Callback on_complete;
+        std::shared_ptr<LLMCancelToken> cancel;
+    };
+
+    struct Dispatcher {
+        std::mutex mutex;
+        std::size_t limit{kDefaultMaxParallel};
+        std::size_t in_flight{0};
+        std::deque<Queued> waiting;
+    };
+
+    static void dispatch(const std::shared_ptr<Dispatcher>& dispatcher, Queued queued);
+    static void release(const std::shared_ptr<Dispatcher>& dispatcher);
+
+    std::string make_categorization_payload(const std::string& file_name,
+                                            const std::string& file_path,
+                                            FileType file_type,
+                                            const std::string& consistency_context);
+    std::string make_completion_payload(const std::string& prompt, int max_tokens) const;
+    std::future<std::string> send_chat_async(std::string payload,
+                                             bool categorization,
+                                             std::shared_ptr<LLMCancelToken> cancel);
+
+    std::string base_url_;
+    std::string model_;
+    std::string api_key_;
+    std::string keep_alive_{kDefaultKeepAlive};
+    int timeout_seconds_{120};
+    bool prompt_logging_enabled_{false};
+    std::string last_prompt_;
+    std::shared_ptr<Dispatcher> dispatcher_;
+};
+
+#endif
@@ -1,18 +1,24 @@
 #pragma once
 
 #include "IProvider.hpp"
+#include <cstddef>
 #include <string>
 
 /**
- * Provider for Ollama Cloud API
- * 
- * This is a scaffolding/stub implementation for PR #1.
- * Full implementation will be added in a future PR.
+ * Provider for an Ollama server, hosted (with an API key) or on the local network
+ *
+ * Clients talk to the native /api/chat endpoint; see OllamaClient. Health checks and model
+ * listing use /api/tags. Servers on loopback or private-network addresses are usually run
+ * without a key, so one is only required for other hosts.
  */
 class OllamaCloudProvider : public IProvider {
 public:
     OllamaCloudProvider(std::string api_key, std::string base_url, std::string model);
 
+    void set_keep_alive(std::string keep_alive);
+    // 0 keeps the client default (OLLAMA_NUM_PARALLEL when set).
+    void set_max_parallel(std::size_t max_parallel);
+
     std::string get_name() const override;
     ProviderHealth check_health() const override;
     std::vector<ModelInfo> list_models() const override;
@@ -20,41 +26,13 @@ public:
     bool requires_api_key() const override;
     bool supports_model_listing() const override;
 
+    // True for localhost, single-label and .local host names and loopback or private IPv4 addresses.
+    static bool is_local_endpoint(const std::string& base_url);
+
 private:
     std::string api_key;
     std::string base_url;
     std::string model;
-#include "IProvider.hpp"
-#include <string>
-#include <optional>
-#include <memory>
-
-namespace spdlog { class logger; }
-
-class OllamaCloudProvider : public IProvider {
-public:
-    explicit OllamaCloudProvider(std::string base_url = "");
-
-    ProviderKind kind() const override;
-    std::string display_name() const override;
-    std::string base_url() const override;
-    HealthResult check_health() override;
-    ListModelsResult list_models() override;
-    bool requires_api_key() const override;
-    bool has_api_key() const override;
-
-    void set_timeout(int seconds);
-    void set_api_key(const std::string& key);
-
-    static std::optional<std::string> get_api_key_from_env();
-
-private:
-    std::string base_url_;
-    std::string api_key_;
-    int timeout_seconds_ = 30;
-    std::shared_ptr<spdlog::logger> logger_;
-
-    std::string perform_get(const std::string& endpoint, long& http_code);
-    std::vector<OllamaModel> parse_tags_response(const std::string& json_body);
-    std::string resolve_api_key() const;
+    std::string keep_alive;
+    std::size_t max_parallel{0};
 };
@@ -0,0 +1,57 @@
+#ifndef OPENAIBATCHCLIENT_HPP
+#define OPENAIBATCHCLIENT_HPP
+
+#include <functional>
+#include <optional>
+#include <string>
+
+// Client for OpenAI's Files and Batch endpoints. A batch is one JSONL file of chat completion
+// requests; OpenAI runs it within 24 hours at half the per-request price, and the results come
+// back as another JSONL file keyed by each request's custom_id.
+// Every call is blocking and throws std::runtime_error on transport or API errors.
+class OpenAIBatchClient {
+public:
+    static constexpr const char* kDefaultBaseUrl = "https://api.openai.com/v1";
+    static constexpr const char* kChatEndpoint = "/v1/chat/completions";
+
+    struct BatchStatus {
+        std::string id;
+        // validating, in_progress, finalizing, completed, failed, expired, cancelling, cancelled
+        std::string status;
+        std::string output_file_id;
+        std::string error_file_id;
+        int total{0};
+        int completed{0};
+        int failed{0};
+
+        bool finished() const;
+        bool succeeded() const { return status == "completed"; }
+    };
+
+    struct ResultLine {
+        std::string custom_id;
+        int status_code{0};
+        std::string content; // assistant message when status_code is 200
+        std::string error;
+    };
+
+    explicit OpenAIBatchClient(std::string api_key, std::string base_url = kDefaultBaseUrl);
+
+    // One JSONL line for a chat completion request; `body` is the JSON request body.
+    static std::string make_request_line(const std::string& custom_id, const std::string& body);
+    static std::optional<ResultLine> parse_result_line(const std::string& line);
+
+    std::string upload_batch_file(const std::string& jsonl, const std::string& file_name);
+    BatchStatus create_batch(const std::string& input_file_id);
+    BatchStatus get_batch(const std::string& batch_id);
+    BatchStatus cancel_batch(const std::string& batch_id);
+    // Streams a result file line by line without holding the whole file in memory.
+    void download_lines(const std::string& file_id, const std::function<void(const std::string&)>& on_line);
+
+private:
+    std::string base_url_;
+    std::string api_key_;
+    long timeout_seconds_{60};
+};
+
+#endif
@@ -11,6 +11,8 @@ class OpenAIProvider : public IProvider {
 public:
     OpenAIProvider(std::string api_key, std::string model);
 
+    void set_request_logprobs(bool enabled);
+
     std::string get_name() const override;
     ProviderHealth check_health() const override;
     std::vector<ModelInfo> list_models() const override;
@@ -21,4 +23,5 @@ public:
 private:
     std::string api_key;
     std::string model;
+    bool request_logprobs{false};
 };
@@ -0,0 +1,78 @@
+#ifndef PROVIDERHEALTHMONITOR_HPP
+#define PROVIDERHEALTHMONITOR_HPP
+
+#include "IProvider.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Stops sending requests to a provider that keeps failing. After failure_threshold failures in
+// a row the breaker opens and allow() refuses until the cooldown has passed; then a single trial
+// request is let through, and its outcome closes or re-opens the breaker. Not thread-safe on its own.
+class CircuitBreaker {
+public:
+    using Clock = std::chrono::steady_clock;
+    enum class State { Closed, Open, HalfOpen };
+
+    explicit CircuitBreaker(std::size_t failure_threshold = 3,
+                            std::chrono::milliseconds cooldown = std::chrono::seconds(30));
+
+    bool allow(Clock::time_point now = Clock::now());
+    void record_success();
+    void record_failure(Clock::time_point now = Clock::now());
+    State state() const;
+
+private:
+    std::size_t failure_threshold_;
+    std::chrono::milliseconds cooldown_;
+    std::size_t consecutive_failures_{0};
+    State state_{State::Closed};
+    Clock::time_point opened_at_{};
+    bool trial_in_flight_{false};
+};
+
+// Checks provider health on a background thread and caches each result for `ttl`, so callers
+// read the last known state without waiting on the network.
+class ProviderHealthMonitor {
+public:
+    using Probe = std::function<ProviderHealth()>;
+
+    explicit ProviderHealthMonitor(std::chrono::milliseconds ttl);
+    ~ProviderHealthMonitor();
+
+    ProviderHealthMonitor(const ProviderHealthMonitor&) = delete;
+    ProviderHealthMonitor& operator=(const ProviderHealthMonitor&) = delete;
+
+    // Starts checking `name` right away. A probe that throws counts as Unavailable.
+    void watch(const std::string& name, Probe probe);
+    // Unknown until the first check of `name` has finished.
+    ProviderHealth status(const std::string& name) const;
+    // Checks `name` again as soon as possible, e.g. after a request to it failed.
+    void invalidate(const std::string& name);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        Probe probe;
+        ProviderHealth status{ProviderHealth::Unknown};
+        Clock::time_point next_check{};
+    };
+
+    void run();
+
+    std::chrono::milliseconds ttl_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::map<std::string, Entry> entries_;
+    bool stopping_{false};
+    std::thread worker_;
+};
+
+#endif
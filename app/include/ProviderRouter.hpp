@@ -0,0 +1,89 @@
+#ifndef PROVIDERROUTER_HPP
+#define PROVIDERROUTER_HPP
+
+#include "ILLMClient.hpp"
+#include "IProvider.hpp"
+#include "ProviderHealthMonitor.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Cascading client over several providers, cheapest first. Each file goes to the first route and
+// moves on to the next only when the reply cannot be read as a category or its confidence is
+// below the threshold, so most files never reach the expensive model. Clients are created the
+// first time a route is needed; a route whose client cannot be created is skipped from then on.
+// A route that keeps failing is skipped while its circuit breaker is open, and a route with a
+// health probe is skipped while its last background check found it unavailable.
+class ProviderRouter : public ILLMClient {
+public:
+    struct RouteStats {
+        std::string name;
+        bool remote{false};
+        std::size_t requests{0};
+        std::size_t accepted{0};
+        std::size_t escalated{0};
+        std::size_t failed{0};
+        // Files that passed this route by because it was down.
+        std::size_t skipped{0};
+        std::chrono::milliseconds total_latency{0};
+    };
+
+    // min_confidence is a fraction (0-1). Replies without a confidence pass when they are readable.
+    explicit ProviderRouter(double min_confidence);
+    // Logs the per-route stats of the run.
+    ~ProviderRouter() override;
+
+    // Routes are tried in the order they are added. `probe`, when given, is run in the background
+    // every kHealthCheckInterval; route names must be unique.
+    void add_route(std::string name,
+                   std::unique_ptr<IProvider> provider,
+                   bool remote,
+                   ProviderHealthMonitor::Probe probe = {});
+    std::size_t route_count() const;
+
+    std::string categorize_file(const std::string& file_name,
+                                const std::string& file_path,
+                                FileType file_type,
+                                const std::string& consistency_context) override;
+    // Free-form prompts (the consistency pass) go to the strongest route that is available, and
+    // to the next strongest when it fails.
+    std::string complete_prompt(const std::string& prompt,
+                                int max_tokens) override;
+    void set_prompt_logging_enabled(bool enabled) override;
+
+    std::vector<RouteStats> stats() const;
+    // One line per route with requests, outcome counts and mean latency.
+    std::string format_stats() const;
+
+    // True when the reply names a category and is confident enough to stop the cascade.
+    static bool accepts(const std::string& reply, double min_confidence);
+
+    static constexpr std::chrono::seconds kHealthCheckInterval{30};
+
+private:
+    struct Route {
+        std::unique_ptr<IProvider> provider;
+        std::unique_ptr<ILLMClient> client;
+        bool unavailable{false};
+        CircuitBreaker breaker;
+        RouteStats stats;
+    };
+
+    // Null when the route cannot take a request right now.
+    ILLMClient* client_for(Route& route);
+    // Counts a request against the route; a failure also trips its breaker and stales its health.
+    // Called with mutex_ held.
+    void record_request(Route& route, std::chrono::milliseconds elapsed, bool failed);
+
+    double min_confidence_;
+    bool prompt_logging_enabled_{false};
+    std::vector<Route> routes_;
+    std::unique_ptr<ProviderHealthMonitor> monitor_;
+    mutable std::mutex mutex_;
+};
+
+#endif
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Downloads one file as several HTTP Range requests running side by side, each writing its own
+// part of a file that is allocated up front. Progress per segment is kept in a sidecar file next
+// to the download, so an interrupted download continues where every segment stopped. When a
+// SHA-256 digest is given, the finished prefix of the file is hashed while the rest is still
+// arriving and the result is checked before the download counts as complete.
+class SegmentedDownloader {
+public:
+    struct Options {
+        std::size_t segments{4};
+        // Files smaller than two segments of this size are fetched in one piece.
+        long long min_segment_bytes{16LL * 1024 * 1024};
+        // Lower-case hex; empty skips verification.
+        std::string expected_sha256;
+        // Attempts per segment before the download gives up.
+        int max_attempts{3};
+    };
+
+    struct Segment {
+        long long begin{0};
+        long long end{0}; // exclusive
+        long long done{0};
+
+        long long remaining() const { return end - begin - done; }
+    };
+
+    using ProgressCallback = std::function<void(long long downloaded, long long total)>;
+    // Called on each transfer to add options such as the CA bundle.
+    using CurlSetup = std::function<void(void* curl)>;
+
+    SegmentedDownloader(std::string url, std::string destination, Options options);
+
+    void set_curl_setup(CurlSetup setup);
+
+    // Blocks until the file is complete and verified (true) or `cancel` was set (false). Throws
+    // std::runtime_error when a segment keeps failing or the digest does not match; a mismatching
+    // file is deleted, a failed one keeps its sidecar for the next attempt.
+    bool run(long long total_size, const ProgressCallback& progress, const std::atomic<bool>& cancel);
+
+    static std::vector<Segment> plan_segments(long long total_size, std::size_t segments, long long min_segment_bytes);
+    static std::string sidecar_path(const std::string& destination);
+    // True while `destination` holds an unfinished segmented download.
+    static bool has_partial_download(const std::string& destination);
+    // Lower-case hex digest of the whole file.
+    static std::string sha256_file(const std::string& path);
+
+    // Transfer state of one segment, shared with the curl callbacks.
+    struct SegmentState;
+
+private:
+    std::vector<Segment> load_or_plan(long long total_size) const;
+    void save_state(const std::vector<Segment>& segments, long long total_size) const;
+    void prepare_file(long long total_size, bool fresh) const;
+    bool fetch_segment(SegmentState& state, const std::atomic<bool>& cancel, std::string& error) const;
+
+    std::string url_;
+    std::string destination_;
+    Options options_;
+    CurlSetup curl_setup_;
+};
@@ -25,6 +25,32 @@ public:
     void set_remote_api_key(const std::string& key);
     std::string get_remote_model() const;
     void set_remote_model(const std::string& model);
+    // Remote runs go through the OpenAI Batch API: submitted now, collected on a later analysis.
+    bool get_openai_batch_mode() const;
+    void set_openai_batch_mode(bool value);
+    // Also ask OpenAI for token logprobs, which give a better confidence than the model's own estimate.
+    bool get_remote_logprobs() const;
+    void set_remote_logprobs(bool value);
+    // Remote replies below this confidence (percent) are asked again, on the escalation model when one is set.
+    int get_remote_min_confidence() const;
+    void set_remote_min_confidence(int percent);
+    std::string get_remote_escalation_model() const;
+    void set_remote_escalation_model(const std::string& model);
+    // Send each file to the downloaded local models first and to the selected model only when
+    // their reply is unusable or below the minimum confidence.
+    bool get_cascade_routing() const;
+    void set_cascade_routing(bool value);
+    std::string get_ollama_base_url() const;
+    void set_ollama_base_url(const std::string& url);
+    std::string get_ollama_model() const;
+    void set_ollama_model(const std::string& model);
+    std::string get_ollama_api_key() const;
+    void set_ollama_api_key(const std::string& key);
+    std::string get_ollama_keep_alive() const;
+    void set_ollama_keep_alive(const std::string& keep_alive);
+    // Concurrent requests sent to Ollama; 0 follows OLLAMA_NUM_PARALLEL or the client default.
+    int get_ollama_max_parallel() const;
+    void set_ollama_max_parallel(int value);
     CategoryLanguage get_category_language() const;
     void set_category_language(CategoryLanguage language);
     std::string get_active_custom_llm_id() const;
@@ -52,6 +78,14 @@ public:
 
     bool get_consistency_pass_enabled() const;
     void set_consistency_pass_enabled(bool value);
+    // Re-check only new items and items whose labels look out of place, not the whole folder.
+    bool get_consistency_pass_delta() const;
+    void set_consistency_pass_delta(bool value);
+    // Write per-stage timings to <config dir>/metrics after each run, plus a Chrome trace when tracing.
+    bool get_metrics_export() const;
+    void set_metrics_export(bool value);
+    bool get_metrics_trace() const;
+    void set_metrics_trace(bool value);
 
     bool get_use_whitelist() const;
     void set_use_whitelist(bool value);
@@ -98,6 +132,16 @@ private:
     LLMChoice llm_choice = LLMChoice::Local_7b;
     std::string remote_api_key;
     std::string remote_model{ "gpt-4o-mini" };
+    bool openai_batch_mode{false};
+    bool remote_logprobs{false};
+    int remote_min_confidence{60};
+    std::string remote_escalation_model;
+    bool cascade_routing{false};
+    std::string ollama_base_url{ "http://localhost:11434" };
+    std::string ollama_model;
+    std::string ollama_api_key;
+    std::string ollama_keep_alive{ "30m" };
+    int ollama_max_parallel{0};
     bool use_subcategories;
     bool categorize_files;
     bool categorize_directories;
@@ -110,6 +154,9 @@ private:
     Language language{Language::English};
     CategoryLanguage category_language{CategoryLanguage::English};
     bool consistency_pass_enabled{false};
+    bool consistency_pass_delta{true};
+    bool metrics_export{false};
+    bool metrics_trace{false};
     bool development_prompt_logging{false};
     int categorized_file_count{0};
     int next_support_prompt_threshold{200};
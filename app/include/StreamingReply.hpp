@@ -0,0 +1,29 @@
+#ifndef STREAMINGREPLY_HPP
+#define STREAMINGREPLY_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// Splits a byte stream into lines as chunks arrive, for SSE and NDJSON replies and JSONL downloads.
+// A trailing '\r' is dropped from each line.
+class LineBuffer {
+public:
+    using LineCallback = std::function<bool(std::string_view line)>;
+
+    // Calls on_line for every complete line; returns false as soon as on_line does.
+    bool feed(std::string_view chunk, const LineCallback& on_line);
+    // Hands over the unterminated last line, if there is one.
+    bool finish(const LineCallback& on_line);
+
+private:
+    std::string pending_;
+};
+
+// Length of the categorization reply at the start of `text` once it is complete, 0 while more
+// output is needed. A reply is a JSON object, complete at its closing brace, or a
+// "<category> : <subcategory>" line, complete at its newline. Streaming clients stop reading there.
+std::size_t complete_category_reply_length(std::string_view text);
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef TYPES_HPP
 #define TYPES_HPP
 
+#include <optional>
 #include <string>
 
 enum class LLMChoice {
@@ -14,6 +15,14 @@ enum class LLMChoice {
 
 enum class FileType {File, Directory};
 
+// How a sort places files in the category tree. The link modes leave the originals
+// untouched and build a mirror tree of category folders instead.
+enum class SortMode {Move, HardLink, SymLink};
+
+// What a move sort does with a file whose contents already exist in the sort or at its destination.
+// None sorts duplicates like any other file; the others keep one copy and resolve the rest.
+enum class DuplicateAction {None, Skip, HardLink, KeepNewest};
+
 struct CategorizedFile {
     std::string file_path;
     std::string file_name;
@@ -23,6 +32,8 @@ struct CategorizedFile {
     int taxonomy_id{0};
     bool from_cache{false};
     bool used_consistency_hints{false};
+    // Model confidence in [0, 1] for remote structured replies; unset for cache hits and local models.
+    std::optional<double> confidence{};
 };
 
 inline std::string to_string(FileType type) {
@@ -59,6 +59,7 @@ public:
         QAction*& copy_action;
         QAction*& cut_action;
         QAction*& undo_last_run_action;
+        QAction*& undo_history_action;
         QAction*& paste_action;
         QAction*& delete_action;
         QAction*& toggle_explorer_action;
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "UndoManager.hpp"
+
+#include <QDialog>
+#include <QString>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+class QCheckBox;
+class QListWidget;
+class QPushButton;
+
+// Lists previous sort runs from the undo index and lets the user pick one to undo,
+// optionally restricted to some of the categories it created.
+class UndoHistoryDialog : public QDialog {
+public:
+    explicit UndoHistoryDialog(const UndoManager& undo_manager, QWidget* parent = nullptr);
+
+    std::optional<QString> selected_plan() const;
+    std::vector<std::string> selected_categories() const;
+    bool verify_contents() const;
+
+private:
+    void setup_ui();
+    void populate_runs();
+    void on_run_selection_changed();
+
+    const UndoManager& undo_manager_;
+    std::vector<UndoManager::RunInfo> runs_;
+    QListWidget* runs_list_{nullptr};
+    QListWidget* categories_list_{nullptr};
+    QCheckBox* verify_checkbox_{nullptr};
+    QPushButton* undo_button_{nullptr};
+};
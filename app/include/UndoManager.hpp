@@ -2,15 +2,24 @@
 
 #include <QString>
 #include <QStringList>
+#include <filesystem>
+#include <functional>
 #include <memory>
 #include <optional>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 #include <cstdint>
 #include <ctime>
 
 #include <spdlog/logger.h>
 
+#include "Types.hpp"
+
+class MoveJournal;
+class UndoRunIndex;
+
 class UndoManager {
 public:
     struct Entry {
@@ -18,15 +27,36 @@ public:
         std::string destination;
         std::uintmax_t size_bytes{0};
         std::time_t mtime{0};
+        std::uint64_t fingerprint{0};
+        SortMode mode{SortMode::Move};
+    };
+
+    struct RunInfo {
+        QString plan_path;
+        std::string base_dir;
+        std::int64_t created_at_ms{0};
+        std::int64_t moved_count{0};
+        bool undone{false};
     };
 
     explicit UndoManager(std::string undo_dir);
+    ~UndoManager();
+    UndoManager(const UndoManager&) = delete;
+    UndoManager& operator=(const UndoManager&) = delete;
+
+    const std::string& undo_dir() const { return undo_dir_; }
 
-    bool save_plan(const std::string& run_base_dir,
-                   const std::vector<Entry>& entries,
-                   const std::shared_ptr<spdlog::logger>& logger) const;
+    // Opens a move journal for a new sort run and registers it in the run index.
+    std::unique_ptr<MoveJournal> begin_run(const std::string& base_dir,
+                                           const std::shared_ptr<spdlog::logger>& logger) const;
+    // Marks the run complete. Runs that moved nothing are discarded.
+    void finish_run(std::unique_ptr<MoveJournal> journal, std::int64_t moved_count) const;
 
     std::optional<QString> latest_plan_path() const;
+    std::vector<RunInfo> list_runs(std::size_t limit) const;
+    std::vector<std::pair<std::string, std::size_t>> categories_in_plan(const QString& plan_path) const;
+    std::vector<QString> interrupted_journal_paths() const;
+    void forget_plan(const QString& plan_path) const;
 
     struct UndoResult {
         int restored{0};
@@ -34,8 +64,42 @@ public:
         QStringList details;
     };
 
+    struct ResumeResult {
+        int completed{0};
+        int failed{0};
+        QStringList details;
+    };
+
+    struct UndoOptions {
+        // Restrict the undo to these top-level categories; empty means the whole run.
+        std::vector<std::string> categories;
+        // Number of threads issuing renames; 0 picks a default from the hardware.
+        unsigned worker_count{0};
+        // Compare the recorded content fingerprint before moving a file back.
+        bool verify_contents{true};
+    };
+
     UndoResult undo_plan(const QString& plan_path) const;
+    UndoResult undo_plan(const QString& plan_path, const UndoOptions& options) const;
+    ResumeResult resume_interrupted(const QString& journal_path,
+                                    const std::shared_ptr<spdlog::logger>& logger) const;
+    bool mark_journal_complete(const QString& journal_path,
+                               const std::shared_ptr<spdlog::logger>& logger) const;
 
 private:
+    std::optional<std::vector<Entry>> load_legacy_entries(const QString& plan_path,
+                                                          std::string& base_dir,
+                                                          UndoResult& result) const;
+    void restore_batch(std::vector<Entry>& entries,
+                       const UndoOptions& options,
+                       UndoResult& result,
+                       std::set<std::filesystem::path>& touched_directories) const;
+    static void remove_link(const Entry& entry, UndoResult& result, std::vector<std::filesystem::path>& touched);
+    static void prune_empty_directories(const std::set<std::filesystem::path>& directories,
+                                        const std::string& base_dir);
+    static bool check_restorable(const Entry& entry, bool verify_contents, UndoResult& result);
+    void import_existing_plans() const;
+
     std::string undo_dir_;
+    std::unique_ptr<UndoRunIndex> index_;
 };
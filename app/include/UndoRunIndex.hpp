@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct sqlite3;
+
+// Small SQLite index of sort runs kept next to the move journals in the undo directory.
+// It answers "latest run" and "list runs" without listing or parsing the plan files.
+class UndoRunIndex {
+public:
+    enum class Status {
+        InProgress = 0,
+        Complete = 1,
+        Undone = 2
+    };
+
+    struct Run {
+        std::int64_t id{0};
+        std::string plan_path;
+        std::string base_dir;
+        std::int64_t created_at{0};
+        std::int64_t moved_count{0};
+        Status status{Status::InProgress};
+    };
+
+    explicit UndoRunIndex(const std::string& undo_dir);
+    ~UndoRunIndex();
+    UndoRunIndex(const UndoRunIndex&) = delete;
+    UndoRunIndex& operator=(const UndoRunIndex&) = delete;
+
+    bool is_open() const { return db_ != nullptr; }
+    // True when the index was created by this instance and existing plan files still need importing.
+    bool needs_import() const { return needs_import_; }
+
+    bool add_run(const Run& run);
+    bool set_status(const std::string& plan_path, Status status, std::optional<std::int64_t> moved_count = std::nullopt);
+    bool remove_run(const std::string& plan_path);
+    std::optional<Run> latest_run() const;
+    std::vector<Run> list_runs(std::size_t limit) const;
+    // Oldest first.
+    std::vector<Run> runs_with_status(Status status) const;
+
+private:
+    void initialize_schema();
+
+    sqlite3* db_{nullptr};
+    bool needs_import_{false};
+};
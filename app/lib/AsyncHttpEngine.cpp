@@ -0,0 +1,295 @@
+#include "AsyncHttpEngine.hpp"
+
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+namespace {
+
+constexpr int kPollTimeoutMs = 1000;
+
+std::atomic<AsyncHttpEngine*> shared_engine{nullptr};
+std::mutex shared_engine_mutex;
+
+} // namespace
+
+struct AsyncHttpEngine::Transfer {
+    RequestId id{0};
+    HttpTransport::Request request;
+    Options options;
+    Callback on_complete;
+    HttpTransport::Response response;
+    HttpTransport::WriteTarget target;
+    curl_slist* headers{nullptr};
+    CURL* easy{nullptr};
+
+    ~Transfer()
+    {
+        if (easy) {
+            curl_easy_cleanup(easy);
+        }
+        if (headers) {
+            curl_slist_free_all(headers);
+        }
+    }
+
+    void complete(const std::string& error)
+    {
+        response.error = error;
+        if (!on_complete) {
+            return;
+        }
+        try {
+            on_complete(std::move(response));
+        } catch (const std::exception& ex) {
+            if (auto logger = Logger::get_logger("core_logger")) {
+                logger->error("HTTP completion callback threw: {}", ex.what());
+            }
+        }
+    }
+};
+
+AsyncHttpEngine& AsyncHttpEngine::shared()
+{
+    std::lock_guard<std::mutex> lock(shared_engine_mutex);
+    if (!shared_engine.load()) {
+        // Like HttpTransport, never destroyed; shutdown_shared() stops its thread before curl is torn down.
+        shared_engine.store(new AsyncHttpEngine());
+    }
+    return *shared_engine.load();
+}
+
+void AsyncHttpEngine::shutdown_shared()
+{
+    std::lock_guard<std::mutex> lock(shared_engine_mutex);
+    if (AsyncHttpEngine* engine = shared_engine.load()) {
+        engine->shutdown();
+    }
+}
+
+AsyncHttpEngine::AsyncHttpEngine() = default;
+
+AsyncHttpEngine::~AsyncHttpEngine()
+{
+    shutdown();
+}
+
+void AsyncHttpEngine::ensure_started()
+{
+    // Caller holds mutex_.
+    if (started_ || stopping_) {
+        return;
+    }
+    multi_ = curl_multi_init();
+    if (!multi_) {
+        return;
+    }
+    curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, kMaxConnectionsPerHost);
+    curl_multi_setopt(multi_, CURLMOPT_MAX_TOTAL_CONNECTIONS, kMaxTotalConnections);
+    started_ = true;
+    io_thread_ = std::thread([this]() { run(); });
+}
+
+AsyncHttpEngine::RequestId AsyncHttpEngine::submit(HttpTransport::Request request,
+                                                   Callback on_complete,
+                                                   Options options)
+{
+    auto transfer = std::make_unique<Transfer>();
+    transfer->request = std::move(request);
+    transfer->options = options;
+    transfer->on_complete = std::move(on_complete);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    ensure_started();
+    const RequestId id = next_id_++;
+    transfer->id = id;
+    if (!started_ || stopping_) {
+        lock.unlock();
+        transfer->complete(stopping_ ? "HTTP engine is shutting down" : "Failed to initialize cURL multi handle");
+        return id;
+    }
+    queued_.push_back(std::move(transfer));
+    // Under the lock: shutdown() cannot clean the handle up until stopping_ is set, which needs it.
+    curl_multi_wakeup(multi_);
+    return id;
+}
+
+std::future<HttpTransport::Response> AsyncHttpEngine::fetch(HttpTransport::Request request,
+                                                            Options options,
+                                                            RequestId* id)
+{
+    auto promise = std::make_shared<std::promise<HttpTransport::Response>>();
+    auto future = promise->get_future();
+    const RequestId submitted = submit(std::move(request), [promise](HttpTransport::Response response) {
+        promise->set_value(std::move(response));
+    }, options);
+    if (id) {
+        *id = submitted;
+    }
+    return future;
+}
+
+void AsyncHttpEngine::cancel(RequestId id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!started_ || stopping_) {
+        return;
+    }
+    cancelled_.push_back(id);
+    curl_multi_wakeup(multi_);
+}
+
+void AsyncHttpEngine::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!started_ || stopping_) {
+            stopping_ = true;
+            return;
+        }
+        stopping_ = true;
+        curl_multi_wakeup(multi_);
+    }
+    if (io_thread_.joinable()) {
+        io_thread_.join();
+    }
+    curl_multi_cleanup(multi_);
+    multi_ = nullptr;
+}
+
+void AsyncHttpEngine::start_transfer(std::unique_ptr<Transfer> transfer)
+{
+    CURL* easy = curl_easy_init();
+    if (!easy) {
+        transfer->complete("Failed to initialize cURL");
+        return;
+    }
+    transfer->easy = easy;
+    const HttpTransport::Request& request = transfer->request;
+
+    HttpTransport::shared().configure_handle(easy);
+    curl_easy_setopt(easy, CURLOPT_URL, request.url.c_str());
+    if (request.method == HttpTransport::Method::Post) {
+        curl_easy_setopt(easy, CURLOPT_POST, 1L);
+        curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request.body.c_str());
+        curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(request.body.size()));
+    } else {
+        curl_easy_setopt(easy, CURLOPT_HTTPGET, 1L);
+    }
+    if (request.follow_redirects) {
+        curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+    }
+    for (const auto& header : request.headers) {
+        transfer->headers = curl_slist_append(transfer->headers, header.c_str());
+    }
+    if (transfer->headers) {
+        curl_easy_setopt(easy, CURLOPT_HTTPHEADER, transfer->headers);
+    }
+
+    long timeout_ms = request.timeout_seconds > 0 ? request.timeout_seconds * 1000 : 0;
+    if (transfer->options.deadline) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            *transfer->options.deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) {
+            transfer->complete("Deadline exceeded before the request started");
+            return;
+        }
+        timeout_ms = timeout_ms > 0 ? std::min<long>(timeout_ms, static_cast<long>(remaining))
+                                    : static_cast<long>(remaining);
+    }
+    if (timeout_ms > 0) {
+        curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, timeout_ms);
+    }
+
+    transfer->target.request = &transfer->request;
+    transfer->target.body = &transfer->response.body;
+    HttpTransport::set_write_target(easy, transfer->target);
+
+    if (curl_multi_add_handle(multi_, easy) != CURLM_OK) {
+        transfer->complete("Failed to queue request");
+        return;
+    }
+    active_.emplace(easy, std::move(transfer));
+}
+
+void AsyncHttpEngine::finish_transfer(CURL* easy, const std::string& error)
+{
+    auto it = active_.find(easy);
+    if (it == active_.end()) {
+        return;
+    }
+    std::unique_ptr<Transfer> transfer = std::move(it->second);
+    active_.erase(it);
+    curl_multi_remove_handle(multi_, easy);
+    if (transfer->target.aborted) {
+        curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &transfer->response.status);
+        transfer->complete(HttpTransport::kAbortedByReceiver);
+        return;
+    }
+    if (error.empty()) {
+        curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &transfer->response.status);
+    }
+    transfer->complete(error);
+}
+
+void AsyncHttpEngine::run()
+{
+    while (true) {
+        std::deque<std::unique_ptr<Transfer>> incoming;
+        std::vector<RequestId> cancelled;
+        bool stopping = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            incoming.swap(queued_);
+            cancelled.swap(cancelled_);
+            stopping = stopping_;
+        }
+
+        if (stopping) {
+            for (auto& transfer : incoming) {
+                transfer->complete("HTTP engine is shutting down");
+            }
+            std::vector<CURL*> remaining;
+            remaining.reserve(active_.size());
+            for (const auto& [easy, transfer] : active_) {
+                remaining.push_back(easy);
+            }
+            for (CURL* easy : remaining) {
+                finish_transfer(easy, "HTTP engine is shutting down");
+            }
+            return;
+        }
+
+        for (auto& transfer : incoming) {
+            if (std::find(cancelled.begin(), cancelled.end(), transfer->id) != cancelled.end()) {
+                transfer->complete("Cancelled");
+                continue;
+            }
+            start_transfer(std::move(transfer));
+        }
+        for (RequestId id : cancelled) {
+            const auto it = std::find_if(active_.begin(), active_.end(), [id](const auto& entry) {
+                return entry.second->id == id;
+            });
+            if (it != active_.end()) {
+                finish_transfer(it->first, "Cancelled");
+            }
+        }
+
+        int running = 0;
+        curl_multi_perform(multi_, &running);
+        int queued_messages = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi_, &queued_messages)) {
+            if (message->msg != CURLMSG_DONE) {
+                continue;
+            }
+            const CURLcode result = message->data.result;
+            finish_transfer(message->easy_handle, result == CURLE_OK ? std::string() : curl_easy_strerror(result));
+        }
+
+        curl_multi_poll(multi_, nullptr, 0, kPollTimeoutMs, nullptr);
+    }
+}
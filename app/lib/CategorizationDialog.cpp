@@ -1,11 +1,15 @@
 #include "CategorizationDialog.hpp"
 
 #include "DatabaseManager.hpp"
+#include "DuplicateFinder.hpp"
+#include "EmptyDirectoryPruner.hpp"
+#include "FileFingerprint.hpp"
 #include "Logger.hpp"
+#include "Metrics.hpp"
 #include "MovableCategorizedFile.hpp"
 #include "TestHooks.hpp"
-#include "Utils.hpp"
 #include "UndoManager.hpp"
+#include "Utils.hpp"
 #include "DryRunPreviewDialog.hpp"
 
 #include <QAbstractItemView>
@@ -13,6 +17,7 @@
 #include <QStyle>
 #include <QBrush>
 #include <QCheckBox>
+#include <QComboBox>
 #include <QCloseEvent>
 #include <QEvent>
 #include <QHeaderView>
@@ -36,11 +41,14 @@
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <vector>
 #include <filesystem>
 #include <optional>
 #include <chrono>
+#include <thread>
+#include <unordered_set>
 
 namespace {
 
@@ -140,6 +148,20 @@ std::chrono::system_clock::time_point to_system_clock(std::filesystem::file_time
 #endif
 }
 
+// Size and modification time journaled for a placed file, so undo can tell it is still the same file.
+std::pair<std::uintmax_t, std::time_t> file_stamp(const std::filesystem::path& path) {
+    std::error_code ec;
+    const std::uintmax_t size_bytes = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return {0, 0};
+    }
+    const auto ftime = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return {size_bytes, 0};
+    }
+    return {size_bytes, std::chrono::system_clock::to_time_t(to_system_clock(ftime))};
+}
+
 } // namespace
 
 namespace TestHooks {
@@ -215,6 +237,26 @@ void CategorizationDialog::setup_ui()
     dry_run_checkbox->setChecked(false);
     layout->addWidget(dry_run_checkbox);
 
+    auto* sort_mode_layout = new QHBoxLayout();
+    sort_mode_label = new QLabel(this);
+    sort_mode_combo = new QComboBox(this);
+    sort_mode_combo->addItem(QString(), static_cast<int>(SortMode::Move));
+    sort_mode_combo->addItem(QString(), static_cast<int>(SortMode::HardLink));
+    sort_mode_combo->addItem(QString(), static_cast<int>(SortMode::SymLink));
+    duplicate_label = new QLabel(this);
+    duplicate_combo = new QComboBox(this);
+    duplicate_combo->addItem(QString(), static_cast<int>(DuplicateAction::None));
+    duplicate_combo->addItem(QString(), static_cast<int>(DuplicateAction::Skip));
+    duplicate_combo->addItem(QString(), static_cast<int>(DuplicateAction::HardLink));
+    duplicate_combo->addItem(QString(), static_cast<int>(DuplicateAction::KeepNewest));
+    sort_mode_layout->addWidget(sort_mode_label);
+    sort_mode_layout->addWidget(sort_mode_combo);
+    sort_mode_layout->addSpacing(16);
+    sort_mode_layout->addWidget(duplicate_label);
+    sort_mode_layout->addWidget(duplicate_combo);
+    sort_mode_layout->addStretch(1);
+    layout->addLayout(sort_mode_layout);
+
     model = new QStandardItemModel(this);
     model->setColumnCount(7);
 
@@ -273,6 +315,13 @@ void CategorizationDialog::setup_ui()
     connect(model, &QStandardItemModel::itemChanged, this, &CategorizationDialog::on_item_changed);
     connect(show_subcategories_checkbox, &QCheckBox::toggled,
             this, &CategorizationDialog::on_show_subcategories_toggled);
+    connect(sort_mode_combo, &QComboBox::currentIndexChanged, this, [this]() {
+        // Duplicates are only resolved when files are moved; a link tree never costs extra space.
+        duplicate_combo->setEnabled(selected_sort_mode() == SortMode::Move);
+        for (int row = 0; row < model->rowCount(); ++row) {
+            update_preview_column(row);
+        }
+    });
 }
 
 
@@ -458,6 +507,24 @@ void CategorizationDialog::on_confirm_and_sort_button_clicked()
         core_logger->info("Dry run enabled; will not move files.");
     }
 
+    active_sort_mode_ = selected_sort_mode();
+    placed_links_.clear();
+    duplicate_copies_.clear();
+    active_duplicate_action_ = active_sort_mode_ == SortMode::Move
+        ? selected_duplicate_action()
+        : DuplicateAction::None;
+    if (!dry_run && active_duplicate_action_ != DuplicateAction::None) {
+        plan_duplicates(rows, base_dir, active_duplicate_action_);
+    }
+    const std::string link_root = destination_root(base_dir);
+    if (!link_root.empty() && !dry_run) {
+        std::error_code ec;
+        std::filesystem::create_directories(Utils::utf8_to_path(link_root), ec);
+        if (ec && core_logger) {
+            core_logger->error("Failed to create link folder '{}': {}", link_root, ec.message());
+        }
+    }
+
     std::vector<std::string> files_not_moved;
     ScopedFlag guard(suppress_item_changed_);
     int row_index = 0;
@@ -477,6 +544,17 @@ void CategorizationDialog::on_confirm_and_sort_button_clicked()
         ++row_index;
     }
 
+    if (!dry_run) {
+        flush_pending_moves(base_dir, files_not_moved);
+        finish_move_journal();
+        // The analysis report is rewritten once with the move timings of this sort.
+        Metrics::instance().flush();
+        if (!link_root.empty()) {
+            // Re-runs only add what changed; links from an earlier categorization are dropped here.
+            MovableCategorizedFile::remove_stale_links(Utils::utf8_to_path(link_root), placed_links_);
+        }
+    }
+
     if (files_not_moved.empty()) {
         if (core_logger) {
             core_logger->info("All files have been sorted and moved successfully.");
@@ -560,10 +638,6 @@ void CategorizationDialog::on_confirm_and_sort_button_clicked()
         undo_button->setEnabled(true);
     }
 
-    if (!move_history_.empty()) {
-        persist_move_plan();
-    }
-
     show_close_button();
 }
 
@@ -606,6 +680,9 @@ void CategorizationDialog::handle_selected_row(int row_index,
     try {
         MovableCategorizedFile categorized_file(
             base_dir, category, effective_subcategory, file_name);
+        if (const std::string root = destination_root(base_dir); !root.empty()) {
+            categorized_file.set_destination_root(root);
+        }
 
         const auto preview_paths = categorized_file.preview_move_paths(show_subcategory_column);
 
@@ -626,27 +703,24 @@ void CategorizationDialog::handle_selected_row(int row_index,
             return;
         }
 
-        categorized_file.create_cat_dirs(show_subcategory_column);
-        bool moved = categorized_file.move_file(show_subcategory_column);
-        update_status_column(row_index, moved);
-
-        if (!moved) {
-            files_not_moved.push_back(file_name);
-            if (core_logger) {
-                core_logger->warn("File {} already exists in the destination.", file_name);
+        if (const auto copy = duplicate_copies_.find(preview_paths.source);
+            copy != duplicate_copies_.end() && confirm_duplicate(copy->first, copy->second)) {
+            ensure_move_journal(base_dir);
+            if (!resolve_duplicate(row_index, copy->first, copy->second, category, effective_subcategory)) {
+                update_status_column(row_index, false);
+                files_not_moved.push_back(file_name);
             }
-        } else {
-            std::error_code ec;
-            const std::uintmax_t size_bytes = std::filesystem::file_size(Utils::utf8_to_path(preview_paths.destination), ec);
-            std::time_t mtime_value = 0;
-            if (!ec) {
-                const auto ftime = std::filesystem::last_write_time(Utils::utf8_to_path(preview_paths.destination), ec);
-                if (!ec) {
-                    const auto sys = to_system_clock(ftime);
-                    mtime_value = std::chrono::system_clock::to_time_t(sys);
-                }
-            }
-            record_move_for_undo(row_index, preview_paths.source, preview_paths.destination, size_bytes, mtime_value);
+            return;
+        }
+
+        pending_moves_.push_back(PendingMove{
+            row_index,
+            file_name,
+            preview_paths.source,
+            preview_paths.destination,
+            std::move(categorized_file)});
+        if (pending_moves_.size() >= kJournalBatchSize) {
+            flush_pending_moves(base_dir, files_not_moved);
         }
     } catch (const std::exception& ex) {
         update_status_column(row_index, false);
@@ -658,6 +732,158 @@ void CategorizationDialog::handle_selected_row(int row_index,
 }
 
 
+void CategorizationDialog::flush_pending_moves(const std::string& base_dir,
+                                               std::vector<std::string>& files_not_moved)
+{
+    if (pending_moves_.empty()) {
+        return;
+    }
+
+    ensure_move_journal(base_dir);
+
+    const SortMode mode = active_sort_mode_;
+    std::optional<std::uint64_t> first_seq;
+    if (move_journal_) {
+        std::vector<MoveJournal::Intent> intents;
+        intents.reserve(pending_moves_.size());
+        for (const auto& pending : pending_moves_) {
+            intents.push_back(MoveJournal::Intent{pending.source,
+                                                  pending.destination,
+                                                  pending.file.get_category(),
+                                                  pending.file.get_subcategory(),
+                                                  mode});
+        }
+        first_seq = move_journal_->append_intents(intents);
+    }
+
+    std::vector<MovableCategorizedFile::PlaceResult> outcomes;
+    place_pending_files(outcomes, mode);
+
+    for (std::size_t index = 0; index < pending_moves_.size(); ++index) {
+        auto& pending = pending_moves_[index];
+        const std::optional<std::uint64_t> seq = first_seq
+            ? std::optional<std::uint64_t>(*first_seq + index)
+            : std::nullopt;
+        const auto outcome = outcomes[index];
+        update_status_column(pending.row_index, outcome != MovableCategorizedFile::PlaceResult::Failed);
+
+        if (mode != SortMode::Move && outcome != MovableCategorizedFile::PlaceResult::Failed) {
+            placed_links_.emplace_back(pending.source, pending.destination);
+        }
+        if (outcome != MovableCategorizedFile::PlaceResult::Placed) {
+            if (outcome == MovableCategorizedFile::PlaceResult::Failed) {
+                files_not_moved.push_back(pending.file_name);
+            }
+            if (seq) {
+                // Also used for links left in place by an earlier run: there is nothing for undo to reverse.
+                move_journal_->record_failed(*seq);
+            }
+            continue;
+        }
+
+        const auto [size_bytes, mtime_value] = file_stamp(Utils::utf8_to_path(pending.destination));
+        if (seq) {
+            const auto fingerprint = FileFingerprint::partial(Utils::utf8_to_path(pending.destination));
+            move_journal_->record_moved(*seq, size_bytes, mtime_value, fingerprint.value_or(0));
+        }
+        record_move_for_undo(pending.row_index, pending.source, pending.destination, size_bytes, mtime_value, mode);
+    }
+
+    pending_moves_.clear();
+}
+
+void CategorizationDialog::ensure_move_journal(const std::string& base_dir)
+{
+    if (move_journal_ || undo_dir_.empty()) {
+        return;
+    }
+    move_journal_ = UndoManager(undo_dir_).begin_run(base_dir, core_logger);
+    if (!move_journal_ && core_logger) {
+        core_logger->warn("Sorting without a move journal; this run cannot be resumed or undone after a restart.");
+    }
+}
+
+std::optional<std::uint64_t> CategorizationDialog::journal_duplicate_steps(
+    const std::vector<MoveJournal::Intent>& steps)
+{
+    if (!move_journal_) {
+        return std::nullopt;
+    }
+    return move_journal_->append_intents(steps);
+}
+
+void CategorizationDialog::record_duplicate_steps(int row_index,
+                                                  std::optional<std::uint64_t> first_seq,
+                                                  const std::vector<MoveJournal::Intent>& steps,
+                                                  std::size_t completed)
+{
+    for (std::size_t index = 0; index < steps.size(); ++index) {
+        const auto& step = steps[index];
+        if (index >= completed) {
+            if (first_seq) {
+                move_journal_->record_failed(*first_seq + index);
+            }
+            continue;
+        }
+        const auto destination = Utils::utf8_to_path(step.destination);
+        const auto [size_bytes, mtime_value] = file_stamp(destination);
+        if (first_seq) {
+            const auto fingerprint = FileFingerprint::partial(destination);
+            move_journal_->record_moved(*first_seq + index, size_bytes, mtime_value, fingerprint.value_or(0),
+                                        step.destination);
+        }
+        // The undo button walks the history backwards, reversing the last step first.
+        record_move_for_undo(row_index, step.source, step.destination, size_bytes, mtime_value, step.mode);
+    }
+}
+
+void CategorizationDialog::place_pending_files(std::vector<MovableCategorizedFile::PlaceResult>& outcomes,
+                                               SortMode mode)
+{
+    outcomes.assign(pending_moves_.size(), MovableCategorizedFile::PlaceResult::Failed);
+    auto place = [&](std::size_t index) {
+        auto& pending = pending_moves_[index];
+        try {
+            pending.file.create_cat_dirs(show_subcategory_column);
+            outcomes[index] = pending.file.place_file(show_subcategory_column, mode);
+            if (outcomes[index] == MovableCategorizedFile::PlaceResult::Failed && core_logger) {
+                core_logger->warn("File {} already exists in the destination.", pending.file_name);
+            }
+        } catch (const std::exception& ex) {
+            if (core_logger) {
+                core_logger->error("Failed to move '{}': {}", pending.file_name, ex.what());
+            }
+        }
+    };
+
+    // Renames stay sequential; links never touch the originals, so they are created in parallel.
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned workers = mode == SortMode::Move
+        ? 1u
+        : static_cast<unsigned>(std::min<std::size_t>(std::min(hardware, kMaxLinkWorkers), pending_moves_.size()));
+    if (workers <= 1) {
+        for (std::size_t index = 0; index < pending_moves_.size(); ++index) {
+            place(index);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (unsigned worker = 0; worker < workers; ++worker) {
+        threads.emplace_back([&]() {
+            for (std::size_t index = next++; index < pending_moves_.size(); index = next++) {
+                place(index);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+
 void CategorizationDialog::on_continue_later_button_clicked()
 {
     record_categorization_to_db();
@@ -741,37 +967,30 @@ void CategorizationDialog::record_move_for_undo(int row,
                                                 const std::string& source,
                                                 const std::string& destination,
                                                 std::uintmax_t size_bytes,
-                                                std::time_t mtime)
+                                                std::time_t mtime,
+                                                SortMode mode)
 {
-    move_history_.push_back(MoveRecord{row, source, destination, size_bytes, mtime});
+    move_history_.push_back(MoveRecord{row, source, destination, size_bytes, mtime, mode});
 }
 
-void CategorizationDialog::remove_empty_parent_directories(const std::string& destination)
-{
-    std::filesystem::path dest_path = Utils::utf8_to_path(destination);
-    auto parent = dest_path.parent_path();
-    while (!parent.empty()) {
-        std::error_code ec;
-        if (!std::filesystem::exists(parent)) {
-            parent = parent.parent_path();
-            continue;
-        }
-        if (std::filesystem::is_directory(parent) &&
-            std::filesystem::is_empty(parent, ec) && !ec) {
-            std::filesystem::remove(parent, ec);
-            parent = parent.parent_path();
-        } else {
-            break;
-        }
-    }
-}
-
-bool CategorizationDialog::move_file_back(const std::string& source, const std::string& destination)
+bool CategorizationDialog::move_file_back(const MoveRecord& record)
 {
     std::error_code ec;
+    const std::string& source = record.source_path;
+    const std::string& destination = record.destination_path;
     auto destination_path = Utils::utf8_to_path(destination);
     auto source_path = Utils::utf8_to_path(source);
 
+    if (record.mode != SortMode::Move) {
+        if (!MovableCategorizedFile::is_link_to(destination_path, source_path, record.mode)) {
+            if (core_logger) {
+                core_logger->warn("Undo skipped; '{}' is no longer a link to '{}'", destination, source);
+            }
+            return false;
+        }
+        return std::filesystem::remove(destination_path, ec) && !ec;
+    }
+
     if (!std::filesystem::exists(destination_path)) {
         if (core_logger) {
             core_logger->warn("Undo skipped; destination '{}' missing", destination);
@@ -790,7 +1009,6 @@ bool CategorizationDialog::move_file_back(const std::string& source, const std::
         return false;
     }
 
-    remove_empty_parent_directories(destination);
     return true;
 }
 
@@ -801,11 +1019,18 @@ bool CategorizationDialog::undo_move_history()
     }
 
     bool any_success = false;
+    // A move sort also journals links and trash moves for duplicates; only a link sort prunes the mirror.
+    const std::string link_root = active_sort_mode_ == SortMode::Move
+        ? std::string()
+        : MovableCategorizedFile::link_mirror_root(base_dir_);
+    EmptyDirectoryPruner pruner(Utils::utf8_to_path(link_root.empty() ? base_dir_ : link_root));
     for (auto it = move_history_.rbegin(); it != move_history_.rend(); ++it) {
-        if (move_file_back(it->source_path, it->destination_path)) {
+        if (move_file_back(*it)) {
             any_success = true;
+            pruner.add(Utils::utf8_to_path(it->destination_path).parent_path());
         }
     }
+    pruner.prune();
 
     if (any_success && core_logger) {
         core_logger->info("Undo completed for {} moved file(s)", move_history_.size());
@@ -817,7 +1042,9 @@ bool CategorizationDialog::undo_move_history()
 void CategorizationDialog::update_status_after_undo()
 {
     for (const auto& record : move_history_) {
-        update_status_column(record.row_index, false, false);
+        if (record.row_index >= 0) {
+            update_status_column(record.row_index, false, false);
+        }
     }
 }
 
@@ -852,6 +1079,219 @@ void CategorizationDialog::apply_subcategory_visibility()
     }
 }
 
+SortMode CategorizationDialog::selected_sort_mode() const
+{
+    if (!sort_mode_combo) {
+        return SortMode::Move;
+    }
+    return static_cast<SortMode>(sort_mode_combo->currentData().toInt());
+}
+
+DuplicateAction CategorizationDialog::selected_duplicate_action() const
+{
+    if (!duplicate_combo) {
+        return DuplicateAction::None;
+    }
+    return static_cast<DuplicateAction>(duplicate_combo->currentData().toInt());
+}
+
+void CategorizationDialog::plan_duplicates(
+    const std::vector<std::tuple<bool, std::string, std::string, std::string>>& rows,
+    const std::string& base_dir,
+    DuplicateAction action)
+{
+    // Candidates are the files being sorted plus whatever already occupies their destinations.
+    std::vector<std::filesystem::path> files;
+    std::unordered_map<std::string, std::string> destination_of;
+    std::unordered_map<std::string, std::pair<std::string, std::string>> labels_of;
+    std::unordered_set<std::string> occupied_destinations;
+    for (const auto& [selected, file_name, category, subcategory] : rows) {
+        if (!selected) {
+            continue;
+        }
+        const std::string effective_subcategory = subcategory.empty() ? category : subcategory;
+        std::string validation_error;
+        if (!validate_labels(category, effective_subcategory, validation_error, !show_subcategory_column)) {
+            continue;
+        }
+        try {
+            const MovableCategorizedFile file(base_dir, category, effective_subcategory, file_name);
+            const auto paths = file.preview_move_paths(show_subcategory_column);
+            files.push_back(Utils::utf8_to_path(paths.source));
+            destination_of.emplace(paths.source, paths.destination);
+            labels_of.emplace(paths.source, std::make_pair(category, effective_subcategory));
+            std::error_code ec;
+            if (paths.destination != paths.source &&
+                std::filesystem::exists(Utils::utf8_to_path(paths.destination), ec) &&
+                occupied_destinations.insert(paths.destination).second) {
+                files.push_back(Utils::utf8_to_path(paths.destination));
+            }
+        } catch (const std::exception&) {
+            continue;
+        }
+    }
+
+    const auto groups = DuplicateFinder(db_manager).find_groups(files);
+    for (const auto& group : groups) {
+        std::vector<std::string> members;
+        members.reserve(group.size());
+        for (const auto& path : group) {
+            members.push_back(Utils::path_to_utf8(path));
+        }
+
+        // Keep a copy that is already sorted when there is one, otherwise the first file in the list.
+        auto is_sorted_copy = [&](const std::string& path) { return destination_of.count(path) == 0; };
+        std::size_t keeper = 0;
+        for (std::size_t index = 0; index < members.size(); ++index) {
+            if (is_sorted_copy(members[index])) {
+                keeper = index;
+                break;
+            }
+        }
+        if (action == DuplicateAction::KeepNewest) {
+            std::error_code ec;
+            auto newest = std::filesystem::last_write_time(group[keeper], ec);
+            for (std::size_t index = 0; index < group.size(); ++index) {
+                const auto mtime = std::filesystem::last_write_time(group[index], ec);
+                if (!ec && mtime > newest) {
+                    newest = mtime;
+                    keeper = index;
+                }
+            }
+        }
+
+        const std::string& kept = members[keeper];
+        for (std::size_t index = 0; index < members.size(); ++index) {
+            const std::string& member = members[index];
+            if (index == keeper) {
+                continue;
+            }
+            if (!is_sorted_copy(member)) {
+                duplicate_copies_.emplace(member, kept);
+                continue;
+            }
+            // An older copy sitting where the newest one is about to go is moved out of its way.
+            const auto target = destination_of.find(kept);
+            if (action == DuplicateAction::KeepNewest && target != destination_of.end() && target->second == member &&
+                confirm_duplicate(member, kept)) {
+                const auto& [category, subcategory] = labels_of[kept];
+                ensure_move_journal(base_dir);
+                std::vector<MoveJournal::Intent> steps{
+                    MoveJournal::Intent{member, std::string(), category, subcategory, SortMode::Move}};
+                const auto first_seq = journal_duplicate_steps(steps);
+                QString trash_path;
+                const bool trashed = QFile::moveToTrash(QString::fromStdString(member), &trash_path);
+                if (trashed) {
+                    steps.front().destination = trash_path.toStdString();
+                } else if (core_logger) {
+                    core_logger->warn("Failed to move older duplicate '{}' to the trash", member);
+                }
+                record_duplicate_steps(-1, first_seq, steps, trashed ? 1 : 0);
+            }
+        }
+    }
+
+    if (core_logger && !duplicate_copies_.empty()) {
+        core_logger->info("Found {} duplicate file(s) in {} group(s)", duplicate_copies_.size(), groups.size());
+    }
+}
+
+bool CategorizationDialog::confirm_duplicate(const std::string& source, const std::string& kept_copy) const
+{
+    if (active_duplicate_action_ == DuplicateAction::Skip ||
+        DuplicateFinder::same_contents(Utils::utf8_to_path(source), Utils::utf8_to_path(kept_copy))) {
+        return true;
+    }
+    if (core_logger) {
+        core_logger->warn("'{}' and '{}' share a content hash but not their bytes; sorting both", source, kept_copy);
+    }
+    return false;
+}
+
+bool CategorizationDialog::resolve_duplicate(int row_index,
+                                             const std::string& source,
+                                             const std::string& kept_copy,
+                                             const std::string& category,
+                                             const std::string& subcategory)
+{
+    const auto source_path = Utils::utf8_to_path(source);
+    const auto kept_path = Utils::utf8_to_path(kept_copy);
+    std::error_code ec;
+    switch (active_duplicate_action_) {
+    case DuplicateAction::HardLink: {
+        if (std::filesystem::equivalent(source_path, kept_path, ec)) {
+            break;
+        }
+        // The copy goes to the trash rather than being overwritten, so undo can bring it back.
+        // Undo removes the link before it restores the copy into its place.
+        std::vector<MoveJournal::Intent> steps{
+            MoveJournal::Intent{source, std::string(), category, subcategory, SortMode::Move},
+            MoveJournal::Intent{kept_copy, source, category, subcategory, SortMode::HardLink}};
+        const auto first_seq = journal_duplicate_steps(steps);
+        QString trash_path;
+        if (!QFile::moveToTrash(QString::fromStdString(source), &trash_path)) {
+            if (core_logger) {
+                core_logger->warn("Could not replace duplicate '{}' with a hard link: moving it to the trash failed",
+                                  source);
+            }
+            record_duplicate_steps(row_index, first_seq, steps, 0);
+            return false;
+        }
+        steps.front().destination = trash_path.toStdString();
+        std::filesystem::create_hard_link(kept_path, source_path, ec);
+        if (ec) {
+            const bool restored = QFile::rename(trash_path, QString::fromStdString(source));
+            if (core_logger) {
+                core_logger->warn("Could not replace duplicate '{}' with a hard link: {}", source, ec.message());
+            }
+            record_duplicate_steps(row_index, first_seq, steps, restored ? 0 : 1);
+            return false;
+        }
+        record_duplicate_steps(row_index, first_seq, steps, steps.size());
+        break;
+    }
+    case DuplicateAction::KeepNewest: {
+        std::vector<MoveJournal::Intent> steps{
+            MoveJournal::Intent{source, std::string(), category, subcategory, SortMode::Move}};
+        const auto first_seq = journal_duplicate_steps(steps);
+        QString trash_path;
+        if (!QFile::moveToTrash(QString::fromStdString(source), &trash_path)) {
+            if (core_logger) {
+                core_logger->warn("Failed to move duplicate '{}' to the trash", source);
+            }
+            record_duplicate_steps(row_index, first_seq, steps, 0);
+            return false;
+        }
+        steps.front().destination = trash_path.toStdString();
+        record_duplicate_steps(row_index, first_seq, steps, steps.size());
+        break;
+    }
+    case DuplicateAction::Skip:
+    case DuplicateAction::None:
+        break;
+    }
+
+    if (core_logger) {
+        core_logger->info("Duplicate '{}' has the same contents as '{}'", source, kept_copy);
+    }
+    mark_duplicate(row_index);
+    return true;
+}
+
+void CategorizationDialog::mark_duplicate(int row)
+{
+    if (auto* status_item = model->item(row, 5)) {
+        status_item->setForeground(QBrush(Qt::darkYellow));
+        status_item->setData(static_cast<int>(RowStatus::Duplicate), kStatusRole);
+        apply_status_text(status_item);
+    }
+}
+
+std::string CategorizationDialog::destination_root(const std::string& base_dir) const
+{
+    return selected_sort_mode() == SortMode::Move ? std::string() : MovableCategorizedFile::link_mirror_root(base_dir);
+}
+
 std::optional<std::string> CategorizationDialog::compute_preview_path(int row) const
 {
     auto rec = build_preview_record_for_row(row);
@@ -900,6 +1340,9 @@ CategorizationDialog::build_preview_record_for_row(int row, std::string* debug_r
 
     try {
         MovableCategorizedFile categorized_file(base_dir_, category, effective_subcategory, file_name);
+        if (const std::string root = destination_root(base_dir_); !root.empty()) {
+            categorized_file.set_destination_root(root);
+        }
         const auto preview_paths = categorized_file.preview_move_paths(show_subcategory_column);
         return PreviewRecord{
             preview_paths.source,
@@ -953,24 +1396,14 @@ void CategorizationDialog::set_preview_status(int row, const std::string& destin
     }
 }
 
-void CategorizationDialog::persist_move_plan()
+void CategorizationDialog::finish_move_journal()
 {
-    if (undo_dir_.empty() || base_dir_.empty() || move_history_.empty()) {
+    if (!move_journal_) {
         return;
     }
 
-    std::vector<UndoManager::Entry> entries;
-    entries.reserve(move_history_.size());
-    for (const auto& rec : move_history_) {
-        entries.push_back(UndoManager::Entry{
-            rec.source_path,
-            rec.destination_path,
-            rec.size_bytes,
-            rec.mtime});
-    }
-
-    UndoManager manager(undo_dir_);
-    manager.save_plan(base_dir_, entries, core_logger);
+    UndoManager(undo_dir_).finish_run(std::move(move_journal_),
+                                      static_cast<std::int64_t>(move_history_.size()));
 }
 
 void CategorizationDialog::clear_move_history()
@@ -991,6 +1424,23 @@ void CategorizationDialog::retranslate_ui()
     set_text_if(select_all_checkbox, tr("Select all"));
     set_text_if(show_subcategories_checkbox, tr("Create subcategory folders"));
     set_text_if(dry_run_checkbox, tr("Dry run (preview only, do not move files)"));
+    set_text_if(sort_mode_label, tr("Sort mode:"));
+    if (sort_mode_combo) {
+        sort_mode_combo->setItemText(0, tr("Move files"));
+        sort_mode_combo->setItemText(1, tr("Hard links in a mirror folder"));
+        sort_mode_combo->setItemText(2, tr("Symbolic links in a mirror folder"));
+        sort_mode_combo->setToolTip(
+            tr("Link modes leave your files where they are and build the category folders next to the selected folder."));
+    }
+    set_text_if(duplicate_label, tr("Duplicates:"));
+    if (duplicate_combo) {
+        duplicate_combo->setItemText(0, tr("Sort like other files"));
+        duplicate_combo->setItemText(1, tr("Leave in place"));
+        duplicate_combo->setItemText(2, tr("Replace with hard links"));
+        duplicate_combo->setItemText(3, tr("Keep newest, trash the rest"));
+        duplicate_combo->setToolTip(
+            tr("Files with the same contents as another file in this sort, or as the file already at their destination."));
+    }
     set_text_if(confirm_button, tr("Confirm and Sort"));
     set_text_if(continue_button, tr("Continue Later"));
     set_text_if(undo_button, tr("Undo this change"));
@@ -1038,6 +1488,9 @@ void CategorizationDialog::apply_status_text(QStandardItem* item) const
     case RowStatus::NotSelected:
         item->setText(tr("Not selected"));
         break;
+    case RowStatus::Duplicate:
+        item->setText(tr("Duplicate"));
+        break;
     case RowStatus::None:
     default:
         item->setText(QString());
@@ -1064,6 +1517,7 @@ CategorizationDialog::RowStatus CategorizationDialog::status_from_item(const QSt
     case RowStatus::Skipped:
     case RowStatus::NotSelected:
     case RowStatus::Preview:
+    case RowStatus::Duplicate:
         return status;
     }
 
@@ -1155,4 +1609,10 @@ void CategorizationDialog::test_trigger_undo() {
 bool CategorizationDialog::test_undo_enabled() const {
     return undo_button && undo_button->isEnabled();
 }
+
+void CategorizationDialog::test_set_duplicate_action(DuplicateAction action) {
+    if (duplicate_combo) {
+        duplicate_combo->setCurrentIndex(duplicate_combo->findData(static_cast<int>(action)));
+    }
+}
 #endif
@@ -4,6 +4,7 @@
 #include "MainApp.hpp"
 
 #include <QHBoxLayout>
+#include <QLabel>
 #include <QPlainTextEdit>
 #include <QPushButton>
 #include <QStyle>
@@ -34,6 +35,12 @@ void CategorizationProgressDialog::setup_ui(bool /*show_subcategory_col*/)
     text_view->setLineWrapMode(QPlainTextEdit::WidgetWidth);
     layout->addWidget(text_view, 1);
 
+    inference_label = new QLabel(this);
+    inference_label->setWordWrap(true);
+    inference_label->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    inference_label->hide();
+    layout->addWidget(inference_label);
+
     auto* button_layout = new QHBoxLayout();
     button_layout->addStretch(1);
 
@@ -87,6 +94,16 @@ void CategorizationProgressDialog::append_text(const std::string& text)
 }
 
 
+void CategorizationProgressDialog::set_inference_summary(const std::string& summary)
+{
+    if (!inference_label) {
+        return;
+    }
+    inference_label->setText(QString::fromStdString(summary));
+    inference_label->setVisible(!summary.empty());
+}
+
+
 void CategorizationProgressDialog::request_stop()
 {
     if (!main_app) {
@@ -4,6 +4,9 @@
 #include "CategoryLanguage.hpp"
 #include "DatabaseManager.hpp"
 #include "ILLMClient.hpp"
+#include "LLMClient.hpp"
+#include "Metrics.hpp"
+#include "OpenAIBatchClient.hpp"
 #include "Utils.hpp"
 
 #include <fmt/format.h>
@@ -13,10 +16,11 @@
 #include <cctype>
 #include <chrono>
 #include <cstdlib>
+#include <ctime>
 #include <future>
 #include <memory>
 #include <sstream>
-#include <thread>
+#include <tuple>
 #include <vector>
 
 namespace {
@@ -204,6 +208,156 @@ std::vector<CategorizedFile> CategorizationService::categorize_entries(
     return categorized;
 }
 
+std::vector<std::string> CategorizationService::submit_remote_batch(
+    OpenAIBatchClient& client,
+    const std::vector<FileEntry>& files,
+    const ProgressCallback& progress_callback) const
+{
+    std::vector<std::string> batch_ids;
+    const std::string model = settings.get_remote_model();
+    const std::string context = build_combined_context(std::string());
+
+    std::string jsonl;
+    std::vector<DatabaseManager::BatchItem> items;
+    const auto submit_pending = [&]() {
+        if (items.empty()) {
+            return;
+        }
+        const std::string file_id = client.upload_batch_file(jsonl, "ai-file-sorter-batch.jsonl");
+        const auto status = client.create_batch(file_id);
+        DatabaseManager::BatchJob job{status.id, model, status.status,
+                                      static_cast<std::int64_t>(std::time(nullptr))};
+        if (!db_manager.record_batch_job(job, items) && !db_manager.record_batch_job(job, items)) {
+            // Results nobody can collect would only be paid for; the items are sent again next run.
+            try {
+                client.cancel_batch(status.id);
+            } catch (const std::exception& ex) {
+                if (core_logger) {
+                    core_logger->error("Could not cancel unrecorded batch {}: {}", status.id, ex.what());
+                }
+            }
+            if (progress_callback) {
+                progress_callback(fmt::format("[BATCH] Could not record batch {}; it was cancelled", status.id));
+            }
+            jsonl.clear();
+            items.clear();
+            return;
+        }
+        if (progress_callback) {
+            progress_callback(fmt::format("[BATCH] Submitted {} item(s) as OpenAI batch {}", items.size(), status.id));
+        }
+        batch_ids.push_back(status.id);
+        jsonl.clear();
+        items.clear();
+    };
+
+    for (const auto& entry : files) {
+        const std::string dir_path = Utils::path_to_utf8(Utils::utf8_to_path(entry.full_path).parent_path());
+        const std::string abbreviated_path = Utils::abbreviate_user_path(entry.full_path);
+        if (auto cached = try_cached_categorization(entry.file_name, abbreviated_path, entry.type, progress_callback)) {
+            db_manager.insert_or_update_file_with_categorization(
+                entry.file_name, entry.type == FileType::File ? "F" : "D", dir_path, *cached, false);
+            continue;
+        }
+
+        DatabaseManager::BatchItem item{std::to_string(items.size()), dir_path, entry.file_name, entry.type};
+        const std::string prompt =
+            LLMClient::make_categorization_prompt(entry.file_name, abbreviated_path, entry.type, context);
+        jsonl += OpenAIBatchClient::make_request_line(item.custom_id,
+                                                      LLMClient::make_categorization_body(model, prompt));
+        jsonl += '\n';
+        items.push_back(std::move(item));
+        if (items.size() == kMaxBatchRequests) {
+            submit_pending();
+        }
+    }
+    submit_pending();
+    return batch_ids;
+}
+
+std::size_t CategorizationService::collect_remote_batches(OpenAIBatchClient& client,
+                                                          const ProgressCallback& progress_callback) const
+{
+    std::size_t stored = 0;
+    for (const auto& job : db_manager.get_open_batch_jobs()) {
+        OpenAIBatchClient::BatchStatus status;
+        try {
+            status = client.get_batch(job.batch_id);
+        } catch (const std::exception& ex) {
+            if (core_logger) {
+                core_logger->warn("Could not check OpenAI batch {}: {}", job.batch_id, ex.what());
+            }
+            continue;
+        }
+
+        if (!status.finished()) {
+            if (status.status != job.status) {
+                db_manager.update_batch_job_status(job.batch_id, status.status);
+            }
+            if (progress_callback) {
+                progress_callback(fmt::format("[BATCH] {} is {} ({}/{} done)",
+                                              job.batch_id, status.status, status.completed, status.total));
+            }
+            continue;
+        }
+        if (!status.succeeded() || status.output_file_id.empty()) {
+            db_manager.update_batch_job_status(job.batch_id, status.status);
+            if (progress_callback) {
+                progress_callback(fmt::format("[BATCH] {} ended as {}; its items will be categorized again",
+                                              job.batch_id, status.status));
+            }
+            continue;
+        }
+
+        std::unordered_map<std::string, DatabaseManager::BatchItem> items;
+        for (auto& item : db_manager.get_batch_items(job.batch_id)) {
+            items.emplace(item.custom_id, std::move(item));
+        }
+
+        std::size_t stored_for_job = 0;
+        try {
+            client.download_lines(status.output_file_id, [&](const std::string& line) {
+                const auto result = OpenAIBatchClient::parse_result_line(line);
+                if (!result) {
+                    return;
+                }
+                const auto it = items.find(result->custom_id);
+                if (it == items.end()) {
+                    return;
+                }
+                const auto& item = it->second;
+                if (result->status_code != 200) {
+                    if (core_logger) {
+                        core_logger->warn("Batch request for '{}' failed ({}): {}",
+                                          item.file_name, result->status_code, result->error);
+                    }
+                    return;
+                }
+                const auto resolved = resolve_llm_reply(result->content, item.file_name, progress_callback);
+                if (resolved.taxonomy_id == -1) {
+                    return;
+                }
+                db_manager.insert_or_update_file_with_categorization(
+                    item.file_name, item.type == FileType::File ? "F" : "D", item.dir_path, resolved, false);
+                ++stored_for_job;
+            });
+        } catch (const std::exception& ex) {
+            if (core_logger) {
+                core_logger->warn("Could not download results of OpenAI batch {}: {}", job.batch_id, ex.what());
+            }
+            continue;
+        }
+
+        db_manager.update_batch_job_status(job.batch_id, "collected");
+        stored += stored_for_job;
+        if (progress_callback) {
+            progress_callback(fmt::format("[BATCH] Stored {} of {} result(s) from batch {}",
+                                          stored_for_job, items.size(), job.batch_id));
+        }
+    }
+    return stored;
+}
+
 std::string CategorizationService::build_whitelist_context() const
 {
     std::ostringstream oss;
@@ -322,36 +476,12 @@ DatabaseManager::ResolvedCategory CategorizationService::categorize_via_llm(
         const std::string category_subcategory =
             run_llm_with_timeout(llm, item_name, item_path, file_type, is_local_llm, consistency_context);
 
-        auto [category, subcategory] = split_category_subcategory(category_subcategory);
-        auto resolved = db_manager.resolve_category(category, subcategory);
-        if (settings.get_use_whitelist()) {
-            const auto allowed_categories = settings.get_allowed_categories();
-            const auto allowed_subcategories = settings.get_allowed_subcategories();
-            if (!is_allowed(resolved.category, allowed_categories)) {
-                resolved.category = first_allowed_or_blank(allowed_categories);
-            }
-            if (!is_allowed(resolved.subcategory, allowed_subcategories)) {
-                resolved.subcategory = first_allowed_or_blank(allowed_subcategories);
-            }
+        auto resolved = resolve_llm_reply(category_subcategory, item_name, progress_callback);
+        if (!is_local_llm && needs_second_opinion(resolved)) {
+            resolved = ask_again(llm, resolved, item_name, item_path, file_type, progress_callback, consistency_context);
         }
-        const auto validation = validate_labels(resolved.category, resolved.subcategory);
-        if (!validation.valid) {
-            if (progress_callback) {
-                progress_callback(fmt::format("[LLM-ERROR] {} (invalid category/subcategory: {})",
-                                              item_name,
-                                              validation.error));
-            }
-            if (core_logger) {
-                core_logger->warn("Invalid LLM output for '{}': {} (cat='{}', sub='{}')",
-                                  item_name,
-                                  validation.error,
-                                  resolved.category,
-                                  resolved.subcategory);
-            }
-            return DatabaseManager::ResolvedCategory{-1, "", ""};
-        }
-        if (resolved.category.empty()) {
-            resolved.category = "Uncategorized";
+        if (resolved.taxonomy_id == -1) {
+            return resolved;
         }
         emit_progress_message(progress_callback, "AI", item_name, resolved, item_path);
         return resolved;
@@ -367,6 +497,113 @@ DatabaseManager::ResolvedCategory CategorizationService::categorize_via_llm(
     }
 }
 
+bool CategorizationService::needs_second_opinion(const DatabaseManager::ResolvedCategory& resolved) const
+{
+    if (resolved.taxonomy_id == -1) {
+        return true;
+    }
+    const double min_confidence = settings.get_remote_min_confidence() / 100.0;
+    return resolved.confidence && *resolved.confidence < min_confidence;
+}
+
+DatabaseManager::ResolvedCategory CategorizationService::ask_again(
+    ILLMClient& llm,
+    const DatabaseManager::ResolvedCategory& first,
+    const std::string& item_name,
+    const std::string& item_path,
+    FileType file_type,
+    const ProgressCallback& progress_callback,
+    const std::string& consistency_context) const
+{
+    // The escalation model only exists for OpenAI; other remote clients get a plain retry.
+    std::unique_ptr<ILLMClient> escalation;
+    const std::string escalation_model = settings.get_remote_escalation_model();
+    if (settings.get_llm_choice() == LLMChoice::Remote && !escalation_model.empty() &&
+        escalation_model != settings.get_remote_model()) {
+        escalation = std::make_unique<LLMClient>(settings.get_remote_api_key(), escalation_model);
+    }
+    ILLMClient& second_llm = escalation ? *escalation : llm;
+
+    if (core_logger) {
+        core_logger->info("Asking {} again about '{}' (first reply {}, confidence {:.2f})",
+                          escalation ? escalation_model : std::string("the same model"),
+                          item_name,
+                          first.taxonomy_id == -1 ? "invalid" : "accepted",
+                          first.confidence.value_or(0.0));
+    }
+
+    DatabaseManager::ResolvedCategory second{-1, "", ""};
+    try {
+        const std::string reply =
+            run_llm_with_timeout(second_llm, item_name, item_path, file_type, false, consistency_context);
+        second = resolve_llm_reply(reply, item_name, progress_callback);
+    } catch (const std::exception& ex) {
+        if (core_logger) {
+            core_logger->warn("Second categorization attempt for '{}' failed: {}", item_name, ex.what());
+        }
+    }
+
+    if (first.taxonomy_id == -1) {
+        return second;
+    }
+    if (second.taxonomy_id == -1) {
+        return first;
+    }
+    return second.confidence.value_or(0.0) > first.confidence.value_or(0.0) ? second : first;
+}
+
+DatabaseManager::ResolvedCategory CategorizationService::resolve_llm_reply(
+    const std::string& reply,
+    const std::string& item_name,
+    const ProgressCallback& progress_callback) const
+{
+    std::string category;
+    std::string subcategory;
+    std::optional<double> confidence;
+    {
+        Metrics::Timer timer(Metrics::Stage::Sanitize);
+        if (const auto structured = LLMClient::parse_category_reply(reply)) {
+            category = Utils::sanitize_path_label(structured->category);
+            subcategory = Utils::sanitize_path_label(structured->subcategory);
+            confidence = structured->confidence;
+        } else {
+            std::tie(category, subcategory) = split_category_subcategory(reply);
+        }
+    }
+    auto resolved = db_manager.resolve_category(category, subcategory);
+    resolved.confidence = confidence;
+    if (settings.get_use_whitelist()) {
+        const auto allowed_categories = settings.get_allowed_categories();
+        const auto allowed_subcategories = settings.get_allowed_subcategories();
+        if (!is_allowed(resolved.category, allowed_categories)) {
+            resolved.category = first_allowed_or_blank(allowed_categories);
+        }
+        if (!is_allowed(resolved.subcategory, allowed_subcategories)) {
+            resolved.subcategory = first_allowed_or_blank(allowed_subcategories);
+        }
+    }
+    const auto validation = validate_labels(resolved.category, resolved.subcategory);
+    if (!validation.valid) {
+        if (progress_callback) {
+            progress_callback(fmt::format("[LLM-ERROR] {} (invalid category/subcategory: {})",
+                                          item_name,
+                                          validation.error));
+        }
+        if (core_logger) {
+            core_logger->warn("Invalid LLM output for '{}': {} (cat='{}', sub='{}')",
+                              item_name,
+                              validation.error,
+                              resolved.category,
+                              resolved.subcategory);
+        }
+        return DatabaseManager::ResolvedCategory{-1, "", ""};
+    }
+    if (resolved.category.empty()) {
+        resolved.category = "Uncategorized";
+    }
+    return resolved;
+}
+
 void CategorizationService::emit_progress_message(const ProgressCallback& progress_callback,
                                                   std::string_view source,
                                                   const std::string& item_name,
@@ -455,6 +692,7 @@ std::optional<CategorizedFile> CategorizationService::categorize_single_entry(
     CategorizedFile result{dir_path, entry.file_name, entry.type,
                            resolved.category, resolved.subcategory, resolved.taxonomy_id};
     result.used_consistency_hints = use_consistency_hints;
+    result.confidence = resolved.confidence;
     return result;
 }
 
@@ -546,7 +784,7 @@ void CategorizationService::update_storage_with_result(const FileEntry& entry,
                                                        SessionHistoryMap& session_history) const
 {
     if (core_logger) {
-        core_logger->info("Categorized '{}' as '{} / {}'.",
+        core_logger->debug("Categorized '{}' as '{} / {}'.",
                           entry.file_name,
                           resolved.category,
                           resolved.subcategory.empty() ? "<none>" : resolved.subcategory);
@@ -575,9 +813,12 @@ std::string CategorizationService::run_llm_with_timeout(
 {
     const int timeout_seconds = resolve_llm_timeout(is_local_llm);
 
-    auto future = start_llm_future(llm, item_name, item_path, file_type, consistency_context);
+    auto cancel = std::make_shared<LLMCancelToken>();
+    auto future = start_llm_future(llm, item_name, item_path, file_type, consistency_context, cancel);
 
     if (future.wait_for(std::chrono::seconds(timeout_seconds)) == std::future_status::timeout) {
+        // Frees the connection and the server's slot instead of leaving the request running.
+        cancel->cancel();
         throw std::runtime_error("Timed out waiting for LLM response");
     }
 
@@ -619,24 +860,10 @@ std::future<std::string> CategorizationService::start_llm_future(
     const std::string& item_name,
     const std::string& item_path,
     FileType file_type,
-    const std::string& consistency_context) const
+    const std::string& consistency_context,
+    std::shared_ptr<LLMCancelToken> cancel) const
 {
-    auto promise = std::make_shared<std::promise<std::string>>();
-    std::future<std::string> future = promise->get_future();
-
-    std::thread([&llm, promise, item_name, item_path, file_type, consistency_context]() mutable {
-        try {
-            promise->set_value(llm.categorize_file(item_name, item_path, file_type, consistency_context));
-        } catch (...) {
-            try {
-                promise->set_exception(std::current_exception());
-            } catch (...) {
-                // no-op
-            }
-        }
-    }).detach();
-
-    return future;
+    return llm.categorize_file_async(item_name, item_path, file_type, consistency_context, std::move(cancel));
 }
 
 std::vector<CategorizationService::CategoryPair> CategorizationService::collect_consistency_hints(
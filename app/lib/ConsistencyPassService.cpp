@@ -1,26 +1,23 @@
 #include "ConsistencyPassService.hpp"
 
 #include "ILLMClient.hpp"
+#include "JsonView.hpp"
+#include "JsonWriter.hpp"
 
 #include <fmt/format.h>
 
 #include <spdlog/spdlog.h>
 
-#ifdef _WIN32
-#include <json/json.h>
-#elif __APPLE__
-#include <json/json.h>
-#else
-#include <jsoncpp/json/json.h>
-#endif
-
 #include <algorithm>
+#include <cctype>
 #include <exception>
 #include <filesystem>
 #include <iostream>
 #include <optional>
 #include <sstream>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace {
 
@@ -34,10 +31,18 @@ std::string trim_whitespace(const std::string& value) {
     return value.substr(start, end - start + 1);
 }
 
+// One harmonized assignment, from the JSON reply or from the line-based fallback.
+// Missing labels fall back to the item's current ones.
+struct HarmonizedEntry {
+    std::string id;
+    std::optional<std::string> category;
+    std::optional<std::string> subcategory;
+};
+
 bool try_parse_harmonized_entry(const std::string& line,
                                 size_t line_number,
                                 const std::string& raw_line,
-                                Json::Value& entry,
+                                HarmonizedEntry& entry,
                                 const std::shared_ptr<spdlog::logger>& logger)
 {
     const auto arrow_pos = line.find("=>");
@@ -65,10 +70,7 @@ bool try_parse_harmonized_entry(const std::string& line,
         return false;
     }
 
-    entry = Json::Value(Json::objectValue);
-    entry["id"] = id;
-    entry["category"] = category;
-    entry["subcategory"] = subcategory;
+    entry = HarmonizedEntry{std::move(id), std::move(category), std::move(subcategory)};
     return true;
 }
 
@@ -87,18 +89,152 @@ std::unordered_map<std::string, CategorizedFile*> build_items_by_key(std::vector
     return map;
 }
 
-std::string build_consistency_prompt(
-    const std::vector<const CategorizedFile*>& chunk,
-    const std::vector<std::pair<std::string, std::string>>& taxonomy)
+std::string build_taxonomy_json(const std::vector<std::pair<std::string, std::string>>& taxonomy)
 {
-    Json::Value taxonomy_json(Json::arrayValue);
+    std::string taxonomy_str;
+    JsonWriter taxonomy_json(taxonomy_str);
+    taxonomy_json.begin_array();
     for (const auto& entry : taxonomy) {
-        Json::Value obj;
-        obj["category"] = entry.first;
-        obj["subcategory"] = entry.second;
-        taxonomy_json.append(obj);
+        taxonomy_json.begin_object()
+            .key("category").value(entry.first)
+            .key("subcategory").value(entry.second)
+            .end_object();
+    }
+    taxonomy_json.end_array();
+    return taxonomy_str;
+}
+
+std::string format_item_line(const CategorizedFile& item)
+{
+    return fmt::format("- id: {}, file: {}, current: {} / {}\n",
+                       make_item_key(item), item.file_name, item.category, item.subcategory);
+}
+
+// The reply line an unchanged item would get; the basis for the reply budget.
+std::string expected_reply_line(const CategorizedFile& item)
+{
+    return fmt::format("{} => {} : {}\n", make_item_key(item), item.category, item.subcategory);
+}
+
+// Lowercase letters and digits only, without a plural "s", so "Docs", "doc" and "DOC-S" compare equal.
+std::string normalize_label(const std::string& label)
+{
+    std::string normalized;
+    normalized.reserve(label.size());
+    for (unsigned char ch : label) {
+        if (std::isalnum(ch)) {
+            normalized.push_back(static_cast<char>(std::tolower(ch)));
+        }
+    }
+    if (normalized.size() > 1 && normalized.back() == 's') {
+        normalized.pop_back();
+    }
+    return normalized;
+}
+
+std::size_t edit_distance(const std::string& a, const std::string& b)
+{
+    std::vector<std::size_t> row(b.size() + 1);
+    for (std::size_t j = 0; j <= b.size(); ++j) {
+        row[j] = j;
+    }
+    for (std::size_t i = 1; i <= a.size(); ++i) {
+        std::size_t diagonal = row[0];
+        row[0] = i;
+        for (std::size_t j = 1; j <= b.size(); ++j) {
+            const std::size_t above = row[j];
+            row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+// Two spellings of the same label. Short labels must match exactly so "Art" and "Arts" stay
+// together but "Car" and "Cat" stay apart.
+bool near_duplicate_labels(const std::string& a, const std::string& b)
+{
+    if (a == b) {
+        return false;
+    }
+    const std::string left = normalize_label(a);
+    const std::string right = normalize_label(b);
+    if (left == right) {
+        return true;
+    }
+    return std::min(left.size(), right.size()) >= 5 && edit_distance(left, right) <= 1;
+}
+
+// True when `label` has a near-duplicate that is used more often.
+bool drifts_from_common_label(const std::string& label,
+                              const std::unordered_map<std::string, std::size_t>& counts)
+{
+    const auto own = counts.find(label);
+    const std::size_t own_count = own == counts.end() ? 0 : own->second;
+    for (const auto& [other, count] : counts) {
+        if (count > own_count && near_duplicate_labels(label, other)) {
+            return true;
+        }
     }
+    return false;
+}
 
+// Words of three or more characters, normalized like labels; plain numbers are dropped.
+std::vector<std::string> label_terms(const std::string& text)
+{
+    std::vector<std::string> terms;
+    std::string word;
+    const auto flush = [&]() {
+        const std::string term = normalize_label(word);
+        word.clear();
+        if (term.size() >= 3 && !std::all_of(term.begin(), term.end(), [](unsigned char ch) { return std::isdigit(ch); })) {
+            terms.push_back(term);
+        }
+    };
+    for (char ch : text) {
+        if (std::isalnum(static_cast<unsigned char>(ch))) {
+            word.push_back(ch);
+        } else if (!word.empty()) {
+            flush();
+        }
+    }
+    if (!word.empty()) {
+        flush();
+    }
+    return terms;
+}
+
+std::string label_key(const std::string& category, const std::string& subcategory)
+{
+    return normalize_label(category) + '\n' + normalize_label(subcategory);
+}
+
+// A taxonomy block the size of the largest one select_relevant_taxonomy can return, so chunks
+// planned against it fit whichever entries they end up with.
+std::string taxonomy_budget_json(const std::vector<DatabaseManager::TaxonomyLabel>& taxonomy, std::size_t limit)
+{
+    std::vector<const DatabaseManager::TaxonomyLabel*> longest;
+    longest.reserve(taxonomy.size());
+    for (const auto& entry : taxonomy) {
+        longest.push_back(&entry);
+    }
+    const std::size_t count = std::min(limit, longest.size());
+    std::partial_sort(longest.begin(), longest.begin() + static_cast<std::ptrdiff_t>(count), longest.end(),
+                      [](const auto* a, const auto* b) {
+                          return a->category.size() + a->subcategory.size() > b->category.size() + b->subcategory.size();
+                      });
+    std::vector<std::pair<std::string, std::string>> sample;
+    sample.reserve(count);
+    for (std::size_t index = 0; index < count; ++index) {
+        sample.emplace_back(longest[index]->category, longest[index]->subcategory);
+    }
+    return build_taxonomy_json(sample);
+}
+
+std::string build_consistency_prompt(
+    const std::vector<const CategorizedFile*>& chunk,
+    const std::string& taxonomy_json)
+{
     std::ostringstream prompt;
     prompt << "You are a taxonomy normalization assistant.\n";
     prompt << "Your task is to review existing (category, subcategory) assignments for files and make them consistent.\n";
@@ -111,19 +247,14 @@ std::string build_consistency_prompt(
     prompt << "6. The <id> must be copied verbatim from the list below (full path). No other text may appear before it.\n";
     prompt << "7. Keep the output order identical to the input and finish by writing END on its own line. No other prose.\n\n";
 
-    Json::StreamWriterBuilder builder;
-    builder["indentation"] = "";
-    const std::string taxonomy_str = Json::writeString(builder, taxonomy_json);
-    prompt << "Known taxonomy entries (JSON array): " << taxonomy_str << "\n\n";
+    prompt << "Known taxonomy entries relevant to these items (JSON array): " << taxonomy_json << "\n\n";
 
     prompt << "Items to harmonize (follow the input order in your response):\n";
     for (const auto* item : chunk) {
         if (!item) {
             continue;
         }
-        prompt << "- id: " << make_item_key(*item)
-               << ", file: " << item->file_name
-               << ", current: " << item->category << " / " << item->subcategory << "\n";
+        prompt << format_item_line(*item);
     }
 
     prompt << "Example response lines:\n";
@@ -136,10 +267,9 @@ std::string build_consistency_prompt(
 
 bool parse_structured_lines(
     const std::string& response,
-    Json::Value& root,
+    std::vector<HarmonizedEntry>& harmonized,
     const std::shared_ptr<spdlog::logger>& logger)
 {
-    Json::Value harmonized(Json::arrayValue);
     std::istringstream stream(response);
     std::string raw_line;
     size_t line_number = 0;
@@ -154,9 +284,9 @@ bool parse_structured_lines(
             break;
         }
 
-        Json::Value entry(Json::objectValue);
+        HarmonizedEntry entry;
         if (try_parse_harmonized_entry(line, line_number, raw_line, entry, logger)) {
-            harmonized.append(entry);
+            harmonized.push_back(std::move(entry));
         }
     }
 
@@ -166,32 +296,48 @@ bool parse_structured_lines(
         }
         return false;
     }
-
-    root = harmonized;
     return true;
 }
 
-const Json::Value* parse_structured_fallback(
+std::optional<std::vector<HarmonizedEntry>> parse_structured_fallback(
     const std::string& response,
-    Json::Value& root,
     const std::shared_ptr<spdlog::logger>& logger)
 {
-    return parse_structured_lines(response, root, logger) ? &root : nullptr;
+    std::vector<HarmonizedEntry> harmonized;
+    if (!parse_structured_lines(response, harmonized, logger)) {
+        return std::nullopt;
+    }
+    return harmonized;
 }
 
-const Json::Value* extract_harmonized_array(Json::Value& root)
+JsonView extract_harmonized_array(const JsonView& root)
 {
-    if (root.isObject() && root.isMember("harmonized")) {
-        const Json::Value& harmonized = root["harmonized"];
-        if (harmonized.isArray()) {
-            return &harmonized;
-        }
-        return nullptr;
+    if (root.is_object() && root.has("harmonized")) {
+        const JsonView harmonized = root["harmonized"];
+        return harmonized.is_array() ? harmonized : JsonView();
     }
-    if (root.isArray()) {
-        return &root;
+    if (root.is_array()) {
+        return root;
     }
-    return nullptr;
+    return JsonView();
+}
+
+std::vector<HarmonizedEntry> read_harmonized_entries(const JsonView& harmonized)
+{
+    std::vector<HarmonizedEntry> entries;
+    harmonized.for_each_element([&](const JsonView& item) {
+        if (!item.is_object()) {
+            return;
+        }
+        const auto label = [&item](const char* key) -> std::optional<std::string> {
+            if (!item.has(key)) {
+                return std::nullopt;
+            }
+            return item[key].string_or("");
+        };
+        entries.push_back(HarmonizedEntry{item["id"].string_or(""), label("category"), label("subcategory")});
+    });
+    return entries;
 }
 
 struct HarmonizedUpdate {
@@ -202,15 +348,11 @@ struct HarmonizedUpdate {
 };
 
 std::optional<HarmonizedUpdate> extract_harmonized_update(
-    const Json::Value& entry,
+    const HarmonizedEntry& entry,
     std::unordered_map<std::string, CategorizedFile*>& items_by_key,
     const std::shared_ptr<spdlog::logger>& logger)
 {
-    if (!entry.isObject()) {
-        return std::nullopt;
-    }
-
-    const std::string id = entry.get("id", "").asString();
+    const std::string& id = entry.id;
     if (id.empty()) {
         return std::nullopt;
     }
@@ -224,101 +366,64 @@ std::optional<HarmonizedUpdate> extract_harmonized_update(
     }
 
     CategorizedFile* target = it->second;
-    const auto trim_or_fallback = [](const Json::Value& parent,
-                                     const char* key,
+    const auto trim_or_fallback = [](const std::optional<std::string>& value,
                                      const std::string& fallback) {
-        if (!parent.isMember(key)) {
+        if (!value || value->empty()) {
             return fallback;
         }
-        std::string candidate = parent[key].asString();
-        if (candidate.empty()) {
-            return fallback;
-        }
-        candidate = trim_whitespace(std::move(candidate));
+        std::string candidate = trim_whitespace(*value);
         return candidate.empty() ? fallback : candidate;
     };
 
-    std::string category = trim_or_fallback(entry, "category", target->category);
+    std::string category = trim_or_fallback(entry.category, target->category);
     if (category.empty()) {
         category = target->category;
     }
 
-    std::string subcategory = trim_or_fallback(entry, "subcategory", target->subcategory);
-    if (!entry.isMember("subcategory") || subcategory.empty()) {
+    std::string subcategory = trim_or_fallback(entry.subcategory, target->subcategory);
+    if (!entry.subcategory || subcategory.empty()) {
         subcategory = category;
     }
 
     return HarmonizedUpdate{id, target, std::move(category), std::move(subcategory)};
 }
 
-void apply_harmonized_update(
-    const HarmonizedUpdate& update,
-    DatabaseManager& db_manager,
-    std::unordered_map<std::string, CategorizedFile*>& new_items_by_key,
-    const ConsistencyPassService::ProgressCallback& progress_callback,
-    const std::shared_ptr<spdlog::logger>& logger)
+ConsistencyPassService::Change to_change(const HarmonizedUpdate& update)
 {
-    DatabaseManager::ResolvedCategory resolved =
-        db_manager.resolve_category(update.category, update.subcategory);
-
-    bool changed = (resolved.category != update.target->category) ||
-                   (resolved.subcategory != update.target->subcategory);
-
-    update.target->category = resolved.category;
-    update.target->subcategory = resolved.subcategory;
-    update.target->taxonomy_id = resolved.taxonomy_id;
-
-    db_manager.insert_or_update_file_with_categorization(
-        update.target->file_name,
-        update.target->type == FileType::File ? "F" : "D",
-        update.target->file_path,
-        resolved,
-        update.target->used_consistency_hints);
-
-    if (auto new_it = new_items_by_key.find(update.id); new_it != new_items_by_key.end() && new_it->second) {
-        new_it->second->category = resolved.category;
-        new_it->second->subcategory = resolved.subcategory;
-        new_it->second->taxonomy_id = resolved.taxonomy_id;
-    }
+    return ConsistencyPassService::Change{update.id,
+                                          update.target->file_name,
+                                          update.target->category,
+                                          update.target->subcategory,
+                                          update.category,
+                                          update.subcategory};
+}
 
-    if (changed) {
-        const std::string message = fmt::format("[CONSISTENCY] {} -> {} / {}",
-                                                update.target->file_name,
-                                                resolved.category,
-                                                resolved.subcategory);
-        if (progress_callback) {
-            progress_callback(message);
-        }
-        if (logger) {
-            logger->info(message);
-        }
-    }
+bool relabels(const ConsistencyPassService::Change& change)
+{
+    return change.to_category != change.from_category || change.to_subcategory != change.from_subcategory;
 }
 
-const Json::Value* parse_consistency_response(
+std::optional<std::vector<HarmonizedEntry>> parse_consistency_response(
     const std::string& response,
-    Json::Value& root,
     const std::shared_ptr<spdlog::logger>& logger)
 {
-    Json::CharReaderBuilder reader;
-    std::string errors;
-    std::istringstream stream(response);
-    if (!Json::parseFromStream(reader, stream, &root, &errors)) {
+    const JsonView root = JsonView::parse(response);
+    if (!root.valid()) {
         if (logger) {
-            logger->warn("Consistency pass JSON parse failed: {}", errors);
+            logger->warn("Consistency pass reply is not valid JSON");
             logger->warn("Consistency pass raw response ({} chars):\n{}", response.size(), response);
         }
-        return parse_structured_fallback(response, root, logger);
+        return parse_structured_fallback(response, logger);
     }
 
-    if (const Json::Value* direct = extract_harmonized_array(root)) {
-        return direct;
+    if (const JsonView direct = extract_harmonized_array(root); direct.valid()) {
+        return read_harmonized_entries(direct);
     }
 
     if (logger) {
         logger->warn("Consistency pass response missing 'harmonized' array");
     }
-    return parse_structured_fallback(response, root, logger);
+    return parse_structured_fallback(response, logger);
 }
 
 std::string strip_list_prefix(std::string line) {
@@ -416,37 +521,37 @@ std::vector<std::pair<std::string, std::string>> parse_ordered_category_lines(
     return ordered;
 }
 
-bool apply_ordered_fallback(
+std::optional<std::vector<ConsistencyPassService::Change>> collect_ordered_fallback(
     const std::string& response,
     const std::vector<const CategorizedFile*>& chunk,
     std::unordered_map<std::string, CategorizedFile*>& items_by_key,
-    DatabaseManager& db_manager,
-    std::unordered_map<std::string, CategorizedFile*>& new_items_by_key,
-    const ConsistencyPassService::ProgressCallback& progress_callback,
     const std::shared_ptr<spdlog::logger>& logger)
 {
     const auto ordered = parse_ordered_category_lines(response, logger);
     if (ordered.empty()) {
-        return false;
+        return std::nullopt;
     }
 
     const size_t limit = std::min(chunk.size(), ordered.size());
-    bool applied = false;
+    std::vector<ConsistencyPassService::Change> changes;
+    bool matched = false;
     for (size_t index = 0; index < limit; ++index) {
         if (!chunk[index]) {
             continue;
         }
-        Json::Value entry(Json::objectValue);
-        entry["id"] = make_item_key(*chunk[index]);
-        entry["category"] = ordered[index].first;
-        entry["subcategory"] = ordered[index].second;
+        const HarmonizedEntry entry{make_item_key(*chunk[index]), ordered[index].first, ordered[index].second};
         if (auto update = extract_harmonized_update(entry, items_by_key, logger)) {
-            apply_harmonized_update(*update, db_manager, new_items_by_key, progress_callback, logger);
-            applied = true;
+            matched = true;
+            if (auto change = to_change(*update); relabels(change)) {
+                changes.push_back(std::move(change));
+            }
         }
     }
 
-    return applied;
+    if (!matched) {
+        return std::nullopt;
+    }
+    return changes;
 }
 
 
@@ -464,6 +569,118 @@ void ConsistencyPassService::set_prompt_logging_enabled(bool enabled)
     prompt_logging_enabled = enabled;
 }
 
+void ConsistencyPassService::set_max_parallel(std::size_t value)
+{
+    max_parallel = std::max<std::size_t>(1, value);
+}
+
+std::vector<const CategorizedFile*> ConsistencyPassService::select_drifting_items(
+    const std::vector<CategorizedFile>& items,
+    const std::vector<CategorizedFile>& new_items)
+{
+    std::unordered_set<std::string> new_keys;
+    new_keys.reserve(new_items.size());
+    for (const auto& item : new_items) {
+        new_keys.insert(make_item_key(item));
+    }
+
+    std::unordered_map<std::string, std::size_t> category_counts;
+    std::unordered_map<std::string, std::unordered_map<std::string, std::size_t>> subcategory_counts;
+    for (const auto& item : items) {
+        ++category_counts[item.category];
+        ++subcategory_counts[item.category][item.subcategory];
+    }
+
+    std::vector<const CategorizedFile*> selected;
+    for (const auto& item : items) {
+        const auto& siblings = subcategory_counts[item.category];
+        const bool is_new = new_keys.count(make_item_key(item)) > 0;
+        const bool singleton = items.size() > 1 && siblings.at(item.subcategory) == 1;
+        if (is_new || singleton ||
+            drifts_from_common_label(item.category, category_counts) ||
+            drifts_from_common_label(item.subcategory, siblings)) {
+            selected.push_back(&item);
+        }
+    }
+    return selected;
+}
+
+std::vector<std::pair<std::string, std::string>> ConsistencyPassService::select_relevant_taxonomy(
+    const std::vector<const CategorizedFile*>& chunk,
+    const std::vector<DatabaseManager::TaxonomyLabel>& taxonomy,
+    std::size_t limit)
+{
+    // Label words weigh more than file name words; an item's own label outranks everything.
+    constexpr double kNameTermWeight = 1.0;
+    constexpr double kLabelTermWeight = 2.0;
+    constexpr double kCurrentLabelBonus = 1000.0;
+
+    std::unordered_map<std::string, double> term_weights;
+    std::unordered_set<std::string> current_labels;
+    for (const auto* item : chunk) {
+        const std::string stem = std::filesystem::path(item->file_name).stem().string();
+        for (const auto& term : label_terms(stem)) {
+            term_weights[term] += kNameTermWeight;
+        }
+        for (const auto& term : label_terms(item->category + ' ' + item->subcategory)) {
+            term_weights[term] += kLabelTermWeight;
+        }
+        current_labels.insert(label_key(item->category, item->subcategory));
+    }
+
+    struct Ranked {
+        double relevance;
+        int frequency;
+        std::size_t index;
+    };
+    std::vector<Ranked> ranked;
+    ranked.reserve(taxonomy.size());
+    for (std::size_t index = 0; index < taxonomy.size(); ++index) {
+        const auto& entry = taxonomy[index];
+        double relevance = current_labels.count(label_key(entry.category, entry.subcategory)) > 0
+                               ? kCurrentLabelBonus
+                               : 0.0;
+        std::unordered_set<std::string> seen;
+        for (const auto& term : label_terms(entry.category + ' ' + entry.subcategory)) {
+            const auto weight = term_weights.find(term);
+            if (weight != term_weights.end() && seen.insert(term).second) {
+                relevance += weight->second;
+            }
+        }
+        ranked.push_back(Ranked{relevance, entry.frequency, index});
+    }
+
+    const std::size_t count = std::min(limit, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(count), ranked.end(),
+                      [](const Ranked& a, const Ranked& b) {
+                          if (a.relevance != b.relevance) {
+                              return a.relevance > b.relevance;
+                          }
+                          if (a.frequency != b.frequency) {
+                              return a.frequency > b.frequency;
+                          }
+                          return a.index < b.index;
+                      });
+
+    std::vector<std::pair<std::string, std::string>> selected;
+    selected.reserve(count);
+    for (std::size_t index = 0; index < count; ++index) {
+        const auto& entry = taxonomy[ranked[index].index];
+        selected.emplace_back(entry.category, entry.subcategory);
+    }
+    return selected;
+}
+
+void ConsistencyPassService::set_delta_mode(bool enabled)
+{
+    delta_mode = enabled;
+}
+
+void ConsistencyPassService::set_dry_run(bool enabled)
+{
+    dry_run = enabled;
+}
+
 std::unique_ptr<ILLMClient> ConsistencyPassService::create_llm(
     std::function<std::unique_ptr<ILLMClient>()> llm_factory) const
 {
@@ -491,149 +708,337 @@ void ConsistencyPassService::log_chunk_items(const std::vector<const Categorized
         if (!item) {
             continue;
         }
-        logger->info("  [{}] {} -> {} / {}", stage, item->file_name, item->category, item->subcategory);
+        logger->debug("  [{}] {} -> {} / {}", stage, item->file_name, item->category, item->subcategory);
     }
 }
 
-bool ConsistencyPassService::apply_harmonized_response(
+std::optional<std::vector<ConsistencyPassService::Change>> ConsistencyPassService::collect_changes(
     const std::string& response,
     const std::vector<const CategorizedFile*>& chunk,
-    std::unordered_map<std::string, CategorizedFile*>& items_by_key,
-    std::unordered_map<std::string, CategorizedFile*>& new_items_by_key,
-    const ProgressCallback& progress_callback,
-    DatabaseManager& db_manager) const
+    std::unordered_map<std::string, CategorizedFile*>& items_by_key) const
 {
-    Json::Value root;
-    if (const Json::Value* harmonized = parse_consistency_response(response, root, logger)) {
+    if (const auto harmonized = parse_consistency_response(response, logger)) {
+        std::vector<Change> changes;
         for (const auto& entry : *harmonized) {
             if (auto update = extract_harmonized_update(entry, items_by_key, logger)) {
-                apply_harmonized_update(*update, db_manager, new_items_by_key, progress_callback, logger);
+                if (auto change = to_change(*update); relabels(change)) {
+                    changes.push_back(std::move(change));
+                }
             }
         }
-        return true;
+        return changes;
     }
 
-    if (apply_ordered_fallback(response,
-                               chunk,
-                               items_by_key,
-                               db_manager,
-                               new_items_by_key,
-                               progress_callback,
-                               logger)) {
-        return true;
+    if (auto changes = collect_ordered_fallback(response, chunk, items_by_key, logger)) {
+        return changes;
     }
 
     if (logger) {
         logger->warn("Consistency pass could not interpret response; skipping chunk");
     }
-    return false;
+    return std::nullopt;
+}
+
+bool ConsistencyPassService::commit_changes(
+    const std::vector<Change>& changes,
+    std::unordered_map<std::string, CategorizedFile*>& items_by_key,
+    std::unordered_map<std::string, CategorizedFile*>& new_items_by_key,
+    const ProgressCallback& progress_callback) const
+{
+    std::vector<CategorizedFile*> targets;
+    std::vector<DatabaseManager::CategorizationUpdate> rows;
+    targets.reserve(changes.size());
+    rows.reserve(changes.size());
+    for (const auto& change : changes) {
+        const auto it = items_by_key.find(change.id);
+        if (it == items_by_key.end() || !it->second) {
+            continue;
+        }
+        CategorizedFile* target = it->second;
+        targets.push_back(target);
+        rows.push_back(DatabaseManager::CategorizationUpdate{
+            target->file_name,
+            target->type == FileType::File ? "F" : "D",
+            target->file_path,
+            DatabaseManager::ResolvedCategory{-1, change.to_category, change.to_subcategory},
+            target->used_consistency_hints,
+            target->taxonomy_id});
+    }
+
+    // The labels are resolved in the same transaction, so a failed chunk adds no taxonomy entries.
+    if (!db_manager.resolve_and_apply_categorization_updates(rows)) {
+        if (logger) {
+            logger->warn("Consistency pass could not save {} change(s); keeping the previous labels", rows.size());
+        }
+        return false;
+    }
+
+    for (std::size_t index = 0; index < rows.size(); ++index) {
+        CategorizedFile* target = targets[index];
+        const auto& resolved = rows[index].resolved;
+        const bool changed = resolved.category != target->category || resolved.subcategory != target->subcategory;
+
+        target->category = resolved.category;
+        target->subcategory = resolved.subcategory;
+        target->taxonomy_id = resolved.taxonomy_id;
+        const std::string key = make_item_key(*target);
+        if (auto new_it = new_items_by_key.find(key); new_it != new_items_by_key.end() && new_it->second) {
+            new_it->second->category = resolved.category;
+            new_it->second->subcategory = resolved.subcategory;
+            new_it->second->taxonomy_id = resolved.taxonomy_id;
+        }
+
+        if (changed) {
+            const std::string message = fmt::format("[CONSISTENCY] {} -> {} / {}",
+                                                    target->file_name,
+                                                    resolved.category,
+                                                    resolved.subcategory);
+            if (progress_callback) {
+                progress_callback(message);
+            }
+            if (logger) {
+                logger->debug(message);
+            }
+        }
+    }
+    return true;
+}
+
+bool ConsistencyPassService::apply_changes(const std::vector<Change>& changes,
+                                           std::vector<CategorizedFile>& categorized_files,
+                                           std::vector<CategorizedFile>& newly_categorized_files,
+                                           const ProgressCallback& progress_callback) const
+{
+    auto items_by_key = build_items_by_key(categorized_files);
+    auto new_items_by_key = build_items_by_key(newly_categorized_files);
+    return commit_changes(changes, items_by_key, new_items_by_key, progress_callback);
+}
+
+std::vector<ConsistencyPassService::ChunkRange> ConsistencyPassService::plan_chunks(
+    const std::vector<const CategorizedFile*>& items,
+    const std::string& taxonomy_json,
+    std::size_t context_tokens,
+    const std::function<std::size_t(const std::string&)>& count_tokens)
+{
+    // Room for "END" and stray whitespace in the reply.
+    constexpr std::size_t kReplyOverheadTokens = 8;
+
+    const std::size_t fixed_tokens = count_tokens(build_consistency_prompt({}, taxonomy_json)) + kReplyOverheadTokens;
+    const std::size_t budget = context_tokens > fixed_tokens ? context_tokens - fixed_tokens : 0;
+
+    std::vector<ChunkRange> chunks;
+    ChunkRange current;
+    std::size_t used = 0;
+    std::size_t reply_tokens = 0;
+    const auto flush = [&]() {
+        current.max_tokens = static_cast<int>(reply_tokens + kReplyOverheadTokens);
+        chunks.push_back(current);
+        current = ChunkRange{current.end, current.end, 0};
+        used = 0;
+        reply_tokens = 0;
+    };
+
+    for (std::size_t index = 0; index < items.size(); ++index) {
+        // Relabelled items can come back longer than they went in.
+        const std::size_t reply_cost = count_tokens(expected_reply_line(*items[index])) * 3 / 2 + 2;
+        const std::size_t cost = count_tokens(format_item_line(*items[index])) + reply_cost;
+        const std::size_t size = current.end - current.begin;
+        if (size > 0 && (used + cost > budget || size == kMaxChunkItems)) {
+            flush();
+        }
+        current.end = index + 1;
+        used += cost;
+        reply_tokens += reply_cost;
+    }
+    if (current.end > current.begin) {
+        flush();
+    }
+    return chunks;
 }
 
 void ConsistencyPassService::process_chunk(
     const std::vector<const CategorizedFile*>& chunk,
-    size_t start_index,
-    size_t end_index,
+    const ChunkRange& range,
     size_t total_items,
     ILLMClient& llm,
-    const std::vector<std::pair<std::string, std::string>>& taxonomy,
+    const std::vector<DatabaseManager::TaxonomyLabel>& taxonomy,
     std::unordered_map<std::string, CategorizedFile*>& items_by_key,
     std::unordered_map<std::string, CategorizedFile*>& new_items_by_key,
-    const ProgressCallback& progress_callback) const
+    const ProgressCallback& progress_callback,
+    std::mutex& apply_mutex,
+    std::vector<Change>& changes) const
 {
-    if (logger) {
-        logger->info("[CONSISTENCY] Processing chunk {}-{} of {}", start_index + 1, end_index, total_items);
-        log_chunk_items(chunk, "BEFORE");
+    // Only this chunk's items may be relabelled from its reply: another worker reads its own
+    // items while building its prompt, so an id the model borrowed from there must not land.
+    std::unordered_map<std::string, CategorizedFile*> chunk_items;
+    chunk_items.reserve(chunk.size());
+    for (const auto* item : chunk) {
+        const std::string key = make_item_key(*item);
+        if (auto it = items_by_key.find(key); it != items_by_key.end()) {
+            chunk_items.emplace(key, it->second);
+        }
     }
 
-    const std::string prompt = build_consistency_prompt(chunk, taxonomy);
-    if (prompt_logging_enabled) {
-        std::cout << "\n[CONSISTENCY PROMPT]\n" << prompt << "\n";
+    const std::string taxonomy_json =
+        build_taxonomy_json(select_relevant_taxonomy(chunk, taxonomy, kTaxonomyContextEntries));
+    const std::string prompt = build_consistency_prompt(chunk, taxonomy_json);
+    {
+        std::lock_guard<std::mutex> lock(apply_mutex);
+        if (logger) {
+            logger->info("[CONSISTENCY] Processing chunk {}-{} of {}", range.begin + 1, range.end, total_items);
+            log_chunk_items(chunk, "BEFORE");
+        }
+        if (prompt_logging_enabled) {
+            std::cout << "\n[CONSISTENCY PROMPT]\n" << prompt << "\n";
+        }
     }
 
     try {
-        const std::string response = llm.complete_prompt(prompt, 512);
+        const std::string response = llm.complete_prompt(prompt, range.max_tokens);
+
+        std::lock_guard<std::mutex> lock(apply_mutex);
         if (prompt_logging_enabled) {
             std::cout << "[CONSISTENCY RESPONSE]\n" << response << "\n";
         }
 
-        apply_harmonized_response(response,
-                                  chunk,
-                                  items_by_key,
-                                  new_items_by_key,
-                                  progress_callback,
-                                  db_manager);
+        // A chunk is written as a whole or not at all.
+        auto proposed = collect_changes(response, chunk, chunk_items);
+        if (proposed && (dry_run || commit_changes(*proposed, chunk_items, new_items_by_key, progress_callback))) {
+            changes.insert(changes.end(), proposed->begin(), proposed->end());
+        }
     } catch (const std::exception& ex) {
         if (logger) {
             logger->warn("Consistency pass chunk failed: {}", ex.what());
         }
     }
 
+    std::lock_guard<std::mutex> lock(apply_mutex);
     log_chunk_items(chunk, "AFTER");
 }
 
 void ConsistencyPassService::process_chunks(
-    ILLMClient& llm,
-    const std::vector<std::pair<std::string, std::string>>& taxonomy,
-    std::vector<CategorizedFile>& categorized_files,
+    std::vector<std::unique_ptr<ILLMClient>>& clients,
+    const std::vector<ChunkRange>& chunks,
+    const std::vector<DatabaseManager::TaxonomyLabel>& taxonomy,
+    const std::vector<const CategorizedFile*>& items,
     std::unordered_map<std::string, CategorizedFile*>& items_by_key,
     std::unordered_map<std::string, CategorizedFile*>& new_items_by_key,
     std::atomic<bool>& stop_flag,
-    const ProgressCallback& progress_callback) const
+    const ProgressCallback& progress_callback,
+    std::vector<Change>& changes) const
 {
-    std::vector<const CategorizedFile*> chunk;
-    chunk.reserve(10);
-
-    for (size_t index = 0; index < categorized_files.size(); ++index) {
-        if (stop_flag.load()) {
-            break;
-        }
-
-        chunk.push_back(&categorized_files[index]);
-        const bool should_flush = chunk.size() == 10 || index + 1 == categorized_files.size();
-        if (!should_flush) {
-            continue;
+    std::mutex apply_mutex;
+    std::atomic<std::size_t> next_chunk{0};
+
+    // Every client takes the next unprocessed chunk until none are left.
+    const auto work = [&](ILLMClient& llm) {
+        while (!stop_flag.load()) {
+            const std::size_t index = next_chunk.fetch_add(1);
+            if (index >= chunks.size()) {
+                return;
+            }
+            const ChunkRange& range = chunks[index];
+            const std::vector<const CategorizedFile*> chunk(items.begin() + static_cast<std::ptrdiff_t>(range.begin),
+                                                            items.begin() + static_cast<std::ptrdiff_t>(range.end));
+            process_chunk(chunk,
+                          range,
+                          items.size(),
+                          llm,
+                          taxonomy,
+                          items_by_key,
+                          new_items_by_key,
+                          progress_callback,
+                          apply_mutex,
+                          changes);
         }
+    };
 
-        const size_t start_index = index + 1 - chunk.size();
-        const size_t end_index = index + 1;
-        process_chunk(chunk,
-                      start_index,
-                      end_index,
-                      categorized_files.size(),
-                      llm,
-                      taxonomy,
-                      items_by_key,
-                      new_items_by_key,
-                      progress_callback);
-        chunk.clear();
+    std::vector<std::thread> workers;
+    workers.reserve(clients.size() - 1);
+    for (std::size_t index = 1; index < clients.size(); ++index) {
+        workers.emplace_back(work, std::ref(*clients[index]));
+    }
+    work(*clients.front());
+    for (auto& worker : workers) {
+        worker.join();
     }
 }
 
-void ConsistencyPassService::run(std::vector<CategorizedFile>& categorized_files,
+std::vector<ConsistencyPassService::Change> ConsistencyPassService::run(
+                                 std::vector<CategorizedFile>& categorized_files,
                                  std::vector<CategorizedFile>& newly_categorized_files,
                                  std::function<std::unique_ptr<ILLMClient>()> llm_factory,
                                  std::atomic<bool>& stop_flag,
                                  const ProgressCallback& progress_callback) const
 {
+    std::vector<Change> changes;
     if (stop_flag.load() || categorized_files.empty()) {
-        return;
+        return changes;
+    }
+
+    std::vector<const CategorizedFile*> items;
+    if (delta_mode) {
+        items = select_drifting_items(categorized_files, newly_categorized_files);
+        const std::string message = fmt::format("[CONSISTENCY] Re-checking {} of {} item(s)",
+                                                items.size(), categorized_files.size());
+        if (progress_callback) {
+            progress_callback(message);
+        }
+        if (logger) {
+            logger->info(message);
+        }
+        if (items.empty()) {
+            return changes;
+        }
+    } else {
+        items.reserve(categorized_files.size());
+        for (const auto& item : categorized_files) {
+            items.push_back(&item);
+        }
     }
 
-    auto llm = create_llm(std::move(llm_factory));
+    auto llm = create_llm(llm_factory);
     if (!llm) {
-        return;
+        return changes;
     }
 
-    const auto taxonomy = db_manager.get_taxonomy_snapshot(150);
+    const auto taxonomy = db_manager.get_taxonomy_labels();
+    const std::size_t context_tokens =
+        llm->context_length() > 0 ? llm->context_length() : kDefaultContextTokens;
+    const auto chunks = plan_chunks(items, taxonomy_budget_json(taxonomy, kTaxonomyContextEntries), context_tokens,
+                                    [&llm](const std::string& text) { return llm->count_tokens(text); });
+
+    std::vector<std::unique_ptr<ILLMClient>> clients;
+    clients.push_back(std::move(llm));
+    const std::size_t wanted_clients = std::min(max_parallel, chunks.size());
+    while (clients.size() < wanted_clients) {
+        auto extra = create_llm(llm_factory);
+        if (!extra) {
+            break;
+        }
+        clients.push_back(std::move(extra));
+    }
+
+    if (logger) {
+        logger->info("[CONSISTENCY] {} item(s) in {} chunk(s) on {} client(s), {} token context",
+                     items.size(), chunks.size(), clients.size(), context_tokens);
+    }
 
     auto items_by_key = build_items_by_key(categorized_files);
     auto new_items_by_key = build_items_by_key(newly_categorized_files);
 
-    process_chunks(*llm,
+    process_chunks(clients,
+                   chunks,
                    taxonomy,
-                   categorized_files,
+                   items,
                    items_by_key,
                    new_items_by_key,
                    stop_flag,
-                   progress_callback);
+                   progress_callback,
+                   changes);
+
+    if (dry_run && logger) {
+        logger->info("[CONSISTENCY] Dry run proposed {} change(s); nothing was saved", changes.size());
+    }
+    return changes;
 }
@@ -1,6 +1,7 @@
 #include "DatabaseManager.hpp"
 #include "Types.hpp"
 #include "Logger.hpp"
+#include "Metrics.hpp"
 
 #include <algorithm>
 #include <cctype>
@@ -9,6 +10,7 @@
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <set>
 #include <sstream>
 #include <utility>
 #include <vector>
@@ -75,6 +77,58 @@ StatementPtr prepare_statement(sqlite3* db, const char* sql) {
     return StatementPtr(raw);
 }
 
+constexpr const char* kUpsertCategorizationSql = R"(
+    INSERT INTO file_categorization
+        (file_name, file_type, dir_path, category, subcategory, taxonomy_id, categorization_style, confidence)
+    VALUES (?, ?, ?, ?, ?, ?, ?, ?)
+    ON CONFLICT(file_name, file_type, dir_path)
+    DO UPDATE SET
+        category = excluded.category,
+        subcategory = excluded.subcategory,
+        taxonomy_id = excluded.taxonomy_id,
+        categorization_style = excluded.categorization_style,
+        confidence = excluded.confidence;
+)";
+
+// Relabels existing rows: a row written without a confidence keeps the one already stored.
+constexpr const char* kUpdateCategorizationSql = R"(
+    INSERT INTO file_categorization
+        (file_name, file_type, dir_path, category, subcategory, taxonomy_id, categorization_style, confidence)
+    VALUES (?, ?, ?, ?, ?, ?, ?, ?)
+    ON CONFLICT(file_name, file_type, dir_path)
+    DO UPDATE SET
+        category = excluded.category,
+        subcategory = excluded.subcategory,
+        taxonomy_id = excluded.taxonomy_id,
+        categorization_style = excluded.categorization_style,
+        confidence = COALESCE(excluded.confidence, file_categorization.confidence);
+)";
+
+void bind_categorization(sqlite3_stmt* stmt,
+                         const std::string& file_name,
+                         const std::string& file_type,
+                         const std::string& dir_path,
+                         const DatabaseManager::ResolvedCategory& resolved,
+                         bool used_consistency_hints) {
+    sqlite3_bind_text(stmt, 1, file_name.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, file_type.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 3, dir_path.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 4, resolved.category.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 5, resolved.subcategory.c_str(), -1, SQLITE_TRANSIENT);
+
+    if (resolved.taxonomy_id > 0) {
+        sqlite3_bind_int(stmt, 6, resolved.taxonomy_id);
+    } else {
+        sqlite3_bind_null(stmt, 6);
+    }
+    sqlite3_bind_int(stmt, 7, used_consistency_hints ? 1 : 0);
+    if (resolved.confidence) {
+        sqlite3_bind_double(stmt, 8, *resolved.confidence);
+    } else {
+        sqlite3_bind_null(stmt, 8);
+    }
+}
+
 std::string trim_copy(std::string value) {
     auto not_space = [](unsigned char ch) { return !std::isspace(ch); };
     value.erase(value.begin(), std::find_if(value.begin(), value.end(), not_space));
@@ -111,11 +165,16 @@ std::optional<CategorizedFile> build_categorized_entry(sqlite3_stmt* stmt) {
     if (sqlite3_column_count(stmt) > 6 && sqlite3_column_type(stmt, 6) != SQLITE_NULL) {
         used_consistency = sqlite3_column_int(stmt, 6) != 0;
     }
+    std::optional<double> confidence;
+    if (sqlite3_column_count(stmt) > 7 && sqlite3_column_type(stmt, 7) != SQLITE_NULL) {
+        confidence = sqlite3_column_double(stmt, 7);
+    }
 
     FileType file_type_enum = (type_str == "F") ? FileType::File : FileType::Directory;
     CategorizedFile entry{dir_path, name, file_type_enum, cat, subcat, taxonomy_id};
     entry.from_cache = true;
     entry.used_consistency_hints = used_consistency;
+    entry.confidence = confidence;
     return entry;
 }
 
@@ -143,6 +202,8 @@ DatabaseManager::DatabaseManager(std::string config_dir)
 
     initialize_schema();
     initialize_taxonomy_schema();
+    initialize_hash_cache_schema();
+    initialize_batch_schema();
     load_taxonomy_cache();
 }
 
@@ -166,6 +227,7 @@ void DatabaseManager::initialize_schema() {
             subcategory TEXT,
             taxonomy_id INTEGER,
             categorization_style INTEGER DEFAULT 0,
+            confidence REAL,
             timestamp DATETIME DEFAULT CURRENT_TIMESTAMP,
             UNIQUE(file_name, file_type, dir_path)
         );
@@ -198,6 +260,16 @@ void DatabaseManager::initialize_schema() {
         }
     }
 
+    const char *add_confidence_column_sql = "ALTER TABLE file_categorization ADD COLUMN confidence REAL;";
+    if (sqlite3_exec(db, add_confidence_column_sql, nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        if (!is_duplicate_column_error(error_msg)) {
+            db_log(spdlog::level::warn, "Failed to add confidence column: {}", error_msg ? error_msg : "");
+        }
+        if (error_msg) {
+            sqlite3_free(error_msg);
+        }
+    }
+
     const char *create_index_sql =
         "CREATE INDEX IF NOT EXISTS idx_file_categorization_taxonomy ON file_categorization(taxonomy_id);";
     if (sqlite3_exec(db, create_index_sql, nullptr, nullptr, &error_msg) != SQLITE_OK) {
@@ -249,6 +321,54 @@ void DatabaseManager::initialize_taxonomy_schema() {
     }
 }
 
+void DatabaseManager::initialize_hash_cache_schema() {
+    if (!db) return;
+
+    const char *hash_cache_sql = R"(
+        CREATE TABLE IF NOT EXISTS file_hash_cache (
+            path TEXT PRIMARY KEY,
+            size INTEGER NOT NULL,
+            mtime INTEGER NOT NULL,
+            partial_hash INTEGER NOT NULL,
+            full_hash INTEGER NOT NULL DEFAULT 0
+        );
+    )";
+
+    char *error_msg = nullptr;
+    if (sqlite3_exec(db, hash_cache_sql, nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        db_log(spdlog::level::err, "Failed to create file_hash_cache table: {}", error_msg);
+        sqlite3_free(error_msg);
+    }
+}
+
+void DatabaseManager::initialize_batch_schema() {
+    if (!db) return;
+
+    const char *batch_sql = R"(
+        CREATE TABLE IF NOT EXISTS openai_batch_job (
+            batch_id TEXT PRIMARY KEY,
+            model TEXT NOT NULL,
+            status TEXT NOT NULL,
+            submitted_at INTEGER NOT NULL
+        );
+        CREATE TABLE IF NOT EXISTS openai_batch_item (
+            batch_id TEXT NOT NULL,
+            custom_id TEXT NOT NULL,
+            dir_path TEXT NOT NULL,
+            file_name TEXT NOT NULL,
+            file_type TEXT NOT NULL,
+            PRIMARY KEY (batch_id, custom_id)
+        );
+        CREATE INDEX IF NOT EXISTS idx_openai_batch_item_dir ON openai_batch_item(dir_path);
+    )";
+
+    char *error_msg = nullptr;
+    if (sqlite3_exec(db, batch_sql, nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        db_log(spdlog::level::err, "Failed to create OpenAI batch tables: {}", error_msg);
+        sqlite3_free(error_msg);
+    }
+}
+
 void DatabaseManager::load_taxonomy_cache() {
     taxonomy_entries.clear();
     canonical_lookup.clear();
@@ -557,6 +677,7 @@ DatabaseManager::ResolvedCategory DatabaseManager::build_resolved_category(
 DatabaseManager::ResolvedCategory
 DatabaseManager::resolve_category(const std::string &category,
                                   const std::string &subcategory) {
+    Metrics::Timer timer(Metrics::Stage::ResolveCategory);
     ResolvedCategory result{-1, category, subcategory};
     if (!db) {
         return result;
@@ -601,37 +722,15 @@ bool DatabaseManager::insert_or_update_file_with_categorization(
     const ResolvedCategory &resolved,
     bool used_consistency_hints) {
     if (!db) return false;
-
-    const char *sql = R"(
-        INSERT INTO file_categorization
-            (file_name, file_type, dir_path, category, subcategory, taxonomy_id, categorization_style)
-        VALUES (?, ?, ?, ?, ?, ?, ?)
-        ON CONFLICT(file_name, file_type, dir_path)
-        DO UPDATE SET
-            category = excluded.category,
-            subcategory = excluded.subcategory,
-            taxonomy_id = excluded.taxonomy_id,
-            categorization_style = excluded.categorization_style;
-    )";
+    Metrics::Timer timer(Metrics::Stage::DbWrite);
 
     sqlite3_stmt *stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    if (sqlite3_prepare_v2(db, kUpsertCategorizationSql, -1, &stmt, nullptr) != SQLITE_OK) {
         db_log(spdlog::level::err, "SQL prepare error: {}", sqlite3_errmsg(db));
         return false;
     }
 
-    sqlite3_bind_text(stmt, 1, file_name.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, file_type.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, dir_path.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 4, resolved.category.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 5, resolved.subcategory.c_str(), -1, SQLITE_TRANSIENT);
-
-    if (resolved.taxonomy_id > 0) {
-        sqlite3_bind_int(stmt, 6, resolved.taxonomy_id);
-    } else {
-        sqlite3_bind_null(stmt, 6);
-    }
-    sqlite3_bind_int(stmt, 7, used_consistency_hints ? 1 : 0);
+    bind_categorization(stmt, file_name, file_type, dir_path, resolved, used_consistency_hints);
 
     bool success = true;
     if (sqlite3_step(stmt) != SQLITE_DONE) {
@@ -648,6 +747,78 @@ bool DatabaseManager::insert_or_update_file_with_categorization(
     return success;
 }
 
+bool DatabaseManager::apply_categorization_updates(const std::vector<CategorizationUpdate>& updates) {
+    if (!db) return false;
+    if (updates.empty()) return true;
+
+    sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr);
+    const bool ok = write_categorization_updates(updates);
+    sqlite3_exec(db, ok ? "COMMIT;" : "ROLLBACK;", nullptr, nullptr, nullptr);
+    return ok;
+}
+
+bool DatabaseManager::resolve_and_apply_categorization_updates(std::vector<CategorizationUpdate>& updates) {
+    if (!db) return false;
+    if (updates.empty()) return true;
+
+    sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr);
+    for (auto& update : updates) {
+        update.resolved = resolve_category(update.resolved.category, update.resolved.subcategory);
+    }
+    const bool ok = write_categorization_updates(updates);
+    sqlite3_exec(db, ok ? "COMMIT;" : "ROLLBACK;", nullptr, nullptr, nullptr);
+    if (!ok) {
+        // Entries and aliases the labels created were rolled back with the rows.
+        load_taxonomy_cache();
+    }
+    return ok;
+}
+
+bool DatabaseManager::write_categorization_updates(const std::vector<CategorizationUpdate>& updates) {
+    Metrics::Timer timer(Metrics::Stage::DbWrite);
+
+    auto upsert = prepare_statement(db, kUpdateCategorizationSql);
+    auto recount = prepare_statement(db,
+        "UPDATE category_taxonomy "
+        "SET frequency = (SELECT COUNT(*) FROM file_categorization WHERE taxonomy_id = ?) "
+        "WHERE id = ?;");
+    if (!upsert || !recount) {
+        db_log(spdlog::level::err, "Failed to prepare categorization batch: {}", sqlite3_errmsg(db));
+        return false;
+    }
+
+    bool ok = true;
+    std::set<int> touched_taxonomy;
+    for (const auto& update : updates) {
+        sqlite3_reset(upsert.get());
+        bind_categorization(upsert.get(), update.file_name, update.file_type, update.dir_path,
+                            update.resolved, update.used_consistency_hints);
+        if (sqlite3_step(upsert.get()) != SQLITE_DONE) {
+            ok = false;
+            break;
+        }
+        for (int id : {update.resolved.taxonomy_id, update.previous_taxonomy_id}) {
+            if (id > 0) {
+                touched_taxonomy.insert(id);
+            }
+        }
+    }
+    // Each entry is recounted once, covering both the labels files moved to and the ones they left.
+    for (int id : touched_taxonomy) {
+        if (!ok) {
+            break;
+        }
+        sqlite3_reset(recount.get());
+        sqlite3_bind_int(recount.get(), 1, id);
+        sqlite3_bind_int(recount.get(), 2, id);
+        ok = sqlite3_step(recount.get()) == SQLITE_DONE;
+    }
+    if (!ok) {
+        db_log(spdlog::level::err, "Failed to apply {} categorization update(s): {}", updates.size(), sqlite3_errmsg(db));
+    }
+    return ok;
+}
+
 bool DatabaseManager::remove_file_categorization(const std::string& dir_path,
                                                  const std::string& file_name,
                                                  const FileType file_type) {
@@ -810,8 +981,8 @@ DatabaseManager::get_categorized_files(const std::string &directory_path) {
     if (!db) return categorized_files;
 
     const char *sql =
-        "SELECT dir_path, file_name, file_type, category, subcategory, taxonomy_id, categorization_style "
-        "FROM file_categorization WHERE dir_path = ?;";
+        "SELECT dir_path, file_name, file_type, category, subcategory, taxonomy_id, categorization_style, "
+        "confidence FROM file_categorization WHERE dir_path = ?;";
     StatementPtr stmt = prepare_statement(db, sql);
     if (!stmt) {
         return categorized_files;
@@ -835,6 +1006,7 @@ std::vector<std::string>
 DatabaseManager::get_categorization_from_db(const std::string &file_name, const FileType file_type) {
     std::vector<std::string> categorization;
     if (!db) return categorization;
+    Metrics::Timer timer(Metrics::Stage::CacheLookup);
 
     const char *sql =
         "SELECT category, subcategory FROM file_categorization WHERE file_name = ? AND file_type = ?;";
@@ -900,6 +1072,184 @@ std::vector<std::string> DatabaseManager::get_dir_contents_from_db(const std::st
     return results;
 }
 
+std::unordered_map<std::string, DatabaseManager::FileHashes>
+DatabaseManager::get_file_hashes(const std::vector<std::string>& paths) const {
+    std::unordered_map<std::string, FileHashes> results;
+    if (!db || paths.empty()) return results;
+
+    auto stmt = prepare_statement(db,
+        "SELECT size, mtime, partial_hash, full_hash FROM file_hash_cache WHERE path = ?;");
+    if (!stmt) {
+        db_log(spdlog::level::warn, "Failed to prepare hash cache lookup: {}", sqlite3_errmsg(db));
+        return results;
+    }
+
+    for (const auto& path : paths) {
+        sqlite3_reset(stmt.get());
+        sqlite3_bind_text(stmt.get(), 1, path.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt.get()) != SQLITE_ROW) {
+            continue;
+        }
+        FileHashes hashes;
+        hashes.size = sqlite3_column_int64(stmt.get(), 0);
+        hashes.mtime = sqlite3_column_int64(stmt.get(), 1);
+        hashes.partial = static_cast<std::uint64_t>(sqlite3_column_int64(stmt.get(), 2));
+        hashes.full = static_cast<std::uint64_t>(sqlite3_column_int64(stmt.get(), 3));
+        results.emplace(path, hashes);
+    }
+    return results;
+}
+
+bool DatabaseManager::store_file_hashes(const std::vector<std::pair<std::string, FileHashes>>& entries) {
+    if (!db || entries.empty()) return false;
+
+    auto stmt = prepare_statement(db,
+        "INSERT OR REPLACE INTO file_hash_cache (path, size, mtime, partial_hash, full_hash) "
+        "VALUES (?, ?, ?, ?, ?);");
+    if (!stmt) {
+        db_log(spdlog::level::warn, "Failed to prepare hash cache insert: {}", sqlite3_errmsg(db));
+        return false;
+    }
+
+    // One transaction for the whole batch instead of a journal sync per row.
+    sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr);
+    bool ok = true;
+    for (const auto& [path, hashes] : entries) {
+        sqlite3_reset(stmt.get());
+        sqlite3_bind_text(stmt.get(), 1, path.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt.get(), 2, hashes.size);
+        sqlite3_bind_int64(stmt.get(), 3, hashes.mtime);
+        sqlite3_bind_int64(stmt.get(), 4, static_cast<sqlite3_int64>(hashes.partial));
+        sqlite3_bind_int64(stmt.get(), 5, static_cast<sqlite3_int64>(hashes.full));
+        if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+            ok = false;
+        }
+    }
+    sqlite3_exec(db, ok ? "COMMIT;" : "ROLLBACK;", nullptr, nullptr, nullptr);
+    return ok;
+}
+
+bool DatabaseManager::record_batch_job(const BatchJob& job, const std::vector<BatchItem>& items) {
+    if (!db || job.batch_id.empty()) return false;
+
+    auto job_stmt = prepare_statement(db,
+        "INSERT OR REPLACE INTO openai_batch_job (batch_id, model, status, submitted_at) VALUES (?, ?, ?, ?);");
+    auto item_stmt = prepare_statement(db,
+        "INSERT OR REPLACE INTO openai_batch_item (batch_id, custom_id, dir_path, file_name, file_type) "
+        "VALUES (?, ?, ?, ?, ?);");
+    if (!job_stmt || !item_stmt) {
+        db_log(spdlog::level::warn, "Failed to prepare batch job insert: {}", sqlite3_errmsg(db));
+        return false;
+    }
+
+    sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr);
+    sqlite3_bind_text(job_stmt.get(), 1, job.batch_id.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(job_stmt.get(), 2, job.model.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(job_stmt.get(), 3, job.status.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(job_stmt.get(), 4, job.submitted_at);
+    bool ok = sqlite3_step(job_stmt.get()) == SQLITE_DONE;
+    for (const auto& item : items) {
+        if (!ok) {
+            break;
+        }
+        sqlite3_reset(item_stmt.get());
+        sqlite3_bind_text(item_stmt.get(), 1, job.batch_id.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(item_stmt.get(), 2, item.custom_id.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(item_stmt.get(), 3, item.dir_path.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(item_stmt.get(), 4, item.file_name.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(item_stmt.get(), 5, item.type == FileType::File ? "F" : "D", -1, SQLITE_TRANSIENT);
+        ok = sqlite3_step(item_stmt.get()) == SQLITE_DONE;
+    }
+    sqlite3_exec(db, ok ? "COMMIT;" : "ROLLBACK;", nullptr, nullptr, nullptr);
+    if (!ok) {
+        db_log(spdlog::level::err, "Failed to record batch job '{}': {}", job.batch_id, sqlite3_errmsg(db));
+    }
+    return ok;
+}
+
+bool DatabaseManager::update_batch_job_status(const std::string& batch_id, const std::string& status) {
+    if (!db) return false;
+
+    auto stmt = prepare_statement(db, "UPDATE openai_batch_job SET status = ? WHERE batch_id = ?;");
+    if (!stmt) {
+        db_log(spdlog::level::warn, "Failed to prepare batch status update: {}", sqlite3_errmsg(db));
+        return false;
+    }
+    sqlite3_bind_text(stmt.get(), 1, status.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt.get(), 2, batch_id.c_str(), -1, SQLITE_TRANSIENT);
+    return sqlite3_step(stmt.get()) == SQLITE_DONE;
+}
+
+std::vector<DatabaseManager::BatchJob> DatabaseManager::get_open_batch_jobs() const {
+    std::vector<BatchJob> jobs;
+    if (!db) return jobs;
+
+    auto stmt = prepare_statement(db,
+        "SELECT batch_id, model, status, submitted_at FROM openai_batch_job "
+        "WHERE status NOT IN ('collected', 'failed', 'expired', 'cancelled') ORDER BY submitted_at;");
+    if (!stmt) {
+        db_log(spdlog::level::warn, "Failed to prepare batch job query: {}", sqlite3_errmsg(db));
+        return jobs;
+    }
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        BatchJob job;
+        job.batch_id = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0));
+        job.model = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
+        job.status = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 2));
+        job.submitted_at = sqlite3_column_int64(stmt.get(), 3);
+        jobs.push_back(std::move(job));
+    }
+    return jobs;
+}
+
+std::vector<DatabaseManager::BatchItem> DatabaseManager::get_batch_items(const std::string& batch_id) const {
+    std::vector<BatchItem> items;
+    if (!db) return items;
+
+    auto stmt = prepare_statement(db,
+        "SELECT custom_id, dir_path, file_name, file_type FROM openai_batch_item WHERE batch_id = ?;");
+    if (!stmt) {
+        db_log(spdlog::level::warn, "Failed to prepare batch item query: {}", sqlite3_errmsg(db));
+        return items;
+    }
+    sqlite3_bind_text(stmt.get(), 1, batch_id.c_str(), -1, SQLITE_TRANSIENT);
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        BatchItem item;
+        item.custom_id = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0));
+        item.dir_path = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
+        item.file_name = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 2));
+        const std::string type = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 3));
+        item.type = type == "D" ? FileType::Directory : FileType::File;
+        items.push_back(std::move(item));
+    }
+    return items;
+}
+
+std::vector<std::string> DatabaseManager::get_pending_batch_file_names(const std::string& dir_path) const {
+    std::vector<std::string> names;
+    if (!db) return names;
+
+    // Items are stored under their own folder, which is below the scanned one in recursive scans.
+    auto stmt = prepare_statement(db,
+        "SELECT i.file_name FROM openai_batch_item i "
+        "JOIN openai_batch_job j ON j.batch_id = i.batch_id "
+        "WHERE (i.dir_path = ?1 OR substr(i.dir_path, 1, length(?1) + 1) IN (?1 || '/', ?1 || '\\')) "
+        "AND j.status NOT IN ('collected', 'failed', 'expired', 'cancelled');");
+    if (!stmt) {
+        db_log(spdlog::level::warn, "Failed to prepare pending batch query: {}", sqlite3_errmsg(db));
+        return names;
+    }
+    std::string root = dir_path;
+    while (root.size() > 1 && (root.back() == '/' || root.back() == '\\')) {
+        root.pop_back();
+    }
+    sqlite3_bind_text(stmt.get(), 1, root.c_str(), -1, SQLITE_TRANSIENT);
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        names.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0)));
+    }
+    return names;
+}
+
 std::vector<std::pair<std::string, std::string>> DatabaseManager::get_taxonomy_snapshot(std::size_t max_entries) const
 {
     std::vector<std::pair<std::string, std::string>> snapshot;
@@ -916,6 +1266,34 @@ std::vector<std::pair<std::string, std::string>> DatabaseManager::get_taxonomy_s
     return snapshot;
 }
 
+std::vector<DatabaseManager::TaxonomyLabel> DatabaseManager::get_taxonomy_labels() const
+{
+    std::vector<TaxonomyLabel> labels;
+    if (!db) {
+        return labels;
+    }
+
+    const char* sql =
+        "SELECT canonical_category, canonical_subcategory, frequency FROM category_taxonomy "
+        "ORDER BY frequency DESC, id;";
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        db_log(spdlog::level::err, "Failed to prepare taxonomy label query: {}", sqlite3_errmsg(db));
+        return labels;
+    }
+
+    labels.reserve(taxonomy_entries.size());
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const auto* category = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        const auto* subcategory = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        labels.push_back(TaxonomyLabel{category ? category : "",
+                                       subcategory ? subcategory : "",
+                                       sqlite3_column_int(stmt, 2)});
+    }
+    sqlite3_finalize(stmt);
+    return labels;
+}
+
 bool DatabaseManager::is_duplicate_category(
     const std::vector<std::pair<std::string, std::string>>& results,
     const std::pair<std::string, std::string>& candidate)
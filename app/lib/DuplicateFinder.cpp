@@ -0,0 +1,266 @@
+#include "DuplicateFinder.hpp"
+
+#include "DatabaseManager.hpp"
+#include "FileFingerprint.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+
+constexpr unsigned kMaxHashWorkers = 8;
+
+struct Candidate {
+    std::filesystem::path path;
+    std::string key;
+    std::size_t order{0};
+    std::uintmax_t size{0};
+    std::int64_t mtime{0};
+    std::uint64_t partial{0};
+    std::uint64_t full{0};
+    bool changed{false};
+};
+
+using Bucket = std::vector<Candidate*>;
+
+unsigned resolve_worker_count(unsigned requested)
+{
+    if (requested > 0) {
+        return requested;
+    }
+    const unsigned hardware = std::thread::hardware_concurrency();
+    return std::clamp(hardware == 0 ? 2u : hardware, 1u, kMaxHashWorkers);
+}
+
+template <typename Work>
+void run_parallel(const std::vector<Candidate*>& items, unsigned workers, Work work)
+{
+    workers = std::max(1u, std::min<unsigned>(workers, static_cast<unsigned>(items.size())));
+    if (workers == 1) {
+        for (Candidate* item : items) {
+            work(*item);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (unsigned worker = 0; worker < workers; ++worker) {
+        threads.emplace_back([&]() {
+            for (std::size_t index = next++; index < items.size(); index = next++) {
+                work(*items[index]);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// Splits every bucket by key_of and keeps the sub-buckets that still hold more than one file.
+// A key of 0 means the file could not be hashed; such files are dropped.
+template <typename KeyOf>
+std::vector<Bucket> refine(const std::vector<Bucket>& buckets, KeyOf key_of)
+{
+    std::vector<Bucket> refined;
+    for (const auto& bucket : buckets) {
+        std::map<std::uint64_t, Bucket> split;
+        for (Candidate* candidate : bucket) {
+            if (const std::uint64_t key = key_of(*candidate); key != 0) {
+                split[key].push_back(candidate);
+            }
+        }
+        for (auto& [key, members] : split) {
+            if (members.size() > 1) {
+                refined.push_back(std::move(members));
+            }
+        }
+    }
+    return refined;
+}
+
+std::vector<Candidate*> flatten(const std::vector<Bucket>& buckets)
+{
+    std::vector<Candidate*> items;
+    for (const auto& bucket : buckets) {
+        items.insert(items.end(), bucket.begin(), bucket.end());
+    }
+    return items;
+}
+
+} // namespace
+
+DuplicateFinder::DuplicateFinder(DatabaseManager* hash_cache, unsigned worker_count)
+    : hash_cache_(hash_cache),
+      worker_count_(resolve_worker_count(worker_count))
+{}
+
+std::vector<DuplicateFinder::Group> DuplicateFinder::find_groups(const std::vector<std::filesystem::path>& files) const
+{
+    std::vector<Candidate> candidates;
+    candidates.reserve(files.size());
+    std::unordered_set<std::string> seen;
+    for (const auto& file : files) {
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(file, ec) || ec) {
+            continue;
+        }
+        const std::uintmax_t size = std::filesystem::file_size(file, ec);
+        if (ec || size == 0) {
+            continue;
+        }
+        const auto mtime = std::filesystem::last_write_time(file, ec);
+        if (ec) {
+            continue;
+        }
+        std::string key = Utils::path_to_utf8(file);
+        if (!seen.insert(key).second) {
+            continue;
+        }
+        Candidate candidate;
+        candidate.path = file;
+        candidate.key = std::move(key);
+        candidate.order = candidates.size();
+        candidate.size = size;
+        candidate.mtime = static_cast<std::int64_t>(mtime.time_since_epoch().count());
+        candidates.push_back(std::move(candidate));
+    }
+
+    // Pass 1: only files that share their size with another file can be duplicates.
+    std::map<std::uintmax_t, Bucket> by_size;
+    for (auto& candidate : candidates) {
+        by_size[candidate.size].push_back(&candidate);
+    }
+    std::vector<Bucket> buckets;
+    for (auto& [size, members] : by_size) {
+        if (members.size() > 1) {
+            buckets.push_back(std::move(members));
+        }
+    }
+    if (buckets.empty()) {
+        return {};
+    }
+
+    std::vector<Candidate*> pending = flatten(buckets);
+    if (hash_cache_) {
+        std::vector<std::string> keys;
+        keys.reserve(pending.size());
+        for (const Candidate* candidate : pending) {
+            keys.push_back(candidate->key);
+        }
+        const auto cached = hash_cache_->get_file_hashes(keys);
+        for (Candidate* candidate : pending) {
+            const auto it = cached.find(candidate->key);
+            if (it != cached.end() &&
+                it->second.size == static_cast<std::int64_t>(candidate->size) &&
+                it->second.mtime == candidate->mtime) {
+                candidate->partial = it->second.partial;
+                candidate->full = it->second.full;
+            }
+        }
+    }
+
+    // Pass 2: a partial fingerprint reads at most two small samples per file.
+    std::vector<Candidate*> to_sample;
+    for (Candidate* candidate : pending) {
+        if (candidate->partial == 0) {
+            to_sample.push_back(candidate);
+        }
+    }
+    run_parallel(to_sample, worker_count_, [](Candidate& candidate) {
+        candidate.partial = FileFingerprint::partial(candidate.path).value_or(0);
+        candidate.full = 0;
+        candidate.changed = true;
+    });
+    buckets = refine(buckets, [](const Candidate& candidate) { return candidate.partial; });
+
+    // Pass 3: full hashes, only for files the samples could not tell apart.
+    std::vector<Candidate*> to_hash;
+    for (Candidate* candidate : flatten(buckets)) {
+        if (candidate->size <= FileFingerprint::kFullyCoveredBytes) {
+            // The samples already covered the whole file.
+            candidate->full = candidate->partial;
+        } else if (candidate->full == 0) {
+            to_hash.push_back(candidate);
+        }
+    }
+    run_parallel(to_hash, worker_count_, [](Candidate& candidate) {
+        candidate.full = FileFingerprint::full(candidate.path).value_or(0);
+        candidate.changed = true;
+    });
+    buckets = refine(buckets, [](const Candidate& candidate) { return candidate.full; });
+
+    if (hash_cache_) {
+        std::vector<std::pair<std::string, DatabaseManager::FileHashes>> updates;
+        for (const Candidate* candidate : pending) {
+            if (candidate->changed && candidate->partial != 0) {
+                updates.emplace_back(candidate->key, DatabaseManager::FileHashes{
+                    static_cast<std::int64_t>(candidate->size),
+                    candidate->mtime,
+                    candidate->partial,
+                    candidate->size <= FileFingerprint::kFullyCoveredBytes ? 0 : candidate->full});
+            }
+        }
+        hash_cache_->store_file_hashes(updates);
+    }
+
+    for (auto& bucket : buckets) {
+        std::sort(bucket.begin(), bucket.end(), [](const Candidate* lhs, const Candidate* rhs) {
+            return lhs->order < rhs->order;
+        });
+    }
+    std::sort(buckets.begin(), buckets.end(), [](const Bucket& lhs, const Bucket& rhs) {
+        return lhs.front()->order < rhs.front()->order;
+    });
+
+    std::vector<Group> groups;
+    groups.reserve(buckets.size());
+    for (const auto& bucket : buckets) {
+        Group group;
+        group.reserve(bucket.size());
+        for (const Candidate* candidate : bucket) {
+            group.push_back(candidate->path);
+        }
+        groups.push_back(std::move(group));
+    }
+    return groups;
+}
+
+bool DuplicateFinder::same_contents(const std::filesystem::path& lhs, const std::filesystem::path& rhs)
+{
+    std::error_code ec;
+    const std::uintmax_t size = std::filesystem::file_size(lhs, ec);
+    if (ec || std::filesystem::file_size(rhs, ec) != size || ec) {
+        return false;
+    }
+    std::ifstream left(lhs, std::ios::binary);
+    std::ifstream right(rhs, std::ios::binary);
+    if (!left || !right) {
+        return false;
+    }
+
+    constexpr std::size_t kChunk = 64 * 1024;
+    std::vector<char> left_buffer(kChunk);
+    std::vector<char> right_buffer(kChunk);
+    std::uintmax_t remaining = size;
+    while (remaining > 0) {
+        const auto count = static_cast<std::streamsize>(std::min<std::uintmax_t>(kChunk, remaining));
+        if (!left.read(left_buffer.data(), count) || !right.read(right_buffer.data(), count) ||
+            std::memcmp(left_buffer.data(), right_buffer.data(), static_cast<std::size_t>(count)) != 0) {
+            return false;
+        }
+        remaining -= static_cast<std::uintmax_t>(count);
+    }
+    return true;
+}
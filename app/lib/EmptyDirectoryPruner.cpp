@@ -0,0 +1,68 @@
+#include "EmptyDirectoryPruner.hpp"
+
+#include <iterator>
+#include <system_error>
+
+namespace {
+
+std::size_t path_depth(const std::filesystem::path& path)
+{
+    return static_cast<std::size_t>(std::distance(path.begin(), path.end()));
+}
+
+std::filesystem::path normalize_directory(const std::filesystem::path& path)
+{
+    std::filesystem::path normalized = path.lexically_normal();
+    if (!normalized.has_filename() && normalized.has_relative_path()) {
+        normalized = normalized.parent_path();
+    }
+    return normalized;
+}
+
+} // namespace
+
+EmptyDirectoryPruner::EmptyDirectoryPruner(std::filesystem::path boundary)
+    : boundary_(boundary.empty() ? boundary : normalize_directory(boundary))
+{}
+
+void EmptyDirectoryPruner::add(const std::filesystem::path& directory)
+{
+    if (directory.empty() || !directory.has_relative_path()) {
+        return;
+    }
+    std::filesystem::path normalized = normalize_directory(directory);
+    pending_.emplace(path_depth(normalized), std::move(normalized));
+}
+
+std::size_t EmptyDirectoryPruner::prune()
+{
+    std::size_t removed = 0;
+    while (!pending_.empty()) {
+        const std::filesystem::path directory = pending_.begin()->second;
+        pending_.erase(pending_.begin());
+        if (!within_boundary(directory)) {
+            continue;
+        }
+
+        std::error_code ec;
+        if (!std::filesystem::is_directory(directory, ec) || ec ||
+            !std::filesystem::is_empty(directory, ec) || ec) {
+            continue;
+        }
+        if (!std::filesystem::remove(directory, ec) || ec) {
+            continue;
+        }
+        ++removed;
+        add(directory.parent_path());
+    }
+    return removed;
+}
+
+bool EmptyDirectoryPruner::within_boundary(const std::filesystem::path& directory) const
+{
+    if (boundary_.empty()) {
+        return true;
+    }
+    const std::filesystem::path relative = directory.lexically_relative(boundary_);
+    return !relative.empty() && relative != "." && *relative.begin() != "..";
+}
@@ -0,0 +1,193 @@
+#include "FileFingerprint.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <system_error>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr std::uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+constexpr std::uint64_t kFnvPrime = 1099511628211ull;
+
+std::uint64_t fnv1a_update(std::uint64_t hash, const unsigned char* data, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+bool hash_sample(std::ifstream& in, std::uintmax_t offset, std::size_t length, std::uint64_t& hash)
+{
+    std::array<unsigned char, FileFingerprint::kSampleBytes> buffer{};
+    in.seekg(static_cast<std::streamoff>(offset));
+    in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(length));
+    if (static_cast<std::size_t>(in.gcount()) != length) {
+        return false;
+    }
+    hash = fnv1a_update(hash, buffer.data(), length);
+    return true;
+}
+
+// Read-only mapping of a file, one window at a time, so hashing several large files in
+// parallel never needs more address space than a few windows.
+class MappedFile {
+public:
+    static constexpr std::uintmax_t kWindowBytes = 64ull * 1024 * 1024;
+
+    explicit MappedFile(const std::filesystem::path& path)
+    {
+#ifdef _WIN32
+        file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            return;
+        }
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file_, &size)) {
+            return;
+        }
+        size_ = static_cast<std::uintmax_t>(size.QuadPart);
+        if (size_ > 0) {
+            mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        }
+        open_ = size_ == 0 || mapping_ != nullptr;
+#else
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) {
+            return;
+        }
+        struct stat info {};
+        if (::fstat(fd_, &info) != 0) {
+            return;
+        }
+        size_ = static_cast<std::uintmax_t>(info.st_size);
+        open_ = true;
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifdef _WIN32
+        if (mapping_) {
+            CloseHandle(mapping_);
+        }
+        if (file_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_);
+        }
+#else
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool is_open() const { return open_; }
+    std::uintmax_t size() const { return size_; }
+
+    // Calls visit(data, length) for consecutive windows; stops and fails if a window can't be mapped.
+    template <typename Visitor>
+    bool for_each_window(Visitor&& visit) const
+    {
+        for (std::uintmax_t offset = 0; offset < size_; offset += kWindowBytes) {
+            const auto length = static_cast<std::size_t>((std::min)(kWindowBytes, size_ - offset));
+#ifdef _WIN32
+            void* view = MapViewOfFile(mapping_, FILE_MAP_READ,
+                                       static_cast<DWORD>(offset >> 32),
+                                       static_cast<DWORD>(offset & 0xFFFFFFFFu),
+                                       length);
+            if (!view) {
+                return false;
+            }
+            visit(static_cast<const unsigned char*>(view), length);
+            UnmapViewOfFile(view);
+#else
+            void* view = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd_, static_cast<off_t>(offset));
+            if (view == MAP_FAILED) {
+                return false;
+            }
+            ::madvise(view, length, MADV_SEQUENTIAL);
+            visit(static_cast<const unsigned char*>(view), length);
+            ::munmap(view, length);
+#endif
+        }
+        return true;
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE file_{INVALID_HANDLE_VALUE};
+    HANDLE mapping_{nullptr};
+#else
+    int fd_{-1};
+#endif
+    std::uintmax_t size_{0};
+    bool open_{false};
+};
+
+} // namespace
+
+std::optional<std::uint64_t> FileFingerprint::partial(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    const std::uintmax_t size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return std::nullopt;
+    }
+
+    std::uint64_t hash = kFnvOffsetBasis;
+    std::array<unsigned char, 8> size_bytes{};
+    for (std::size_t i = 0; i < size_bytes.size(); ++i) {
+        size_bytes[i] = static_cast<unsigned char>((static_cast<std::uint64_t>(size) >> (8 * i)) & 0xFFu);
+    }
+    hash = fnv1a_update(hash, size_bytes.data(), size_bytes.size());
+
+    const std::size_t head = static_cast<std::size_t>(std::min<std::uintmax_t>(size, kSampleBytes));
+    if (!hash_sample(in, 0, head, hash)) {
+        return std::nullopt;
+    }
+    if (size > kSampleBytes) {
+        const std::size_t tail = static_cast<std::size_t>(std::min<std::uintmax_t>(size - kSampleBytes, kSampleBytes));
+        if (!hash_sample(in, size - tail, tail, hash)) {
+            return std::nullopt;
+        }
+    }
+    // Zero is reserved for "no fingerprint recorded".
+    return hash == 0 ? 1 : hash;
+}
+
+std::optional<std::uint64_t> FileFingerprint::full(const std::filesystem::path& path)
+{
+    MappedFile file(path);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+
+    std::uint64_t hash = kFnvOffsetBasis;
+    const bool complete = file.for_each_window([&hash](const unsigned char* data, std::size_t length) {
+        hash = fnv1a_update(hash, data, length);
+    });
+    if (!complete) {
+        return std::nullopt;
+    }
+    return hash == 0 ? 1 : hash;
+}
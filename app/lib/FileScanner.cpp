@@ -1,5 +1,6 @@
 #include "FileScanner.hpp"
 #include "Logger.hpp"
+#include "Metrics.hpp"
 #include "Utils.hpp"
 #include <algorithm>
 #include <iostream>
@@ -24,6 +25,7 @@ std::vector<FileEntry>
 FileScanner::get_directory_entries(const std::string &directory_path,
                                    FileScanOptions options)
 {
+    Metrics::Timer timer(Metrics::Stage::Scan);
     std::vector<FileEntry> file_paths_and_names;
     auto logger = Logger::get_logger("core_logger");
 
@@ -0,0 +1,197 @@
+#include "HttpTransport.hpp"
+
+#include "Logger.hpp"
+#include "Utils.hpp"
+
+#include <utility>
+
+namespace {
+
+constexpr long kKeepAliveIdleSeconds = 60;
+constexpr long kKeepAliveIntervalSeconds = 30;
+
+size_t write_callback(void* contents, size_t size, size_t nmemb, void* user)
+{
+    const size_t total = size * nmemb;
+    auto* target = static_cast<HttpTransport::WriteTarget*>(user);
+    const std::string_view chunk(static_cast<const char*>(contents), total);
+    long status = 0;
+    curl_easy_getinfo(target->handle, CURLINFO_RESPONSE_CODE, &status);
+    if (target->request && target->request->on_data && status < 400) {
+        if (!target->request->on_data(chunk)) {
+            target->aborted = true;
+            return 0;
+        }
+        return total;
+    }
+    target->body->append(chunk);
+    return total;
+}
+
+struct HeaderList {
+    curl_slist* list{nullptr};
+
+    HeaderList() = default;
+    HeaderList(const HeaderList&) = delete;
+    HeaderList& operator=(const HeaderList&) = delete;
+    ~HeaderList()
+    {
+        if (list) {
+            curl_slist_free_all(list);
+        }
+    }
+};
+
+} // namespace
+
+HttpTransport& HttpTransport::shared()
+{
+    // Never destroyed: curl_global_cleanup runs at the end of main, before static destructors.
+    static HttpTransport* transport = new HttpTransport();
+    return *transport;
+}
+
+HttpTransport::HttpTransport()
+{
+    share_ = curl_share_init();
+    if (!share_) {
+        if (auto logger = Logger::get_logger("core_logger")) {
+            logger->warn("Failed to create cURL share handle; requests will not share DNS or TLS caches");
+        }
+        return;
+    }
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &HttpTransport::lock_share);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &HttpTransport::unlock_share);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    // The connection cache is deliberately not shared: libcurl does not support using shared
+    // connections from concurrent threads. Live connections are kept by the pooled handles instead.
+}
+
+HttpTransport::~HttpTransport()
+{
+    for (CURL* handle : idle_handles_) {
+        curl_easy_cleanup(handle);
+    }
+    if (share_) {
+        curl_share_cleanup(share_);
+    }
+}
+
+void HttpTransport::lock_share(CURL*, curl_lock_data data, curl_lock_access, void* user)
+{
+    auto* self = static_cast<HttpTransport*>(user);
+    self->share_locks_[static_cast<std::size_t>(data)].lock();
+}
+
+void HttpTransport::unlock_share(CURL*, curl_lock_data data, void* user)
+{
+    auto* self = static_cast<HttpTransport*>(user);
+    self->share_locks_[static_cast<std::size_t>(data)].unlock();
+}
+
+void HttpTransport::configure_handle(CURL* handle) const
+{
+    if (share_) {
+        curl_easy_setopt(handle, CURLOPT_SHARE, share_);
+    }
+    // Worker threads must not rely on SIGALRM for DNS timeouts.
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPIDLE, kKeepAliveIdleSeconds);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPINTVL, kKeepAliveIntervalSeconds);
+#ifdef _WIN32
+    try {
+        const auto cert_path = Utils::ensure_ca_bundle();
+        curl_easy_setopt(handle, CURLOPT_CAINFO, cert_path.string().c_str());
+    } catch (const std::exception& ex) {
+        if (auto logger = Logger::get_logger("core_logger")) {
+            logger->error("Failed to stage CA bundle: {}", ex.what());
+        }
+    }
+#endif
+}
+
+void HttpTransport::set_write_target(CURL* handle, WriteTarget& target)
+{
+    target.handle = handle;
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &target);
+}
+
+CURL* HttpTransport::acquire_handle()
+{
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if (!idle_handles_.empty()) {
+            CURL* handle = idle_handles_.back();
+            idle_handles_.pop_back();
+            return handle;
+        }
+    }
+    return curl_easy_init();
+}
+
+void HttpTransport::release_handle(CURL* handle)
+{
+    // Reset clears per-request options but keeps the handle's open connections.
+    curl_easy_reset(handle);
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    if (idle_handles_.size() < kMaxIdleHandles) {
+        idle_handles_.push_back(handle);
+        return;
+    }
+    curl_easy_cleanup(handle);
+}
+
+HttpTransport::Response HttpTransport::perform(const Request& request)
+{
+    Response response;
+    CURL* handle = acquire_handle();
+    if (!handle) {
+        response.error = "Failed to initialize cURL";
+        return response;
+    }
+
+    configure_handle(handle);
+    curl_easy_setopt(handle, CURLOPT_URL, request.url.c_str());
+    if (request.method == Method::Post) {
+        curl_easy_setopt(handle, CURLOPT_POST, 1L);
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDS, request.body.c_str());
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(request.body.size()));
+    } else {
+        curl_easy_setopt(handle, CURLOPT_HTTPGET, 1L);
+    }
+    if (request.timeout_seconds > 0) {
+        curl_easy_setopt(handle, CURLOPT_TIMEOUT, request.timeout_seconds);
+    }
+    if (request.follow_redirects) {
+        curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+    }
+
+    HeaderList headers;
+    for (const auto& header : request.headers) {
+        headers.list = curl_slist_append(headers.list, header.c_str());
+    }
+    if (headers.list) {
+        curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers.list);
+    }
+    WriteTarget target{&request, &response.body};
+    set_write_target(handle, target);
+
+    const CURLcode result = curl_easy_perform(handle);
+    if (target.aborted) {
+        response.error = kAbortedByReceiver;
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response.status);
+    } else if (result != CURLE_OK) {
+        response.error = curl_easy_strerror(result);
+    } else {
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response.status);
+    }
+
+    release_handle(handle);
+    return response;
+}
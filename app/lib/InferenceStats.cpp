@@ -0,0 +1,93 @@
+#include "InferenceStats.hpp"
+
+#include <algorithm>
+
+#include <fmt/format.h>
+
+namespace {
+
+double per_second(double count, double ms)
+{
+    return ms > 0.0 ? count * 1000.0 / ms : 0.0;
+}
+
+std::string describe_gpu_layers(int gpu_layers, int model_layers)
+{
+    if (gpu_layers == 0) {
+        return "CPU only";
+    }
+    if (gpu_layers < 0) {
+        return model_layers > 0 ? fmt::format("auto of {}", model_layers) : std::string("auto");
+    }
+    if (model_layers > 0) {
+        return fmt::format("{}/{}", std::min(gpu_layers, model_layers), model_layers);
+    }
+    return std::to_string(gpu_layers);
+}
+
+} // namespace
+
+double InferenceStats::Totals::prompt_tokens_per_second() const
+{
+    return per_second(static_cast<double>(prompt_tokens), prompt_eval_ms);
+}
+
+double InferenceStats::Totals::generated_tokens_per_second() const
+{
+    return per_second(static_cast<double>(generated_tokens), eval_ms);
+}
+
+InferenceStats& InferenceStats::instance()
+{
+    static InferenceStats stats;
+    return stats;
+}
+
+void InferenceStats::add(const InferenceSample& sample)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++totals_.requests;
+    totals_.prompt_tokens += static_cast<std::uint64_t>(std::max(sample.prompt_tokens, 0));
+    totals_.prompt_eval_ms += sample.prompt_eval_ms;
+    totals_.generated_tokens += static_cast<std::uint64_t>(std::max(sample.generated_tokens, 0));
+    totals_.eval_ms += sample.eval_ms;
+    if (sample.kv_cells_used >= totals_.kv_peak_used) {
+        totals_.kv_peak_used = sample.kv_cells_used;
+        totals_.kv_cells_total = sample.kv_cells_total;
+    }
+    totals_.gpu_layers = sample.gpu_layers;
+    totals_.model_layers = sample.model_layers;
+}
+
+InferenceStats::Totals InferenceStats::totals() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return totals_;
+}
+
+void InferenceStats::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    totals_ = Totals{};
+}
+
+std::string InferenceStats::describe(const Totals& totals)
+{
+    if (totals.requests == 0) {
+        return {};
+    }
+    const int kv_percent = totals.kv_cells_total > 0
+        ? static_cast<int>(100.0 * totals.kv_peak_used / totals.kv_cells_total + 0.5)
+        : 0;
+    return fmt::format("{} request(s): prompt {} tok at {:.1f} tok/s, generated {} tok at {:.1f} tok/s, "
+                       "KV cache peak {}/{} ({}%), GPU layers {}",
+                       totals.requests,
+                       totals.prompt_tokens,
+                       totals.prompt_tokens_per_second(),
+                       totals.generated_tokens,
+                       totals.generated_tokens_per_second(),
+                       totals.kv_peak_used,
+                       totals.kv_cells_total,
+                       kv_percent,
+                       describe_gpu_layers(totals.gpu_layers, totals.model_layers));
+}
@@ -0,0 +1,360 @@
+#include "JsonView.hpp"
+
+#include <locale>
+#include <sstream>
+
+namespace {
+
+constexpr std::size_t kInvalid = std::string_view::npos;
+constexpr int kMaxDepth = 256;
+
+std::size_t skip_whitespace(std::string_view text, std::size_t pos)
+{
+    while (pos < text.size() &&
+           (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+        ++pos;
+    }
+    return pos;
+}
+
+bool is_digit(char ch)
+{
+    return ch >= '0' && ch <= '9';
+}
+
+int hex_value(char ch)
+{
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+    if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+    return -1;
+}
+
+std::size_t skip_string(std::string_view text, std::size_t pos)
+{
+    if (pos >= text.size() || text[pos] != '"') {
+        return kInvalid;
+    }
+    ++pos;
+    while (pos < text.size()) {
+        const auto ch = static_cast<unsigned char>(text[pos]);
+        if (ch == '"') {
+            return pos + 1;
+        }
+        if (ch < 0x20) {
+            return kInvalid;
+        }
+        if (ch != '\\') {
+            ++pos;
+            continue;
+        }
+        if (pos + 1 >= text.size()) {
+            return kInvalid;
+        }
+        const char escape = text[pos + 1];
+        if (escape == 'u') {
+            if (pos + 6 > text.size()) {
+                return kInvalid;
+            }
+            for (std::size_t i = pos + 2; i < pos + 6; ++i) {
+                if (hex_value(text[i]) < 0) {
+                    return kInvalid;
+                }
+            }
+            pos += 6;
+        } else if (std::string_view("\"\\/bfnrt").find(escape) != std::string_view::npos) {
+            pos += 2;
+        } else {
+            return kInvalid;
+        }
+    }
+    return kInvalid;
+}
+
+std::size_t skip_digits(std::string_view text, std::size_t pos)
+{
+    const std::size_t start = pos;
+    while (pos < text.size() && is_digit(text[pos])) {
+        ++pos;
+    }
+    return pos == start ? kInvalid : pos;
+}
+
+std::size_t skip_number(std::string_view text, std::size_t pos)
+{
+    if (pos < text.size() && text[pos] == '-') {
+        ++pos;
+    }
+    if (pos < text.size() && text[pos] == '0') {
+        ++pos;
+    } else if ((pos = skip_digits(text, pos)) == kInvalid) {
+        return kInvalid;
+    }
+    if (pos < text.size() && text[pos] == '.') {
+        if ((pos = skip_digits(text, pos + 1)) == kInvalid) {
+            return kInvalid;
+        }
+    }
+    if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+        ++pos;
+        if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) {
+            ++pos;
+        }
+        if ((pos = skip_digits(text, pos)) == kInvalid) {
+            return kInvalid;
+        }
+    }
+    return pos;
+}
+
+std::size_t skip_literal(std::string_view text, std::size_t pos, std::string_view literal)
+{
+    return text.substr(pos, literal.size()) == literal ? pos + literal.size() : kInvalid;
+}
+
+std::size_t skip_value(std::string_view text, std::size_t pos, int depth);
+
+// Shared walk over object members and array elements. `visit` gets the raw name token (empty for
+// array elements) and the raw value, and returns false to stop early.
+template <typename Visit>
+std::size_t walk_container(std::string_view text, std::size_t pos, int depth, Visit&& visit)
+{
+    const bool is_object = text[pos] == '{';
+    const char close = is_object ? '}' : ']';
+    if (depth > kMaxDepth) {
+        return kInvalid;
+    }
+    pos = skip_whitespace(text, pos + 1);
+    if (pos < text.size() && text[pos] == close) {
+        return pos + 1;
+    }
+    while (pos < text.size()) {
+        std::size_t key_start = pos;
+        std::size_t key_end = pos;
+        if (is_object) {
+            if ((key_end = skip_string(text, pos)) == kInvalid) {
+                return kInvalid;
+            }
+            pos = skip_whitespace(text, key_end);
+            if (pos >= text.size() || text[pos] != ':') {
+                return kInvalid;
+            }
+            pos = skip_whitespace(text, pos + 1);
+        }
+        const std::size_t value_start = pos;
+        const std::size_t value_end = skip_value(text, pos, depth + 1);
+        if (value_end == kInvalid) {
+            return kInvalid;
+        }
+        if (!visit(text.substr(key_start, key_end - key_start), text.substr(value_start, value_end - value_start))) {
+            return value_end;
+        }
+        pos = skip_whitespace(text, value_end);
+        if (pos < text.size() && text[pos] == close) {
+            return pos + 1;
+        }
+        if (pos >= text.size() || text[pos] != ',') {
+            return kInvalid;
+        }
+        pos = skip_whitespace(text, pos + 1);
+    }
+    return kInvalid;
+}
+
+std::size_t skip_value(std::string_view text, std::size_t pos, int depth)
+{
+    if (pos >= text.size()) {
+        return kInvalid;
+    }
+    switch (text[pos]) {
+        case '"': return skip_string(text, pos);
+        case '{':
+        case '[': return walk_container(text, pos, depth, [](std::string_view, std::string_view) { return true; });
+        case 't': return skip_literal(text, pos, "true");
+        case 'f': return skip_literal(text, pos, "false");
+        case 'n': return skip_literal(text, pos, "null");
+        default: return skip_number(text, pos);
+    }
+}
+
+void append_utf8(std::string& out, unsigned code_point)
+{
+    if (code_point < 0x80) {
+        out += static_cast<char>(code_point);
+    } else if (code_point < 0x800) {
+        out += static_cast<char>(0xC0 | (code_point >> 6));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else if (code_point < 0x10000) {
+        out += static_cast<char>(0xE0 | (code_point >> 12));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code_point >> 18));
+        out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+}
+
+unsigned read_hex4(std::string_view text, std::size_t pos)
+{
+    unsigned value = 0;
+    for (std::size_t i = pos; i < pos + 4; ++i) {
+        value = (value << 4) | static_cast<unsigned>(hex_value(text[i]));
+    }
+    return value;
+}
+
+// Decodes a validated string token, quotes included.
+std::string decode_string(std::string_view token)
+{
+    const std::string_view body = token.substr(1, token.size() - 2);
+    std::string out;
+    out.reserve(body.size());
+    for (std::size_t i = 0; i < body.size(); ++i) {
+        if (body[i] != '\\') {
+            out += body[i];
+            continue;
+        }
+        const char escape = body[++i];
+        switch (escape) {
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                unsigned code_point = read_hex4(body, i + 1);
+                i += 4;
+                if (code_point >= 0xD800 && code_point < 0xDC00 && i + 6 < body.size() &&
+                    body.substr(i + 1, 2) == "\\u") {
+                    const unsigned low = read_hex4(body, i + 3);
+                    if (low >= 0xDC00 && low < 0xE000) {
+                        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                        i += 6;
+                    }
+                }
+                if (code_point >= 0xD800 && code_point < 0xE000) {
+                    code_point = 0xFFFD; // unpaired surrogate
+                }
+                append_utf8(out, code_point);
+                break;
+            }
+            default: out += escape; break; // '"', '\\' and '/'
+        }
+    }
+    return out;
+}
+
+bool key_equals(std::string_view token, std::string_view key)
+{
+    const std::string_view body = token.substr(1, token.size() - 2);
+    if (body.find('\\') == std::string_view::npos) {
+        return body == key;
+    }
+    return decode_string(token) == key;
+}
+
+} // namespace
+
+JsonView JsonView::parse(std::string_view document)
+{
+    const std::size_t start = skip_whitespace(document, 0);
+    const std::size_t end = skip_value(document, start, 0);
+    if (end == kInvalid || skip_whitespace(document, end) != document.size()) {
+        return JsonView();
+    }
+    return JsonView(document.substr(start, end - start));
+}
+
+JsonView::Kind JsonView::kind() const
+{
+    if (text_.empty()) {
+        return Kind::Missing;
+    }
+    switch (text_.front()) {
+        case '{': return Kind::Object;
+        case '[': return Kind::Array;
+        case '"': return Kind::String;
+        case 't':
+        case 'f': return Kind::Bool;
+        case 'n': return Kind::Null;
+        default: return Kind::Number;
+    }
+}
+
+JsonView JsonView::operator[](std::string_view key) const
+{
+    if (!is_object()) {
+        return JsonView();
+    }
+    JsonView found;
+    walk_container(text_, 0, 0, [&](std::string_view name, std::string_view value) {
+        if (key_equals(name, key)) {
+            found = JsonView(value);
+            return false;
+        }
+        return true;
+    });
+    return found;
+}
+
+JsonView JsonView::operator[](std::size_t index) const
+{
+    if (!is_array()) {
+        return JsonView();
+    }
+    JsonView found;
+    std::size_t position = 0;
+    walk_container(text_, 0, 0, [&](std::string_view, std::string_view value) {
+        if (position++ == index) {
+            found = JsonView(value);
+            return false;
+        }
+        return true;
+    });
+    return found;
+}
+
+void JsonView::for_each_element(const std::function<void(const JsonView&)>& visit) const
+{
+    if (!is_array()) {
+        return;
+    }
+    walk_container(text_, 0, 0, [&](std::string_view, std::string_view value) {
+        visit(JsonView(value));
+        return true;
+    });
+}
+
+std::optional<std::string> JsonView::as_string() const
+{
+    if (!is_string()) {
+        return std::nullopt;
+    }
+    return decode_string(text_);
+}
+
+std::optional<double> JsonView::as_number() const
+{
+    if (!is_number()) {
+        return std::nullopt;
+    }
+    // JSON numbers always use '.', whatever the process locale says.
+    std::istringstream stream{std::string(text_)};
+    stream.imbue(std::locale::classic());
+    double value = 0.0;
+    stream >> value;
+    if (stream.fail()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::optional<bool> JsonView::as_bool() const
+{
+    if (kind() != Kind::Bool) {
+        return std::nullopt;
+    }
+    return text_.front() == 't';
+}
@@ -1,165 +1,133 @@
 #include "LLMClient.hpp"
+#include "AsyncHttpEngine.hpp"
+#include "HttpTransport.hpp"
+#include "JsonView.hpp"
+#include "JsonWriter.hpp"
+#include "StreamingReply.hpp"
 #include "Types.hpp"
 #include "Utils.hpp"
 #include "Logger.hpp"
-#include <curl/curl.h>
 #include <filesystem>
-#ifdef _WIN32
-    #include <json/json.h>
-#elif __APPLE__
-    #include <json/json.h>
-#else
-    #include <jsoncpp/json/json.h>
-#endif
 
+#include <algorithm>
+#include <cctype>
+#include <cmath>
 #include <iostream>
-#include <sstream>
+#include <optional>
 #include <string>
 #include <utility>
-
-// Helper function to write the response from curl into a string
-static size_t WriteCallback(void *contents, size_t size, size_t nmemb, std::string *response)
-{
-    size_t totalSize = size * nmemb;
-    response->append(static_cast<const char*>(contents), totalSize);
-    return totalSize;
-}
+#include <vector>
 
 namespace {
-std::string escape_json(const std::string& input) {
-    std::string out;
-    out.reserve(input.size() * 2);
-    for (char c : input) {
-        switch (c) {
-            case '"': out += "\\\""; break;
-            case '\\': out += "\\\\"; break;
-            case '\n': out += "\\n"; break;
-            case '\r': out += "\\r"; break;
-            case '\t': out += "\\t"; break;
-            default:
-                out += c;
-        }
+// Locates the string value of "key" in a flat JSON object as written by the model, so the
+// tokens that spelled it can be picked out of the logprobs list.
+std::optional<std::pair<std::size_t, std::size_t>> find_string_value(const std::string& json, const std::string& key)
+{
+    const std::string quoted_key = "\"" + key + "\"";
+    std::size_t pos = json.find(quoted_key);
+    if (pos == std::string::npos) {
+        return std::nullopt;
+    }
+    pos += quoted_key.size();
+    while (pos < json.size() && (std::isspace(static_cast<unsigned char>(json[pos])) || json[pos] == ':')) {
+        ++pos;
+    }
+    if (pos >= json.size() || json[pos] != '"') {
+        return std::nullopt;
+    }
+    const std::size_t begin = ++pos;
+    while (pos < json.size() && json[pos] != '"') {
+        pos += json[pos] == '\\' ? 2 : 1;
+    }
+    if (pos >= json.size()) {
+        return std::nullopt;
     }
-    return out;
+    return std::make_pair(begin, pos);
 }
 
-struct CurlRequest {
-    CURL* handle{nullptr};
-    curl_slist* headers{nullptr};
-
-    CurlRequest() = default;
-    CurlRequest(const CurlRequest&) = delete;
-    CurlRequest& operator=(const CurlRequest&) = delete;
-
-    CurlRequest(CurlRequest&& other) noexcept
-        : handle(other.handle),
-          headers(other.headers)
-    {
-        other.handle = nullptr;
-        other.headers = nullptr;
+// Joint probability of the tokens that make up the category and subcategory values.
+std::optional<double> label_confidence_from_logprobs(const std::string& content, const JsonView& tokens)
+{
+    if (!tokens.is_array() || !tokens[0].valid()) {
+        return std::nullopt;
     }
-
-    CurlRequest& operator=(CurlRequest&& other) noexcept
-    {
-        if (this != &other) {
-            cleanup();
-            handle = other.handle;
-            headers = other.headers;
-            other.handle = nullptr;
-            other.headers = nullptr;
+    std::vector<std::pair<std::size_t, std::size_t>> spans;
+    for (const char* key : {"category", "subcategory"}) {
+        if (auto span = find_string_value(content, key)) {
+            spans.push_back(*span);
         }
-        return *this;
     }
-
-    ~CurlRequest() {
-        cleanup();
+    if (spans.empty()) {
+        return std::nullopt;
     }
 
-private:
-    void cleanup()
-    {
-        if (handle) {
-            curl_easy_cleanup(handle);
-            handle = nullptr;
+    std::size_t offset = 0;
+    double sum = 0.0;
+    bool aligned = true;
+    tokens.for_each_element([&](const JsonView& token) {
+        const std::string text = token["token"].string_or("");
+        const std::size_t begin = offset;
+        const std::size_t end = offset + text.size();
+        offset = end;
+        if (!aligned || begin >= content.size()) {
+            return; // tokens past a reply that was cut short at its closing brace
         }
-        if (headers) {
-            curl_slist_free_all(headers);
-            headers = nullptr;
+        const std::size_t overlap = std::min(text.size(), content.size() - begin);
+        if (content.compare(begin, overlap, text, 0, overlap) != 0) {
+            aligned = false; // tokens do not spell the content; nothing to attribute
+            return;
         }
-    }
-};
-
-CurlRequest create_curl_request(const std::shared_ptr<spdlog::logger>& logger)
-{
-    CurlRequest request;
-    request.handle = curl_easy_init();
-    if (!request.handle) {
-        if (logger) {
-            logger->critical("Failed to initialize cURL handle for remote request");
+        for (const auto& [span_begin, span_end] : spans) {
+            if (begin < span_end && end > span_begin) {
+                sum += token["logprob"].as_number().value_or(0.0);
+                break;
+            }
         }
-        throw std::runtime_error("Initialization Error: Failed to initialize cURL.");
+    });
+    if (!aligned) {
+        return std::nullopt;
     }
-
-#ifdef _WIN32
-    try {
-        const auto cert_path = Utils::ensure_ca_bundle();
-        curl_easy_setopt(request.handle, CURLOPT_CAINFO, cert_path.string().c_str());
-    } catch (const std::exception& ex) {
-        throw std::runtime_error(std::string("Failed to stage CA bundle: ") + ex.what());
-    }
-#endif
-    return request;
+    return std::exp(sum);
 }
 
-void configure_request_payload(CurlRequest& request,
-                               const std::string& api_url,
-                               const std::string& payload,
-                               const std::string& api_key,
-                               std::string& response_buffer)
+// Normalizes a structured categorization reply to {"category", "subcategory", "confidence"}.
+// The logprob estimate replaces the model's own figure when logprobs were requested.
+std::string make_structured_reply(const std::string& content, const JsonView& logprob_tokens)
 {
-    curl_easy_setopt(request.handle, CURLOPT_URL, api_url.c_str());
-    curl_easy_setopt(request.handle, CURLOPT_POST, 1L);
-    curl_easy_setopt(request.handle, CURLOPT_TIMEOUT, 5L);
-
-    request.headers = curl_slist_append(request.headers, "Content-Type: application/json");
-    const std::string auth = "Authorization: Bearer " + api_key;
-    request.headers = curl_slist_append(request.headers, auth.c_str());
-    curl_easy_setopt(request.handle, CURLOPT_HTTPHEADER, request.headers);
-
-    curl_easy_setopt(request.handle, CURLOPT_POSTFIELDS, payload.c_str());
-    curl_easy_setopt(request.handle, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(request.handle, CURLOPT_WRITEDATA, &response_buffer);
-}
+    const JsonView reply = JsonView::parse(content);
+    if (!reply.is_object()) {
+        return content;
+    }
 
-long perform_request(CurlRequest& request, const std::shared_ptr<spdlog::logger>& logger)
-{
-    const CURLcode res = curl_easy_perform(request.handle);
-    if (res != CURLE_OK) {
-        if (logger) {
-            logger->error("cURL request failed: {}", curl_easy_strerror(res));
-        }
-        throw std::runtime_error("Network Error: " + std::string(curl_easy_strerror(res)));
+    std::optional<double> confidence = label_confidence_from_logprobs(content, logprob_tokens);
+    if (!confidence) {
+        confidence = reply["confidence"].as_number();
     }
 
-    long http_code = 0;
-    curl_easy_getinfo(request.handle, CURLINFO_RESPONSE_CODE, &http_code);
-    return http_code;
+    std::string normalized;
+    JsonWriter json(normalized);
+    json.begin_object()
+        .key("category").value(reply["category"].string_or(""))
+        .key("subcategory").value(reply["subcategory"].string_or(""));
+    if (confidence) {
+        json.key("confidence").value(std::clamp(*confidence, 0.0, 1.0));
+    }
+    json.end_object();
+    return normalized;
 }
 
 std::string parse_category_response(const std::string& payload,
                                     long http_code,
+                                    bool structured_reply,
                                     const std::shared_ptr<spdlog::logger>& logger)
 {
-    Json::CharReaderBuilder reader_builder;
-    Json::Value root;
-    std::istringstream response_stream(payload);
-    std::string errors;
-
-    if (!Json::parseFromStream(reader_builder, response_stream, &root, &errors)) {
+    // Read in place from the response buffer; only the fields used below are decoded.
+    const JsonView root = JsonView::parse(payload);
+    if (!root.valid()) {
         if (logger) {
-            logger->error("Failed to parse JSON response: {}", errors);
+            logger->error("Failed to parse JSON response ({} bytes)", payload.size());
         }
-        throw std::runtime_error("Response Error: Failed to parse JSON response. " + errors);
+        throw std::runtime_error("Response Error: Failed to parse JSON response.");
     }
 
     if (http_code == 401) {
@@ -172,12 +140,127 @@ std::string parse_category_response(const std::string& payload,
         throw std::runtime_error("Server Error: OpenAI server returned an error. Status code: " + std::to_string(http_code));
     }
     if (http_code >= 400) {
-        const std::string error_message = root["error"]["message"].asString();
+        const std::string error_message = root["error"]["message"].string_or("");
         throw std::runtime_error("Client Error: " + error_message);
     }
 
-    return root["choices"][0]["message"]["content"].asString();
+    const JsonView choice = root["choices"][0];
+    if (const auto refusal = choice["message"]["refusal"].as_string()) {
+        throw std::runtime_error("Response Error: The model refused the request. " + *refusal);
+    }
+    std::string content = choice["message"]["content"].string_or("");
+    if (!structured_reply) {
+        return content;
+    }
+    return make_structured_reply(content, choice["logprobs"]["content"]);
+}
+
+std::string read_api_response(const HttpTransport::Response& response,
+                              bool structured_reply,
+                              const std::shared_ptr<spdlog::logger>& logger)
+{
+    if (!response.ok()) {
+        if (logger) {
+            logger->error("cURL request failed: {}", response.error);
+        }
+        throw std::runtime_error("Network Error: " + response.error);
+    }
+    return parse_category_response(response.body, response.status, structured_reply, logger);
+}
+
+// A streamed (SSE) categorization reply, read until the category reply is complete.
+struct StreamedCompletion {
+    LineBuffer lines;
+    std::string content;
+    std::string refusal;
+    std::string logprob_tokens; // raw token objects, comma separated
+    std::string unframed;       // body of a server that answered without SSE framing
+    bool complete{false};
+
+    bool consume(std::string_view line)
+    {
+        if (line.empty() || line.front() == ':') {
+            return true;
+        }
+        if (line.rfind("data:", 0) != 0) {
+            unframed.append(line);
+            unframed += '\n';
+            return true;
+        }
+        std::string_view data = line.substr(5);
+        if (!data.empty() && data.front() == ' ') {
+            data.remove_prefix(1);
+        }
+        if (data == "[DONE]") {
+            return true;
+        }
+
+        const JsonView choice = JsonView::parse(data)["choices"][0];
+        if (const auto text = choice["delta"]["content"].as_string()) {
+            content += *text;
+        }
+        if (const auto text = choice["delta"]["refusal"].as_string()) {
+            refusal += *text;
+        }
+        choice["logprobs"]["content"].for_each_element([this](const JsonView& token) {
+            if (!logprob_tokens.empty()) {
+                logprob_tokens += ',';
+            }
+            logprob_tokens.append(token.raw());
+        });
+        complete = complete_category_reply_length(content) > 0;
+        return !complete;
+    }
+};
+
+void attach_stream(HttpTransport::Request& request, const std::shared_ptr<StreamedCompletion>& stream)
+{
+    request.on_data = [stream](std::string_view chunk) {
+        return stream->lines.feed(chunk, [&stream](std::string_view line) { return stream->consume(line); });
+    };
 }
+
+std::string read_streamed_response(StreamedCompletion& stream,
+                                   const HttpTransport::Response& response,
+                                   const std::shared_ptr<spdlog::logger>& logger)
+{
+    const bool stopped_early = stream.complete && response.error == HttpTransport::kAbortedByReceiver;
+    if (!response.ok() && !stopped_early) {
+        if (logger) {
+            logger->error("cURL request failed: {}", response.error);
+        }
+        throw std::runtime_error("Network Error: " + response.error);
+    }
+    if (response.status >= 400) {
+        return parse_category_response(response.body, response.status, true, logger);
+    }
+
+    stream.lines.finish([&stream](std::string_view line) { return stream.consume(line); });
+    if (stream.content.empty() && !stream.unframed.empty()) {
+        return parse_category_response(stream.unframed, response.status, true, logger);
+    }
+    if (!stream.refusal.empty()) {
+        throw std::runtime_error("Response Error: The model refused the request. " + stream.refusal);
+    }
+    if (stopped_early && logger) {
+        logger->debug("Closed the reply stream once the category was complete");
+    }
+    if (const std::size_t length = complete_category_reply_length(stream.content)) {
+        stream.content.resize(length);
+    }
+    const std::string tokens = "[" + stream.logprob_tokens + "]";
+    return make_structured_reply(stream.content, JsonView::parse(tokens));
+}
+
+constexpr const char* kApiUrl = "https://api.openai.com/v1/chat/completions";
+constexpr const char* kJsonAssistantPrompt =
+    "You are a precise assistant that returns well-formed JSON responses.";
+constexpr const char* kCategoryResponseFormat =
+    "{\"type\": \"json_schema\", \"json_schema\": {\"name\": \"file_category\", \"strict\": true, "
+    "\"schema\": {\"type\": \"object\", \"properties\": {"
+    "\"category\": {\"type\": \"string\"}, \"subcategory\": {\"type\": \"string\"}, "
+    "\"confidence\": {\"type\": \"number\"}}, "
+    "\"required\": [\"category\", \"subcategory\", \"confidence\"], \"additionalProperties\": false}}}";
 }
 
 
@@ -195,26 +278,81 @@ void LLMClient::set_prompt_logging_enabled(bool enabled)
 }
 
 
-std::string LLMClient::send_api_request(std::string json_payload) {
+void LLMClient::set_request_logprobs(bool enabled)
+{
+    request_logprobs = enabled;
+}
+
+
+HttpTransport::Request LLMClient::build_api_request(std::string json_payload) const
+{
     if (api_key.empty()) {
         throw std::runtime_error("Missing OpenAI API key.");
     }
 
-    std::string response_string;
-    const std::string api_url = "https://api.openai.com/v1/chat/completions";
-    auto logger = Logger::get_logger("core_logger");
+    if (auto logger = Logger::get_logger("core_logger")) {
+        logger->debug("Dispatching remote LLM request to {}", kApiUrl);
+    }
 
-    if (logger) {
-        logger->debug("Dispatching remote LLM request to {}", api_url);
+    HttpTransport::Request request;
+    request.method = HttpTransport::Method::Post;
+    request.url = kApiUrl;
+    request.headers = {"Content-Type: application/json", "Authorization: Bearer " + api_key};
+    request.body = std::move(json_payload);
+    request.timeout_seconds = 5;
+    return request;
+}
+
+
+std::string LLMClient::send_api_request(std::string json_payload, bool structured_reply) {
+    auto request = build_api_request(std::move(json_payload));
+    if (!structured_reply) {
+        return read_api_response(HttpTransport::shared().perform(request),
+                                 false,
+                                 Logger::get_logger("core_logger"));
+    }
+    auto stream = std::make_shared<StreamedCompletion>();
+    attach_stream(request, stream);
+    return read_streamed_response(*stream, HttpTransport::shared().perform(request), Logger::get_logger("core_logger"));
+}
+
+
+std::future<std::string> LLMClient::send_api_request_async(std::string json_payload,
+                                                          bool structured_reply,
+                                                          std::shared_ptr<LLMCancelToken> cancel)
+{
+    auto promise = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> future = promise->get_future();
+    HttpTransport::Request request;
+    try {
+        request = build_api_request(std::move(json_payload));
+    } catch (...) {
+        promise->set_exception(std::current_exception());
+        return future;
     }
 
-    CurlRequest request = create_curl_request(logger);
-    configure_request_payload(request, api_url, json_payload, api_key, response_string);
+    std::shared_ptr<StreamedCompletion> stream;
+    if (structured_reply) {
+        stream = std::make_shared<StreamedCompletion>();
+        attach_stream(request, stream);
+    }
 
-    const long http_code = perform_request(request, logger);
-    return parse_category_response(response_string, http_code, logger);
+    const auto id = AsyncHttpEngine::shared().submit(std::move(request), [promise, stream](HttpTransport::Response response) {
+        try {
+            const auto logger = Logger::get_logger("core_logger");
+            promise->set_value(stream ? read_streamed_response(*stream, response, logger)
+                                      : read_api_response(response, false, logger));
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    if (cancel) {
+        cancel->set_handler([id]() { AsyncHttpEngine::shared().cancel(id); });
+    }
+    return future;
 }
 
+
 std::string LLMClient::effective_model() const
 {
     return model.empty() ? "gpt-4o-mini" : model;
@@ -240,7 +378,7 @@ std::string LLMClient::categorize_file(const std::string& file_name,
         std::cout << "\n[DEV][PROMPT] Categorization request\n" << last_prompt << "\n";
     }
 
-    std::string category = send_api_request(json_payload);
+    std::string category = send_api_request(json_payload, true);
 
     if (prompt_logging_enabled) {
         std::cout << "[DEV][RESPONSE] Categorization reply\n" << category << "\n";
@@ -250,10 +388,10 @@ std::string LLMClient::categorize_file(const std::string& file_name,
 }
 
 
-std::string LLMClient::make_payload(const std::string& file_name,
-                                    const std::string& file_path,
-                                    const FileType file_type,
-                                    const std::string& consistency_context)
+std::string LLMClient::make_categorization_prompt(const std::string& file_name,
+                                                  const std::string& file_path,
+                                                  FileType file_type,
+                                                  const std::string& consistency_context)
 {
     std::string prompt;
     std::string sanitized_path = file_path;
@@ -278,51 +416,128 @@ std::string LLMClient::make_payload(const std::string& file_name,
     if (!consistency_context.empty()) {
         prompt += "\n\n" + consistency_context;
     }
+    return prompt;
+}
+
 
-    last_prompt = prompt;
-    const std::string escaped_prompt = escape_json(prompt);
+std::string LLMClient::make_categorization_body(const std::string& model,
+                                                const std::string& prompt,
+                                                bool request_logprobs,
+                                                bool stream)
+{
     const std::string system_prompt =
         "You are a file categorization assistant. If it's an installer, describe the type of software it installs. "
-        "Consider the filename, extension, and any directory context provided. Always reply with one line in the "
-        "format <Main category> : <Subcategory>. Main category must be broad (one or two words, plural). Subcategory "
-        "must be specific, relevant, and must not repeat the main category.";
-    const std::string escaped_system = escape_json(system_prompt);
-
-    std::ostringstream payload;
-    payload << "{\n"
-            << "    \"model\": \"" << escape_json(effective_model()) << "\",\n"
-            << "    \"messages\": [\n"
-            << "        {\"role\": \"system\", \"content\": \"" << escaped_system << "\"},\n"
-            << "        {\"role\": \"user\", \"content\": \"" << escaped_prompt << "\"}\n"
-            << "    ]\n"
-            << "}";
-
-    return payload.str();
+        "Consider the filename, extension, and any directory context provided. Reply with a JSON object. "
+        "\"category\" is the main category: broad, one or two words, plural. \"subcategory\" is specific, "
+        "relevant, and must not repeat the main category. \"confidence\" is a number from 0 to 1 saying how sure "
+        "you are that both labels fit.";
+
+    // Kept on one line so the same body can be written as a JSONL batch request.
+    std::string payload;
+    payload.reserve(system_prompt.size() + prompt.size() + 512);
+    JsonWriter json(payload);
+    json.begin_object()
+        .key("model").value(model)
+        .key("messages").begin_array()
+            .begin_object().key("role").value("system").key("content").value(system_prompt).end_object()
+            .begin_object().key("role").value("user").key("content").value(prompt).end_object()
+        .end_array()
+        .key("response_format").raw(kCategoryResponseFormat);
+    if (request_logprobs) {
+        json.key("logprobs").value(true);
+    }
+    if (stream) {
+        json.key("stream").value(true);
+    }
+    json.end_object();
+
+    return payload;
+}
+
+
+std::optional<LLMClient::CategoryReply> LLMClient::parse_category_reply(const std::string& reply)
+{
+    const JsonView root = JsonView::parse(reply);
+    if (!root.is_object()) {
+        return std::nullopt;
+    }
+
+    CategoryReply parsed;
+    parsed.category = root["category"].string_or("");
+    parsed.subcategory = root["subcategory"].string_or("");
+    if (const auto confidence = root["confidence"].as_number()) {
+        parsed.confidence = std::clamp(*confidence, 0.0, 1.0);
+    }
+    return parsed;
+}
+
+
+std::string LLMClient::category_reply_from_response(const std::string& response_body)
+{
+    return parse_category_response(response_body, 200, true, Logger::get_logger("core_logger"));
+}
+
+
+std::string LLMClient::make_payload(const std::string& file_name,
+                                    const std::string& file_path,
+                                    const FileType file_type,
+                                    const std::string& consistency_context)
+{
+    last_prompt = make_categorization_prompt(file_name, file_path, file_type, consistency_context);
+    return make_categorization_body(effective_model(), last_prompt, request_logprobs, true);
 }
 
 std::string LLMClient::make_generic_payload(const std::string& system_prompt,
                                             const std::string& user_prompt,
                                             int max_tokens) const
 {
-    std::ostringstream payload;
-    payload << "{\"model\": \"" << escape_json(effective_model()) << "\",";
-    payload << "\"messages\": [";
-    payload << "{\"role\": \"system\", \"content\": \""
-            << escape_json(system_prompt) << "\"},";
-    payload << "{\"role\": \"user\", \"content\": \""
-            << escape_json(user_prompt) << "\"}]";
+    std::string payload;
+    payload.reserve(system_prompt.size() + user_prompt.size() + 128);
+    JsonWriter json(payload);
+    json.begin_object()
+        .key("model").value(effective_model())
+        .key("messages").begin_array()
+            .begin_object().key("role").value("system").key("content").value(system_prompt).end_object()
+            .begin_object().key("role").value("user").key("content").value(user_prompt).end_object()
+        .end_array();
     if (max_tokens > 0) {
-        payload << ",\"max_tokens\": " << max_tokens;
+        json.key("max_tokens").value(max_tokens);
     }
-    payload << "}";
-    return payload.str();
+    json.end_object();
+    return payload;
 }
 
 std::string LLMClient::complete_prompt(const std::string& prompt,
                                        int max_tokens)
 {
-    static const std::string kSystem =
-        "You are a precise assistant that returns well-formed JSON responses.";
-    std::string json_payload = make_generic_payload(kSystem, prompt, max_tokens);
-    return send_api_request(json_payload);
+    std::string json_payload = make_generic_payload(kJsonAssistantPrompt, prompt, max_tokens);
+    return send_api_request(json_payload, false);
+}
+
+
+std::future<std::string> LLMClient::categorize_file_async(const std::string& file_name,
+                                                          const std::string& file_path,
+                                                          FileType file_type,
+                                                          const std::string& consistency_context,
+                                                          std::shared_ptr<LLMCancelToken> cancel)
+{
+    if (auto logger = Logger::get_logger("core_logger")) {
+        logger->debug("Queueing remote categorization for '{}' ({})", file_name, to_string(file_type));
+    }
+    std::string json_payload = make_payload(file_name, file_path, file_type, consistency_context);
+
+    if (prompt_logging_enabled && !last_prompt.empty()) {
+        std::cout << "\n[DEV][PROMPT] Categorization request\n" << last_prompt << "\n";
+    }
+
+    return send_api_request_async(std::move(json_payload), true, std::move(cancel));
+}
+
+
+std::future<std::string> LLMClient::complete_prompt_async(const std::string& prompt,
+                                                          int max_tokens,
+                                                          std::shared_ptr<LLMCancelToken> cancel)
+{
+    return send_api_request_async(make_generic_payload(kJsonAssistantPrompt, prompt, max_tokens), false,
+                                  std::move(cancel));
 }
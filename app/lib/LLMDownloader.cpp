@@ -1,8 +1,11 @@
 #include "LLMDownloader.hpp"
+#include "ModelStore.hpp"
+#include "SegmentedDownloader.hpp"
 #include "Utils.hpp"
 #include "Logger.hpp"
 #include "TestHooks.hpp"
 #include <algorithm>
+#include <cctype>
 #include <cstdlib>
 #include <curl/curl.h>
 #include <filesystem>
@@ -12,6 +15,16 @@
 
 namespace {
 
+// Parallel Range requests per model download when the server accepts them.
+constexpr std::size_t kDownloadSegments = 4;
+
+bool is_sha256_hex(const std::string& value)
+{
+    return value.size() == 64 && std::all_of(value.begin(), value.end(), [](unsigned char ch) {
+        return std::isdigit(ch) || (ch >= 'a' && ch <= 'f');
+    });
+}
+
 #ifdef AI_FILE_SORTER_TEST_BUILD
 TestHooks::LLMDownloadProbe& download_probe_slot() {
     static TestHooks::LLMDownloadProbe probe;
@@ -107,33 +120,38 @@ int LLMDownloader::progress_func(void* clientp, curl_off_t dltotal, curl_off_t d
         return 1;
     }
 
-    if (dltotal > 0 && self->on_status_text) {
-        std::string msg = "Downloaded " + Utils::format_size(self->resume_offset + dlnow) +
-            " / " + Utils::format_size(self->real_content_length);
-        self->on_status_text(msg);
+    if (dltotal > 0) {
+        self->report_progress(self->resume_offset + dlnow);
     }
+    return 0;
+}
 
-    curl_off_t total_size = self->real_content_length;
 
-    if (total_size == 0) {
-        return 0;
+void LLMDownloader::report_progress(long long downloaded)
+{
+    if (on_status_text) {
+        std::string msg = "Downloaded " + Utils::format_size(downloaded) +
+            " / " + Utils::format_size(real_content_length);
+        on_status_text(msg);
     }
 
-    double raw_progress = static_cast<double>(self->resume_offset + dlnow) / static_cast<double>(total_size);
+    if (real_content_length == 0) {
+        return;
+    }
+
+    double raw_progress = static_cast<double>(downloaded) / static_cast<double>(real_content_length);
     double clamped_progress = std::min(raw_progress, 1.0);
 
     auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - self->last_progress_update);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_progress_update);
 
     if (elapsed.count() > 100) {
-        self->last_progress_update = now;
+        last_progress_update = now;
 
-        if (self->progress_callback) {
-            self->progress_callback(clamped_progress);
+        if (progress_callback) {
+            progress_callback(clamped_progress);
         }
     }
-
-    return 0;
 }
 
 
@@ -199,6 +217,11 @@ void LLMDownloader::start_download(std::function<void(double)> progress_cb,
 
 void LLMDownloader::perform_download()
 {
+    if (use_segmented_download()) {
+        perform_segmented_download();
+        return;
+    }
+
     auto init_curl = []() -> CURL* {
         CURL* handle = curl_easy_init();
         if (!handle) {
@@ -296,6 +319,68 @@ void LLMDownloader::perform_download()
 }
 
 
+bool LLMDownloader::use_segmented_download() const
+{
+#ifdef AI_FILE_SORTER_TEST_BUILD
+    if (download_probe_slot()) {
+        return false;
+    }
+#endif
+    std::lock_guard<std::mutex> lock(mutex);
+    return real_content_length > 0 && server_supports_resume_locked();
+}
+
+
+std::string LLMDownloader::published_sha256() const
+{
+    // Hugging Face reports the SHA-256 of LFS files as the linked ETag of the redirect.
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = curl_headers.find("x-linked-etag");
+    if (it == curl_headers.end()) {
+        return {};
+    }
+    std::string value = it->second;
+    if (value.rfind("W/", 0) == 0) {
+        value.erase(0, 2);
+    }
+    value.erase(std::remove(value.begin(), value.end(), '"'), value.end());
+    std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+    return is_sha256_hex(value) ? value : std::string();
+}
+
+
+void LLMDownloader::perform_segmented_download()
+{
+    SegmentedDownloader::Options options;
+    options.segments = kDownloadSegments;
+    options.expected_sha256 = published_sha256();
+    if (options.expected_sha256.empty()) {
+        if (auto logger = Logger::get_logger("core_logger")) {
+            logger->warn("No published SHA-256 for '{}'; the download will not be verified.", url);
+        }
+    }
+
+    SegmentedDownloader downloader(url, download_destination, options);
+    downloader.set_curl_setup([this](void* curl) { setup_common_curl_options(static_cast<CURL*>(curl)); });
+
+    const bool finished = downloader.run(
+        real_content_length,
+        [this](long long downloaded, long long) { report_progress(downloaded); },
+        cancel_requested);
+    cancel_requested.store(false, std::memory_order_relaxed);
+
+    if (!finished) {
+        if (on_download_error) {
+            on_download_error("Download cancelled");
+        }
+        return;
+    }
+    verified_sha256 = options.expected_sha256;
+    mark_download_resumable();
+    notify_download_complete();
+}
+
+
 void LLMDownloader::mark_download_resumable()
 {
     std::lock_guard<std::mutex> lock(mutex);
@@ -305,12 +390,26 @@ void LLMDownloader::mark_download_resumable()
 
 void LLMDownloader::notify_download_complete()
 {
+    register_downloaded_model();
     if (on_download_complete) {
         on_download_complete();
     }
 }
 
 
+void LLMDownloader::register_downloaded_model()
+{
+    try {
+        const auto root = std::filesystem::path(download_destination).parent_path().string();
+        ModelStore(root).register_model(download_destination, url, verified_sha256);
+    } catch (const std::exception& ex) {
+        if (auto logger = Logger::get_logger("core_logger")) {
+            logger->warn("Could not record '{}' in the model store: {}", download_destination, ex.what());
+        }
+    }
+}
+
+
 void LLMDownloader::setup_common_curl_options(CURL* curl)
 {
 #ifdef _WIN32
@@ -435,6 +534,10 @@ bool LLMDownloader::is_download_resumable() const
 
 bool LLMDownloader::is_download_complete() const
 {
+    // A segmented download is allocated at full size before any data arrives.
+    if (SegmentedDownloader::has_partial_download(download_destination)) {
+        return false;
+    }
     try {
         auto file_size = std::filesystem::file_size(download_destination);
         return static_cast<std::int64_t>(file_size) >= real_content_length;
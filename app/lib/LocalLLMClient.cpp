@@ -1,5 +1,6 @@
 #include "LocalLLMClient.hpp"
 #include "Logger.hpp"
+#include "Metrics.hpp"
 #include "Utils.hpp"
 #include "TestHooks.hpp"
 #include "LocalLLMTestAccess.hpp"
@@ -487,6 +488,7 @@ bool tokenize_prompt(const llama_vocab* vocab,
                      int& n_prompt,
                      const std::shared_ptr<spdlog::logger>& logger)
 {
+    Metrics::Timer timer(Metrics::Stage::Tokenize);
     n_prompt = -llama_tokenize(vocab,
                                final_prompt.c_str(),
                                final_prompt.size(),
@@ -524,15 +526,20 @@ std::string run_generation_loop(llama_context* ctx,
                                 int n_prompt,
                                 int max_tokens,
                                 const std::shared_ptr<spdlog::logger>& logger,
-                                const llama_vocab* vocab)
+                                const llama_vocab* vocab,
+                                int& n_past)
 {
     llama_batch batch = llama_batch_get_one(prompt_tokens.data(),
                                             prompt_tokens.size());
     llama_token new_token_id;
     std::string output;
     int generated_tokens = 0;
+    int n_pos = 0;
 
-    for (int n_pos = 0; generated_tokens < max_tokens; ) {
+    while (generated_tokens < max_tokens) {
+        // The first batch is the whole prompt; every later one is a single generated token.
+        const auto stage = n_pos == 0 ? Metrics::Stage::PromptEval : Metrics::Stage::Decode;
+        const auto step_start = Metrics::Clock::now();
         if (llama_decode(ctx, batch)) {
             if (logger) {
                 logger->warn("llama_decode returned non-zero status; aborting generation");
@@ -542,6 +549,7 @@ std::string run_generation_loop(llama_context* ctx,
 
         n_pos += batch.n_tokens;
         new_token_id = llama_sampler_sample(smpl, ctx, -1);
+        Metrics::instance().record(stage, step_start, Metrics::Clock::now());
 
         if (llama_vocab_is_eog(vocab, new_token_id)) {
             break;
@@ -560,6 +568,7 @@ std::string run_generation_loop(llama_context* ctx,
 
         batch = llama_batch_get_one(&new_token_id, 1);
     }
+    n_past = n_pos;
 
     while (!output.empty() && std::isspace(static_cast<unsigned char>(output.front()))) {
         output.erase(output.begin());
@@ -1261,12 +1270,14 @@ LocalLLMClient::LocalLLMClient(const std::string& model_path)
 
     const int context_length = std::clamp(resolve_context_length(), 512, 8192);
     llama_model_params model_params = prepare_model_params(logger);
+    gpu_layers = model_params.n_gpu_layers;
 
     if (logger) {
         logger->info("Configured context length {} token(s) for local LLM", context_length);
     }
 
     load_model_or_throw(model_params, logger);
+    model_layers = llama_model_n_layer(model);
     configure_context(context_length, model_params);
 }
 
@@ -1447,6 +1458,8 @@ void LocalLLMClient::configure_context(int context_length, const llama_model_par
     ctx_params = llama_context_default_params();
     ctx_params.n_ctx = context_length;
     ctx_params.n_batch = context_length;
+    // Timings are collected per request for the progress dialog.
+    ctx_params.no_perf = false;
 #ifdef GGML_USE_METAL
     if (model_params.n_gpu_layers != 0) {
         ctx_params.offload_kqv = true;
@@ -1515,7 +1528,10 @@ std::string LocalLLMClient::generate_response(const std::string &prompt,
     llama_sampler_chain_add(smpl, llama_sampler_init_dist(LLAMA_DEFAULT_SEED));
 
     std::string final_prompt;
-    if (!format_prompt(model, prompt, final_prompt)) {
+    Metrics::Timer template_timer(Metrics::Stage::PromptBuild);
+    const bool formatted = format_prompt(model, prompt, final_prompt);
+    template_timer.stop();
+    if (!formatted) {
         if (logger) {
             logger->error("Failed to apply chat template to prompt");
         }
@@ -1532,20 +1548,41 @@ std::string LocalLLMClient::generate_response(const std::string &prompt,
         return "";
     }
 
+    int n_past = 0;
     std::string output = run_generation_loop(ctx,
                                              smpl,
                                              prompt_tokens,
                                              n_prompt,
                                              n_predict,
                                              logger,
-                                             vocab);
+                                             vocab,
+                                             n_past);
+
+    const llama_perf_context_data perf = llama_perf_context(ctx);
+    last_sample.prompt_tokens = perf.n_p_eval;
+    last_sample.prompt_eval_ms = perf.t_p_eval_ms;
+    last_sample.generated_tokens = perf.n_eval;
+    last_sample.eval_ms = perf.t_eval_ms;
+    last_sample.kv_cells_used = n_past;
+    last_sample.kv_cells_total = static_cast<int>(llama_n_ctx(ctx));
+    last_sample.gpu_layers = gpu_layers;
+    last_sample.model_layers = model_layers;
+    InferenceStats::instance().add(last_sample);
 
     llama_sampler_reset(smpl);
     llama_free(ctx);
     llama_sampler_free(smpl);
 
     if (logger) {
-        logger->debug("Generation complete, produced {} character(s)", output.size());
+        logger->debug("Generation complete, produced {} character(s); prompt {} tok in {:.1f} ms, "
+                      "generated {} tok in {:.1f} ms, KV {}/{}",
+                      output.size(),
+                      last_sample.prompt_tokens,
+                      last_sample.prompt_eval_ms,
+                      last_sample.generated_tokens,
+                      last_sample.eval_ms,
+                      last_sample.kv_cells_used,
+                      last_sample.kv_cells_total);
     }
 
     if (apply_sanitizer) {
@@ -1568,7 +1605,9 @@ std::string LocalLLMClient::categorize_file(const std::string& file_name,
             logger->debug("Requesting local categorization for '{}' ({})", file_name, to_string(file_type));
         }
     }
+    Metrics::Timer prompt_timer(Metrics::Stage::PromptBuild);
     std::string prompt = make_prompt(file_name, file_path, file_type, consistency_context);
+    prompt_timer.stop();
     if (prompt_logging_enabled) {
         std::cout << "\n[DEV][PROMPT] Categorization request\n" << prompt << "\n";
     }
@@ -1589,6 +1628,7 @@ std::string LocalLLMClient::complete_prompt(const std::string& prompt,
 
 
 std::string LocalLLMClient::sanitize_output(std::string& output) {
+    Metrics::Timer timer(Metrics::Stage::Sanitize);
     output.erase(0, output.find_first_not_of(" \t\n\r\f\v"));
     output.erase(output.find_last_not_of(" \t\n\r\f\v") + 1);
 
@@ -1625,3 +1665,29 @@ void LocalLLMClient::set_prompt_logging_enabled(bool enabled)
 {
     prompt_logging_enabled = enabled;
 }
+
+InferenceSample LocalLLMClient::last_inference() const
+{
+    return last_sample;
+}
+
+
+std::optional<int32_t> LocalLLMClient::read_block_count(const std::string& model_path)
+{
+    return extract_block_count(model_path);
+}
+
+std::size_t LocalLLMClient::context_length() const
+{
+    return ctx_params.n_ctx;
+}
+
+std::size_t LocalLLMClient::count_tokens(const std::string& text) const
+{
+    if (!vocab || text.empty()) {
+        return ILLMClient::count_tokens(text);
+    }
+    // With no output buffer llama_tokenize returns the negated token count.
+    const int needed = -llama_tokenize(vocab, text.c_str(), static_cast<int32_t>(text.size()), nullptr, 0, false, true);
+    return needed > 0 ? static_cast<std::size_t>(needed) : ILLMClient::count_tokens(text);
+}
@@ -1,10 +1,97 @@
 #include "constants.hpp"
 #include "Logger.hpp"
 #include "Utils.hpp"
+#include <spdlog/async.h>
+#include <spdlog/async_logger.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
 #include <cstdlib>
+#include <sstream>
 #include <string>
 #include <filesystem>
 #include <chrono>
+#include <vector>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+
+namespace {
+
+std::string env_value(const char* name)
+{
+    const char* value = std::getenv(name);
+    return value ? std::string(value) : std::string();
+}
+
+bool env_flag(const char* name, bool fallback)
+{
+    const std::string value = env_value(name);
+    if (value.empty()) {
+        return fallback;
+    }
+    return value != "0" && value != "false" && value != "off" && value != "no";
+}
+
+bool stdout_is_terminal()
+{
+#ifdef _WIN32
+    return false;
+#else
+    return isatty(STDOUT_FILENO) != 0;
+#endif
+}
+
+} // namespace
+
+
+LogOptions LogOptions::from_environment(bool console_requested, bool development_mode)
+{
+    LogOptions options;
+    if (development_mode) {
+        options.level = spdlog::level::debug;
+    }
+    if (std::string level = env_value("AI_FILE_SORTER_LOG_LEVEL"); !level.empty()) {
+        std::transform(level.begin(), level.end(), level.begin(), [](unsigned char ch) {
+            return static_cast<char>(std::tolower(ch));
+        });
+        // from_str turns any name it does not know into "off", which would silence every log.
+        const auto parsed = spdlog::level::from_str(level);
+        if (parsed != spdlog::level::off || level == "off") {
+            options.level = parsed;
+        } else {
+            // The loggers are not set up yet.
+            std::fprintf(stderr, "Unknown AI_FILE_SORTER_LOG_LEVEL '%s'; using '%s'\n", level.c_str(),
+                         spdlog::level::to_string_view(options.level).data());
+        }
+    }
+
+    options.console = env_flag("AI_FILE_SORTER_LOG_CONSOLE", console_requested || stdout_is_terminal());
+    options.async = env_flag("AI_FILE_SORTER_LOG_ASYNC", true);
+
+    if (const std::string files = env_value("AI_FILE_SORTER_LOG_FILES"); !files.empty()) {
+        options.file_sinks.clear();
+        std::stringstream stream(files);
+        std::string name;
+        while (std::getline(stream, name, ',')) {
+            if (name == "core" || name == "db" || name == "ui") {
+                options.file_sinks.insert(name);
+            }
+        }
+    }
+
+    if (const std::string queue = env_value("AI_FILE_SORTER_LOG_QUEUE"); !queue.empty()) {
+        const long long size = std::atoll(queue.c_str());
+        if (size > 0) {
+            options.queue_size = static_cast<std::size_t>(size);
+        }
+    }
+    if (env_value("AI_FILE_SORTER_LOG_OVERFLOW") == "block") {
+        options.overflow = Overflow::Block;
+    }
+    return options;
+}
 
 
 std::string Logger::get_log_directory()
@@ -43,41 +130,62 @@ std::string Logger::get_windows_log_directory() {
 
 void Logger::setup_loggers()
 {
-    std::string log_dir = get_log_directory();
-    Utils::ensure_directory_exists(log_dir);
+    setup_loggers(LogOptions::from_environment(false, false));
+}
 
-    auto core_log_path = log_dir + "/core.log";
-    auto db_log_path = log_dir + "/db.log";
-    auto ui_log_path = log_dir + "/ui.log";
-    
-    auto core_console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-    auto core_file_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(core_log_path, 1048576 * 5, 3);
 
-    auto db_console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-    auto db_file_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(db_log_path, 1048576 * 5, 3);
+void Logger::setup_loggers(const LogOptions& options)
+{
+    std::string log_dir = get_log_directory();
+    Utils::ensure_directory_exists(log_dir);
 
-    auto ui_console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-    auto ui_file_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(ui_log_path, 1048576 * 5, 3);
+    if (options.async) {
+        spdlog::init_thread_pool(std::max<std::size_t>(options.queue_size, 64), 1);
+    }
 
-    auto core_logger = std::make_shared<spdlog::logger>("core_logger", spdlog::sinks_init_list{core_console_sink, core_file_sink});
-    auto db_logger = std::make_shared<spdlog::logger>("db_logger", spdlog::sinks_init_list{db_console_sink, db_file_sink});
-    auto ui_logger = std::make_shared<spdlog::logger>("ui_logger", spdlog::sinks_init_list{ui_console_sink, ui_file_sink});
+    // One console sink shared by all loggers keeps their lines from interleaving mid-write.
+    std::shared_ptr<spdlog::sinks::sink> console_sink;
+    if (options.console) {
+        console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    }
 
-    spdlog::register_logger(core_logger);
-    spdlog::register_logger(db_logger);
-    spdlog::register_logger(ui_logger);
+    for (const char* name : {"core", "db", "ui"}) {
+        std::vector<spdlog::sink_ptr> sinks;
+        if (console_sink) {
+            sinks.push_back(console_sink);
+        }
+        if (options.file_sinks.count(name) > 0) {
+            sinks.push_back(std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
+                log_dir + "/" + name + ".log", 1048576 * 5, 3));
+        }
+
+        const std::string logger_name = std::string(name) + "_logger";
+        std::shared_ptr<spdlog::logger> logger;
+        if (options.async) {
+            const auto policy = options.overflow == LogOptions::Overflow::Block
+                ? spdlog::async_overflow_policy::block
+                : spdlog::async_overflow_policy::overrun_oldest;
+            logger = std::make_shared<spdlog::async_logger>(
+                logger_name, sinks.begin(), sinks.end(), spdlog::thread_pool(), policy);
+        } else {
+            logger = std::make_shared<spdlog::logger>(logger_name, sinks.begin(), sinks.end());
+        }
+
+        // Without sinks the level is off, so call sites skip formatting altogether.
+        logger->set_level(sinks.empty() ? spdlog::level::off : options.level);
+        logger->flush_on(options.flush_level);
+        spdlog::register_logger(logger);
+    }
 
-    core_logger->set_level(spdlog::level::debug);
-    db_logger->set_level(spdlog::level::debug);
-    ui_logger->set_level(spdlog::level::debug);
+    spdlog::flush_every(options.flush_interval);
+    spdlog::set_level(options.level);
+    spdlog::info("Loggers initialized.");
+}
 
-    core_logger->flush_on(spdlog::level::info);
-    db_logger->flush_on(spdlog::level::info);
-    ui_logger->flush_on(spdlog::level::info);
 
-    spdlog::flush_every(std::chrono::seconds(2));
-    spdlog::set_level(spdlog::level::debug);
-    spdlog::info("Loggers initialized.");
+void Logger::shutdown()
+{
+    spdlog::shutdown();
 }
 
 
@@ -3,19 +3,28 @@
 #include "CategorizationSession.hpp"
 #include "DialogUtils.hpp"
 #include "ErrorMessages.hpp"
+#include "InferenceStats.hpp"
 #include "LLMClient.hpp"
 #include "LLMSelectionDialog.hpp"
 #include "Logger.hpp"
 #include "MainAppEditActions.hpp"
 #include "MainAppHelpActions.hpp"
+#include "Metrics.hpp"
+#include "ModelStore.hpp"
 #include "Updater.hpp"
 #include "TranslationManager.hpp"
 #include "Utils.hpp"
 #include "Types.hpp"
 #include "CategoryLanguage.hpp"
 #include "MainAppUiBuilder.hpp"
+#include "OllamaClient.hpp"
+#include "OpenAIBatchClient.hpp"
+#include "OpenAIProvider.hpp"
+#include "ProviderFactory.hpp"
+#include "ProviderRouter.hpp"
 #include "UiTranslator.hpp"
 #include "WhitelistManagerDialog.hpp"
+#include "UndoHistoryDialog.hpp"
 #include "UndoManager.hpp"
 #ifdef AI_FILE_SORTER_TEST_BUILD
 #include "MainAppTestAccess.hpp"
@@ -83,6 +92,24 @@ using namespace std::chrono_literals;
 
 namespace {
 
+// Consistency-pass chunks in flight at once on a remote API.
+constexpr std::size_t kRemoteConsistencyParallel = 4;
+
+// Local models share one machine, so their consistency chunks run one at a time.
+std::size_t consistency_pass_parallelism(const Settings& settings)
+{
+    switch (settings.get_llm_choice()) {
+        case LLMChoice::Remote:
+            return kRemoteConsistencyParallel;
+        case LLMChoice::OllamaCloud:
+            return settings.get_ollama_max_parallel() > 0
+                ? static_cast<std::size_t>(settings.get_ollama_max_parallel())
+                : OllamaClient::kDefaultMaxParallel;
+        default:
+            return 1;
+    }
+}
+
 void schedule_next_support_prompt(Settings& settings, int total_files, int increment) {
     if (increment <= 0) {
         increment = 200;
@@ -176,18 +203,23 @@ MainApp::MainApp(Settings& settings, bool development_mode, QWidget* parent)
 }
 
 
-MainApp::~MainApp() = default;
+MainApp::~MainApp()
+{
+    wait_for_undo();
+}
 
 
 void MainApp::run()
 {
     show();
+    recover_interrupted_sorts();
 }
 
 
 void MainApp::shutdown()
 {
     stop_running_analysis();
+    wait_for_undo();
     save_settings();
 }
 
@@ -966,6 +998,11 @@ void MainApp::record_categorized_metrics(int count)
 
 void MainApp::undo_last_run()
 {
+    if (undo_in_progress_) {
+        show_error_dialog(tr("An undo is already in progress.").toStdString());
+        return;
+    }
+
     const auto latest = undo_manager_.latest_plan_path();
     if (!latest) {
         show_error_dialog("No undo plans available.");
@@ -982,7 +1019,54 @@ void MainApp::undo_last_run()
         return;
     }
 
-    const auto res = undo_manager_.undo_plan(*latest);
+    start_undo(*latest, UndoManager::UndoOptions{});
+}
+
+void MainApp::show_undo_history()
+{
+    if (undo_in_progress_) {
+        show_error_dialog(tr("An undo is already in progress.").toStdString());
+        return;
+    }
+
+    UndoHistoryDialog dialog(undo_manager_, this);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+    const auto plan_path = dialog.selected_plan();
+    if (!plan_path) {
+        return;
+    }
+
+    UndoManager::UndoOptions options;
+    options.categories = dialog.selected_categories();
+    options.verify_contents = dialog.verify_contents();
+    start_undo(*plan_path, options);
+}
+
+void MainApp::start_undo(const QString& plan_path, const UndoManager::UndoOptions& options)
+{
+    undo_in_progress_ = true;
+    set_undo_actions_enabled(false);
+    statusBar()->showMessage(tr("Undoing…"));
+
+    undo_thread_ = std::thread([this, plan_path, options]() {
+        const auto res = undo_manager_.undo_plan(plan_path, options);
+        run_on_ui([this, plan_path, whole_run = options.categories.empty(), res]() {
+            finish_undo(plan_path, whole_run, res);
+        });
+    });
+}
+
+void MainApp::finish_undo(const QString& plan_path, bool whole_run, const UndoManager::UndoResult& res)
+{
+    if (undo_thread_.joinable()) {
+        undo_thread_.join();
+    }
+    undo_in_progress_ = false;
+    set_undo_actions_enabled(true);
+    statusBar()->clearMessage();
+
     QString summary = tr("Restored %1 file(s). Skipped %2.").arg(res.restored).arg(res.skipped);
     if (!res.details.isEmpty()) {
         summary.append("\n");
@@ -993,8 +1077,26 @@ void MainApp::undo_last_run()
     if (ui_logger) {
         ui_logger->info(summary.toStdString());
     }
-    if (res.restored > 0) {
-        QFile::remove(*latest);
+    if (whole_run && res.restored > 0) {
+        undo_manager_.forget_plan(plan_path);
+        QFile::remove(plan_path);
+    }
+}
+
+void MainApp::set_undo_actions_enabled(bool enabled)
+{
+    if (undo_last_run_action) {
+        undo_last_run_action->setEnabled(enabled);
+    }
+    if (undo_history_action) {
+        undo_history_action->setEnabled(enabled);
+    }
+}
+
+void MainApp::wait_for_undo()
+{
+    if (undo_thread_.joinable()) {
+        undo_thread_.join();
     }
 }
 
@@ -1010,6 +1112,43 @@ bool MainApp::perform_undo_from_plan(const QString& plan_path)
     return res.restored > 0;
 }
 
+void MainApp::recover_interrupted_sorts()
+{
+    for (const QString& journal_path : undo_manager_.interrupted_journal_paths()) {
+        QMessageBox box(this);
+        box.setIcon(QMessageBox::Warning);
+        box.setWindowTitle(tr("Interrupted sort"));
+        box.setText(tr("A previous sort was interrupted before all files were moved.\n\n"
+                       "You can finish the remaining moves or roll back the files that were already moved.\n\n"
+                       "Journal file: %1").arg(journal_path));
+        auto* finish_button = box.addButton(tr("Finish sorting"), QMessageBox::AcceptRole);
+        auto* rollback_button = box.addButton(tr("Roll back"), QMessageBox::DestructiveRole);
+        box.addButton(tr("Decide later"), QMessageBox::RejectRole);
+        box.setDefaultButton(finish_button);
+        box.exec();
+
+        if (box.clickedButton() == finish_button) {
+            const auto res = undo_manager_.resume_interrupted(journal_path, core_logger);
+            QString summary = tr("Moved %1 file(s). Failed %2.").arg(res.completed).arg(res.failed);
+            if (!res.details.isEmpty()) {
+                summary.append("\n");
+                summary.append(res.details.join("\n"));
+            }
+            QMessageBox::information(this, tr("Sort resumed"), summary);
+            if (ui_logger) {
+                ui_logger->info(summary.toStdString());
+            }
+        } else if (box.clickedButton() == rollback_button) {
+            const bool restored_any = perform_undo_from_plan(journal_path);
+            undo_manager_.mark_journal_complete(journal_path, core_logger);
+            if (restored_any) {
+                undo_manager_.forget_plan(journal_path);
+                QFile::remove(journal_path);
+            }
+        }
+    }
+}
+
 MainApp::SupportPromptResult MainApp::show_support_prompt_dialog(int total_files)
 {
     QMessageBox box(this);
@@ -1148,9 +1287,11 @@ void MainApp::populate_tree_view(const std::vector<CategorizedFile>& files)
 
 void MainApp::append_progress(const std::string& message)
 {
-    run_on_ui([this, message]() {
+    std::string inference = InferenceStats::describe(InferenceStats::instance().totals());
+    run_on_ui([this, message, inference = std::move(inference)]() {
         if (progress_dialog) {
             progress_dialog->append_text(message);
+            progress_dialog->set_inference_summary(inference);
         }
     });
 }
@@ -1219,12 +1360,28 @@ void MainApp::perform_analysis()
     const std::string directory_path = get_folder_path();
     core_logger->info("Starting analysis for directory '{}'", directory_path);
 
+    InferenceStats::instance().reset();
+    auto& metrics = Metrics::instance();
+    metrics.reset();
+    metrics.set_tracing_enabled(settings.get_metrics_export() && settings.get_metrics_trace());
+    metrics.set_report_directory(settings.get_metrics_export()
+        ? (std::filesystem::path(settings.get_config_dir()) / "metrics").string()
+        : std::string());
+
     append_progress(fmt::format("[SCAN] Exploring {}", directory_path));
     if (should_abort_analysis()) {
         return;
     }
 
+    const bool batch_mode = settings.get_llm_choice() == LLMChoice::Remote && settings.get_openai_batch_mode();
     try {
+        std::unique_ptr<OpenAIBatchClient> batch_client;
+        if (batch_mode) {
+            batch_client = std::make_unique<OpenAIBatchClient>(settings.get_remote_api_key());
+            categorization_service.collect_remote_batches(
+                *batch_client, [this](const std::string& message) { append_progress(message); });
+        }
+
         prune_empty_cached_entries_for(directory_path);
         already_categorized_files = categorization_service.load_cached_entries(directory_path);
 
@@ -1234,7 +1391,13 @@ void MainApp::perform_analysis()
 
         log_cached_highlights();
 
-        const auto cached_file_names = results_coordinator.extract_file_names(already_categorized_files);
+        auto cached_file_names = results_coordinator.extract_file_names(already_categorized_files);
+        if (batch_mode) {
+            // Items waiting in a submitted batch are not sent again.
+            for (auto& name : db_manager.get_pending_batch_file_names(directory_path)) {
+                cached_file_names.insert(std::move(name));
+            }
+        }
         files_to_categorize = results_coordinator.find_files_to_categorize(directory_path, file_scan_options, cached_file_names);
         core_logger->debug("Found {} item(s) pending categorization in '{}'.",
                            files_to_categorize.size(), directory_path);
@@ -1244,11 +1407,27 @@ void MainApp::perform_analysis()
             return;
         }
 
+        if (batch_mode && !files_to_categorize.empty()) {
+            append_progress("[BATCH] Submitting items to the OpenAI Batch API...");
+            categorization_service.submit_remote_batch(
+                *batch_client, files_to_categorize, [this](const std::string& message) { append_progress(message); });
+            append_progress("[BATCH] Results arrive within 24 hours; analyze this folder again to collect them.");
+            files_to_categorize.clear();
+        }
+
         append_progress("[PROCESS] Letting the AI do its magic...");
 
+        // The cascade starts on a local model, so it runs with local timeouts and does its own escalation.
+        auto router = std::make_shared<std::unique_ptr<ILLMClient>>(
+            settings.get_cascade_routing() ? make_provider_router() : nullptr);
+        const bool cascading = *router != nullptr;
+        if (cascading) {
+            append_progress("[PROCESS] Trying local models first and escalating uncertain files.");
+        }
+
         new_files_with_categories = categorization_service.categorize_entries(
             files_to_categorize,
-            using_local_llm,
+            using_local_llm || cascading,
             stop_analysis,
             [this](const std::string& message) { append_progress(message); },
             [this](const FileEntry& entry) {
@@ -1259,10 +1438,14 @@ void MainApp::perform_analysis()
             [this](const CategorizedFile& entry, const std::string& reason) {
                 notify_recategorization_reset(entry, reason);
             },
-            [this]() { return make_llm_client(); });
+            [this, router]() { return *router ? std::move(*router) : make_llm_client(); });
 
         core_logger->info("Categorization produced {} new record(s).",
                           new_files_with_categories.size());
+        if (const auto inference = InferenceStats::describe(InferenceStats::instance().totals()); !inference.empty()) {
+            core_logger->info("Local model: {}", inference);
+            append_progress("[LOCAL] " + inference);
+        }
 
         already_categorized_files.insert(
             already_categorized_files.end(),
@@ -1273,6 +1456,7 @@ void MainApp::perform_analysis()
         new_files_to_sort = results_coordinator.compute_files_to_sort(get_folder_path(), file_scan_options, actual_files, already_categorized_files);
         core_logger->debug("{} file(s) queued for sorting after analysis.",
                            new_files_to_sort.size());
+        metrics.flush();
 
         run_on_ui([this]() {
             handle_analysis_finished();
@@ -1300,6 +1484,8 @@ void MainApp::run_consistency_pass()
         });
     };
 
+    consistency_pass_service.set_max_parallel(consistency_pass_parallelism(settings));
+    consistency_pass_service.set_delta_mode(settings.get_consistency_pass_delta());
     consistency_pass_service.run(
         already_categorized_files,
         new_files_with_categories,
@@ -1395,6 +1581,17 @@ std::unique_ptr<ILLMClient> MainApp::make_llm_client()
         CategorizationSession session(api_key, model);
         auto client = std::make_unique<LLMClient>(session.create_llm_client());
         client->set_prompt_logging_enabled(should_log_prompts());
+        client->set_request_logprobs(settings.get_remote_logprobs());
+        return client;
+    }
+
+    if (settings.get_llm_choice() == LLMChoice::OllamaCloud) {
+        auto provider = ProviderFactory::create_provider_from_settings(settings);
+        if (!provider) {
+            throw std::runtime_error("Ollama is not configured. Please select a model from Select LLM.");
+        }
+        auto client = provider->create_client();
+        client->set_prompt_logging_enabled(should_log_prompts());
         return client;
     }
 
@@ -1419,11 +1616,79 @@ std::unique_ptr<ILLMClient> MainApp::make_llm_client()
     }
 
     auto client = std::make_unique<LocalLLMClient>(
-        Utils::make_default_path_to_file_from_download_url(env_url));
+        resolve_default_model(Utils::make_default_path_to_file_from_download_url(env_url)));
     client->set_prompt_logging_enabled(should_log_prompts());
     return client;
 }
 
+// Files are hashed when they are downloaded, so this only reads the index. A model the index
+// does not know, or the only variant of its family, is used as is.
+std::string MainApp::resolve_default_model(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(model_store_mutex_);
+    if (!model_store_) {
+        model_store_ = std::make_unique<ModelStore>(Utils::get_default_llm_destination());
+    } else {
+        model_store_->reload();
+    }
+    const std::string resolved = model_store_->resolve_for_budget(path, MemoryBudget::detect());
+    if (resolved != path && resolved != announced_model_substitution_) {
+        announced_model_substitution_ = resolved;
+        const QString file_name = QString::fromStdString(Utils::path_to_utf8(Utils::utf8_to_path(resolved).filename()));
+        run_on_ui([this, file_name]() {
+            statusBar()->showMessage(tr("Using %1, the downloaded variant that fits this machine's memory").arg(file_name),
+                                     8000);
+        });
+    }
+    return resolved;
+}
+
+std::unique_ptr<ILLMClient> MainApp::make_provider_router()
+{
+    auto router = std::make_unique<ProviderRouter>(settings.get_remote_min_confidence() / 100.0);
+    const LLMChoice choice = settings.get_llm_choice();
+
+    for (const LLMChoice tier : {LLMChoice::Local_3b, LLMChoice::Local_7b}) {
+        const char* env_url = std::getenv(tier == LLMChoice::Local_3b ? "LOCAL_LLM_3B_DOWNLOAD_URL"
+                                                                      : "LOCAL_LLM_7B_DOWNLOAD_URL");
+        if (!env_url) {
+            continue;
+        }
+        auto provider = ProviderFactory::create_local_provider(
+            resolve_default_model(Utils::make_default_path_to_file_from_download_url(env_url)));
+        if (provider->check_health() == ProviderHealth::Healthy) {
+            router->add_route(tier == LLMChoice::Local_3b ? "Local 3B" : "Local 7B", std::move(provider), false);
+        }
+    }
+
+    if (choice == LLMChoice::Remote) {
+        auto provider = std::make_unique<OpenAIProvider>(settings.get_remote_api_key(), settings.get_remote_model());
+        provider->set_request_logprobs(settings.get_remote_logprobs());
+        if (provider->check_health() != ProviderHealth::Unavailable) {
+            router->add_route(settings.get_remote_model(), std::move(provider), true);
+        }
+    } else if (choice == LLMChoice::Custom || choice == LLMChoice::OllamaCloud) {
+        // The Ollama server is checked in the background; only the custom model's file is checked up front.
+        const bool remote = choice == LLMChoice::OllamaCloud;
+        ProviderHealthMonitor::Probe probe;
+        if (remote) {
+            std::shared_ptr<IProvider> checked = ProviderFactory::create_provider_from_settings(settings);
+            probe = [checked]() { return checked ? checked->check_health() : ProviderHealth::Unavailable; };
+        }
+        if (auto provider = ProviderFactory::create_provider_from_settings(settings);
+            provider && (remote || provider->check_health() == ProviderHealth::Healthy)) {
+            router->add_route(remote ? settings.get_ollama_model() : provider->get_name(),
+                              std::move(provider), remote, std::move(probe));
+        }
+    }
+
+    if (router->route_count() < 2) {
+        return nullptr;
+    }
+    router->set_prompt_logging_enabled(should_log_prompts());
+    return router;
+}
+
 void MainApp::notify_recategorization_reset(const std::vector<CategorizedFile>& entries,
                                             const std::string& reason)
 {
@@ -1527,6 +1792,7 @@ void MainApp::changeEvent(QEvent* event)
 void MainApp::closeEvent(QCloseEvent* event)
 {
     stop_running_analysis();
+    wait_for_undo();
     save_settings();
     QMainWindow::closeEvent(event);
 }
@@ -192,6 +192,7 @@ UiTranslator::Dependencies MainAppUiBuilder::build_translator_dependencies(MainA
             app.copy_action,
             app.cut_action,
             app.undo_last_run_action,
+            app.undo_history_action,
             app.paste_action,
             app.delete_action,
             app.toggle_explorer_action,
@@ -269,6 +270,9 @@ void MainAppUiBuilder::build_edit_menu(MainApp& app) {
     app.undo_last_run_action = app.edit_menu->addAction(icon_for(app, "edit-undo", QStyle::SP_ArrowBack), QString());
     QObject::connect(app.undo_last_run_action, &QAction::triggered, &app, &MainApp::undo_last_run);
 
+    app.undo_history_action = app.edit_menu->addAction(icon_for(app, "document-open-recent", QStyle::SP_FileDialogBack), QString());
+    QObject::connect(app.undo_history_action, &QAction::triggered, &app, &MainApp::show_undo_history);
+
     app.copy_action = app.edit_menu->addAction(icon_for(app, "edit-copy", QStyle::SP_FileDialogContentsView), QString());
     QObject::connect(app.copy_action, &QAction::triggered, &app, [&app]() {
         MainAppEditActions::on_copy(app.path_entry);
@@ -0,0 +1,309 @@
+#include "Metrics.hpp"
+
+#include "JsonWriter.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#include <fmt/format.h>
+
+namespace {
+
+constexpr std::size_t kSubBuckets = 16;
+constexpr int kSubBucketBits = 4;
+
+std::uint32_t current_thread_number()
+{
+    static std::atomic<std::uint32_t> next{1};
+    thread_local const std::uint32_t number = next.fetch_add(1, std::memory_order_relaxed);
+    return number;
+}
+
+double to_seconds(std::uint64_t ns)
+{
+    return static_cast<double>(ns) / 1e9;
+}
+
+double to_milliseconds(std::uint64_t ns)
+{
+    return static_cast<double>(ns) / 1e6;
+}
+
+bool write_text_file(const std::filesystem::path& path, const std::string& text)
+{
+    const auto temp = path.string() + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out << text;
+        if (!out) {
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, path, ec);
+    return !ec;
+}
+
+} // namespace
+
+Metrics::Timer::Timer(Stage stage)
+    : stage_(stage),
+      start_(Clock::now())
+{
+}
+
+Metrics::Timer::~Timer()
+{
+    stop();
+}
+
+void Metrics::Timer::stop()
+{
+    if (running_) {
+        running_ = false;
+        Metrics::instance().record(stage_, start_, Clock::now());
+    }
+}
+
+Metrics& Metrics::instance()
+{
+    static Metrics metrics;
+    return metrics;
+}
+
+const char* Metrics::stage_name(Stage stage)
+{
+    switch (stage) {
+        case Stage::Scan: return "scan";
+        case Stage::CacheLookup: return "cache_lookup";
+        case Stage::PromptBuild: return "prompt_build";
+        case Stage::Tokenize: return "tokenize";
+        case Stage::PromptEval: return "prompt_eval";
+        case Stage::Decode: return "decode";
+        case Stage::Sanitize: return "sanitize";
+        case Stage::ResolveCategory: return "resolve_category";
+        case Stage::DbWrite: return "db_write";
+        case Stage::Move: return "move";
+        case Stage::Count: break;
+    }
+    return "unknown";
+}
+
+std::size_t Metrics::bucket_index(std::uint64_t value_ns)
+{
+    if (value_ns < kSubBuckets) {
+        return static_cast<std::size_t>(value_ns);
+    }
+    const int exponent = std::bit_width(value_ns) - 1;
+    const auto sub = static_cast<std::size_t>((value_ns >> (exponent - kSubBucketBits)) & (kSubBuckets - 1));
+    return static_cast<std::size_t>(exponent - kSubBucketBits + 1) * kSubBuckets + sub;
+}
+
+std::uint64_t Metrics::bucket_value(std::size_t index)
+{
+    if (index < kSubBuckets) {
+        return index;
+    }
+    const int shift = static_cast<int>(index / kSubBuckets) - 1;
+    const std::uint64_t lower = (kSubBuckets + index % kSubBuckets) << shift;
+    return lower + ((std::uint64_t{1} << shift) >> 1);
+}
+
+void Metrics::record(Stage stage, Clock::time_point start, Clock::time_point end)
+{
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    const auto value = static_cast<std::uint64_t>(std::max<std::int64_t>(elapsed, 0));
+    auto& data = stages_[static_cast<std::size_t>(stage)];
+
+    data.count.fetch_add(1, std::memory_order_relaxed);
+    data.total_ns.fetch_add(value, std::memory_order_relaxed);
+    data.buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    for (auto seen = data.min_ns.load(std::memory_order_relaxed);
+         value < seen && !data.min_ns.compare_exchange_weak(seen, value, std::memory_order_relaxed);) {
+    }
+    for (auto seen = data.max_ns.load(std::memory_order_relaxed);
+         value > seen && !data.max_ns.compare_exchange_weak(seen, value, std::memory_order_relaxed);) {
+    }
+
+    if (!tracing_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    const std::uint32_t thread = current_thread_number();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (trace_.size() < kMaxTraceEvents) {
+        const auto since_epoch = std::chrono::duration_cast<std::chrono::microseconds>(start - epoch_).count();
+        trace_.push_back({stage, thread, static_cast<std::uint64_t>(std::max<std::int64_t>(since_epoch, 0)),
+                          value / 1000});
+    } else {
+        ++dropped_trace_events_;
+    }
+}
+
+Metrics::Summary Metrics::summary(Stage stage) const
+{
+    const auto& data = stages_[static_cast<std::size_t>(stage)];
+    Summary result;
+    result.count = data.count.load(std::memory_order_relaxed);
+    if (result.count == 0) {
+        return result;
+    }
+    result.total_ns = data.total_ns.load(std::memory_order_relaxed);
+    result.min_ns = data.min_ns.load(std::memory_order_relaxed);
+    result.max_ns = data.max_ns.load(std::memory_order_relaxed);
+
+    std::array<std::uint64_t, kBucketCount> counts{};
+    std::uint64_t total = 0;
+    for (std::size_t index = 0; index < kBucketCount; ++index) {
+        counts[index] = data.buckets[index].load(std::memory_order_relaxed);
+        total += counts[index];
+    }
+    const auto quantile = [&](double q) {
+        const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(q * static_cast<double>(total) + 0.5));
+        std::uint64_t seen = 0;
+        for (std::size_t index = 0; index < kBucketCount; ++index) {
+            seen += counts[index];
+            if (seen >= rank) {
+                return std::clamp(bucket_value(index), result.min_ns, result.max_ns);
+            }
+        }
+        return result.max_ns;
+    };
+    result.p50_ns = quantile(0.50);
+    result.p90_ns = quantile(0.90);
+    result.p99_ns = quantile(0.99);
+    return result;
+}
+
+void Metrics::reset()
+{
+    for (auto& data : stages_) {
+        data.count.store(0, std::memory_order_relaxed);
+        data.total_ns.store(0, std::memory_order_relaxed);
+        data.min_ns.store(UINT64_MAX, std::memory_order_relaxed);
+        data.max_ns.store(0, std::memory_order_relaxed);
+        for (auto& bucket : data.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    trace_.clear();
+    dropped_trace_events_ = 0;
+    epoch_ = Clock::now();
+}
+
+void Metrics::set_tracing_enabled(bool enabled)
+{
+    tracing_.store(enabled, std::memory_order_relaxed);
+}
+
+bool Metrics::tracing_enabled() const
+{
+    return tracing_.load(std::memory_order_relaxed);
+}
+
+void Metrics::set_report_directory(std::string directory)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    report_directory_ = std::move(directory);
+}
+
+bool Metrics::flush() const
+{
+    std::string directory;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        directory = report_directory_;
+    }
+    if (directory.empty()) {
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    const std::filesystem::path root(directory);
+    bool written = write_text_file(root / "metrics.json", to_json()) &&
+                   write_text_file(root / "metrics.prom", to_prometheus());
+    if (written && tracing_enabled()) {
+        written = write_text_file(root / "trace.json", to_chrome_trace());
+    }
+    if (auto logger = Logger::get_logger("core_logger")) {
+        if (written) {
+            logger->info("Wrote stage metrics to '{}'", directory);
+        } else {
+            logger->warn("Could not write stage metrics to '{}'", directory);
+        }
+    }
+    return written;
+}
+
+std::string Metrics::to_json() const
+{
+    std::string text;
+    JsonWriter writer(text);
+    writer.begin_object().key("stages").begin_object();
+    for (std::size_t index = 0; index < kStageCount; ++index) {
+        const auto stage = static_cast<Stage>(index);
+        const Summary s = summary(stage);
+        writer.key(stage_name(stage)).begin_object()
+            .key("count").value(s.count)
+            .key("total_ms").value(to_milliseconds(s.total_ns))
+            .key("mean_ms").value(s.count ? to_milliseconds(s.total_ns / s.count) : 0.0)
+            .key("min_ms").value(to_milliseconds(s.min_ns))
+            .key("p50_ms").value(to_milliseconds(s.p50_ns))
+            .key("p90_ms").value(to_milliseconds(s.p90_ns))
+            .key("p99_ms").value(to_milliseconds(s.p99_ns))
+            .key("max_ms").value(to_milliseconds(s.max_ns))
+            .end_object();
+    }
+    writer.end_object().end_object();
+    return text;
+}
+
+std::string Metrics::to_prometheus() const
+{
+    std::string text =
+        "# HELP aifs_stage_duration_seconds Time spent in each categorization pipeline stage.\n"
+        "# TYPE aifs_stage_duration_seconds summary\n";
+    for (std::size_t index = 0; index < kStageCount; ++index) {
+        const auto stage = static_cast<Stage>(index);
+        const char* name = stage_name(stage);
+        const Summary s = summary(stage);
+        const std::array<std::pair<const char*, std::uint64_t>, 3> quantiles{
+            {{"0.5", s.p50_ns}, {"0.9", s.p90_ns}, {"0.99", s.p99_ns}}};
+        for (const auto& [quantile, value] : quantiles) {
+            text += fmt::format("aifs_stage_duration_seconds{{stage=\"{}\",quantile=\"{}\"}} {:.9f}\n",
+                                name, quantile, to_seconds(value));
+        }
+        text += fmt::format("aifs_stage_duration_seconds_sum{{stage=\"{}\"}} {:.9f}\n", name, to_seconds(s.total_ns));
+        text += fmt::format("aifs_stage_duration_seconds_count{{stage=\"{}\"}} {}\n", name, s.count);
+    }
+    return text;
+}
+
+std::string Metrics::to_chrome_trace() const
+{
+    std::string text;
+    JsonWriter writer(text);
+    writer.begin_object().key("displayTimeUnit").value("ms").key("traceEvents").begin_array();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& event : trace_) {
+        writer.begin_object()
+            .key("name").value(stage_name(event.stage))
+            .key("cat").value("pipeline")
+            .key("ph").value("X")
+            .key("ts").value(event.start_us)
+            .key("dur").value(event.duration_us)
+            .key("pid").value(1)
+            .key("tid").value(event.thread)
+            .end_object();
+    }
+    writer.end_array();
+    writer.key("otherData").begin_object().key("dropped_events").value(dropped_trace_events_).end_object();
+    writer.end_object();
+    return text;
+}
@@ -0,0 +1,435 @@
+#include "ModelStore.hpp"
+
+#include "JsonView.hpp"
+#include "JsonWriter.hpp"
+#include "LocalLLMClient.hpp"
+#include "Logger.hpp"
+#include "SegmentedDownloader.hpp"
+#include "Utils.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <sys/sysctl.h>
+#include <sys/types.h>
+#endif
+
+namespace {
+
+constexpr const char* kIndexFileName = "model-store.json";
+
+struct QuantizationInfo {
+    const char* name;
+    double bits_per_weight;
+};
+
+// Longer names first so "Q4_K_M" is found before "Q4_K".
+constexpr std::array<QuantizationInfo, 30> kQuantizations{{
+    {"IQ3_XXS", 3.06}, {"IQ2_XXS", 2.06}, {"IQ4_NL", 4.50}, {"IQ4_XS", 4.25}, {"IQ3_XS", 3.30},
+    {"IQ2_XS", 2.31}, {"Q4_K_M", 4.85}, {"Q4_K_S", 4.58}, {"Q5_K_M", 5.69}, {"Q5_K_S", 5.54},
+    {"Q3_K_L", 4.27}, {"Q3_K_M", 3.91}, {"Q3_K_S", 3.50}, {"Q2_K_S", 2.60}, {"IQ3_M", 3.66},
+    {"IQ3_S", 3.44}, {"IQ2_M", 2.70}, {"IQ2_S", 2.50}, {"IQ1_M", 1.75}, {"IQ1_S", 1.56},
+    {"Q8_0", 8.50}, {"Q6_K", 6.56}, {"Q5_1", 6.00}, {"Q5_0", 5.50}, {"Q4_1", 5.00},
+    {"Q4_0", 4.50}, {"Q2_K", 2.96}, {"BF16", 16.0}, {"F16", 16.0}, {"F32", 32.0},
+}};
+
+std::string to_upper(std::string value)
+{
+    std::transform(value.begin(), value.end(), value.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::toupper(ch));
+    });
+    return value;
+}
+
+bool is_separator(char ch)
+{
+    return ch == '-' || ch == '_' || ch == '.';
+}
+
+// Position of the quantization token in the upper-cased stem, bounded by separators.
+std::optional<std::pair<std::size_t, const QuantizationInfo*>> find_quantization(const std::string& stem)
+{
+    for (const auto& info : kQuantizations) {
+        const std::string_view name(info.name);
+        for (std::size_t pos = stem.find(name); pos != std::string::npos; pos = stem.find(name, pos + 1)) {
+            const bool starts = pos == 0 || is_separator(stem[pos - 1]);
+            const std::size_t end = pos + name.size();
+            const bool ends = end == stem.size() || is_separator(stem[end]);
+            if (starts && ends) {
+                return std::make_pair(pos, &info);
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+std::string file_stem(const std::string& file_name)
+{
+    return std::filesystem::path(file_name).stem().string();
+}
+
+std::string normalized_path(const std::string& path)
+{
+    std::error_code ec;
+    const auto absolute = std::filesystem::absolute(path, ec);
+    return (ec ? std::filesystem::path(path) : absolute).lexically_normal().string();
+}
+
+bool is_within(const std::string& path, const std::string& root)
+{
+    const auto relative = std::filesystem::path(path).lexically_relative(root);
+    return !relative.empty() && *relative.begin() != "..";
+}
+
+bool file_exists(const std::string& path)
+{
+    std::error_code ec;
+    return std::filesystem::is_regular_file(path, ec);
+}
+
+// Whole seconds, so the value survives the round trip through the JSON index.
+std::int64_t modification_time(const std::string& path)
+{
+    std::error_code ec;
+    const auto time = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return 0;
+    }
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+std::shared_ptr<spdlog::logger> store_logger()
+{
+    return Logger::get_logger("core_logger");
+}
+
+} // namespace
+
+MemoryBudget MemoryBudget::detect()
+{
+    MemoryBudget budget;
+#ifdef _WIN32
+    MEMORYSTATUSEX status{};
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status)) {
+        budget.ram_bytes = status.ullAvailPhys;
+    }
+#elif defined(__APPLE__)
+    // Unified memory: the GPU draws from the same pool, so all of it counts as RAM.
+    std::uint64_t total = 0;
+    std::size_t length = sizeof(total);
+    if (sysctlbyname("hw.memsize", &total, &length, nullptr, 0) == 0) {
+        budget.ram_bytes = total * 3 / 4;
+    }
+#else
+    std::ifstream meminfo("/proc/meminfo");
+    std::string key;
+    std::uint64_t kib = 0;
+    std::string unit;
+    while (meminfo >> key >> kib >> unit) {
+        if (key == "MemAvailable:") {
+            budget.ram_bytes = kib * 1024;
+            break;
+        }
+    }
+#endif
+    if (const auto cuda = Utils::query_cuda_memory(); cuda && cuda->valid()) {
+        budget.vram_bytes = cuda->free_bytes;
+    }
+    return budget;
+}
+
+ModelStore::ModelStore(std::string root_dir)
+    : root_dir_(normalized_path(root_dir))
+{
+    load();
+}
+
+std::string ModelStore::index_path() const
+{
+    return (std::filesystem::path(root_dir_) / kIndexFileName).string();
+}
+
+std::string ModelStore::quantization_from_name(const std::string& file_name)
+{
+    const auto found = find_quantization(to_upper(file_stem(file_name)));
+    return found ? found->second->name : std::string();
+}
+
+std::string ModelStore::family_from_name(const std::string& file_name)
+{
+    std::string stem = file_stem(file_name);
+    if (const auto found = find_quantization(to_upper(stem))) {
+        std::size_t begin = found->first;
+        std::size_t end = begin + std::string_view(found->second->name).size();
+        // Drop one separator with the token so "model-Q4_K_M" and "model.Q8_0" both become "model".
+        if (begin > 0) {
+            --begin;
+        } else if (end < stem.size()) {
+            ++end;
+        }
+        stem.erase(begin, end - begin);
+    }
+    std::transform(stem.begin(), stem.end(), stem.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::tolower(ch));
+    });
+    return stem;
+}
+
+double ModelStore::bits_per_weight(const std::string& quantization)
+{
+    const std::string upper = to_upper(quantization);
+    for (const auto& info : kQuantizations) {
+        if (upper == info.name) {
+            return info.bits_per_weight;
+        }
+    }
+    return 0.0;
+}
+
+std::uint64_t ModelStore::estimated_footprint(std::uint64_t file_size)
+{
+    // KV cache, compute buffers and runtime overhead on top of the mapped weights.
+    constexpr std::uint64_t kBaseOverhead = 512ULL * 1024 * 1024;
+    return file_size + file_size / 10 + kBaseOverhead;
+}
+
+std::optional<ModelStore::Record> ModelStore::choose_variant(const std::vector<Record>& variants,
+                                                             const MemoryBudget& budget)
+{
+    if (variants.empty()) {
+        return std::nullopt;
+    }
+    const auto better = [](const Record& a, const Record& b) {
+        const double a_bits = bits_per_weight(a.quantization);
+        const double b_bits = bits_per_weight(b.quantization);
+        return a_bits != b_bits ? a_bits > b_bits : a.size > b.size;
+    };
+    const auto best_within = [&](std::uint64_t limit) -> std::optional<Record> {
+        std::optional<Record> best;
+        for (const auto& variant : variants) {
+            if (limit > 0 && estimated_footprint(variant.size) <= limit && (!best || better(variant, *best))) {
+                best = variant;
+            }
+        }
+        return best;
+    };
+
+    // Fully offloaded layers are the fastest option, even at a lower quantization.
+    if (auto on_gpu = best_within(budget.vram_bytes)) {
+        return on_gpu;
+    }
+    if (auto in_memory = best_within(budget.ram_bytes + budget.vram_bytes)) {
+        return in_memory;
+    }
+    return *std::min_element(variants.begin(), variants.end(), [](const Record& a, const Record& b) {
+        return a.size < b.size;
+    });
+}
+
+std::optional<ModelStore::Record> ModelStore::register_model(const std::string& path,
+                                                             const std::string& source,
+                                                             const std::string& digest)
+{
+    const std::string normalized = normalized_path(path);
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(normalized, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    const auto mtime = modification_time(normalized);
+
+    const auto existing = std::find_if(records_.begin(), records_.end(), [&](const Record& record) {
+        return record.path == normalized;
+    });
+    if (existing != records_.end() && existing->size == size && existing->mtime == mtime &&
+        (digest.empty() || digest == existing->digest)) {
+        return *existing;
+    }
+
+    Record record;
+    record.digest = digest.empty() ? SegmentedDownloader::sha256_file(normalized) : digest;
+    record.path = normalized;
+    record.size = size;
+    record.mtime = mtime;
+    record.quantization = quantization_from_name(normalized);
+    record.family = family_from_name(normalized);
+    record.block_count = LocalLLMClient::read_block_count(normalized).value_or(0);
+    record.source = source.empty() && existing != records_.end() ? existing->source : source;
+    if (existing != records_.end()) {
+        records_.erase(existing);
+    }
+
+    for (const auto& other : records_) {
+        if (other.digest != record.digest || !file_exists(other.path)) {
+            continue;
+        }
+        if (auto logger = store_logger()) {
+            logger->info("Model '{}' has the same contents as '{}'", record.path, other.path);
+        }
+        // Only files the app downloaded itself are replaced; custom model files are left alone.
+        if (!is_within(record.path, root_dir_) || !is_within(other.path, root_dir_)) {
+            break;
+        }
+        const std::string link = record.path + ".link";
+        std::filesystem::create_hard_link(other.path, link, ec);
+        if (!ec) {
+            std::filesystem::rename(link, record.path, ec);
+        }
+        if (ec) {
+            std::filesystem::remove(link, ec);
+        } else {
+            record.mtime = modification_time(record.path);
+        }
+        break;
+    }
+
+    records_.push_back(record);
+    save();
+    return record;
+}
+
+void ModelStore::reload()
+{
+    records_.clear();
+    load();
+}
+
+std::vector<ModelStore::Record> ModelStore::records() const
+{
+    return records_;
+}
+
+std::optional<ModelStore::Record> ModelStore::find_by_path(const std::string& path) const
+{
+    const std::string normalized = normalized_path(path);
+    for (const auto& record : records_) {
+        if (record.path == normalized) {
+            return record;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<ModelStore::Record> ModelStore::find_by_digest(const std::string& digest) const
+{
+    std::vector<Record> matches;
+    std::copy_if(records_.begin(), records_.end(), std::back_inserter(matches),
+                 [&](const Record& record) { return record.digest == digest; });
+    return matches;
+}
+
+std::vector<ModelStore::Record> ModelStore::variants_of(const std::string& family) const
+{
+    std::vector<Record> matches;
+    std::copy_if(records_.begin(), records_.end(), std::back_inserter(matches),
+                 [&](const Record& record) { return !family.empty() && record.family == family; });
+    return matches;
+}
+
+std::string ModelStore::resolve_for_budget(const std::string& path, const MemoryBudget& budget) const
+{
+    const auto record = find_by_path(path);
+    if (!record) {
+        return path;
+    }
+    std::vector<Record> variants = variants_of(record->family);
+    variants.erase(std::remove_if(variants.begin(), variants.end(),
+                                  [](const Record& variant) { return !file_exists(variant.path); }),
+                   variants.end());
+    if (variants.size() < 2) {
+        return path;
+    }
+    const auto chosen = choose_variant(variants, budget);
+    if (!chosen || chosen->path == record->path) {
+        return path;
+    }
+    if (auto logger = store_logger()) {
+        logger->info("Using {} variant '{}' instead of '{}' for the available memory",
+                     chosen->quantization.empty() ? std::string("another") : chosen->quantization,
+                     chosen->path, record->path);
+    }
+    return chosen->path;
+}
+
+void ModelStore::load()
+{
+    std::ifstream in(index_path(), std::ios::binary);
+    if (!in) {
+        return;
+    }
+    const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const JsonView root = JsonView::parse(text);
+    if (!root.is_object()) {
+        if (auto logger = store_logger()) {
+            logger->warn("Ignoring unreadable model index '{}'", index_path());
+        }
+        return;
+    }
+    root["models"].for_each_element([this](const JsonView& entry) {
+        Record record;
+        record.digest = entry["digest"].string_or("");
+        record.path = entry["path"].string_or("");
+        record.size = static_cast<std::uint64_t>(entry["size"].as_number().value_or(0));
+        record.mtime = static_cast<std::int64_t>(entry["mtime"].as_number().value_or(0));
+        record.quantization = entry["quantization"].string_or("");
+        record.family = entry["family"].string_or("");
+        record.block_count = static_cast<int>(entry["block_count"].as_number().value_or(0));
+        record.source = entry["source"].string_or("");
+        if (!record.digest.empty() && !record.path.empty()) {
+            records_.push_back(std::move(record));
+        }
+    });
+}
+
+void ModelStore::save() const
+{
+    std::string text;
+    JsonWriter writer(text);
+    writer.begin_object().key("models").begin_array();
+    for (const auto& record : records_) {
+        writer.begin_object()
+            .key("digest").value(record.digest)
+            .key("path").value(record.path)
+            .key("size").value(record.size)
+            .key("mtime").value(record.mtime)
+            .key("quantization").value(record.quantization)
+            .key("family").value(record.family)
+            .key("block_count").value(record.block_count)
+            .key("source").value(record.source)
+            .end_object();
+    }
+    writer.end_array().end_object();
+
+    std::error_code ec;
+    std::filesystem::create_directories(root_dir_, ec);
+    const std::string temp = index_path() + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out << text;
+        if (!out) {
+            if (auto logger = store_logger()) {
+                logger->warn("Could not write model index '{}'", temp);
+            }
+            return;
+        }
+    }
+    std::filesystem::rename(temp, index_path(), ec);
+    if (ec) {
+        if (auto logger = store_logger()) {
+            logger->warn("Could not update model index '{}': {}", index_path(), ec.message());
+        }
+    }
+}
@@ -1,10 +1,14 @@
 #include "MovableCategorizedFile.hpp"
 #include "Utils.hpp"
 #include "Logger.hpp"
+#include "Metrics.hpp"
+#include "EmptyDirectoryPruner.hpp"
 #include <filesystem>
 #include <cstdio>
 #include <algorithm>
 #include <cctype>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace {
@@ -105,13 +109,16 @@ MovableCategorizedFile::MovePaths
 MovableCategorizedFile::build_move_paths(bool use_subcategory) const
 {
     const std::filesystem::path base_dir = Utils::utf8_to_path(dir_path);
+    const std::filesystem::path target_root = destination_root.empty()
+        ? base_dir
+        : Utils::utf8_to_path(destination_root);
     const std::filesystem::path category_segment = Utils::utf8_to_path(category);
     const std::filesystem::path subcategory_segment = Utils::utf8_to_path(subcategory);
     const std::filesystem::path file_segment = Utils::utf8_to_path(file_name);
 
     const std::filesystem::path categorized_root = use_subcategory
-        ? base_dir / category_segment / subcategory_segment
-        : base_dir / category_segment;
+        ? target_root / category_segment / subcategory_segment
+        : target_root / category_segment;
 
     return MovePaths{
         base_dir / file_segment,
@@ -149,7 +156,7 @@ bool MovableCategorizedFile::perform_move(const std::filesystem::path& source_pa
     try {
         std::filesystem::rename(source_path, destination_path);
         with_core_logger([&](auto& logger) {
-            logger.info("Moved '{}' to '{}'", Utils::path_to_utf8(source_path), Utils::path_to_utf8(destination_path));
+            logger.debug("Moved '{}' to '{}'", Utils::path_to_utf8(source_path), Utils::path_to_utf8(destination_path));
         });
         return true;
     } catch (const std::filesystem::filesystem_error& e) {
@@ -160,6 +167,162 @@ bool MovableCategorizedFile::perform_move(const std::filesystem::path& source_pa
     }
 }
 
+MovableCategorizedFile::PlaceResult
+MovableCategorizedFile::perform_link(const std::filesystem::path& source_path,
+                                     const std::filesystem::path& destination_path,
+                                     SortMode mode) const
+{
+    std::error_code ec;
+    if (std::filesystem::exists(std::filesystem::symlink_status(destination_path, ec))) {
+        if (is_link_to(destination_path, source_path, mode)) {
+            return PlaceResult::AlreadyPlaced;
+        }
+        with_core_logger([&](auto& logger) {
+            logger.info("Destination already contains '{}'; skipping link", Utils::path_to_utf8(destination_path));
+        });
+        return PlaceResult::Failed;
+    }
+
+    if (!create_link(source_path, destination_path, mode)) {
+        return PlaceResult::Failed;
+    }
+    with_core_logger([&](auto& logger) {
+        logger.info("Linked '{}' at '{}'", Utils::path_to_utf8(source_path), Utils::path_to_utf8(destination_path));
+    });
+    return PlaceResult::Placed;
+}
+
+bool MovableCategorizedFile::create_link(const std::filesystem::path& source,
+                                         const std::filesystem::path& link,
+                                         SortMode mode)
+{
+    std::error_code ec;
+    // Directories cannot be hard-linked, and hard links cannot cross volumes; both fall back to a symlink.
+    if (mode == SortMode::HardLink && !std::filesystem::is_directory(source, ec)) {
+        std::filesystem::create_hard_link(source, link, ec);
+        if (!ec) {
+            return true;
+        }
+        if (ec != std::errc::cross_device_link) {
+            with_core_logger([&](auto& logger) {
+                logger.error("Failed to hard-link '{}' at '{}': {}", Utils::path_to_utf8(source), Utils::path_to_utf8(link), ec.message());
+            });
+            return false;
+        }
+    }
+
+    const std::filesystem::path target = std::filesystem::absolute(source, ec);
+    ec.clear();
+    if (std::filesystem::is_directory(target, ec)) {
+        std::filesystem::create_directory_symlink(target, link, ec);
+    } else {
+        std::filesystem::create_symlink(target, link, ec);
+    }
+    if (ec) {
+        with_core_logger([&](auto& logger) {
+            logger.error("Failed to symlink '{}' at '{}': {}", Utils::path_to_utf8(source), Utils::path_to_utf8(link), ec.message());
+        });
+        return false;
+    }
+    return true;
+}
+
+bool MovableCategorizedFile::is_link_to(const std::filesystem::path& link,
+                                        const std::filesystem::path& source,
+                                        SortMode mode)
+{
+    std::error_code ec;
+    if (mode == SortMode::Move) {
+        return false;
+    }
+    if (std::filesystem::is_symlink(link, ec)) {
+        const auto target = std::filesystem::read_symlink(link, ec);
+        return !ec && target.lexically_normal() == std::filesystem::absolute(source, ec).lexically_normal();
+    }
+    // Hard links (or a symlink fallback that was later replaced) are recognised by file identity.
+    return std::filesystem::equivalent(link, source, ec) && !ec;
+}
+
+std::string MovableCategorizedFile::link_mirror_root(const std::string& base_dir)
+{
+    if (base_dir.empty()) {
+        return std::string();
+    }
+    // Kept outside the sorted folder so later scans of that folder do not pick the links up.
+    std::filesystem::path base = Utils::utf8_to_path(base_dir).lexically_normal();
+    if (!base.has_filename() && base.has_relative_path()) {
+        base = base.parent_path();
+    }
+    if (!base.has_relative_path()) {
+        return Utils::path_to_utf8(base / "Sorted links");
+    }
+    return Utils::path_to_utf8(base.parent_path() /
+                               Utils::utf8_to_path(Utils::path_to_utf8(base.filename()) + " (sorted)"));
+}
+
+std::size_t MovableCategorizedFile::remove_stale_links(
+    const std::filesystem::path& mirror_root,
+    const std::vector<std::pair<std::string, std::string>>& placed_links)
+{
+    std::unordered_map<std::string, std::vector<const std::pair<std::string, std::string>*>> by_file_name;
+    std::unordered_set<std::string> placed_paths;
+    for (const auto& placed : placed_links) {
+        by_file_name[Utils::path_to_utf8(Utils::utf8_to_path(placed.first).filename())].push_back(&placed);
+        placed_paths.insert(Utils::path_to_utf8(Utils::utf8_to_path(placed.second).lexically_normal()));
+    }
+
+    std::vector<std::filesystem::path> stale;
+    std::error_code ec;
+    for (std::filesystem::recursive_directory_iterator it(
+             mirror_root, std::filesystem::directory_options::skip_permission_denied, ec), end;
+         !ec && it != end; it.increment(ec)) {
+        const std::filesystem::path entry = it->path();
+        if (placed_paths.count(Utils::path_to_utf8(entry.lexically_normal())) > 0) {
+            continue;
+        }
+        std::error_code entry_ec;
+        const bool is_symlink = it->is_symlink(entry_ec);
+        if (is_symlink && !std::filesystem::exists(entry, entry_ec)) {
+            stale.push_back(entry);
+            continue;
+        }
+        if (!is_symlink && !it->is_regular_file(entry_ec)) {
+            continue;
+        }
+        const auto candidates = by_file_name.find(Utils::path_to_utf8(entry.filename()));
+        if (candidates == by_file_name.end()) {
+            continue;
+        }
+        for (const auto* placed : candidates->second) {
+            const auto source = Utils::utf8_to_path(placed->first);
+            if (entry.lexically_normal() == source.lexically_normal()) {
+                continue;
+            }
+            if (is_link_to(entry, source, is_symlink ? SortMode::SymLink : SortMode::HardLink)) {
+                stale.push_back(entry);
+                break;
+            }
+        }
+    }
+
+    EmptyDirectoryPruner pruner(mirror_root);
+    std::size_t removed = 0;
+    for (const auto& entry : stale) {
+        std::error_code remove_ec;
+        if (std::filesystem::remove(entry, remove_ec) && !remove_ec) {
+            ++removed;
+            pruner.add(entry.parent_path());
+        }
+    }
+    pruner.prune();
+    if (removed > 0) {
+        with_core_logger([&](auto& logger) {
+            logger.info("Removed {} stale link(s) under '{}'", removed, Utils::path_to_utf8(mirror_root));
+        });
+    }
+    return removed;
+}
+
 
 MovableCategorizedFile::MovableCategorizedFile(
     const std::string& dir_path, const std::string& cat, const std::string& subcat,
@@ -185,13 +348,26 @@ MovableCategorizedFile::MovableCategorizedFile(
         throw std::runtime_error("Invalid path component in CategorizedFile constructor.");
     }
 
-    const std::filesystem::path base_dir = Utils::utf8_to_path(dir_path);
-    category_path = base_dir / Utils::utf8_to_path(category);
+    update_destination_paths();
+}
+
+
+void MovableCategorizedFile::update_destination_paths()
+{
+    const std::filesystem::path root = Utils::utf8_to_path(destination_root.empty() ? dir_path : destination_root);
+    category_path = root / Utils::utf8_to_path(category);
     subcategory_path = category_path / Utils::utf8_to_path(subcategory);
     destination_path = subcategory_path / Utils::utf8_to_path(file_name);
 }
 
 
+void MovableCategorizedFile::set_destination_root(const std::string& root)
+{
+    destination_root = root;
+    update_destination_paths();
+}
+
+
 void MovableCategorizedFile::create_cat_dirs(bool use_subcategory)
 {
     try {
@@ -225,6 +401,21 @@ bool MovableCategorizedFile::move_file(bool use_subcategory)
     return perform_move(paths.source, paths.destination);
 }
 
+MovableCategorizedFile::PlaceResult
+MovableCategorizedFile::place_file(bool use_subcategory, SortMode mode)
+{
+    Metrics::Timer timer(Metrics::Stage::Move);
+    if (mode == SortMode::Move) {
+        return move_file(use_subcategory) ? PlaceResult::Placed : PlaceResult::Failed;
+    }
+
+    const MovePaths paths = build_move_paths(use_subcategory);
+    if (!source_is_available(paths.source)) {
+        return PlaceResult::Failed;
+    }
+    return perform_link(paths.source, paths.destination, mode);
+}
+
 MovableCategorizedFile::PreviewPaths
 MovableCategorizedFile::preview_move_paths(bool use_subcategory) const
 {
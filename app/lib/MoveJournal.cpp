@@ -0,0 +1,657 @@
+#include "MoveJournal.hpp"
+
+#include "Utils.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <system_error>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kMagic[8] = {'A', 'I', 'F', 'S', 'J', 'R', 'N', '\0'};
+constexpr std::uint32_t kFormatVersion = 1;
+constexpr std::uint32_t kMaxPayloadBytes = 64 * 1024;
+
+enum RecordType : std::uint8_t {
+    kRecordRun = 1,
+    kRecordIntent = 2,
+    kRecordMoved = 3,
+    kRecordFailed = 4,
+    kRecordComplete = 5
+};
+
+const std::array<std::uint32_t, 256>& crc_table()
+{
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> values{};
+        for (std::uint32_t i = 0; i < values.size(); ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1u) ? 0xEDB88320u ^ (c >> 1) : (c >> 1);
+            }
+            values[i] = c;
+        }
+        return values;
+    }();
+    return table;
+}
+
+std::uint32_t crc32_update(std::uint32_t crc, const unsigned char* data, std::size_t size)
+{
+    const auto& table = crc_table();
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void put_u8(std::string& out, std::uint8_t value)
+{
+    out.push_back(static_cast<char>(value));
+}
+
+void put_u32(std::string& out, std::uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFFu));
+    }
+}
+
+void put_u64(std::string& out, std::uint64_t value)
+{
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFFu));
+    }
+}
+
+void put_string(std::string& out, const std::string& value)
+{
+    put_u32(out, static_cast<std::uint32_t>(value.size()));
+    out.append(value);
+}
+
+class PayloadReader {
+public:
+    explicit PayloadReader(const std::string& data) : data_(data) {}
+
+    bool u8(std::uint8_t& value)
+    {
+        if (data_.size() - pos_ < 1) {
+            return false;
+        }
+        value = static_cast<std::uint8_t>(data_[pos_]);
+        pos_ += 1;
+        return true;
+    }
+
+    bool u32(std::uint32_t& value)
+    {
+        if (data_.size() - pos_ < 4) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<std::uint32_t>(static_cast<unsigned char>(data_[pos_ + i])) << (8 * i);
+        }
+        pos_ += 4;
+        return true;
+    }
+
+    bool u64(std::uint64_t& value)
+    {
+        if (data_.size() - pos_ < 8) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(data_[pos_ + i])) << (8 * i);
+        }
+        pos_ += 8;
+        return true;
+    }
+
+    bool at_end() const { return pos_ >= data_.size(); }
+
+    bool string(std::string& value)
+    {
+        std::uint32_t len = 0;
+        if (!u32(len) || data_.size() - pos_ < len) {
+            return false;
+        }
+        value.assign(data_, pos_, len);
+        pos_ += len;
+        return true;
+    }
+
+private:
+    const std::string& data_;
+    std::size_t pos_{0};
+};
+
+std::FILE* open_file(const std::filesystem::path& path, const char* mode)
+{
+#ifdef _WIN32
+    std::wstring wide_mode(mode, mode + std::strlen(mode));
+    return _wfopen(path.c_str(), wide_mode.c_str());
+#else
+    return std::fopen(path.c_str(), mode);
+#endif
+}
+
+bool sync_file(std::FILE* file)
+{
+    if (std::fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return ::fsync(fileno(file)) == 0;
+#endif
+}
+
+void sync_directory(const std::filesystem::path& dir)
+{
+#ifndef _WIN32
+    const int fd = ::open(dir.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+#else
+    (void)dir;
+#endif
+}
+
+std::int64_t now_millis()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+struct JournalVisitor {
+    std::function<void(std::string base_dir, std::int64_t created_at)> on_run;
+    std::function<bool(MoveJournal::Record& intent)> on_intent;
+    std::function<bool(std::uint64_t seq, MoveJournal::State state, std::uintmax_t size, std::time_t mtime,
+                       std::uint64_t fingerprint, std::string destination)> on_result;
+    std::function<void()> on_complete;
+};
+
+std::uint32_t decode_u32(const unsigned char* bytes)
+{
+    return static_cast<std::uint32_t>(bytes[0]) |
+           (static_cast<std::uint32_t>(bytes[1]) << 8) |
+           (static_cast<std::uint32_t>(bytes[2]) << 16) |
+           (static_cast<std::uint32_t>(bytes[3]) << 24);
+}
+
+// Walks the journal record by record. Stops at the first torn or corrupt record, which can only be
+// the tail of an interrupted run; valid_bytes reports how much of the file is intact.
+bool scan_journal(const std::string& path, const JournalVisitor& visitor, std::uint64_t& valid_bytes)
+{
+    std::FILE* file = open_file(Utils::utf8_to_path(path), "rb");
+    if (!file) {
+        return false;
+    }
+
+    char magic[sizeof(kMagic)] = {};
+    unsigned char version_bytes[4] = {};
+    if (std::fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+        std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+        std::fread(version_bytes, 1, sizeof(version_bytes), file) != sizeof(version_bytes) ||
+        decode_u32(version_bytes) != kFormatVersion) {
+        std::fclose(file);
+        return false;
+    }
+    valid_bytes = sizeof(kMagic) + sizeof(version_bytes);
+
+    std::uint64_t intent_count = 0;
+    std::string payload;
+    MoveJournal::Record intent;
+    while (true) {
+        unsigned char header[5];
+        if (std::fread(header, 1, sizeof(header), file) != sizeof(header)) {
+            break;
+        }
+        const std::uint8_t type = header[0];
+        const std::uint32_t length = decode_u32(header + 1);
+        if (length > kMaxPayloadBytes) {
+            break;
+        }
+        payload.resize(length);
+        unsigned char crc_bytes[4];
+        if ((length > 0 && std::fread(payload.data(), 1, length, file) != length) ||
+            std::fread(crc_bytes, 1, sizeof(crc_bytes), file) != sizeof(crc_bytes)) {
+            break;
+        }
+        std::uint32_t crc = crc32_update(0, &type, 1);
+        crc = crc32_update(crc, reinterpret_cast<const unsigned char*>(payload.data()), payload.size());
+        if (crc != decode_u32(crc_bytes)) {
+            break;
+        }
+
+        PayloadReader reader(payload);
+        bool ok = true;
+        switch (type) {
+        case kRecordRun: {
+            std::string base_dir;
+            std::uint64_t created = 0;
+            ok = reader.string(base_dir) && reader.u64(created);
+            if (ok && visitor.on_run) {
+                visitor.on_run(std::move(base_dir), static_cast<std::int64_t>(created));
+            }
+            break;
+        }
+        case kRecordIntent: {
+            intent = MoveJournal::Record{};
+            ok = reader.u64(intent.seq) && reader.string(intent.source) && reader.string(intent.destination) &&
+                 intent.seq == intent_count;
+            if (ok && !reader.at_end()) {
+                ok = reader.string(intent.category) && reader.string(intent.subcategory);
+            }
+            if (ok && !reader.at_end()) {
+                std::uint8_t mode = 0;
+                ok = reader.u8(mode) && mode <= static_cast<std::uint8_t>(SortMode::SymLink);
+                intent.mode = static_cast<SortMode>(mode);
+            }
+            if (ok) {
+                ++intent_count;
+                ok = !visitor.on_intent || visitor.on_intent(intent);
+            }
+            break;
+        }
+        case kRecordMoved: {
+            std::uint64_t seq = 0;
+            std::uint64_t size = 0;
+            std::uint64_t mtime = 0;
+            std::uint64_t fingerprint = 0;
+            std::string destination;
+            ok = reader.u64(seq) && reader.u64(size) && reader.u64(mtime) && seq < intent_count;
+            if (ok && !reader.at_end()) {
+                ok = reader.u64(fingerprint);
+            }
+            if (ok && !reader.at_end()) {
+                ok = reader.string(destination);
+            }
+            if (ok && visitor.on_result) {
+                ok = visitor.on_result(seq, MoveJournal::State::Moved, static_cast<std::uintmax_t>(size),
+                                       static_cast<std::time_t>(static_cast<std::int64_t>(mtime)), fingerprint,
+                                       std::move(destination));
+            }
+            break;
+        }
+        case kRecordFailed: {
+            std::uint64_t seq = 0;
+            ok = reader.u64(seq) && seq < intent_count;
+            if (ok && visitor.on_result) {
+                ok = visitor.on_result(seq, MoveJournal::State::Failed, 0, 0, 0, std::string());
+            }
+            break;
+        }
+        case kRecordComplete:
+            if (visitor.on_complete) {
+                visitor.on_complete();
+            }
+            break;
+        default:
+            ok = false;
+            break;
+        }
+        if (!ok) {
+            break;
+        }
+        valid_bytes += sizeof(header) + length + sizeof(crc_bytes);
+    }
+
+    std::fclose(file);
+    return true;
+}
+
+bool read_journal(const std::string& path, MoveJournal::Contents& contents, std::uint64_t& valid_bytes)
+{
+    JournalVisitor visitor;
+    visitor.on_run = [&](std::string base_dir, std::int64_t created_at) {
+        contents.base_dir = std::move(base_dir);
+        contents.created_at = created_at;
+    };
+    visitor.on_intent = [&](MoveJournal::Record& intent) {
+        contents.records.push_back(std::move(intent));
+        return true;
+    };
+    visitor.on_result = [&](std::uint64_t seq, MoveJournal::State state, std::uintmax_t size, std::time_t mtime,
+                            std::uint64_t fingerprint, std::string destination) {
+        auto& record = contents.records[static_cast<std::size_t>(seq)];
+        record.state = state;
+        record.size_bytes = size;
+        record.mtime = mtime;
+        record.fingerprint = fingerprint;
+        if (!destination.empty()) {
+            record.destination = std::move(destination);
+        }
+        return true;
+    };
+    visitor.on_complete = [&]() { contents.complete = true; };
+    return scan_journal(path, visitor, valid_bytes);
+}
+
+} // namespace
+
+MoveJournal::MoveJournal(std::FILE* file,
+                         std::string path,
+                         std::uint64_t next_seq,
+                         std::shared_ptr<spdlog::logger> logger)
+    : file_(file),
+      path_(std::move(path)),
+      next_seq_(next_seq),
+      logger_(std::move(logger))
+{}
+
+MoveJournal::~MoveJournal()
+{
+    if (file_) {
+        sync_file(file_);
+        std::fclose(file_);
+    }
+}
+
+std::unique_ptr<MoveJournal> MoveJournal::create(const std::string& journal_dir,
+                                                 const std::string& base_dir,
+                                                 const std::shared_ptr<spdlog::logger>& logger)
+{
+    if (journal_dir.empty()) {
+        return nullptr;
+    }
+
+    const std::filesystem::path dir = Utils::utf8_to_path(journal_dir);
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+
+    const std::int64_t created_at = now_millis();
+    std::filesystem::path file_path;
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        std::string name = kFilePrefix + std::to_string(created_at);
+        if (attempt > 0) {
+            name += "_" + std::to_string(attempt);
+        }
+        file_path = dir / Utils::utf8_to_path(name + kFileSuffix);
+        if (!std::filesystem::exists(file_path, ec)) {
+            break;
+        }
+    }
+
+    std::FILE* file = open_file(file_path, "wb");
+    if (!file) {
+        if (logger) {
+            logger->error("Failed to create move journal '{}'", Utils::path_to_utf8(file_path));
+        }
+        return nullptr;
+    }
+
+    std::string header(kMagic, sizeof(kMagic));
+    put_u32(header, kFormatVersion);
+    std::unique_ptr<MoveJournal> journal(
+        new MoveJournal(file, Utils::path_to_utf8(file_path), 0, logger));
+    if (std::fwrite(header.data(), 1, header.size(), file) != header.size()) {
+        if (logger) {
+            logger->error("Failed to write move journal header '{}'", journal->path());
+        }
+        return nullptr;
+    }
+
+    std::string run_payload;
+    put_string(run_payload, base_dir);
+    put_u64(run_payload, static_cast<std::uint64_t>(created_at));
+    if (!journal->write_record(kRecordRun, run_payload) || !journal->sync()) {
+        return nullptr;
+    }
+    sync_directory(dir);
+
+    if (logger) {
+        logger->info("Opened move journal '{}'", journal->path());
+    }
+    return journal;
+}
+
+std::unique_ptr<MoveJournal> MoveJournal::open_existing(const std::string& path,
+                                                        const std::shared_ptr<spdlog::logger>& logger)
+{
+    Contents contents;
+    std::uint64_t valid_bytes = 0;
+    if (!read_journal(path, contents, valid_bytes)) {
+        if (logger) {
+            logger->error("Failed to read move journal '{}'", path);
+        }
+        return nullptr;
+    }
+
+    // Drop a torn trailing record so new records are appended after the last valid one.
+    const std::filesystem::path file_path = Utils::utf8_to_path(path);
+    std::error_code ec;
+    if (std::filesystem::file_size(file_path, ec) != valid_bytes && !ec) {
+        std::filesystem::resize_file(file_path, valid_bytes, ec);
+        if (ec) {
+            if (logger) {
+                logger->error("Failed to truncate move journal '{}': {}", path, ec.message());
+            }
+            return nullptr;
+        }
+    }
+
+    std::FILE* file = open_file(file_path, "ab");
+    if (!file) {
+        if (logger) {
+            logger->error("Failed to reopen move journal '{}'", path);
+        }
+        return nullptr;
+    }
+    return std::unique_ptr<MoveJournal>(
+        new MoveJournal(file, path, static_cast<std::uint64_t>(contents.records.size()), logger));
+}
+
+std::optional<std::uint64_t> MoveJournal::append_intents(const std::vector<Intent>& intents)
+{
+    const std::uint64_t first_seq = next_seq_;
+    for (const auto& intent : intents) {
+        std::string payload;
+        put_u64(payload, next_seq_);
+        put_string(payload, intent.source);
+        put_string(payload, intent.destination);
+        put_string(payload, intent.category);
+        put_string(payload, intent.subcategory);
+        put_u8(payload, static_cast<std::uint8_t>(intent.mode));
+        if (!write_record(kRecordIntent, payload)) {
+            return std::nullopt;
+        }
+        ++next_seq_;
+    }
+    if (!sync()) {
+        return std::nullopt;
+    }
+    return first_seq;
+}
+
+bool MoveJournal::record_moved(std::uint64_t seq, std::uintmax_t size_bytes, std::time_t mtime,
+                               std::uint64_t fingerprint, const std::string& destination)
+{
+    std::string payload;
+    put_u64(payload, seq);
+    put_u64(payload, static_cast<std::uint64_t>(size_bytes));
+    put_u64(payload, static_cast<std::uint64_t>(static_cast<std::int64_t>(mtime)));
+    put_u64(payload, fingerprint);
+    if (!destination.empty()) {
+        put_string(payload, destination);
+    }
+    return write_record(kRecordMoved, payload);
+}
+
+bool MoveJournal::record_failed(std::uint64_t seq)
+{
+    std::string payload;
+    put_u64(payload, seq);
+    return write_record(kRecordFailed, payload);
+}
+
+bool MoveJournal::mark_complete()
+{
+    if (!write_record(kRecordComplete, std::string()) || !sync()) {
+        return false;
+    }
+    if (logger_) {
+        logger_->info("Closed move journal '{}' with {} intent(s)", path_, next_seq_);
+    }
+    return true;
+}
+
+std::optional<MoveJournal::Contents> MoveJournal::read(const std::string& path)
+{
+    Contents contents;
+    std::uint64_t valid_bytes = 0;
+    if (!read_journal(path, contents, valid_bytes)) {
+        return std::nullopt;
+    }
+    return contents;
+}
+
+std::optional<MoveJournal::Summary> MoveJournal::read_summary(const std::string& path)
+{
+    Summary summary;
+    JournalVisitor visitor;
+    visitor.on_run = [&](std::string base_dir, std::int64_t created_at) {
+        summary.base_dir = std::move(base_dir);
+        summary.created_at = created_at;
+    };
+    visitor.on_intent = [&](Record&) {
+        ++summary.intent_count;
+        return true;
+    };
+    visitor.on_result = [&](std::uint64_t, State state, std::uintmax_t, std::time_t, std::uint64_t, std::string) {
+        if (state == State::Moved) {
+            ++summary.moved_count;
+        }
+        return true;
+    };
+    visitor.on_complete = [&]() { summary.complete = true; };
+
+    std::uint64_t valid_bytes = 0;
+    if (!scan_journal(path, visitor, valid_bytes)) {
+        return std::nullopt;
+    }
+    return summary;
+}
+
+bool MoveJournal::for_each_record(const std::string& path,
+                                  const std::function<bool(const Record&)>& visitor,
+                                  Summary* summary)
+{
+    struct Outcome {
+        State state{State::Pending};
+        std::uintmax_t size_bytes{0};
+        std::time_t mtime{0};
+        std::uint64_t fingerprint{0};
+        std::string destination;
+    };
+
+    // First pass: final outcome per intent. Results can trail their intents by a whole batch,
+    // so paths are only materialized in the second pass.
+    Summary local_summary;
+    std::vector<Outcome> outcomes;
+    JournalVisitor outcome_pass;
+    outcome_pass.on_run = [&](std::string base_dir, std::int64_t created_at) {
+        local_summary.base_dir = std::move(base_dir);
+        local_summary.created_at = created_at;
+    };
+    outcome_pass.on_intent = [&](Record&) {
+        outcomes.emplace_back();
+        return true;
+    };
+    outcome_pass.on_result = [&](std::uint64_t seq, State state, std::uintmax_t size, std::time_t mtime,
+                                 std::uint64_t fingerprint, std::string destination) {
+        outcomes[static_cast<std::size_t>(seq)] = Outcome{state, size, mtime, fingerprint, std::move(destination)};
+        if (state == State::Moved) {
+            ++local_summary.moved_count;
+        }
+        return true;
+    };
+    outcome_pass.on_complete = [&]() { local_summary.complete = true; };
+
+    std::uint64_t valid_bytes = 0;
+    if (!scan_journal(path, outcome_pass, valid_bytes)) {
+        return false;
+    }
+    local_summary.intent_count = outcomes.size();
+    if (summary) {
+        *summary = local_summary;
+    }
+
+    JournalVisitor record_pass;
+    record_pass.on_intent = [&](Record& intent) {
+        if (intent.seq >= outcomes.size()) {
+            return false;
+        }
+        const auto& outcome = outcomes[static_cast<std::size_t>(intent.seq)];
+        intent.state = outcome.state;
+        intent.size_bytes = outcome.size_bytes;
+        intent.mtime = outcome.mtime;
+        intent.fingerprint = outcome.fingerprint;
+        if (!outcome.destination.empty()) {
+            intent.destination = outcome.destination;
+        }
+        return visitor(intent);
+    };
+    return scan_journal(path, record_pass, valid_bytes);
+}
+
+bool MoveJournal::is_journal_file(const std::string& path)
+{
+    const std::string name = Utils::path_to_utf8(Utils::utf8_to_path(path).filename());
+    const std::string prefix = kFilePrefix;
+    const std::string suffix = kFileSuffix;
+    return name.size() > prefix.size() + suffix.size() &&
+           name.compare(0, prefix.size(), prefix) == 0 &&
+           name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool MoveJournal::write_record(std::uint8_t type, const std::string& payload)
+{
+    if (!file_) {
+        return false;
+    }
+    std::string frame;
+    frame.reserve(payload.size() + 9);
+    frame.push_back(static_cast<char>(type));
+    put_u32(frame, static_cast<std::uint32_t>(payload.size()));
+    frame.append(payload);
+    std::uint32_t crc = crc32_update(0, &type, 1);
+    crc = crc32_update(crc, reinterpret_cast<const unsigned char*>(payload.data()), payload.size());
+    put_u32(frame, crc);
+
+    if (std::fwrite(frame.data(), 1, frame.size(), file_) != frame.size()) {
+        if (logger_) {
+            logger_->error("Failed to append to move journal '{}'", path_);
+        }
+        return false;
+    }
+    return true;
+}
+
+bool MoveJournal::sync()
+{
+    if (!file_ || !sync_file(file_)) {
+        if (logger_) {
+            logger_->error("Failed to sync move journal '{}'", path_);
+        }
+        return false;
+    }
+    return true;
+}
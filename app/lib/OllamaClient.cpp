@@ -0,0 +1,396 @@
+#include "OllamaClient.hpp"
+#include "JsonView.hpp"
+#include "Logger.hpp"
+#include "StreamingReply.hpp"
+#ifdef _WIN32
+    #include <json/json.h>
+#elif __APPLE__
+    #include <json/json.h>
+#else
+    #include <jsoncpp/json/json.h>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr const char* kCategorizationSystemPrompt =
+    "You are a file categorization assistant. If it's an installer, describe the type of software it installs. "
+    "Consider the filename, extension, and any directory context provided. Reply with a JSON object with the keys "
+    "\"category\" and \"subcategory\". The category must be broad (one or two words, plural). The subcategory "
+    "must be specific, relevant, and must not repeat the category.";
+constexpr const char* kJsonAssistantPrompt =
+    "You are a precise assistant that returns well-formed JSON responses.";
+
+std::size_t max_parallel_from_env()
+{
+    const char* value = std::getenv("OLLAMA_NUM_PARALLEL");
+    if (!value || *value == '\0') {
+        return OllamaClient::kDefaultMaxParallel;
+    }
+    try {
+        const int parsed = std::stoi(value);
+        if (parsed > 0) {
+            return static_cast<std::size_t>(parsed);
+        }
+    } catch (const std::exception&) {
+        // Fall through to the default.
+    }
+    return OllamaClient::kDefaultMaxParallel;
+}
+
+Json::Value category_schema()
+{
+    Json::Value schema(Json::objectValue);
+    schema["type"] = "object";
+    schema["properties"]["category"]["type"] = "string";
+    schema["properties"]["subcategory"]["type"] = "string";
+    schema["required"].append("category");
+    schema["required"].append("subcategory");
+    return schema;
+}
+
+Json::Value message(const std::string& role, const std::string& content)
+{
+    Json::Value value(Json::objectValue);
+    value["role"] = role;
+    value["content"] = content;
+    return value;
+}
+
+std::string write_compact(const Json::Value& value)
+{
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    return Json::writeString(writer, value);
+}
+
+bool parse_json(const std::string& text, Json::Value& root, std::string* errors = nullptr)
+{
+    Json::CharReaderBuilder reader;
+    std::istringstream stream(text);
+    std::string parse_errors;
+    const bool ok = Json::parseFromStream(reader, stream, &root, &parse_errors);
+    if (errors) {
+        *errors = parse_errors;
+    }
+    return ok;
+}
+
+std::string read_chat_response(const HttpTransport::Response& response)
+{
+    if (!response.ok()) {
+        throw std::runtime_error("Network Error: " + response.error);
+    }
+
+    // Proxies in front of a hosted server answer refusals and failures in plain text.
+    if (response.status == 401 || response.status == 403) {
+        throw std::runtime_error("Authentication Error: Ollama rejected the API key.");
+    }
+    Json::Value root;
+    std::string errors;
+    const bool parsed = parse_json(response.body, root, &errors);
+    if (response.status >= 400) {
+        constexpr std::size_t kMaxErrorBodyChars = 200;
+        const std::string message = !parsed ? response.body.substr(0, kMaxErrorBodyChars)
+                                    : root.isObject() ? root.get("error", "").asString()
+                                                      : std::string();
+        throw std::runtime_error("Ollama Error (HTTP " + std::to_string(response.status) + "): " + message);
+    }
+    if (!parsed) {
+        throw std::runtime_error("Response Error: Failed to parse Ollama response. " + errors);
+    }
+    return root["message"]["content"].asString();
+}
+
+// A streamed categorization reply: one JSON object per line, each carrying the next piece of
+// message.content, until "done". Reading stops once the reply object is complete. Lines that are
+// not objects on their own are kept, in case the server ignored "stream" and sent one document.
+struct StreamedChat {
+    LineBuffer lines;
+    std::string content;
+    std::string error;
+    std::string unframed;
+    bool complete{false};
+
+    bool consume(std::string_view line)
+    {
+        const JsonView chunk = JsonView::parse(line);
+        if (!chunk.is_object()) {
+            unframed.append(line).append("\n");
+            return true;
+        }
+        if (const auto message = chunk["error"].as_string()) {
+            error = *message;
+            return false;
+        }
+        if (const auto text = chunk["message"]["content"].as_string()) {
+            content += *text;
+        }
+        complete = complete_category_reply_length(content) > 0;
+        return !complete;
+    }
+};
+
+std::string read_streamed_chat(StreamedChat& stream, const HttpTransport::Response& response)
+{
+    const bool stopped_early = stream.complete && response.error == HttpTransport::kAbortedByReceiver;
+    if (!response.ok() && !stopped_early && stream.error.empty()) {
+        throw std::runtime_error("Network Error: " + response.error);
+    }
+    if (response.status >= 400) {
+        return read_chat_response(response);
+    }
+    stream.lines.finish([&stream](std::string_view line) { return stream.consume(line); });
+    if (!stream.error.empty()) {
+        throw std::runtime_error("Ollama Error: " + stream.error);
+    }
+    if (stream.content.empty() && !stream.unframed.empty()) {
+        HttpTransport::Response whole = response;
+        whole.body = stream.unframed;
+        stream.content = read_chat_response(whole);
+    }
+    if (const std::size_t length = complete_category_reply_length(stream.content)) {
+        stream.content.resize(length);
+    }
+    return stream.content;
+}
+
+} // namespace
+
+OllamaClient::OllamaClient(std::string base_url, std::string model, std::string api_key)
+    : base_url_(std::move(base_url)),
+      model_(std::move(model)),
+      api_key_(std::move(api_key)),
+      dispatcher_(std::make_shared<Dispatcher>())
+{
+    if (base_url_.empty()) {
+        base_url_ = kDefaultBaseUrl;
+    }
+    while (!base_url_.empty() && base_url_.back() == '/') {
+        base_url_.pop_back();
+    }
+    dispatcher_->limit = max_parallel_from_env();
+}
+
+void OllamaClient::set_prompt_logging_enabled(bool enabled)
+{
+    prompt_logging_enabled_ = enabled;
+}
+
+void OllamaClient::set_keep_alive(std::string keep_alive)
+{
+    keep_alive_ = std::move(keep_alive);
+}
+
+void OllamaClient::set_max_parallel(std::size_t max_parallel)
+{
+    std::lock_guard<std::mutex> lock(dispatcher_->mutex);
+    dispatcher_->limit = std::max<std::size_t>(1, max_parallel);
+}
+
+std::size_t OllamaClient::max_parallel() const
+{
+    std::lock_guard<std::mutex> lock(dispatcher_->mutex);
+    return dispatcher_->limit;
+}
+
+void OllamaClient::set_timeout(int seconds)
+{
+    timeout_seconds_ = seconds;
+}
+
+std::string OllamaClient::format_category_reply(const std::string& content)
+{
+    Json::Value root;
+    if (!parse_json(content, root) || !root.isObject()) {
+        return content;
+    }
+    const std::string category = root.get("category", "").asString();
+    const std::string subcategory = root.get("subcategory", "").asString();
+    if (category.empty()) {
+        return content;
+    }
+    return subcategory.empty() ? category : category + " : " + subcategory;
+}
+
+void OllamaClient::dispatch(const std::shared_ptr<Dispatcher>& dispatcher, Queued queued)
+{
+    if (queued.cancel && queued.cancel->cancelled()) {
+        HttpTransport::Response response;
+        response.error = "Cancelled";
+        queued.on_complete(std::move(response));
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(dispatcher->mutex);
+        if (dispatcher->in_flight >= dispatcher->limit) {
+            dispatcher->waiting.push_back(std::move(queued));
+            return;
+        }
+        ++dispatcher->in_flight;
+    }
+
+    const auto id = AsyncHttpEngine::shared().submit(std::move(queued.request),
+        [dispatcher, on_complete = std::move(queued.on_complete)](HttpTransport::Response response) {
+            on_complete(std::move(response));
+            release(dispatcher);
+        });
+    if (queued.cancel) {
+        queued.cancel->set_handler([id]() { AsyncHttpEngine::shared().cancel(id); });
+    }
+}
+
+void OllamaClient::release(const std::shared_ptr<Dispatcher>& dispatcher)
+{
+    {
+        std::lock_guard<std::mutex> lock(dispatcher->mutex);
+        --dispatcher->in_flight;
+    }
+    // Cancelled requests are completed without taking the slot, so keep going until one does.
+    while (true) {
+        Queued next;
+        {
+            std::lock_guard<std::mutex> lock(dispatcher->mutex);
+            if (dispatcher->waiting.empty() || dispatcher->in_flight >= dispatcher->limit) {
+                return;
+            }
+            next = std::move(dispatcher->waiting.front());
+            dispatcher->waiting.pop_front();
+        }
+        dispatch(dispatcher, std::move(next));
+    }
+}
+
+std::string OllamaClient::make_categorization_payload(const std::string& file_name,
+                                                      const std::string& file_path,
+                                                      FileType file_type,
+                                                      const std::string& consistency_context)
+{
+    const bool is_directory = file_type == FileType::Directory;
+    std::string prompt;
+    if (!file_path.empty()) {
+        prompt = std::string(is_directory ? "Categorize the directory with full path: " : "Categorize the item with full path: ")
+                 + file_path + "\n" + (is_directory ? "Directory name: " : "File name: ") + file_name;
+    } else {
+        prompt = std::string(is_directory ? "Categorize directory: " : "Categorize file: ") + file_name;
+    }
+    if (!consistency_context.empty()) {
+        prompt += "\n\n" + consistency_context;
+    }
+    last_prompt_ = prompt;
+
+    Json::Value payload(Json::objectValue);
+    payload["model"] = model_;
+    payload["stream"] = true;
+    payload["keep_alive"] = keep_alive_;
+    payload["format"] = category_schema();
+    payload["options"]["temperature"] = 0;
+    payload["messages"].append(message("system", kCategorizationSystemPrompt));
+    payload["messages"].append(message("user", prompt));
+    return write_compact(payload);
+}
+
+std::string OllamaClient::make_completion_payload(const std::string& prompt, int max_tokens) const
+{
+    Json::Value payload(Json::objectValue);
+    payload["model"] = model_;
+    payload["stream"] = false;
+    payload["keep_alive"] = keep_alive_;
+    payload["format"] = "json";
+    if (max_tokens > 0) {
+        payload["options"]["num_predict"] = max_tokens;
+    }
+    payload["messages"].append(message("system", kJsonAssistantPrompt));
+    payload["messages"].append(message("user", prompt));
+    return write_compact(payload);
+}
+
+std::future<std::string> OllamaClient::send_chat_async(std::string payload,
+                                                       bool categorization,
+                                                       std::shared_ptr<LLMCancelToken> cancel)
+{
+    auto promise = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> future = promise->get_future();
+    if (model_.empty()) {
+        promise->set_exception(std::make_exception_ptr(std::runtime_error("No Ollama model is configured.")));
+        return future;
+    }
+
+    HttpTransport::Request request;
+    request.method = HttpTransport::Method::Post;
+    request.url = base_url_ + "/api/chat";
+    request.headers = {"Content-Type: application/json"};
+    if (!api_key_.empty()) {
+        request.headers.push_back("Authorization: Bearer " + api_key_);
+    }
+    request.body = std::move(payload);
+    request.timeout_seconds = timeout_seconds_;
+
+    std::shared_ptr<StreamedChat> stream;
+    if (categorization) {
+        stream = std::make_shared<StreamedChat>();
+        request.on_data = [stream](std::string_view chunk) {
+            return stream->lines.feed(chunk, [&stream](std::string_view line) { return stream->consume(line); });
+        };
+    }
+
+    if (auto logger = Logger::get_logger("core_logger")) {
+        logger->debug("Dispatching Ollama chat request to {} (model '{}')", request.url, model_);
+    }
+
+    const bool log_reply = prompt_logging_enabled_;
+    dispatch(dispatcher_, Queued{std::move(request), [promise, stream, log_reply](HttpTransport::Response response) {
+        try {
+            std::string content = stream ? format_category_reply(read_streamed_chat(*stream, response))
+                                         : read_chat_response(response);
+            if (log_reply) {
+                std::cout << "[DEV][RESPONSE] Ollama reply\n" << content << "\n";
+            }
+            promise->set_value(std::move(content));
+        } catch (...) {
+            if (auto logger = Logger::get_logger("core_logger")) {
+                logger->warn("Ollama chat request failed: {}", response.error.empty() ? "bad reply" : response.error);
+            }
+            promise->set_exception(std::current_exception());
+        }
+    }, std::move(cancel)});
+    return future;
+}
+
+std::future<std::string> OllamaClient::categorize_file_async(const std::string& file_name,
+                                                             const std::string& file_path,
+                                                             FileType file_type,
+                                                             const std::string& consistency_context,
+                                                             std::shared_ptr<LLMCancelToken> cancel)
+{
+    std::string payload = make_categorization_payload(file_name, file_path, file_type, consistency_context);
+    if (prompt_logging_enabled_ && !last_prompt_.empty()) {
+        std::cout << "\n[DEV][PROMPT] Categorization request\n" << last_prompt_ << "\n";
+    }
+    return send_chat_async(std::move(payload), true, std::move(cancel));
+}
+
+std::future<std::string> OllamaClient::complete_prompt_async(const std::string& prompt,
+                                                             int max_tokens,
+                                                             std::shared_ptr<LLMCancelToken> cancel)
+{
+    return send_chat_async(make_completion_payload(prompt, max_tokens), false, std::move(cancel));
+}
+
+std::string OllamaClient::categorize_file(const std::string& file_name,
+                                          const std::string& file_path,
+                                          FileType file_type,
+                                          const std::string& consistency_context)
+{
+    return categorize_file_async(file_name, file_path, file_type, consistency_context).get();
+}
+
+std::string OllamaClient::complete_prompt(const std::string& prompt, int max_tokens)
+{
+    return complete_prompt_async(prompt, max_tokens).get();
+}
@@ -1,298 +1,200 @@
 #include "OllamaCloudProvider.hpp"
+#include "HttpTransport.hpp"
+#include "JsonView.hpp"
+#include "Logger.hpp"
+#include "OllamaClient.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cctype>
 #include <stdexcept>
 
-OllamaCloudProvider::OllamaCloudProvider(std::string api_key, std::string base_url, std::string model)
-    : api_key(std::move(api_key)), 
-      base_url(std::move(base_url)), 
-      model(std::move(model))
-{
-}
+namespace {
 
-std::string OllamaCloudProvider::get_name() const
-{
-    return "Ollama Cloud";
-}
+constexpr long kHealthTimeoutSeconds = 3;
+constexpr long kListTimeoutSeconds = 10;
 
-ProviderHealth OllamaCloudProvider::check_health() const
+std::string trimmed_url(std::string url)
 {
-    // Stub implementation - health check not yet implemented
-    // Future PR will add actual health check via Ollama API
-    if (api_key.empty() || base_url.empty()) {
-        return ProviderHealth::Unavailable;
+    while (!url.empty() && url.back() == '/') {
+        url.pop_back();
     }
-    return ProviderHealth::Unknown;
+    return url;
 }
 
-std::vector<ModelInfo> OllamaCloudProvider::list_models() const
+HttpTransport::Response get_tags(const std::string& base_url, const std::string& api_key, long timeout_seconds)
 {
-    // Stub implementation - model listing not yet implemented
-    // Future PR will query Ollama API for available models
-    return {};
-}
-
-std::unique_ptr<ILLMClient> OllamaCloudProvider::create_client()
-{
-    // Stub implementation - client creation not yet implemented
-    // Future PR will implement OllamaCloudClient that uses Ollama API
-    throw std::runtime_error("Ollama Cloud provider is not yet fully implemented");
+    HttpTransport::Request request;
+    request.url = trimmed_url(base_url) + "/api/tags";
+    request.timeout_seconds = timeout_seconds;
+    request.follow_redirects = true;
+    if (!api_key.empty()) {
+        request.headers.push_back("Authorization: Bearer " + api_key);
+    }
+    return HttpTransport::shared().perform(request);
 }
 
-bool OllamaCloudProvider::requires_api_key() const
+bool is_success(const HttpTransport::Response& response)
 {
-    return true;
+    return response.ok() && response.status >= 200 && response.status < 300;
 }
 
-bool OllamaCloudProvider::supports_model_listing() const
+bool is_private_ipv4(const std::string& host)
 {
-    return true; // Will be implemented in future PR
-#include "Logger.hpp"
-#include <curl/curl.h>
-#ifdef _WIN32
-    #include <json/json.h>
-#elif __APPLE__
-    #include <json/json.h>
-#else
-    #include <jsoncpp/json/json.h>
-#endif
-#include <sstream>
-#include <cstdlib>
-
-namespace {
-
-size_t write_callback(void* contents, size_t size, size_t nmemb, std::string* response) {
-    size_t total = size * nmemb;
-    response->append(static_cast<const char*>(contents), total);
-    return total;
+    int octets[4] = {0, 0, 0, 0};
+    std::size_t index = 0;
+    std::size_t digits = 0;
+    for (char ch : host) {
+        if (ch == '.') {
+            if (digits == 0 || ++index > 3) {
+                return false;
+            }
+            digits = 0;
+        } else if (std::isdigit(static_cast<unsigned char>(ch)) && digits < 3) {
+            octets[index] = octets[index] * 10 + (ch - '0');
+            ++digits;
+        } else {
+            return false;
+        }
+    }
+    if (index != 3 || digits == 0) {
+        return false;
+    }
+    return octets[0] == 127 || octets[0] == 10 ||
+           (octets[0] == 192 && octets[1] == 168) ||
+           (octets[0] == 172 && octets[1] >= 16 && octets[1] <= 31);
 }
 
-}
+} // namespace
 
-OllamaCloudProvider::OllamaCloudProvider(std::string base_url)
-    : base_url_(std::move(base_url))
+OllamaCloudProvider::OllamaCloudProvider(std::string api_key, std::string base_url, std::string model)
+    : api_key(std::move(api_key)),
+      base_url(std::move(base_url)),
+      model(std::move(model))
 {
-    logger_ = Logger::get_logger("core_logger");
-    while (!base_url_.empty() && base_url_.back() == '/') {
-        base_url_.pop_back();
-    }
-}
-
-ProviderKind OllamaCloudProvider::kind() const {
-    return ProviderKind::OllamaCloud;
 }
 
-std::string OllamaCloudProvider::display_name() const {
+std::string OllamaCloudProvider::get_name() const
+{
     return "Ollama Cloud";
 }
 
-std::string OllamaCloudProvider::base_url() const {
-    return base_url_;
-}
-
-bool OllamaCloudProvider::requires_api_key() const {
-    return true;
-}
-
-bool OllamaCloudProvider::has_api_key() const {
-    return !resolve_api_key().empty();
-}
-
-void OllamaCloudProvider::set_timeout(int seconds) {
-    timeout_seconds_ = seconds;
-}
-
-void OllamaCloudProvider::set_api_key(const std::string& key) {
-    api_key_ = key;
-}
-
-std::optional<std::string> OllamaCloudProvider::get_api_key_from_env() {
-    const char* key = std::getenv("OLLAMA_API_KEY");
-    if (key && key[0] != '\0') {
-        return std::string(key);
+bool OllamaCloudProvider::is_local_endpoint(const std::string& base_url)
+{
+    std::string host = base_url;
+    if (const auto scheme = host.find("://"); scheme != std::string::npos) {
+        host.erase(0, scheme + 3);
     }
-    return std::nullopt;
-}
-
-std::string OllamaCloudProvider::resolve_api_key() const {
-    if (!api_key_.empty()) {
-        return api_key_;
+    host = host.substr(0, host.find_first_of("/?#"));
+    if (const auto at = host.rfind('@'); at != std::string::npos) {
+        host.erase(0, at + 1);
     }
-    auto env_key = get_api_key_from_env();
-    return env_key.value_or("");
-}
-
-std::string OllamaCloudProvider::perform_get(const std::string& endpoint, long& http_code) {
-    std::string response;
-    http_code = 0;
-
-    if (base_url_.empty()) {
-        if (logger_) {
-            logger_->error("Ollama Cloud base URL not configured");
-        }
-        return "";
+    if (!host.empty() && host.front() == '[') {
+        return host.substr(1, host.find(']') - 1) == "::1";
     }
-
-    std::string api_key = resolve_api_key();
-    if (api_key.empty()) {
-        if (logger_) {
-            logger_->error("Ollama Cloud API key not found (set OLLAMA_API_KEY environment variable)");
-        }
-        return "";
+    host = host.substr(0, host.find(':'));
+    std::transform(host.begin(), host.end(), host.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::tolower(ch));
+    });
+    if (host.empty()) {
+        return false;
     }
+    const auto ends_with = [&host](const std::string& suffix) {
+        return host.size() > suffix.size() && host.compare(host.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    return host == "localhost" || host.find('.') == std::string::npos ||
+           ends_with(".localhost") || ends_with(".local") || is_private_ipv4(host);
+}
 
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        if (logger_) {
-            logger_->error("Failed to initialize cURL for Ollama Cloud request");
-        }
-        return "";
+ProviderHealth OllamaCloudProvider::check_health() const
+{
+    if (base_url.empty() || (requires_api_key() && api_key.empty())) {
+        return ProviderHealth::Unavailable;
     }
-
-    std::string url = base_url_ + endpoint;
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, static_cast<long>(timeout_seconds_));
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-    std::string auth_header = "Authorization: Bearer " + api_key;
-    headers = curl_slist_append(headers, auth_header.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-    if (logger_) {
-        logger_->debug("Ollama Cloud GET {} (base: {})", endpoint, base_url_);
+    const auto response = get_tags(base_url, api_key, kHealthTimeoutSeconds);
+    if (is_success(response)) {
+        return ProviderHealth::Healthy;
     }
-
-    CURLcode res = curl_easy_perform(curl);
-    curl_slist_free_all(headers);
-
-    if (res != CURLE_OK) {
-        if (logger_) {
-            logger_->warn("Ollama Cloud request to {} failed: {}", url, curl_easy_strerror(res));
-        }
-        curl_easy_cleanup(curl);
-        return "";
+    if (auto logger = Logger::get_logger("core_logger")) {
+        logger->warn("Ollama health check at {} failed: {}", base_url,
+                     response.ok() ? "HTTP " + std::to_string(response.status) : response.error);
     }
-
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    curl_easy_cleanup(curl);
-
-    if (logger_) {
-        logger_->debug("Ollama Cloud GET {} returned HTTP {}", endpoint, http_code);
+    // The server answered, but refused or failed the request.
+    if (response.ok() && response.status != 401 && response.status != 403) {
+        return ProviderHealth::Degraded;
     }
-
-    return response;
+    return ProviderHealth::Unavailable;
 }
 
-std::vector<OllamaModel> OllamaCloudProvider::parse_tags_response(const std::string& json_body) {
-    std::vector<OllamaModel> models;
-
-    Json::CharReaderBuilder builder;
-    Json::Value root;
-    std::istringstream stream(json_body);
-    std::string errors;
-
-    if (!Json::parseFromStream(builder, stream, &root, &errors)) {
-        if (logger_) {
-            logger_->warn("Failed to parse Ollama Cloud tags response: {}", errors);
-        }
+std::vector<ModelInfo> OllamaCloudProvider::list_models() const
+{
+    std::vector<ModelInfo> models;
+    if (base_url.empty() || (requires_api_key() && api_key.empty())) {
         return models;
     }
-
-    const Json::Value& models_arr = root["models"];
-    if (!models_arr.isArray()) {
-        if (logger_) {
-            logger_->warn("Ollama Cloud tags response missing 'models' array");
+    const auto response = get_tags(base_url, api_key, kListTimeoutSeconds);
+    if (!is_success(response)) {
+        if (auto logger = Logger::get_logger("core_logger")) {
+            logger->warn("Listing Ollama models at {} failed: {}", base_url,
+                         response.ok() ? "HTTP " + std::to_string(response.status) : response.error);
         }
         return models;
     }
 
-    for (const auto& item : models_arr) {
-        OllamaModel m;
-        m.name = item["name"].asString();
-        m.digest = item.get("digest", "").asString();
-        m.size_bytes = item.get("size", 0ULL).asUInt64();
-
-        const Json::Value& details = item["details"];
-        if (details.isObject()) {
-            m.family = details.get("family", "").asString();
-            m.parameter_size = details.get("parameter_size", "").asString();
-            m.quantization_level = details.get("quantization_level", "").asString();
-        }
-
-        if (!m.name.empty()) {
-            models.push_back(std::move(m));
+    const JsonView root = JsonView::parse(response.body);
+    root["models"].for_each_element([&models](const JsonView& entry) {
+        ModelInfo info;
+        info.name = entry["name"].string_or("");
+        if (info.name.empty()) {
+            return;
         }
-    }
-
-    if (logger_) {
-        logger_->info("Parsed {} models from Ollama Cloud", models.size());
-    }
-
+        info.id = entry["model"].string_or(info.name);
+        const std::string parameters = entry["details"]["parameter_size"].string_or("");
+        const std::string quantization = entry["details"]["quantization_level"].string_or("");
+        info.description = parameters.empty() || quantization.empty() ? parameters + quantization
+                                                                      : parameters + ", " + quantization;
+        info.size_bytes = static_cast<std::size_t>(entry["size"].as_number().value_or(0));
+        models.push_back(std::move(info));
+    });
     return models;
 }
 
-HealthResult OllamaCloudProvider::check_health() {
-    if (base_url_.empty()) {
-        return HealthResult::error("Ollama Cloud base URL not configured", 0);
-    }
-
-    if (!has_api_key()) {
-        return HealthResult::error("OLLAMA_API_KEY environment variable not set", 0);
-    }
-
-    long http_code = 0;
-    std::string response = perform_get("/api/tags", http_code);
-
-    if (http_code == 0) {
-        return HealthResult::error("Connection failed - cannot reach " + base_url_, 0);
-    }
-
-    if (http_code == 401) {
-        return HealthResult::error("Authentication failed - check your OLLAMA_API_KEY", 401);
-    }
-
-    if (http_code == 403) {
-        return HealthResult::error("Access denied - API key may lack permissions", 403);
-    }
-
-    if (http_code >= 200 && http_code < 300) {
-        return HealthResult::success();
-    }
-
-    return HealthResult::error("Ollama Cloud returned HTTP " + std::to_string(http_code), static_cast<int>(http_code));
+void OllamaCloudProvider::set_keep_alive(std::string keep_alive)
+{
+    this->keep_alive = std::move(keep_alive);
 }
 
-ListModelsResult OllamaCloudProvider::list_models() {
-    if (base_url_.empty()) {
-        return ListModelsResult::error("Ollama Cloud base URL not configured");
-    }
+void OllamaCloudProvider::set_max_parallel(std::size_t max_parallel)
+{
+    this->max_parallel = max_parallel;
+}
 
-    if (!has_api_key()) {
-        return ListModelsResult::error("OLLAMA_API_KEY environment variable not set");
+std::unique_ptr<ILLMClient> OllamaCloudProvider::create_client()
+{
+    if (base_url.empty()) {
+        throw std::runtime_error("Ollama base URL is missing");
     }
-
-    long http_code = 0;
-    std::string response = perform_get("/api/tags", http_code);
-
-    if (http_code == 0) {
-        return ListModelsResult::error("Connection failed - cannot reach " + base_url_);
+    if (model.empty()) {
+        throw std::runtime_error("No Ollama model is selected");
     }
 
-    if (http_code == 401) {
-        return ListModelsResult::error("Authentication failed - check your OLLAMA_API_KEY");
+    auto client = std::make_unique<OllamaClient>(base_url, model, api_key);
+    if (!keep_alive.empty()) {
+        client->set_keep_alive(keep_alive);
     }
-
-    if (http_code == 403) {
-        return ListModelsResult::error("Access denied - API key may lack permissions");
+    if (max_parallel > 0) {
+        client->set_max_parallel(max_parallel);
     }
+    return client;
+}
 
-    if (http_code < 200 || http_code >= 300) {
-        return ListModelsResult::error("Ollama Cloud returned HTTP " + std::to_string(http_code));
-    }
+bool OllamaCloudProvider::requires_api_key() const
+{
+    return !is_local_endpoint(base_url);
+}
 
-    std::vector<OllamaModel> models = parse_tags_response(response);
-    return ListModelsResult::success(std::move(models));
+bool OllamaCloudProvider::supports_model_listing() const
+{
+    return true;
 }
@@ -0,0 +1,224 @@
+#include "OpenAIBatchClient.hpp"
+#include "HttpTransport.hpp"
+#include "JsonView.hpp"
+#include "JsonWriter.hpp"
+#include "Logger.hpp"
+#include "StreamingReply.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+constexpr long kDownloadTimeoutSeconds = 1800;
+
+// The returned view reads from response.body, so the response must outlive it.
+JsonView read_api_json(const HttpTransport::Response& response, const char* what)
+{
+    if (!response.ok()) {
+        throw std::runtime_error(std::string("Network Error: ") + what + ": " + response.error);
+    }
+    const JsonView root = JsonView::parse(response.body);
+    if (response.status >= 400) {
+        const std::string message = root.valid() ? root["error"]["message"].string_or("") : response.body;
+        throw std::runtime_error(std::string("Batch Error: ") + what + " failed (HTTP " +
+                                 std::to_string(response.status) + "): " + message);
+    }
+    if (!root.valid()) {
+        throw std::runtime_error(std::string("Response Error: ") + what + " returned invalid JSON");
+    }
+    return root;
+}
+
+int count_or_zero(const JsonView& counts, const char* key)
+{
+    return static_cast<int>(counts[key].as_number().value_or(0.0));
+}
+
+OpenAIBatchClient::BatchStatus to_status(const JsonView& root)
+{
+    OpenAIBatchClient::BatchStatus status;
+    status.id = root["id"].string_or("");
+    status.status = root["status"].string_or("");
+    status.output_file_id = root["output_file_id"].string_or("");
+    status.error_file_id = root["error_file_id"].string_or("");
+    const JsonView counts = root["request_counts"];
+    if (counts.is_object()) {
+        status.total = count_or_zero(counts, "total");
+        status.completed = count_or_zero(counts, "completed");
+        status.failed = count_or_zero(counts, "failed");
+    }
+    return status;
+}
+
+} // namespace
+
+bool OpenAIBatchClient::BatchStatus::finished() const
+{
+    return status == "completed" || status == "failed" || status == "expired" || status == "cancelled";
+}
+
+OpenAIBatchClient::OpenAIBatchClient(std::string api_key, std::string base_url)
+    : base_url_(std::move(base_url)),
+      api_key_(std::move(api_key))
+{
+    while (!base_url_.empty() && base_url_.back() == '/') {
+        base_url_.pop_back();
+    }
+}
+
+std::string OpenAIBatchClient::make_request_line(const std::string& custom_id, const std::string& body)
+{
+    // The body is checked and embedded verbatim rather than parsed and written back out.
+    const JsonView parsed_body = JsonView::parse(body);
+    if (!parsed_body.is_object()) {
+        throw std::runtime_error("Batch request body for '" + custom_id + "' is not valid JSON");
+    }
+    std::string line;
+    line.reserve(body.size() + custom_id.size() + 80);
+    JsonWriter json(line);
+    json.begin_object()
+        .key("custom_id").value(custom_id)
+        .key("method").value("POST")
+        .key("url").value(kChatEndpoint)
+        .key("body").raw(parsed_body.raw())
+        .end_object();
+    return line;
+}
+
+std::optional<OpenAIBatchClient::ResultLine> OpenAIBatchClient::parse_result_line(const std::string& line)
+{
+    const JsonView root = JsonView::parse(line);
+    if (!root.is_object()) {
+        return std::nullopt;
+    }
+
+    ResultLine result;
+    result.custom_id = root["custom_id"].string_or("");
+    if (result.custom_id.empty()) {
+        return std::nullopt;
+    }
+    const JsonView response = root["response"];
+    if (response.is_object()) {
+        result.status_code = static_cast<int>(response["status_code"].as_number().value_or(0.0));
+        const JsonView body = response["body"];
+        if (result.status_code == 200) {
+            result.content = body["choices"][0]["message"]["content"].string_or("");
+        } else if (body.is_object()) {
+            result.error = body["error"]["message"].string_or("");
+        }
+    }
+    if (root["error"].is_object()) {
+        result.error = root["error"]["message"].string_or("");
+    }
+    return result;
+}
+
+std::string OpenAIBatchClient::upload_batch_file(const std::string& jsonl, const std::string& file_name)
+{
+    const std::string boundary = "aifs-" + std::to_string(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+
+    std::string body;
+    body.reserve(jsonl.size() + 512);
+    body += "--" + boundary + "\r\n";
+    body += "Content-Disposition: form-data; name=\"purpose\"\r\n\r\nbatch\r\n";
+    body += "--" + boundary + "\r\n";
+    body += "Content-Disposition: form-data; name=\"file\"; filename=\"" + file_name + "\"\r\n";
+    body += "Content-Type: application/jsonl\r\n\r\n";
+    body += jsonl;
+    body += "\r\n--" + boundary + "--\r\n";
+
+    HttpTransport::Request request;
+    request.method = HttpTransport::Method::Post;
+    request.url = base_url_ + "/files";
+    request.headers = {"Authorization: Bearer " + api_key_,
+                       "Content-Type: multipart/form-data; boundary=" + boundary};
+    request.body = std::move(body);
+    request.timeout_seconds = kDownloadTimeoutSeconds;
+
+    if (auto logger = Logger::get_logger("core_logger")) {
+        logger->info("Uploading batch input '{}' ({} bytes)", file_name, jsonl.size());
+    }
+    const auto response = HttpTransport::shared().perform(request);
+    const std::string file_id = read_api_json(response, "File upload")["id"].string_or("");
+    if (file_id.empty()) {
+        throw std::runtime_error("Response Error: File upload returned no file id");
+    }
+    return file_id;
+}
+
+OpenAIBatchClient::BatchStatus OpenAIBatchClient::create_batch(const std::string& input_file_id)
+{
+    std::string payload;
+    JsonWriter(payload).begin_object()
+        .key("input_file_id").value(input_file_id)
+        .key("endpoint").value(kChatEndpoint)
+        .key("completion_window").value("24h")
+        .end_object();
+
+    HttpTransport::Request request;
+    request.method = HttpTransport::Method::Post;
+    request.url = base_url_ + "/batches";
+    request.headers = {"Content-Type: application/json", "Authorization: Bearer " + api_key_};
+    request.body = std::move(payload);
+    request.timeout_seconds = timeout_seconds_;
+
+    const auto response = HttpTransport::shared().perform(request);
+    return to_status(read_api_json(response, "Batch creation"));
+}
+
+OpenAIBatchClient::BatchStatus OpenAIBatchClient::get_batch(const std::string& batch_id)
+{
+    HttpTransport::Request request;
+    request.url = base_url_ + "/batches/" + batch_id;
+    request.headers = {"Authorization: Bearer " + api_key_};
+    request.timeout_seconds = timeout_seconds_;
+
+    const auto response = HttpTransport::shared().perform(request);
+    return to_status(read_api_json(response, "Batch status"));
+}
+
+OpenAIBatchClient::BatchStatus OpenAIBatchClient::cancel_batch(const std::string& batch_id)
+{
+    HttpTransport::Request request;
+    request.method = HttpTransport::Method::Post;
+    request.url = base_url_ + "/batches/" + batch_id + "/cancel";
+    request.headers = {"Authorization: Bearer " + api_key_};
+    request.timeout_seconds = timeout_seconds_;
+
+    const auto response = HttpTransport::shared().perform(request);
+    return to_status(read_api_json(response, "Batch cancellation"));
+}
+
+void OpenAIBatchClient::download_lines(const std::string& file_id,
+                                       const std::function<void(const std::string&)>& on_line)
+{
+    LineBuffer lines;
+    const LineBuffer::LineCallback forward = [&on_line](std::string_view line) {
+        if (!line.empty()) {
+            on_line(std::string(line));
+        }
+        return true;
+    };
+
+    HttpTransport::Request request;
+    request.url = base_url_ + "/files/" + file_id + "/content";
+    request.headers = {"Authorization: Bearer " + api_key_};
+    request.timeout_seconds = kDownloadTimeoutSeconds;
+    request.follow_redirects = true;
+    request.on_data = [&](std::string_view chunk) { return lines.feed(chunk, forward); };
+
+    const auto response = HttpTransport::shared().perform(request);
+    if (!response.ok()) {
+        throw std::runtime_error("Network Error: Result download: " + response.error);
+    }
+    if (response.status >= 400) {
+        const JsonView root = JsonView::parse(response.body);
+        const std::string message = root.valid() ? root["error"]["message"].string_or("") : response.body;
+        throw std::runtime_error("Batch Error: Result download failed (HTTP " +
+                                 std::to_string(response.status) + "): " + message);
+    }
+    lines.finish(forward);
+}
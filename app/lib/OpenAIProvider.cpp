@@ -7,6 +7,11 @@ OpenAIProvider::OpenAIProvider(std::string api_key, std::string model)
 {
 }
 
+void OpenAIProvider::set_request_logprobs(bool enabled)
+{
+    request_logprobs = enabled;
+}
+
 std::string OpenAIProvider::get_name() const
 {
     return "OpenAI";
@@ -36,7 +41,9 @@ std::unique_ptr<ILLMClient> OpenAIProvider::create_client()
     }
     
     CategorizationSession session(api_key, model);
-    return std::make_unique<LLMClient>(session.create_llm_client());
+    auto client = std::make_unique<LLMClient>(session.create_llm_client());
+    client->set_request_logprobs(request_logprobs);
+    return client;
 }
 
 bool OpenAIProvider::requires_api_key() const
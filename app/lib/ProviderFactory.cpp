@@ -42,9 +42,17 @@ std::unique_ptr<IProvider> ProviderFactory::create_provider_from_settings(const
         }
 
         case LLMChoice::OllamaCloud: {
-            // Stub: In future PR, read Ollama config from settings
-            // For now, return nullptr as it's not yet fully implemented
-            return nullptr;
+            std::string api_key = settings.get_ollama_api_key();
+            if (api_key.empty()) {
+                if (const char* env_key = std::getenv("OLLAMA_API_KEY")) {
+                    api_key = env_key;
+                }
+            }
+            auto provider = std::make_unique<OllamaCloudProvider>(
+                api_key, settings.get_ollama_base_url(), settings.get_ollama_model());
+            provider->set_keep_alive(settings.get_ollama_keep_alive());
+            provider->set_max_parallel(static_cast<std::size_t>(settings.get_ollama_max_parallel()));
+            return provider;
         }
 
         case LLMChoice::Unset:
@@ -0,0 +1,151 @@
+#include "ProviderHealthMonitor.hpp"
+
+#include "Logger.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <exception>
+
+CircuitBreaker::CircuitBreaker(std::size_t failure_threshold, std::chrono::milliseconds cooldown)
+    : failure_threshold_(failure_threshold > 0 ? failure_threshold : 1),
+      cooldown_(cooldown)
+{
+}
+
+bool CircuitBreaker::allow(Clock::time_point now)
+{
+    switch (state_) {
+        case State::Closed:
+            return true;
+        case State::Open:
+            if (now - opened_at_ < cooldown_) {
+                return false;
+            }
+            state_ = State::HalfOpen;
+            trial_in_flight_ = true;
+            return true;
+        case State::HalfOpen:
+            if (trial_in_flight_) {
+                return false;
+            }
+            trial_in_flight_ = true;
+            return true;
+    }
+    return true;
+}
+
+void CircuitBreaker::record_success()
+{
+    consecutive_failures_ = 0;
+    state_ = State::Closed;
+    trial_in_flight_ = false;
+}
+
+void CircuitBreaker::record_failure(Clock::time_point now)
+{
+    ++consecutive_failures_;
+    trial_in_flight_ = false;
+    if (state_ == State::HalfOpen || consecutive_failures_ >= failure_threshold_) {
+        state_ = State::Open;
+        opened_at_ = now;
+    }
+}
+
+CircuitBreaker::State CircuitBreaker::state() const
+{
+    return state_;
+}
+
+ProviderHealthMonitor::ProviderHealthMonitor(std::chrono::milliseconds ttl)
+    : ttl_(ttl),
+      worker_([this]() { run(); })
+{
+}
+
+ProviderHealthMonitor::~ProviderHealthMonitor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    worker_.join();
+}
+
+void ProviderHealthMonitor::watch(const std::string& name, Probe probe)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& entry = entries_[name];
+        entry.probe = std::move(probe);
+        entry.next_check = Clock::time_point{};
+    }
+    wake_.notify_all();
+}
+
+ProviderHealth ProviderHealthMonitor::status(const std::string& name) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = entries_.find(name);
+    return it == entries_.end() ? ProviderHealth::Unknown : it->second.status;
+}
+
+void ProviderHealthMonitor::invalidate(const std::string& name)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = entries_.find(name);
+        if (it == entries_.end()) {
+            return;
+        }
+        it->second.next_check = Clock::time_point{};
+    }
+    wake_.notify_all();
+}
+
+void ProviderHealthMonitor::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        auto due = entries_.end();
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (due == entries_.end() || it->second.next_check < due->second.next_check) {
+                due = it;
+            }
+        }
+        if (due == entries_.end()) {
+            wake_.wait(lock);
+            continue;
+        }
+        if (due->second.next_check > Clock::now()) {
+            wake_.wait_until(lock, due->second.next_check);
+            continue;
+        }
+
+        // Entries are never erased, so the iterator stays valid while the probe runs unlocked.
+        const std::string name = due->first;
+        const Probe probe = due->second.probe;
+        due->second.next_check = Clock::now() + ttl_;
+        lock.unlock();
+
+        ProviderHealth health = ProviderHealth::Unavailable;
+        try {
+            health = probe();
+        } catch (const std::exception& ex) {
+            if (auto logger = Logger::get_logger("core_logger")) {
+                logger->warn("Health check for '{}' failed: {}", name, ex.what());
+            }
+        }
+
+        lock.lock();
+        if (due->second.status != health) {
+            if (auto logger = Logger::get_logger("core_logger")) {
+                logger->info("Provider '{}' is now {}", name,
+                             health == ProviderHealth::Healthy       ? "healthy"
+                             : health == ProviderHealth::Unavailable ? "unavailable"
+                                                                     : "degraded");
+            }
+        }
+        due->second.status = health;
+    }
+}
@@ -0,0 +1,274 @@
+#include "ProviderRouter.hpp"
+
+#include "LLMClient.hpp"
+#include "Logger.hpp"
+
+#include <spdlog/spdlog.h>
+#include <fmt/format.h>
+
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+
+bool has_text(std::string_view text)
+{
+    return text.find_first_not_of(" \t\r\n") != std::string_view::npos;
+}
+
+// Readable reply: its confidence when it carries one, 1.0 when it does not.
+std::optional<double> reply_confidence(const std::string& reply)
+{
+    if (const auto structured = LLMClient::parse_category_reply(reply)) {
+        if (!has_text(structured->category)) {
+            return std::nullopt;
+        }
+        return structured->confidence.value_or(1.0);
+    }
+    const std::size_t colon = reply.find(':');
+    if (colon == std::string::npos || !has_text(std::string_view(reply).substr(0, colon)) ||
+        !has_text(std::string_view(reply).substr(colon + 1))) {
+        return std::nullopt;
+    }
+    return 1.0;
+}
+
+} // namespace
+
+ProviderRouter::ProviderRouter(double min_confidence)
+    : min_confidence_(min_confidence)
+{
+}
+
+ProviderRouter::~ProviderRouter()
+{
+    std::size_t requests = 0;
+    for (const auto& route : stats()) {
+        requests += route.requests;
+    }
+    if (requests == 0) {
+        return;
+    }
+    if (auto logger = Logger::get_logger("core_logger")) {
+        logger->info("Cascade routing stats:\n{}", format_stats());
+    }
+}
+
+void ProviderRouter::add_route(std::string name,
+                               std::unique_ptr<IProvider> provider,
+                               bool remote,
+                               ProviderHealthMonitor::Probe probe)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (probe) {
+        if (!monitor_) {
+            monitor_ = std::make_unique<ProviderHealthMonitor>(kHealthCheckInterval);
+        }
+        monitor_->watch(name, std::move(probe));
+    }
+    Route route;
+    route.provider = std::move(provider);
+    route.stats.name = std::move(name);
+    route.stats.remote = remote;
+    routes_.push_back(std::move(route));
+}
+
+std::size_t ProviderRouter::route_count() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return routes_.size();
+}
+
+bool ProviderRouter::accepts(const std::string& reply, double min_confidence)
+{
+    const auto confidence = reply_confidence(reply);
+    return confidence && *confidence >= min_confidence;
+}
+
+ILLMClient* ProviderRouter::client_for(Route& route)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (route.unavailable) {
+        return nullptr;
+    }
+    const bool down = monitor_ && monitor_->status(route.stats.name) == ProviderHealth::Unavailable;
+    if (down || !route.breaker.allow()) {
+        ++route.stats.skipped;
+        return nullptr;
+    }
+    if (route.client) {
+        return route.client.get();
+    }
+    try {
+        route.client = route.provider->create_client();
+        route.client->set_prompt_logging_enabled(prompt_logging_enabled_);
+    } catch (const std::exception& ex) {
+        route.unavailable = true;
+        if (auto logger = Logger::get_logger("core_logger")) {
+            logger->warn("Skipping route '{}' for this run: {}", route.stats.name, ex.what());
+        }
+    }
+    return route.client.get();
+}
+
+std::string ProviderRouter::categorize_file(const std::string& file_name,
+                                            const std::string& file_path,
+                                            FileType file_type,
+                                            const std::string& consistency_context)
+{
+    auto logger = Logger::get_logger("core_logger");
+    std::optional<std::string> best;
+    double best_confidence = -1.0;
+    std::exception_ptr last_error;
+
+    for (std::size_t index = 0; index < routes_.size(); ++index) {
+        Route& route = routes_[index];
+        ILLMClient* client = client_for(route);
+        if (!client) {
+            continue;
+        }
+
+        const auto started = std::chrono::steady_clock::now();
+        std::string reply;
+        bool failed = false;
+        try {
+            reply = client->categorize_file(file_name, file_path, file_type, consistency_context);
+        } catch (const std::exception& ex) {
+            failed = true;
+            last_error = std::current_exception();
+            if (logger) {
+                logger->warn("Route '{}' failed for '{}': {}", route.stats.name, file_name, ex.what());
+            }
+        }
+        const auto elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+
+        const auto confidence = failed ? std::nullopt : reply_confidence(reply);
+        const bool accepted = confidence && *confidence >= min_confidence_;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            record_request(route, elapsed, failed);
+            if (!failed) {
+                ++(accepted ? route.stats.accepted : route.stats.escalated);
+            }
+        }
+
+        if (accepted) {
+            return reply;
+        }
+        if (failed) {
+            continue;
+        }
+        if (logger) {
+            logger->debug("Escalating '{}' past route '{}' ({})", file_name, route.stats.name,
+                          confidence ? fmt::format("confidence {:.2f}", *confidence) : std::string("unreadable reply"));
+        }
+        // Keep the most confident readable answer in case no route is sure enough.
+        const double rank = confidence.value_or(-0.5);
+        if (!best || rank > best_confidence) {
+            best = std::move(reply);
+            best_confidence = rank;
+        }
+    }
+
+    if (best) {
+        return *best;
+    }
+    if (last_error) {
+        std::rethrow_exception(last_error);
+    }
+    throw std::runtime_error("No categorization route is available.");
+}
+
+std::string ProviderRouter::complete_prompt(const std::string& prompt, int max_tokens)
+{
+    auto logger = Logger::get_logger("core_logger");
+    std::exception_ptr last_error;
+
+    // Strongest route first; a failure falls back to the next one down.
+    for (auto it = routes_.rbegin(); it != routes_.rend(); ++it) {
+        Route& route = *it;
+        ILLMClient* client = client_for(route);
+        if (!client) {
+            continue;
+        }
+
+        const auto started = std::chrono::steady_clock::now();
+        std::string reply;
+        bool failed = false;
+        try {
+            reply = client->complete_prompt(prompt, max_tokens);
+        } catch (const std::exception& ex) {
+            failed = true;
+            last_error = std::current_exception();
+            if (logger) {
+                logger->warn("Route '{}' failed to complete a prompt: {}", route.stats.name, ex.what());
+            }
+        }
+        const auto elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            record_request(route, elapsed, failed);
+        }
+        if (!failed) {
+            return reply;
+        }
+    }
+
+    if (last_error) {
+        std::rethrow_exception(last_error);
+    }
+    throw std::runtime_error("No categorization route is available.");
+}
+
+void ProviderRouter::record_request(Route& route, std::chrono::milliseconds elapsed, bool failed)
+{
+    ++route.stats.requests;
+    route.stats.total_latency += elapsed;
+    if (failed) {
+        ++route.stats.failed;
+        route.breaker.record_failure();
+        if (monitor_) {
+            monitor_->invalidate(route.stats.name);
+        }
+    } else {
+        route.breaker.record_success();
+    }
+}
+
+void ProviderRouter::set_prompt_logging_enabled(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    prompt_logging_enabled_ = enabled;
+    for (auto& route : routes_) {
+        if (route.client) {
+            route.client->set_prompt_logging_enabled(enabled);
+        }
+    }
+}
+
+std::vector<ProviderRouter::RouteStats> ProviderRouter::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<RouteStats> result;
+    result.reserve(routes_.size());
+    for (const auto& route : routes_) {
+        result.push_back(route.stats);
+    }
+    return result;
+}
+
+std::string ProviderRouter::format_stats() const
+{
+    std::string out;
+    for (const auto& route : stats()) {
+        const auto mean = route.requests > 0 ? route.total_latency.count() / static_cast<long long>(route.requests) : 0;
+        out += fmt::format("{}{}: {} request(s), {} accepted, {} escalated, {} failed, {} skipped, {} ms mean\n",
+                           route.name, route.remote ? " (remote)" : "", route.requests,
+                           route.accepted, route.escalated, route.failed, route.skipped, mean);
+    }
+    return out;
+}
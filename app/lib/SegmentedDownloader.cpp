@@ -0,0 +1,547 @@
+#include "SegmentedDownloader.hpp"
+
+#include "Logger.hpp"
+
+#include <curl/curl.h>
+#include <openssl/evp.h>
+#include <spdlog/spdlog.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <fcntl.h>
+#endif
+
+struct SegmentedDownloader::SegmentState {
+    std::size_t index{0};
+    long long begin{0};
+    long long end{0};
+    std::atomic<long long> done{0};
+    std::atomic<bool> finished{false};
+    std::string error;
+    // Transfer-local; only touched by the thread fetching this segment.
+    FILE* file{nullptr};
+    CURL* curl{nullptr};
+    const std::atomic<bool>* cancel{nullptr};
+    bool checked_status{false};
+    std::string write_error;
+};
+
+namespace {
+
+constexpr const char* kSidecarMagic = "aifs-segments 1";
+constexpr std::size_t kHashBlockBytes = 1 << 20;
+constexpr auto kStateSaveInterval = std::chrono::seconds(1);
+constexpr auto kPollInterval = std::chrono::milliseconds(100);
+
+int seek_to(FILE* file, long long offset)
+{
+#ifdef _WIN32
+    return _fseeki64(file, offset, SEEK_SET);
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET);
+#endif
+}
+
+struct FileCloser {
+    void operator()(FILE* file) const
+    {
+        if (file) {
+            std::fclose(file);
+        }
+    }
+};
+using FilePtr = std::unique_ptr<FILE, FileCloser>;
+
+struct DigestDeleter {
+    void operator()(EVP_MD_CTX* context) const { EVP_MD_CTX_free(context); }
+};
+using DigestPtr = std::unique_ptr<EVP_MD_CTX, DigestDeleter>;
+
+DigestPtr new_sha256()
+{
+    DigestPtr context(EVP_MD_CTX_new());
+    if (!context || EVP_DigestInit_ex(context.get(), EVP_sha256(), nullptr) != 1) {
+        throw std::runtime_error("Failed to initialize SHA-256");
+    }
+    return context;
+}
+
+std::string finish_sha256(EVP_MD_CTX* context)
+{
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    if (EVP_DigestFinal_ex(context, digest, &length) != 1) {
+        throw std::runtime_error("Failed to finalize SHA-256");
+    }
+    std::string hex;
+    hex.reserve(length * 2);
+    for (unsigned int index = 0; index < length; ++index) {
+        hex += fmt::format("{:02x}", digest[index]);
+    }
+    return hex;
+}
+
+// Hashes `file` from `hashed` up to `limit`, reading what the segments have already written.
+void hash_range(EVP_MD_CTX* context, FILE* file, long long& hashed, long long limit)
+{
+    if (hashed >= limit) {
+        return;
+    }
+    std::vector<char> buffer(kHashBlockBytes);
+    if (seek_to(file, hashed) != 0) {
+        throw std::runtime_error("Failed to read back the download for verification");
+    }
+    while (hashed < limit) {
+        const auto wanted = static_cast<std::size_t>(std::min<long long>(limit - hashed, kHashBlockBytes));
+        const std::size_t read = std::fread(buffer.data(), 1, wanted, file);
+        if (read == 0) {
+            throw std::runtime_error("Failed to read back the download for verification");
+        }
+        EVP_DigestUpdate(context, buffer.data(), read);
+        hashed += static_cast<long long>(read);
+    }
+}
+
+// Pushes what the segments wrote to the disk, so the sidecar never claims bytes a crash could lose.
+bool sync_to_disk(FILE* file)
+{
+    if (std::fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return ::fsync(fileno(file)) == 0;
+#endif
+}
+
+// Stops and joins the segment threads on every way out of run(), exceptions included.
+class WorkerJoiner {
+public:
+    WorkerJoiner(std::vector<std::thread>& workers, std::atomic<bool>& stop)
+        : workers_(workers), stop_(stop)
+    {
+    }
+    ~WorkerJoiner()
+    {
+        stop_ = true;
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+    WorkerJoiner(const WorkerJoiner&) = delete;
+    WorkerJoiner& operator=(const WorkerJoiner&) = delete;
+
+private:
+    std::vector<std::thread>& workers_;
+    std::atomic<bool>& stop_;
+};
+
+void log_warning(const std::string& message)
+{
+    if (auto logger = Logger::get_logger("core_logger")) {
+        logger->warn("{}", message);
+    }
+}
+
+size_t write_segment(char* data, size_t size, size_t count, void* userdata)
+{
+    auto* state = static_cast<SegmentedDownloader::SegmentState*>(userdata);
+    const size_t bytes = size * count;
+
+    if (!state->checked_status) {
+        state->checked_status = true;
+        long status = 0;
+        curl_easy_getinfo(state->curl, CURLINFO_RESPONSE_CODE, &status);
+        // A server that ignores Range sends the whole file; that is only usable from the start.
+        const bool whole_file = state->begin == 0 && state->done.load() == 0;
+        if (status != 206 && !(status == 200 && whole_file)) {
+            state->write_error = fmt::format("server answered a range request with HTTP {}", status);
+            return 0;
+        }
+    }
+
+    const long long room = state->end - state->begin - state->done.load();
+    if (static_cast<long long>(bytes) > room) {
+        state->write_error = "server sent more data than requested";
+        return 0;
+    }
+    if (std::fwrite(data, 1, bytes, state->file) != bytes) {
+        state->write_error = "failed to write to the download file";
+        return 0;
+    }
+    state->done += static_cast<long long>(bytes);
+    return bytes;
+}
+
+int segment_progress(void* userdata, curl_off_t, curl_off_t, curl_off_t, curl_off_t)
+{
+    const auto* state = static_cast<SegmentedDownloader::SegmentState*>(userdata);
+    return state->cancel->load(std::memory_order_relaxed) ? 1 : 0;
+}
+
+} // namespace
+
+SegmentedDownloader::SegmentedDownloader(std::string url, std::string destination, Options options)
+    : url_(std::move(url)),
+      destination_(std::move(destination)),
+      options_(std::move(options))
+{
+}
+
+void SegmentedDownloader::set_curl_setup(CurlSetup setup)
+{
+    curl_setup_ = std::move(setup);
+}
+
+std::vector<SegmentedDownloader::Segment> SegmentedDownloader::plan_segments(long long total_size,
+                                                                            std::size_t segments,
+                                                                            long long min_segment_bytes)
+{
+    std::vector<Segment> planned;
+    if (total_size <= 0) {
+        return planned;
+    }
+    const long long by_size = min_segment_bytes > 0 ? total_size / min_segment_bytes : total_size;
+    const long long count = std::clamp<long long>(by_size, 1, static_cast<long long>(std::max<std::size_t>(segments, 1)));
+    const long long size = total_size / count;
+    for (long long index = 0; index < count; ++index) {
+        const long long begin = index * size;
+        planned.push_back(Segment{begin, index + 1 == count ? total_size : begin + size, 0});
+    }
+    return planned;
+}
+
+std::string SegmentedDownloader::sidecar_path(const std::string& destination)
+{
+    return destination + ".parts";
+}
+
+bool SegmentedDownloader::has_partial_download(const std::string& destination)
+{
+    std::error_code ec;
+    return std::filesystem::exists(sidecar_path(destination), ec);
+}
+
+std::string SegmentedDownloader::sha256_file(const std::string& path)
+{
+    FilePtr file(std::fopen(path.c_str(), "rb"));
+    if (!file) {
+        throw std::runtime_error("Failed to open " + path);
+    }
+    auto context = new_sha256();
+    std::vector<char> buffer(kHashBlockBytes);
+    while (const std::size_t read = std::fread(buffer.data(), 1, buffer.size(), file.get())) {
+        EVP_DigestUpdate(context.get(), buffer.data(), read);
+    }
+    return finish_sha256(context.get());
+}
+
+std::vector<SegmentedDownloader::Segment> SegmentedDownloader::load_or_plan(long long total_size) const
+{
+    const auto fresh = plan_segments(total_size, options_.segments, options_.min_segment_bytes);
+
+    std::ifstream in(sidecar_path(destination_));
+    std::string magic;
+    std::string url;
+    long long saved_total = 0;
+    if (!in || !std::getline(in, magic) || magic != kSidecarMagic ||
+        !(in >> saved_total) || !std::getline(in >> std::ws, url) ||
+        saved_total != total_size || url != url_) {
+        return fresh;
+    }
+
+    std::error_code ec;
+    if (static_cast<long long>(std::filesystem::file_size(destination_, ec)) != total_size || ec) {
+        return fresh;
+    }
+
+    std::vector<Segment> saved;
+    long long expected_begin = 0;
+    for (Segment segment; in >> segment.begin >> segment.end >> segment.done;) {
+        if (segment.begin != expected_begin || segment.end <= segment.begin ||
+            segment.done < 0 || segment.done > segment.end - segment.begin) {
+            return fresh;
+        }
+        expected_begin = segment.end;
+        saved.push_back(segment);
+    }
+    return expected_begin == total_size ? saved : fresh;
+}
+
+void SegmentedDownloader::save_state(const std::vector<Segment>& segments, long long total_size) const
+{
+    const std::string path = sidecar_path(destination_);
+    const std::string temp = path + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::trunc);
+        out << kSidecarMagic << '\n' << total_size << ' ' << url_ << '\n';
+        for (const auto& segment : segments) {
+            out << segment.begin << ' ' << segment.end << ' ' << segment.done << '\n';
+        }
+        if (!out) {
+            log_warning("Could not save download progress to " + temp);
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, path, ec);
+    if (ec) {
+        log_warning(fmt::format("Could not save download progress to {}: {}", path, ec.message()));
+    }
+}
+
+void SegmentedDownloader::prepare_file(long long total_size, bool fresh) const
+{
+    if (!fresh) {
+        return;
+    }
+    std::filesystem::create_directories(std::filesystem::path(destination_).parent_path());
+    {
+        std::ofstream create(destination_, std::ios::binary | std::ios::trunc);
+        if (!create) {
+            throw std::runtime_error("Failed to open file: " + destination_);
+        }
+    }
+    std::filesystem::resize_file(destination_, static_cast<std::uintmax_t>(total_size));
+#ifdef __linux__
+    // Reserve the blocks now so a full disk fails here instead of in the middle of a segment.
+    const int fd = ::open(destination_.c_str(), O_RDWR);
+    if (fd >= 0) {
+        const int result = ::posix_fallocate(fd, 0, static_cast<off_t>(total_size));
+        ::close(fd);
+        if (result == ENOSPC) {
+            throw std::runtime_error("Not enough disk space for " + destination_);
+        }
+    }
+#endif
+}
+
+bool SegmentedDownloader::fetch_segment(SegmentState& state,
+                                        const std::atomic<bool>& cancel,
+                                        std::string& error) const
+{
+    FilePtr file(std::fopen(destination_.c_str(), "r+b"));
+    if (!file) {
+        error = "failed to open " + destination_;
+        return false;
+    }
+    // Unbuffered, so bytes counted as done are visible to the hashing reader straight away.
+    std::setvbuf(file.get(), nullptr, _IONBF, 0);
+    if (seek_to(file.get(), state.begin + state.done.load()) != 0) {
+        error = "failed to seek in " + destination_;
+        return false;
+    }
+
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        error = "failed to initialize curl";
+        return false;
+    }
+    state.file = file.get();
+    state.curl = curl;
+    state.cancel = &cancel;
+    state.checked_status = false;
+    state.write_error.clear();
+
+    const std::string range = fmt::format("{}-{}", state.begin + state.done.load(), state.end - 1);
+    if (curl_setup_) {
+        curl_setup_(curl);
+    }
+    curl_easy_setopt(curl, CURLOPT_URL, url_.c_str());
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+    curl_easy_setopt(curl, CURLOPT_RANGE, range.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &write_segment);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &state);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, &segment_progress);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &state);
+    // A stalled connection is retried rather than waited on forever.
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1024L);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, 30L);
+
+    const CURLcode result = curl_easy_perform(curl);
+    curl_easy_cleanup(curl);
+    state.curl = nullptr;
+    state.file = nullptr;
+
+    if (result == CURLE_OK && state.done.load() == state.end - state.begin) {
+        return true;
+    }
+    if (result == CURLE_OK) {
+        error = "connection closed before the segment was complete";
+    } else if (!state.write_error.empty()) {
+        error = state.write_error;
+    } else {
+        error = curl_easy_strerror(result);
+    }
+    return false;
+}
+
+bool SegmentedDownloader::run(long long total_size, const ProgressCallback& progress, const std::atomic<bool>& cancel)
+{
+    if (total_size <= 0) {
+        throw std::runtime_error("Segmented download needs the file size");
+    }
+
+    std::vector<Segment> segments = load_or_plan(total_size);
+    const bool fresh = std::all_of(segments.begin(), segments.end(), [](const Segment& s) { return s.done == 0; });
+    prepare_file(total_size, fresh);
+    save_state(segments, total_size);
+
+    std::vector<std::unique_ptr<SegmentState>> states;
+    for (std::size_t index = 0; index < segments.size(); ++index) {
+        auto state = std::make_unique<SegmentState>();
+        state->index = index;
+        state->begin = segments[index].begin;
+        state->end = segments[index].end;
+        state->done = segments[index].done;
+        state->finished = segments[index].remaining() == 0;
+        states.push_back(std::move(state));
+    }
+
+    DigestPtr digest;
+    FilePtr reader;
+    long long hashed = 0;
+    if (!options_.expected_sha256.empty()) {
+        digest = new_sha256();
+        reader.reset(std::fopen(destination_.c_str(), "rb"));
+        if (!reader) {
+            throw std::runtime_error("Failed to open file: " + destination_);
+        }
+    }
+    FilePtr data(std::fopen(destination_.c_str(), "r+b"));
+    if (!data) {
+        throw std::runtime_error("Failed to open file: " + destination_);
+    }
+
+    // Set when the caller cancels or run() leaves early; the transfers check it between writes.
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> workers;
+    WorkerJoiner joiner(workers, stop);
+    for (auto& state : states) {
+        if (state->finished) {
+            continue;
+        }
+        workers.emplace_back([this, &stop, state = state.get()]() {
+            try {
+                for (int attempt = 1; attempt <= options_.max_attempts && !stop.load(); ++attempt) {
+                    std::string error;
+                    if (fetch_segment(*state, stop, error)) {
+                        break;
+                    }
+                    if (stop.load()) {
+                        break;
+                    }
+                    state->error = error;
+                    log_warning(fmt::format("Download segment {} attempt {} failed: {}", state->index + 1, attempt, error));
+                }
+            } catch (const std::exception& ex) {
+                state->error = ex.what();
+            } catch (...) {
+                state->error = "unknown error";
+            }
+            state->finished = true;
+        });
+    }
+
+    const auto snapshot = [&]() {
+        long long downloaded = 0;
+        for (std::size_t index = 0; index < states.size(); ++index) {
+            segments[index].done = states[index]->done.load();
+            downloaded += segments[index].done;
+        }
+        return downloaded;
+    };
+    // Saves the progress of the last snapshot once the bytes it counts are on the disk.
+    const auto checkpoint = [&]() {
+        if (sync_to_disk(data.get())) {
+            save_state(segments, total_size);
+        } else {
+            log_warning("Could not flush " + destination_ + "; keeping the previous download progress");
+        }
+    };
+    // End of the part of the file every segment before it has finished.
+    const auto contiguous_end = [&]() {
+        for (const auto& state : states) {
+            if (state->done.load() < state->end - state->begin) {
+                return state->begin + state->done.load();
+            }
+        }
+        return total_size;
+    };
+
+    auto last_save = std::chrono::steady_clock::now();
+    while (!std::all_of(states.begin(), states.end(), [](const auto& s) { return s->finished.load(); })) {
+        std::this_thread::sleep_for(kPollInterval);
+        if (cancel.load()) {
+            stop = true;
+        }
+        const long long downloaded = snapshot();
+        if (progress) {
+            progress(downloaded, total_size);
+        }
+        if (std::chrono::steady_clock::now() - last_save >= kStateSaveInterval) {
+            checkpoint();
+            last_save = std::chrono::steady_clock::now();
+        }
+        if (digest) {
+            hash_range(digest.get(), reader.get(), hashed, contiguous_end());
+        }
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    const long long downloaded = snapshot();
+    checkpoint();
+    data.reset();
+    if (progress) {
+        progress(downloaded, total_size);
+    }
+    if (cancel.load()) {
+        return false;
+    }
+    for (const auto& state : states) {
+        if (state->done.load() < state->end - state->begin) {
+            throw std::runtime_error(fmt::format("Download segment {} failed: {}", state->index + 1, state->error));
+        }
+    }
+
+    if (digest) {
+        hash_range(digest.get(), reader.get(), hashed, total_size);
+        reader.reset();
+        const std::string actual = finish_sha256(digest.get());
+        if (actual != options_.expected_sha256) {
+            std::error_code ec;
+            std::filesystem::remove(destination_, ec);
+            std::filesystem::remove(sidecar_path(destination_), ec);
+            throw std::runtime_error(fmt::format("Checksum mismatch for {}: expected {}, got {}",
+                                                 destination_, options_.expected_sha256, actual));
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(sidecar_path(destination_), ec);
+    return true;
+}
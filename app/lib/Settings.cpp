@@ -57,6 +57,14 @@ std::vector<std::string> parse_list(const std::string& value) {
     return result;
 }
 
+std::string trimmed_copy(const std::string& value) {
+    auto trimmed = value;
+    auto not_space = [](unsigned char ch) { return !std::isspace(ch); };
+    trimmed.erase(trimmed.begin(), std::find_if(trimmed.begin(), trimmed.end(), not_space));
+    trimmed.erase(std::find_if(trimmed.rbegin(), trimmed.rend(), not_space).base(), trimmed.end());
+    return trimmed;
+}
+
 std::string join_list(const std::vector<std::string>& items) {
     std::ostringstream oss;
     for (size_t i = 0; i < items.size(); ++i) {
@@ -78,6 +86,7 @@ std::string llm_choice_to_string(LLMChoice choice) {
         case LLMChoice::Local_7b: return "Local_7b";
         case LLMChoice::Remote: return "Remote";
         case LLMChoice::Custom: return "Custom";
+        case LLMChoice::OllamaCloud: return "Ollama";
         default: return "Unset";
     }
 }
@@ -171,6 +180,7 @@ LLMChoice Settings::parse_llm_choice() const
     if (value == "Local_7b") return LLMChoice::Local_7b;
     if (value == "Remote")   return LLMChoice::Remote;
     if (value == "Custom")   return LLMChoice::Custom;
+    if (value == "Ollama")   return LLMChoice::OllamaCloud;
     return LLMChoice::Unset;
 }
 
@@ -180,6 +190,16 @@ void Settings::load_basic_settings(const std::function<bool(const char*, bool)>&
     llm_choice = parse_llm_choice();
     set_remote_api_key(config.getValue("Settings", "RemoteApiKey", ""));
     set_remote_model(config.getValue("Settings", "RemoteModel", "gpt-4o-mini"));
+    openai_batch_mode = load_bool("OpenAIBatchMode", false);
+    remote_logprobs = load_bool("RemoteLogprobs", false);
+    set_remote_min_confidence(load_int("RemoteMinConfidence", 60, 0));
+    set_remote_escalation_model(config.getValue("Settings", "RemoteEscalationModel", ""));
+    cascade_routing = load_bool("CascadeRouting", false);
+    set_ollama_base_url(config.getValue("Settings", "OllamaBaseUrl", "http://localhost:11434"));
+    set_ollama_model(config.getValue("Settings", "OllamaModel", ""));
+    set_ollama_api_key(config.getValue("Settings", "OllamaApiKey", ""));
+    set_ollama_keep_alive(config.getValue("Settings", "OllamaKeepAlive", "30m"));
+    ollama_max_parallel = load_int("OllamaMaxParallel", 0, 0);
     use_subcategories = load_bool("UseSubcategories", false);
     use_consistency_hints = load_bool("UseConsistencyHints", false);
     categorize_files = load_bool("CategorizeFiles", true);
@@ -187,6 +207,9 @@ void Settings::load_basic_settings(const std::function<bool(const char*, bool)>&
     sort_folder = config.getValue("Settings", "SortFolder", default_sort_folder.empty() ? std::string("/") : default_sort_folder);
     show_file_explorer = load_bool("ShowFileExplorer", true);
     consistency_pass_enabled = load_bool("ConsistencyPass", false);
+    consistency_pass_delta = load_bool("ConsistencyPassDelta", true);
+    metrics_export = load_bool("MetricsExport", false);
+    metrics_trace = load_bool("MetricsTrace", false);
     development_prompt_logging = load_bool("DevelopmentPromptLogging", false);
     skipped_version = config.getValue("Settings", "SkippedVersion", "0.0.0");
     if (config.hasValue("Settings", "Language")) {
@@ -247,6 +270,16 @@ void Settings::save_core_settings()
     config.setValue(settings_section, "LLMChoice", llm_choice_to_string(llm_choice));
     config.setValue(settings_section, "RemoteApiKey", remote_api_key);
     config.setValue(settings_section, "RemoteModel", remote_model.empty() ? "gpt-4o-mini" : remote_model);
+    set_bool_setting(config, settings_section, "OpenAIBatchMode", openai_batch_mode);
+    set_bool_setting(config, settings_section, "RemoteLogprobs", remote_logprobs);
+    config.setValue(settings_section, "RemoteMinConfidence", std::to_string(remote_min_confidence));
+    set_optional_setting(config, settings_section, "RemoteEscalationModel", remote_escalation_model);
+    set_bool_setting(config, settings_section, "CascadeRouting", cascade_routing);
+    config.setValue(settings_section, "OllamaBaseUrl", ollama_base_url);
+    config.setValue(settings_section, "OllamaModel", ollama_model);
+    config.setValue(settings_section, "OllamaApiKey", ollama_api_key);
+    config.setValue(settings_section, "OllamaKeepAlive", ollama_keep_alive);
+    config.setValue(settings_section, "OllamaMaxParallel", std::to_string(ollama_max_parallel));
     set_bool_setting(config, settings_section, "UseSubcategories", use_subcategories);
     set_bool_setting(config, settings_section, "UseConsistencyHints", use_consistency_hints);
     set_bool_setting(config, settings_section, "CategorizeFiles", categorize_files);
@@ -257,6 +290,9 @@ void Settings::save_core_settings()
 
     set_bool_setting(config, settings_section, "ShowFileExplorer", show_file_explorer);
     set_bool_setting(config, settings_section, "ConsistencyPass", consistency_pass_enabled);
+    set_bool_setting(config, settings_section, "ConsistencyPassDelta", consistency_pass_delta);
+    set_bool_setting(config, settings_section, "MetricsExport", metrics_export);
+    set_bool_setting(config, settings_section, "MetricsTrace", metrics_trace);
     set_bool_setting(config, settings_section, "DevelopmentPromptLogging", development_prompt_logging);
     config.setValue(settings_section, "Language", languageToString(language).toStdString());
     config.setValue(settings_section, "CategoryLanguage", categoryLanguageToString(category_language).toStdString());
@@ -400,6 +436,112 @@ void Settings::set_remote_model(const std::string& model)
     remote_model = trimmed;
 }
 
+bool Settings::get_openai_batch_mode() const
+{
+    return openai_batch_mode;
+}
+
+void Settings::set_openai_batch_mode(bool value)
+{
+    openai_batch_mode = value;
+}
+
+bool Settings::get_remote_logprobs() const
+{
+    return remote_logprobs;
+}
+
+void Settings::set_remote_logprobs(bool value)
+{
+    remote_logprobs = value;
+}
+
+int Settings::get_remote_min_confidence() const
+{
+    return remote_min_confidence;
+}
+
+void Settings::set_remote_min_confidence(int percent)
+{
+    remote_min_confidence = std::clamp(percent, 0, 100);
+}
+
+std::string Settings::get_remote_escalation_model() const
+{
+    return remote_escalation_model;
+}
+
+void Settings::set_remote_escalation_model(const std::string& model)
+{
+    remote_escalation_model = trimmed_copy(model);
+}
+
+bool Settings::get_cascade_routing() const
+{
+    return cascade_routing;
+}
+
+void Settings::set_cascade_routing(bool value)
+{
+    cascade_routing = value;
+}
+
+std::string Settings::get_ollama_base_url() const
+{
+    return ollama_base_url;
+}
+
+void Settings::set_ollama_base_url(const std::string& url)
+{
+    ollama_base_url = trimmed_copy(url);
+    if (ollama_base_url.empty()) {
+        ollama_base_url = "http://localhost:11434";
+    }
+}
+
+std::string Settings::get_ollama_model() const
+{
+    return ollama_model;
+}
+
+void Settings::set_ollama_model(const std::string& model)
+{
+    ollama_model = trimmed_copy(model);
+}
+
+std::string Settings::get_ollama_api_key() const
+{
+    return ollama_api_key;
+}
+
+void Settings::set_ollama_api_key(const std::string& key)
+{
+    ollama_api_key = trimmed_copy(key);
+}
+
+std::string Settings::get_ollama_keep_alive() const
+{
+    return ollama_keep_alive;
+}
+
+void Settings::set_ollama_keep_alive(const std::string& keep_alive)
+{
+    ollama_keep_alive = trimmed_copy(keep_alive);
+    if (ollama_keep_alive.empty()) {
+        ollama_keep_alive = "30m";
+    }
+}
+
+int Settings::get_ollama_max_parallel() const
+{
+    return ollama_max_parallel;
+}
+
+void Settings::set_ollama_max_parallel(int value)
+{
+    ollama_max_parallel = std::max(0, value);
+}
+
 std::string Settings::get_active_custom_llm_id() const
 {
     return active_custom_llm_id;
@@ -535,6 +677,36 @@ void Settings::set_consistency_pass_enabled(bool value)
     consistency_pass_enabled = value;
 }
 
+bool Settings::get_consistency_pass_delta() const
+{
+    return consistency_pass_delta;
+}
+
+void Settings::set_consistency_pass_delta(bool value)
+{
+    consistency_pass_delta = value;
+}
+
+bool Settings::get_metrics_export() const
+{
+    return metrics_export;
+}
+
+void Settings::set_metrics_export(bool value)
+{
+    metrics_export = value;
+}
+
+bool Settings::get_metrics_trace() const
+{
+    return metrics_trace;
+}
+
+void Settings::set_metrics_trace(bool value)
+{
+    metrics_trace = value;
+}
+
 bool Settings::get_development_prompt_logging() const
 {
     return development_prompt_logging;
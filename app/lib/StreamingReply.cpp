@@ -0,0 +1,89 @@
+#include "StreamingReply.hpp"
+
+namespace {
+
+std::string_view without_carriage_return(std::string_view line)
+{
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+} // namespace
+
+bool LineBuffer::feed(std::string_view chunk, const LineCallback& on_line)
+{
+    std::size_t newline = chunk.find('\n');
+    if (newline == std::string_view::npos) {
+        pending_.append(chunk);
+        return true;
+    }
+
+    // The first line may have started in an earlier chunk.
+    pending_.append(chunk.substr(0, newline));
+    const bool keep_going = on_line(without_carriage_return(pending_));
+    pending_.clear();
+    if (!keep_going) {
+        return false;
+    }
+
+    std::size_t start = newline + 1;
+    while ((newline = chunk.find('\n', start)) != std::string_view::npos) {
+        if (!on_line(without_carriage_return(chunk.substr(start, newline - start)))) {
+            return false;
+        }
+        start = newline + 1;
+    }
+    pending_.assign(chunk.substr(start));
+    return true;
+}
+
+bool LineBuffer::finish(const LineCallback& on_line)
+{
+    if (pending_.empty()) {
+        return true;
+    }
+    const std::string last = std::move(pending_);
+    pending_.clear();
+    return on_line(without_carriage_return(last));
+}
+
+std::size_t complete_category_reply_length(std::string_view text)
+{
+    const std::size_t start = text.find_first_not_of(" \t\r\n");
+    if (start == std::string_view::npos) {
+        return 0;
+    }
+
+    if (text[start] != '{') {
+        const std::size_t newline = text.find('\n', start);
+        if (newline == std::string_view::npos) {
+            return 0;
+        }
+        const std::string_view line = text.substr(start, newline - start);
+        return line.find(" : ") != std::string_view::npos ? newline : 0;
+    }
+
+    int depth = 0;
+    bool in_string = false;
+    for (std::size_t pos = start; pos < text.size(); ++pos) {
+        const char ch = text[pos];
+        if (in_string) {
+            if (ch == '\\') {
+                ++pos;
+            } else if (ch == '"') {
+                in_string = false;
+            }
+            continue;
+        }
+        if (ch == '"') {
+            in_string = true;
+        } else if (ch == '{' || ch == '[') {
+            ++depth;
+        } else if ((ch == '}' || ch == ']') && --depth == 0) {
+            return pos + 1;
+        }
+    }
+    return 0;
+}
@@ -78,6 +78,25 @@ static const QHash<QString, QString> kFrenchTranslations = {
     {QStringLiteral("Planned destination"), QStringLiteral("Destination prevue")},
     {QStringLiteral("Preview"), QStringLiteral("Aperçu")},
     {QStringLiteral("Undo last run"), QStringLiteral("Annuler la dernière exécution")},
+    {QStringLiteral("Undo a previous run…"), QStringLiteral("Annuler une exécution précédente…")},
+    {QStringLiteral("Previous runs"), QStringLiteral("Exécutions précédentes")},
+    {QStringLiteral("Undo selected run"), QStringLiteral("Annuler l'exécution sélectionnée")},
+    {QStringLiteral("Categories to restore (none selected: whole run)"), QStringLiteral("Catégories à restaurer (aucune sélection : toute l'exécution)")},
+    {QStringLiteral("Undoing…"), QStringLiteral("Annulation en cours…")},
+    {QStringLiteral("Verify file contents before restoring"), QStringLiteral("Vérifier le contenu des fichiers avant la restauration")},
+    {QStringLiteral("Sort mode:"), QStringLiteral("Mode de tri :")},
+    {QStringLiteral("Duplicates:"), QStringLiteral("Doublons :")},
+    {QStringLiteral("Sort like other files"), QStringLiteral("Trier comme les autres fichiers")},
+    {QStringLiteral("Leave in place"), QStringLiteral("Laisser en place")},
+    {QStringLiteral("Replace with hard links"), QStringLiteral("Remplacer par des liens physiques")},
+    {QStringLiteral("Keep newest, trash the rest"), QStringLiteral("Garder le plus récent, mettre les autres à la corbeille")},
+    {QStringLiteral("Files with the same contents as another file in this sort, or as the file already at their destination."), QStringLiteral("Fichiers ayant le même contenu qu'un autre fichier de ce tri ou que le fichier déjà présent à leur destination.")},
+    {QStringLiteral("Duplicate"), QStringLiteral("Doublon")},
+    {QStringLiteral("Move files"), QStringLiteral("Déplacer les fichiers")},
+    {QStringLiteral("Hard links in a mirror folder"), QStringLiteral("Liens physiques dans un dossier miroir")},
+    {QStringLiteral("Symbolic links in a mirror folder"), QStringLiteral("Liens symboliques dans un dossier miroir")},
+    {QStringLiteral("Link modes leave your files where they are and build the category folders next to the selected folder."), QStringLiteral("Les modes de liens laissent vos fichiers en place et créent les dossiers de catégories à côté du dossier sélectionné.")},
+    {QStringLiteral("An undo is already in progress."), QStringLiteral("Une annulation est déjà en cours.")},
     {QStringLiteral("Plan file:"), QStringLiteral("Fichier du plan :")},
     {QStringLiteral("Dry run (preview only, do not move files)"), QStringLiteral("Simulation (aperçu uniquement, ne déplace pas les fichiers)")},
     {QStringLiteral("Dry run preview"), QStringLiteral("Aperçu de la simulation")},
@@ -196,6 +215,25 @@ static const QHash<QString, QString> kGermanTranslations = {
     {QStringLiteral("Planned destination"), QStringLiteral("Geplantes Ziel")},
     {QStringLiteral("Preview"), QStringLiteral("Vorschau")},
     {QStringLiteral("Undo last run"), QStringLiteral("Letzten Durchlauf rückgängig machen")},
+    {QStringLiteral("Undo a previous run…"), QStringLiteral("Früheren Durchlauf rückgängig machen…")},
+    {QStringLiteral("Previous runs"), QStringLiteral("Frühere Durchläufe")},
+    {QStringLiteral("Undo selected run"), QStringLiteral("Ausgewählten Durchlauf rückgängig machen")},
+    {QStringLiteral("Categories to restore (none selected: whole run)"), QStringLiteral("Wiederherzustellende Kategorien (keine Auswahl: gesamter Durchlauf)")},
+    {QStringLiteral("Undoing…"), QStringLiteral("Rückgängig machen läuft…")},
+    {QStringLiteral("Verify file contents before restoring"), QStringLiteral("Dateiinhalte vor dem Wiederherstellen prüfen")},
+    {QStringLiteral("Sort mode:"), QStringLiteral("Sortiermodus:")},
+    {QStringLiteral("Duplicates:"), QStringLiteral("Duplikate:")},
+    {QStringLiteral("Sort like other files"), QStringLiteral("Wie andere Dateien sortieren")},
+    {QStringLiteral("Leave in place"), QStringLiteral("An Ort und Stelle lassen")},
+    {QStringLiteral("Replace with hard links"), QStringLiteral("Durch Hardlinks ersetzen")},
+    {QStringLiteral("Keep newest, trash the rest"), QStringLiteral("Neueste behalten, Rest in den Papierkorb")},
+    {QStringLiteral("Files with the same contents as another file in this sort, or as the file already at their destination."), QStringLiteral("Dateien mit demselben Inhalt wie eine andere Datei in dieser Sortierung oder wie die Datei, die bereits am Ziel liegt.")},
+    {QStringLiteral("Duplicate"), QStringLiteral("Duplikat")},
+    {QStringLiteral("Move files"), QStringLiteral("Dateien verschieben")},
+    {QStringLiteral("Hard links in a mirror folder"), QStringLiteral("Hardlinks in einem Spiegelordner")},
+    {QStringLiteral("Symbolic links in a mirror folder"), QStringLiteral("Symbolische Links in einem Spiegelordner")},
+    {QStringLiteral("Link modes leave your files where they are and build the category folders next to the selected folder."), QStringLiteral("Link-Modi lassen Ihre Dateien an ihrem Ort und legen die Kategorieordner neben dem ausgewählten Ordner an.")},
+    {QStringLiteral("An undo is already in progress."), QStringLiteral("Ein Rückgängig-Vorgang läuft bereits.")},
     {QStringLiteral("Plan file:"), QStringLiteral("Plan-Datei:")},
     {QStringLiteral("Dry run (preview only, do not move files)"), QStringLiteral("Probelauf (nur Vorschau, keine Dateien verschieben)")},
     {QStringLiteral("Dry run preview"), QStringLiteral("Vorschau Probelauf")},
@@ -314,6 +352,25 @@ static const QHash<QString, QString> kItalianTranslations = {
     {QStringLiteral("Planned destination"), QStringLiteral("Destinazione prevista")},
     {QStringLiteral("Preview"), QStringLiteral("Anteprima")},
     {QStringLiteral("Undo last run"), QStringLiteral("Annulla l'ultima esecuzione")},
+    {QStringLiteral("Undo a previous run…"), QStringLiteral("Annulla un'esecuzione precedente…")},
+    {QStringLiteral("Previous runs"), QStringLiteral("Esecuzioni precedenti")},
+    {QStringLiteral("Undo selected run"), QStringLiteral("Annulla l'esecuzione selezionata")},
+    {QStringLiteral("Categories to restore (none selected: whole run)"), QStringLiteral("Categorie da ripristinare (nessuna selezione: intera esecuzione)")},
+    {QStringLiteral("Undoing…"), QStringLiteral("Annullamento in corso…")},
+    {QStringLiteral("Verify file contents before restoring"), QStringLiteral("Verifica il contenuto dei file prima del ripristino")},
+    {QStringLiteral("Sort mode:"), QStringLiteral("Modalità di ordinamento:")},
+    {QStringLiteral("Duplicates:"), QStringLiteral("Duplicati:")},
+    {QStringLiteral("Sort like other files"), QStringLiteral("Ordina come gli altri file")},
+    {QStringLiteral("Leave in place"), QStringLiteral("Lascia dove si trovano")},
+    {QStringLiteral("Replace with hard links"), QStringLiteral("Sostituisci con collegamenti fisici")},
+    {QStringLiteral("Keep newest, trash the rest"), QStringLiteral("Mantieni il più recente, cestina gli altri")},
+    {QStringLiteral("Files with the same contents as another file in this sort, or as the file already at their destination."), QStringLiteral("File con lo stesso contenuto di un altro file di questo ordinamento o del file già presente nella destinazione.")},
+    {QStringLiteral("Duplicate"), QStringLiteral("Duplicato")},
+    {QStringLiteral("Move files"), QStringLiteral("Sposta i file")},
+    {QStringLiteral("Hard links in a mirror folder"), QStringLiteral("Collegamenti fisici in una cartella speculare")},
+    {QStringLiteral("Symbolic links in a mirror folder"), QStringLiteral("Collegamenti simbolici in una cartella speculare")},
+    {QStringLiteral("Link modes leave your files where they are and build the category folders next to the selected folder."), QStringLiteral("Le modalità con collegamenti lasciano i file dove sono e creano le cartelle delle categorie accanto alla cartella selezionata.")},
+    {QStringLiteral("An undo is already in progress."), QStringLiteral("Un annullamento è già in corso.")},
     {QStringLiteral("Plan file:"), QStringLiteral("File del piano:")},
     {QStringLiteral("Dry run (preview only, do not move files)"), QStringLiteral("Prova (solo anteprima, non spostare i file)")},
     {QStringLiteral("Dry run preview"), QStringLiteral("Anteprima prova")},
@@ -432,6 +489,25 @@ static const QHash<QString, QString> kSpanishTranslations = {
     {QStringLiteral("Planned destination"), QStringLiteral("Destino previsto")},
     {QStringLiteral("Preview"), QStringLiteral("Vista previa")},
     {QStringLiteral("Undo last run"), QStringLiteral("Deshacer la última ejecución")},
+    {QStringLiteral("Undo a previous run…"), QStringLiteral("Deshacer una ejecución anterior…")},
+    {QStringLiteral("Previous runs"), QStringLiteral("Ejecuciones anteriores")},
+    {QStringLiteral("Undo selected run"), QStringLiteral("Deshacer la ejecución seleccionada")},
+    {QStringLiteral("Categories to restore (none selected: whole run)"), QStringLiteral("Categorías a restaurar (sin selección: toda la ejecución)")},
+    {QStringLiteral("Undoing…"), QStringLiteral("Deshaciendo…")},
+    {QStringLiteral("Verify file contents before restoring"), QStringLiteral("Verificar el contenido de los archivos antes de restaurar")},
+    {QStringLiteral("Sort mode:"), QStringLiteral("Modo de ordenación:")},
+    {QStringLiteral("Duplicates:"), QStringLiteral("Duplicados:")},
+    {QStringLiteral("Sort like other files"), QStringLiteral("Ordenar como los demás archivos")},
+    {QStringLiteral("Leave in place"), QStringLiteral("Dejar en su sitio")},
+    {QStringLiteral("Replace with hard links"), QStringLiteral("Reemplazar con enlaces duros")},
+    {QStringLiteral("Keep newest, trash the rest"), QStringLiteral("Conservar el más reciente, enviar el resto a la papelera")},
+    {QStringLiteral("Files with the same contents as another file in this sort, or as the file already at their destination."), QStringLiteral("Archivos con el mismo contenido que otro archivo de esta ordenación o que el archivo que ya está en su destino.")},
+    {QStringLiteral("Duplicate"), QStringLiteral("Duplicado")},
+    {QStringLiteral("Move files"), QStringLiteral("Mover archivos")},
+    {QStringLiteral("Hard links in a mirror folder"), QStringLiteral("Enlaces duros en una carpeta espejo")},
+    {QStringLiteral("Symbolic links in a mirror folder"), QStringLiteral("Enlaces simbólicos en una carpeta espejo")},
+    {QStringLiteral("Link modes leave your files where they are and build the category folders next to the selected folder."), QStringLiteral("Los modos de enlace dejan tus archivos donde están y crean las carpetas de categorías junto a la carpeta seleccionada.")},
+    {QStringLiteral("An undo is already in progress."), QStringLiteral("Ya hay una operación de deshacer en curso.")},
     {QStringLiteral("Plan file:"), QStringLiteral("Archivo de plan:")},
     {QStringLiteral("Dry run (preview only, do not move files)"), QStringLiteral("Prueba (solo vista previa, no mover archivos)")},
     {QStringLiteral("Dry run preview"), QStringLiteral("Vista previa de la prueba")},
@@ -581,6 +657,25 @@ static const QHash<QString, QString> kTurkishTranslations = {
     {QStringLiteral("Download cancelled."), QStringLiteral("İndirme iptal edildi.")},
     {QStringLiteral("Download error: %1"), QStringLiteral("İndirme hatası: %1")},
     {QStringLiteral("Undo last run"), QStringLiteral("Son çalıştırmayı geri al")},
+    {QStringLiteral("Undo a previous run…"), QStringLiteral("Önceki bir çalıştırmayı geri al…")},
+    {QStringLiteral("Previous runs"), QStringLiteral("Önceki çalıştırmalar")},
+    {QStringLiteral("Undo selected run"), QStringLiteral("Seçili çalıştırmayı geri al")},
+    {QStringLiteral("Categories to restore (none selected: whole run)"), QStringLiteral("Geri yüklenecek kategoriler (seçim yoksa tüm çalıştırma)")},
+    {QStringLiteral("Undoing…"), QStringLiteral("Geri alınıyor…")},
+    {QStringLiteral("Verify file contents before restoring"), QStringLiteral("Geri yüklemeden önce dosya içeriklerini doğrula")},
+    {QStringLiteral("Sort mode:"), QStringLiteral("Sıralama modu:")},
+    {QStringLiteral("Duplicates:"), QStringLiteral("Kopyalar:")},
+    {QStringLiteral("Sort like other files"), QStringLiteral("Diğer dosyalar gibi sırala")},
+    {QStringLiteral("Leave in place"), QStringLiteral("Yerinde bırak")},
+    {QStringLiteral("Replace with hard links"), QStringLiteral("Sabit bağlantılarla değiştir")},
+    {QStringLiteral("Keep newest, trash the rest"), QStringLiteral("En yenisini tut, diğerlerini çöpe taşı")},
+    {QStringLiteral("Files with the same contents as another file in this sort, or as the file already at their destination."), QStringLiteral("Bu sıralamadaki başka bir dosyayla veya hedefte zaten bulunan dosyayla aynı içeriğe sahip dosyalar.")},
+    {QStringLiteral("Duplicate"), QStringLiteral("Kopya")},
+    {QStringLiteral("Move files"), QStringLiteral("Dosyaları taşı")},
+    {QStringLiteral("Hard links in a mirror folder"), QStringLiteral("Yansı klasöründe sabit bağlantılar")},
+    {QStringLiteral("Symbolic links in a mirror folder"), QStringLiteral("Yansı klasöründe sembolik bağlantılar")},
+    {QStringLiteral("Link modes leave your files where they are and build the category folders next to the selected folder."), QStringLiteral("Bağlantı modları dosyalarınızı yerinde bırakır ve kategori klasörlerini seçilen klasörün yanında oluşturur.")},
+    {QStringLiteral("An undo is already in progress."), QStringLiteral("Zaten bir geri alma işlemi sürüyor.")},
     {QStringLiteral("Plan file:"), QStringLiteral("Plan dosyası:")},
     {QStringLiteral("Dry run (preview only, do not move files)"), QStringLiteral("Deneme çalıştırma (yalnızca önizleme, dosyaları taşıma)")},
     {QStringLiteral("Dry run preview"), QStringLiteral("Deneme çalıştırma önizlemesi")},
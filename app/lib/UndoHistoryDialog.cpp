@@ -0,0 +1,120 @@
+#include "UndoHistoryDialog.hpp"
+
+#include <QCheckBox>
+#include <QDateTime>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QListWidget>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+namespace {
+
+constexpr std::size_t kMaxListedRuns = 200;
+
+} // namespace
+
+UndoHistoryDialog::UndoHistoryDialog(const UndoManager& undo_manager, QWidget* parent)
+    : QDialog(parent),
+      undo_manager_(undo_manager)
+{
+    setWindowTitle(tr("Undo a previous run…"));
+    resize(720, 480);
+    setup_ui();
+    populate_runs();
+}
+
+void UndoHistoryDialog::setup_ui()
+{
+    auto* layout = new QVBoxLayout(this);
+
+    layout->addWidget(new QLabel(tr("Previous runs"), this));
+    runs_list_ = new QListWidget(this);
+    runs_list_->setSelectionMode(QAbstractItemView::SingleSelection);
+    runs_list_->setAlternatingRowColors(true);
+    layout->addWidget(runs_list_, 2);
+
+    layout->addWidget(new QLabel(tr("Categories to restore (none selected: whole run)"), this));
+    categories_list_ = new QListWidget(this);
+    layout->addWidget(categories_list_, 1);
+
+    verify_checkbox_ = new QCheckBox(tr("Verify file contents before restoring"), this);
+    verify_checkbox_->setChecked(true);
+    layout->addWidget(verify_checkbox_);
+
+    auto* button_layout = new QHBoxLayout();
+    button_layout->addStretch(1);
+    undo_button_ = new QPushButton(tr("Undo selected run"), this);
+    undo_button_->setEnabled(false);
+    auto* close_button = new QPushButton(tr("Close"), this);
+    connect(undo_button_, &QPushButton::clicked, this, &QDialog::accept);
+    connect(close_button, &QPushButton::clicked, this, &QDialog::reject);
+    button_layout->addWidget(undo_button_);
+    button_layout->addWidget(close_button);
+    layout->addLayout(button_layout);
+
+    connect(runs_list_, &QListWidget::itemSelectionChanged, this, [this]() {
+        on_run_selection_changed();
+    });
+}
+
+void UndoHistoryDialog::populate_runs()
+{
+    runs_ = undo_manager_.list_runs(kMaxListedRuns);
+    for (const auto& run : runs_) {
+        const QString when = QDateTime::fromMSecsSinceEpoch(run.created_at_ms).toString(Qt::ISODate);
+        QString label = tr("%1 — %2 (%3 file(s))")
+                            .arg(when, QString::fromStdString(run.base_dir))
+                            .arg(run.moved_count);
+        if (run.undone) {
+            label.append(QStringLiteral(" — ")).append(tr("undone"));
+        }
+        auto* item = new QListWidgetItem(label, runs_list_);
+        item->setToolTip(run.plan_path);
+    }
+}
+
+void UndoHistoryDialog::on_run_selection_changed()
+{
+    categories_list_->clear();
+    const int row = runs_list_->currentRow();
+    const bool has_selection = row >= 0 && row < static_cast<int>(runs_.size());
+    undo_button_->setEnabled(has_selection);
+    if (!has_selection) {
+        return;
+    }
+
+    for (const auto& [category, count] : undo_manager_.categories_in_plan(runs_[static_cast<std::size_t>(row)].plan_path)) {
+        auto* item = new QListWidgetItem(QStringLiteral("%1 (%2)").arg(QString::fromStdString(category)).arg(count),
+                                         categories_list_);
+        item->setData(Qt::UserRole, QString::fromStdString(category));
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(Qt::Unchecked);
+    }
+}
+
+std::optional<QString> UndoHistoryDialog::selected_plan() const
+{
+    const int row = runs_list_->currentRow();
+    if (row < 0 || row >= static_cast<int>(runs_.size())) {
+        return std::nullopt;
+    }
+    return runs_[static_cast<std::size_t>(row)].plan_path;
+}
+
+std::vector<std::string> UndoHistoryDialog::selected_categories() const
+{
+    std::vector<std::string> categories;
+    for (int index = 0; index < categories_list_->count(); ++index) {
+        const auto* item = categories_list_->item(index);
+        if (item->checkState() == Qt::Checked) {
+            categories.push_back(item->data(Qt::UserRole).toString().toStdString());
+        }
+    }
+    return categories;
+}
+
+bool UndoHistoryDialog::verify_contents() const
+{
+    return verify_checkbox_->isChecked();
+}
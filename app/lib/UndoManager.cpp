@@ -1,5 +1,12 @@
 #include "UndoManager.hpp"
 
+#include "EmptyDirectoryPruner.hpp"
+#include "FileFingerprint.hpp"
+#include "MovableCategorizedFile.hpp"
+#include "MoveJournal.hpp"
+#include "UndoRunIndex.hpp"
+#include "Utils.hpp"
+
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
@@ -7,147 +14,603 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QDateTime>
-#include <QMessageBox>
 #include <spdlog/logger.h>
 
-#include <fmt/format.h>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <numeric>
+#include <set>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+constexpr std::size_t kRestoreBatchSize = 4096;
+constexpr unsigned kMaxRestoreWorkers = 8;
+
+QString journal_name_filter()
+{
+    return QStringLiteral("%1*%2")
+        .arg(QString::fromLatin1(MoveJournal::kFilePrefix), QString::fromLatin1(MoveJournal::kFileSuffix));
+}
+
+unsigned resolve_worker_count(unsigned requested)
+{
+    if (requested > 0) {
+        return requested;
+    }
+    const unsigned hardware = std::thread::hardware_concurrency();
+    return std::clamp(hardware == 0 ? 2u : hardware, 1u, kMaxRestoreWorkers);
+}
+
+bool matches_categories(const std::vector<std::string>& categories, const std::string& category)
+{
+    return categories.empty() ||
+           std::find(categories.begin(), categories.end(), category) != categories.end();
+}
+
+} // namespace
 
 UndoManager::UndoManager(std::string undo_dir)
     : undo_dir_(std::move(undo_dir))
-{}
-
-bool UndoManager::save_plan(const std::string& run_base_dir,
-                            const std::vector<Entry>& entries,
-                            const std::shared_ptr<spdlog::logger>& logger) const
 {
-    if (undo_dir_.empty() || entries.empty()) {
-        return false;
+    if (!undo_dir_.empty()) {
+        index_ = std::make_unique<UndoRunIndex>(undo_dir_);
+        if (index_->needs_import()) {
+            import_existing_plans();
+        }
     }
+}
 
+UndoManager::~UndoManager() = default;
+
+void UndoManager::import_existing_plans() const
+{
     QDir dir(QString::fromStdString(undo_dir_));
     if (!dir.exists()) {
-        dir.mkpath(QStringLiteral("."));
+        return;
     }
 
-    QJsonArray arr;
-    for (const auto& entry : entries) {
-        QJsonObject obj;
-        obj["source"] = QString::fromStdString(entry.source);
-        obj["destination"] = QString::fromStdString(entry.destination);
-        obj["size"] = static_cast<qint64>(entry.size_bytes);
-        obj["mtime"] = static_cast<qint64>(entry.mtime);
-        arr.push_back(obj);
-    }
-
-    QJsonObject root;
-    root["version"] = 1;
-    root["base_dir"] = QString::fromStdString(run_base_dir);
-    root["created_at_utc"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
-    root["entries"] = arr;
-
-    const QString filename = QStringLiteral("undo_plan_%1.json")
-        .arg(QDateTime::currentDateTimeUtc().toString("yyyyMMdd_hhmmsszzz"));
-    QFile file(dir.filePath(filename));
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-        if (logger) {
-            logger->error("Failed to write undo plan '{}': {}", filename.toStdString(), file.errorString().toStdString());
+    // Plans written before the index existed; oldest first so index order matches run order.
+    const auto files = dir.entryInfoList(QStringList() << "undo_plan_*.json" << journal_name_filter(),
+                                         QDir::Files,
+                                         QDir::Time | QDir::Reversed);
+    for (const auto& info : files) {
+        UndoRunIndex::Run run;
+        run.plan_path = info.filePath().toStdString();
+        run.created_at = info.lastModified().toMSecsSinceEpoch();
+        run.status = UndoRunIndex::Status::Complete;
+        if (MoveJournal::is_journal_file(run.plan_path)) {
+            const auto summary = MoveJournal::read_summary(run.plan_path);
+            if (!summary) {
+                continue;
+            }
+            run.base_dir = summary->base_dir;
+            run.created_at = summary->created_at;
+            run.moved_count = static_cast<std::int64_t>(summary->moved_count);
+            if (!summary->complete) {
+                run.status = UndoRunIndex::Status::InProgress;
+            }
+        } else {
+            QFile file(info.filePath());
+            if (file.open(QIODevice::ReadOnly)) {
+                const auto root = QJsonDocument::fromJson(file.readAll()).object();
+                run.base_dir = root.value("base_dir").toString().toStdString();
+                run.moved_count = root.value("entries").toArray().size();
+            }
         }
-        return false;
+        index_->add_run(run);
     }
+}
 
-    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
-    file.close();
-    if (logger) {
-        logger->info("Saved undo plan to '{}'", file.fileName().toStdString());
+std::unique_ptr<MoveJournal> UndoManager::begin_run(const std::string& base_dir,
+                                                    const std::shared_ptr<spdlog::logger>& logger) const
+{
+    auto journal = MoveJournal::create(undo_dir_, base_dir, logger);
+    if (journal && index_) {
+        UndoRunIndex::Run run;
+        run.plan_path = journal->path();
+        run.base_dir = base_dir;
+        run.created_at = QDateTime::currentMSecsSinceEpoch();
+        run.status = UndoRunIndex::Status::InProgress;
+        index_->add_run(run);
+    }
+    return journal;
+}
+
+void UndoManager::finish_run(std::unique_ptr<MoveJournal> journal, std::int64_t moved_count) const
+{
+    if (!journal) {
+        return;
+    }
+
+    journal->mark_complete();
+    const std::string plan_path = journal->path();
+    journal.reset();
+
+    if (moved_count == 0) {
+        // Nothing was moved, so there is nothing to undo later.
+        forget_plan(QString::fromStdString(plan_path));
+        QFile::remove(QString::fromStdString(plan_path));
+        return;
+    }
+    if (index_) {
+        index_->set_status(plan_path, UndoRunIndex::Status::Complete, moved_count);
     }
-    return true;
 }
 
 std::optional<QString> UndoManager::latest_plan_path() const
 {
-    if (undo_dir_.empty()) {
+    if (!index_) {
         return std::nullopt;
     }
-    QDir dir(QString::fromStdString(undo_dir_));
-    if (!dir.exists()) {
+    const auto run = index_->latest_run();
+    if (!run) {
         return std::nullopt;
     }
-    const auto files = dir.entryInfoList(QStringList() << "undo_plan_*.json",
-                                         QDir::Files,
-                                         QDir::Time | QDir::Reversed);
-    if (files.isEmpty()) {
-        return std::nullopt;
+    return QString::fromStdString(run->plan_path);
+}
+
+std::vector<UndoManager::RunInfo> UndoManager::list_runs(std::size_t limit) const
+{
+    std::vector<RunInfo> runs;
+    if (!index_) {
+        return runs;
+    }
+    for (const auto& run : index_->list_runs(limit)) {
+        if (run.status == UndoRunIndex::Status::InProgress) {
+            continue;
+        }
+        runs.push_back(RunInfo{
+            QString::fromStdString(run.plan_path),
+            run.base_dir,
+            run.created_at,
+            run.moved_count,
+            run.status == UndoRunIndex::Status::Undone});
     }
-    return files.back().filePath();
+    return runs;
 }
 
-UndoManager::UndoResult UndoManager::undo_plan(const QString& plan_path) const
+std::vector<std::pair<std::string, std::size_t>> UndoManager::categories_in_plan(const QString& plan_path) const
 {
-    UndoResult result;
+    std::map<std::string, std::size_t> counts;
+    if (MoveJournal::is_journal_file(plan_path.toStdString())) {
+        MoveJournal::for_each_record(plan_path.toStdString(), [&](const MoveJournal::Record& record) {
+            if (record.state == MoveJournal::State::Moved && !record.category.empty()) {
+                ++counts[record.category];
+            }
+            return true;
+        });
+    }
+    return {counts.begin(), counts.end()};
+}
+
+std::vector<QString> UndoManager::interrupted_journal_paths() const
+{
+    std::vector<QString> paths;
+    if (!index_) {
+        return paths;
+    }
+    for (const auto& run : index_->runs_with_status(UndoRunIndex::Status::InProgress)) {
+        const auto summary = MoveJournal::read_summary(run.plan_path);
+        if (!summary) {
+            // The run never got past creating its journal.
+            index_->remove_run(run.plan_path);
+            continue;
+        }
+        if (summary->complete) {
+            index_->set_status(run.plan_path, UndoRunIndex::Status::Complete,
+                               static_cast<std::int64_t>(summary->moved_count));
+            continue;
+        }
+        paths.push_back(QString::fromStdString(run.plan_path));
+    }
+    return paths;
+}
+
+void UndoManager::forget_plan(const QString& plan_path) const
+{
+    if (index_) {
+        index_->remove_run(plan_path.toStdString());
+    }
+}
 
+std::optional<std::vector<UndoManager::Entry>>
+UndoManager::load_legacy_entries(const QString& plan_path, std::string& base_dir, UndoResult& result) const
+{
     QFile file(plan_path);
     if (!file.open(QIODevice::ReadOnly)) {
         result.details << QString("Failed to open plan: %1").arg(plan_path);
         result.skipped++;
-        return result;
+        return std::nullopt;
     }
 
     const auto doc = QJsonDocument::fromJson(file.readAll());
     if (!doc.isObject()) {
         result.details << QString("Invalid plan: %1").arg(plan_path);
         result.skipped++;
-        return result;
+        return std::nullopt;
     }
 
-    const QJsonArray entries = doc.object().value("entries").toArray();
-    for (const auto& val : entries) {
+    std::vector<Entry> entries;
+    base_dir = doc.object().value("base_dir").toString().toStdString();
+    const QJsonArray array = doc.object().value("entries").toArray();
+    entries.reserve(static_cast<std::size_t>(array.size()));
+    for (const auto& val : array) {
         if (!val.isObject()) {
             result.skipped++;
             continue;
         }
         const QJsonObject obj = val.toObject();
-        const QString source = obj.value("source").toString();
-        const QString destination = obj.value("destination").toString();
-        const qint64 expected_size = obj.value("size").toInteger(0);
-        const qint64 expected_mtime = obj.value("mtime").toInteger(0);
+        entries.push_back(Entry{
+            obj.value("source").toString().toStdString(),
+            obj.value("destination").toString().toStdString(),
+            static_cast<std::uintmax_t>(obj.value("size").toInteger(0)),
+            static_cast<std::time_t>(obj.value("mtime").toInteger(0))});
+    }
+    return entries;
+}
 
-        QFileInfo dest_info(destination);
-        if (!dest_info.exists()) {
-            result.details << QString("Missing destination: %1").arg(destination);
-            result.skipped++;
-            continue;
+UndoManager::UndoResult UndoManager::undo_plan(const QString& plan_path) const
+{
+    return undo_plan(plan_path, UndoOptions{});
+}
+
+UndoManager::UndoResult UndoManager::undo_plan(const QString& plan_path, const UndoOptions& options) const
+{
+    UndoResult result;
+    std::set<std::filesystem::path> touched_directories;
+
+    if (!MoveJournal::is_journal_file(plan_path.toStdString())) {
+        std::string base_dir;
+        if (auto entries = load_legacy_entries(plan_path, base_dir, result)) {
+            restore_batch(*entries, options, result, touched_directories);
+        }
+        prune_empty_directories(touched_directories, base_dir);
+        return result;
+    }
+
+    // Stream the journal in fixed-size batches so memory stays flat regardless of run size.
+    std::vector<Entry> batch;
+    batch.reserve(kRestoreBatchSize);
+    MoveJournal::Summary summary;
+    bool move_run = false;
+    const bool readable = MoveJournal::for_each_record(plan_path.toStdString(), [&](const MoveJournal::Record& record) {
+        if (record.state == MoveJournal::State::Failed || !matches_categories(options.categories, record.category)) {
+            return true;
+        }
+        if (record.state == MoveJournal::State::Pending) {
+            if (record.destination.empty()) {
+                // A trash move without a result: if it happened, where the file went is unknown.
+                return true;
+            }
+            // The run was interrupted around this operation; only undo it if it actually happened.
+            const bool happened = record.mode == SortMode::Move
+                ? QFileInfo::exists(QString::fromStdString(record.destination)) &&
+                      !QFileInfo::exists(QString::fromStdString(record.source))
+                : MovableCategorizedFile::is_link_to(Utils::utf8_to_path(record.destination),
+                                                     Utils::utf8_to_path(record.source),
+                                                     record.mode);
+            if (!happened) {
+                return true;
+            }
+        }
+        move_run = move_run || record.mode == SortMode::Move;
+        batch.push_back(Entry{record.source, record.destination, record.size_bytes, record.mtime, record.fingerprint,
+                              record.mode});
+        if (batch.size() >= kRestoreBatchSize) {
+            restore_batch(batch, options, result, touched_directories);
+            batch.clear();
+        }
+        return true;
+    }, &summary);
+    if (!readable) {
+        result.details << QString("Invalid plan: %1").arg(plan_path);
+        result.skipped++;
+        return result;
+    }
+    restore_batch(batch, options, result, touched_directories);
+    // Links of a link sort live in the mirror folder, so that is where emptied category folders are
+    // pruned. A move sort may also hold links that replaced duplicates; its folders are in the base.
+    prune_empty_directories(touched_directories,
+                            move_run ? summary.base_dir : MovableCategorizedFile::link_mirror_root(summary.base_dir));
+
+    if (options.categories.empty() && result.skipped == 0 && index_) {
+        index_->set_status(plan_path.toStdString(), UndoRunIndex::Status::Undone);
+    }
+    return result;
+}
+
+void UndoManager::restore_batch(std::vector<Entry>& entries,
+                                const UndoOptions& options,
+                                UndoResult& result,
+                                std::set<std::filesystem::path>& touched_directories) const
+{
+    if (entries.empty()) {
+        return;
+    }
+
+    // A duplicate replaced by a hard link is restored from the trash into the place the link
+    // held, so when a batch mixes links and moves, every link goes first.
+    const auto first_move = std::stable_partition(entries.begin(), entries.end(), [](const Entry& entry) {
+        return entry.mode != SortMode::Move;
+    });
+    if (first_move != entries.begin() && first_move != entries.end()) {
+        std::vector<std::filesystem::path> touched;
+        for (auto it = entries.begin(); it != first_move; ++it) {
+            if (check_restorable(*it, options.verify_contents, result)) {
+                remove_link(*it, result, touched);
+            }
+        }
+        touched_directories.insert(touched.begin(), touched.end());
+        entries.erase(entries.begin(), first_move);
+    }
+
+    // Group restores by source directory: each directory is recreated once, and each worker
+    // owns whole directories, so concurrent renames never contend on the same parent.
+    struct Group {
+        std::string directory;
+        std::size_t begin{0};
+        std::size_t end{0};
+    };
+    std::vector<std::string> parents;
+    parents.reserve(entries.size());
+    for (const auto& entry : entries) {
+        parents.push_back(Utils::path_to_utf8(Utils::utf8_to_path(entry.source).parent_path()));
+    }
+    std::vector<std::size_t> order(entries.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+        return parents[lhs] < parents[rhs];
+    });
+    std::vector<Entry> sorted;
+    sorted.reserve(entries.size());
+    std::vector<Group> groups;
+    for (const std::size_t index : order) {
+        if (groups.empty() || groups.back().directory != parents[index]) {
+            groups.push_back(Group{parents[index], sorted.size(), sorted.size()});
+        }
+        sorted.push_back(std::move(entries[index]));
+        groups.back().end = sorted.size();
+    }
+
+    std::mutex result_mutex;
+    std::atomic<std::size_t> next_group{0};
+    auto restore_groups = [&]() {
+        UndoResult local;
+        std::vector<std::filesystem::path> local_touched;
+        for (std::size_t group_index = next_group++; group_index < groups.size(); group_index = next_group++) {
+            const Group& group = groups[group_index];
+            bool directory_ready = false;
+            for (std::size_t index = group.begin; index < group.end; ++index) {
+                const Entry& entry = sorted[index];
+                if (!check_restorable(entry, options.verify_contents, local)) {
+                    continue;
+                }
+                if (entry.mode != SortMode::Move) {
+                    remove_link(entry, local, local_touched);
+                    continue;
+                }
+                if (!directory_ready) {
+                    QDir().mkpath(QString::fromStdString(group.directory));
+                    directory_ready = true;
+                }
+                const QString source = QString::fromStdString(entry.source);
+                const QString destination = QString::fromStdString(entry.destination);
+                if (QFile::rename(destination, source)) {
+                    local.restored++;
+                    local_touched.push_back(Utils::utf8_to_path(entry.destination).parent_path());
+                } else {
+                    local.details << QString("Failed to move %1 back to %2").arg(destination, source);
+                    local.skipped++;
+                }
+            }
         }
 
-        QFileInfo src_info(source);
-        if (src_info.exists()) {
-            result.details << QString("Source already exists, skipping: %1").arg(source);
+        std::lock_guard<std::mutex> lock(result_mutex);
+        result.restored += local.restored;
+        result.skipped += local.skipped;
+        result.details << local.details;
+        touched_directories.insert(local_touched.begin(), local_touched.end());
+    };
+
+    const unsigned workers = std::max(1u, std::min<unsigned>(resolve_worker_count(options.worker_count),
+                                                             static_cast<unsigned>(groups.size())));
+    if (workers == 1) {
+        restore_groups();
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (unsigned worker = 0; worker < workers; ++worker) {
+        threads.emplace_back(restore_groups);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void UndoManager::remove_link(const Entry& entry, UndoResult& result, std::vector<std::filesystem::path>& touched)
+{
+    // The original never moved, so undo only drops the link.
+    std::error_code ec;
+    if (std::filesystem::remove(Utils::utf8_to_path(entry.destination), ec) && !ec) {
+        result.restored++;
+        touched.push_back(Utils::utf8_to_path(entry.destination).parent_path());
+    } else {
+        result.details << QString("Failed to remove link %1").arg(QString::fromStdString(entry.destination));
+        result.skipped++;
+    }
+}
+
+void UndoManager::prune_empty_directories(const std::set<std::filesystem::path>& directories,
+                                          const std::string& base_dir)
+{
+    if (directories.empty()) {
+        return;
+    }
+    EmptyDirectoryPruner pruner(Utils::utf8_to_path(base_dir));
+    for (const auto& directory : directories) {
+        pruner.add(directory);
+    }
+    pruner.prune();
+}
+
+bool UndoManager::check_restorable(const Entry& entry, bool verify_contents, UndoResult& result)
+{
+    const QString source = QString::fromStdString(entry.source);
+    const QString destination = QString::fromStdString(entry.destination);
+    if (entry.mode != SortMode::Move) {
+        std::error_code ec;
+        const auto link_path = Utils::utf8_to_path(entry.destination);
+        if (!std::filesystem::exists(std::filesystem::symlink_status(link_path, ec))) {
+            // Already removed by an earlier (partial) undo.
+            return false;
+        }
+        if (!MovableCategorizedFile::is_link_to(link_path, Utils::utf8_to_path(entry.source), entry.mode)) {
+            result.details << QString("No longer a link to %1, skipping: %2").arg(source, destination);
             result.skipped++;
-            continue;
+            return false;
         }
+        return true;
+    }
 
-        if (expected_size > 0 && dest_info.size() != expected_size) {
-            result.details << QString("Size mismatch for %1").arg(destination);
+    const QFileInfo dest_info(destination);
+    const QFileInfo src_info(source);
+    if (!dest_info.exists()) {
+        if (!src_info.exists()) {
+            result.details << QString("Missing destination: %1").arg(destination);
             result.skipped++;
-            continue;
         }
+        // Otherwise it was already restored by an earlier (partial) undo.
+        return false;
+    }
 
-        if (expected_mtime > 0) {
-            const auto mtime = dest_info.lastModified().toSecsSinceEpoch();
-            if (mtime != expected_mtime) {
-                result.details << QString("Timestamp mismatch for %1").arg(destination);
-                result.skipped++;
-                continue;
+    if (src_info.exists()) {
+        result.details << QString("Source already exists, skipping: %1").arg(source);
+        result.skipped++;
+        return false;
+    }
+
+    const qint64 expected_size = static_cast<qint64>(entry.size_bytes);
+    if (expected_size > 0 && dest_info.size() != expected_size) {
+        result.details << QString("Size mismatch for %1").arg(destination);
+        result.skipped++;
+        return false;
+    }
+
+    const qint64 expected_mtime = static_cast<qint64>(entry.mtime);
+    if (expected_mtime > 0 && dest_info.lastModified().toSecsSinceEpoch() != expected_mtime) {
+        result.details << QString("Timestamp mismatch for %1").arg(destination);
+        result.skipped++;
+        return false;
+    }
+
+    if (verify_contents && entry.fingerprint != 0 && dest_info.isFile() &&
+        FileFingerprint::partial(Utils::utf8_to_path(entry.destination)) != entry.fingerprint) {
+        result.details << QString("Content changed for %1").arg(destination);
+        result.skipped++;
+        return false;
+    }
+    return true;
+}
+
+UndoManager::ResumeResult UndoManager::resume_interrupted(const QString& journal_path,
+                                                          const std::shared_ptr<spdlog::logger>& logger) const
+{
+    ResumeResult result;
+    auto journal = MoveJournal::open_existing(journal_path.toStdString(), logger);
+    if (!journal) {
+        result.details << QString("Failed to open plan: %1").arg(journal_path);
+        return result;
+    }
+
+    const bool readable = MoveJournal::for_each_record(journal_path.toStdString(), [&](const MoveJournal::Record& record) {
+        if (record.state != MoveJournal::State::Pending) {
+            return true;
+        }
+        const QString source = QString::fromStdString(record.source);
+        const QString destination = QString::fromStdString(record.destination);
+        const bool source_exists = QFileInfo::exists(source);
+        const bool destination_exists = QFileInfo::exists(destination);
+
+        bool moved = false;
+        if (record.destination.empty()) {
+            // A duplicate sent to the trash is never sent again; without its result nothing
+            // records where it went, so undo cannot bring it back either.
+            if (!source_exists) {
+                result.details << QString("%1 was moved to the trash; restore it from there if needed").arg(source);
+            }
+        } else if (record.mode != SortMode::Move) {
+            const auto link_path = Utils::utf8_to_path(record.destination);
+            const auto source_path = Utils::utf8_to_path(record.source);
+            if (MovableCategorizedFile::is_link_to(link_path, source_path, record.mode)) {
+                moved = true;
+            } else if (source_exists && !destination_exists) {
+                QDir().mkpath(QFileInfo(destination).path());
+                moved = MovableCategorizedFile::create_link(source_path, link_path, record.mode);
+            }
+            if (!moved) {
+                result.details << QString("Cannot resume link of %1").arg(source);
             }
+        } else if (!source_exists && destination_exists) {
+            // The rename completed before the interruption; only its result record was lost.
+            moved = true;
+        } else if (source_exists && !destination_exists) {
+            QDir().mkpath(QFileInfo(destination).path());
+            moved = QFile::rename(source, destination);
+            if (!moved) {
+                result.details << QString("Failed to move %1 to %2").arg(source, destination);
+            }
+        } else {
+            result.details << QString("Cannot resume move of %1").arg(source);
         }
 
-        QDir().mkpath(src_info.path());
-        if (QFile::rename(destination, source)) {
-            result.restored++;
+        if (moved) {
+            const QFileInfo dest_info(destination);
+            const bool is_file = dest_info.isFile();
+            const auto size = is_file ? static_cast<std::uintmax_t>(dest_info.size()) : 0;
+            const auto fingerprint = is_file ? FileFingerprint::partial(Utils::utf8_to_path(record.destination)) : std::nullopt;
+            journal->record_moved(record.seq, size,
+                                  static_cast<std::time_t>(dest_info.lastModified().toSecsSinceEpoch()),
+                                  fingerprint.value_or(0));
+            result.completed++;
         } else {
-            result.details << QString("Failed to move %1 back to %2").arg(destination, source);
-            result.skipped++;
+            journal->record_failed(record.seq);
+            result.failed++;
         }
+        return true;
+    });
+    if (!readable) {
+        result.details << QString("Invalid plan: %1").arg(journal_path);
+        return result;
     }
 
+    const std::string plan_path = journal->path();
+    journal.reset();
+    mark_journal_complete(journal_path, logger);
+    if (logger) {
+        logger->info("Resumed interrupted sort '{}': {} completed, {} failed",
+                     plan_path, result.completed, result.failed);
+    }
     return result;
 }
+
+bool UndoManager::mark_journal_complete(const QString& journal_path,
+                                        const std::shared_ptr<spdlog::logger>& logger) const
+{
+    auto journal = MoveJournal::open_existing(journal_path.toStdString(), logger);
+    if (!journal || !journal->mark_complete()) {
+        return false;
+    }
+    journal.reset();
+    if (index_) {
+        if (const auto summary = MoveJournal::read_summary(journal_path.toStdString())) {
+            index_->set_status(journal_path.toStdString(), UndoRunIndex::Status::Complete,
+                               static_cast<std::int64_t>(summary->moved_count));
+        }
+    }
+    return true;
+}
@@ -0,0 +1,229 @@
+#include "UndoRunIndex.hpp"
+
+#include "Logger.hpp"
+#include "Utils.hpp"
+
+#include <filesystem>
+#include <memory>
+
+#include <sqlite3.h>
+
+namespace {
+
+constexpr const char* kIndexFileName = "undo_index.db";
+constexpr int kSchemaVersion = 1;
+constexpr int kBusyTimeoutMs = 2000;
+
+struct StatementDeleter {
+    void operator()(sqlite3_stmt* stmt) const {
+        if (stmt) {
+            sqlite3_finalize(stmt);
+        }
+    }
+};
+
+using StatementPtr = std::unique_ptr<sqlite3_stmt, StatementDeleter>;
+
+StatementPtr prepare_statement(sqlite3* db, const char* sql) {
+    sqlite3_stmt* raw = nullptr;
+    if (sqlite3_prepare_v2(db, sql, -1, &raw, nullptr) != SQLITE_OK) {
+        return StatementPtr{};
+    }
+    return StatementPtr(raw);
+}
+
+void log_error(const std::string& message) {
+    if (auto logger = Logger::get_logger("core_logger")) {
+        logger->error("{}", message);
+    }
+}
+
+std::string column_text(sqlite3_stmt* stmt, int column) {
+    const auto* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+    return text ? text : "";
+}
+
+UndoRunIndex::Run read_run(sqlite3_stmt* stmt) {
+    UndoRunIndex::Run run;
+    run.id = sqlite3_column_int64(stmt, 0);
+    run.plan_path = column_text(stmt, 1);
+    run.base_dir = column_text(stmt, 2);
+    run.created_at = sqlite3_column_int64(stmt, 3);
+    run.moved_count = sqlite3_column_int64(stmt, 4);
+    run.status = static_cast<UndoRunIndex::Status>(sqlite3_column_int(stmt, 5));
+    return run;
+}
+
+} // namespace
+
+UndoRunIndex::UndoRunIndex(const std::string& undo_dir)
+{
+    if (undo_dir.empty()) {
+        return;
+    }
+
+    const std::filesystem::path dir = Utils::utf8_to_path(undo_dir);
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    const std::string db_path = Utils::path_to_utf8(dir / kIndexFileName);
+
+    if (sqlite3_open(db_path.c_str(), &db_) != SQLITE_OK) {
+        log_error("Can't open undo index '" + db_path + "': " + (db_ ? sqlite3_errmsg(db_) : "unknown error"));
+        if (db_) {
+            sqlite3_close(db_);
+        }
+        db_ = nullptr;
+        return;
+    }
+    // The sort dialog and the undo worker each open their own connection.
+    sqlite3_busy_timeout(db_, kBusyTimeoutMs);
+    initialize_schema();
+}
+
+UndoRunIndex::~UndoRunIndex()
+{
+    if (db_) {
+        sqlite3_close(db_);
+        db_ = nullptr;
+    }
+}
+
+void UndoRunIndex::initialize_schema()
+{
+    int version = 0;
+    if (auto stmt = prepare_statement(db_, "PRAGMA user_version;")) {
+        if (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            version = sqlite3_column_int(stmt.get(), 0);
+        }
+    }
+
+    const char* schema_sql = R"(
+        CREATE TABLE IF NOT EXISTS undo_runs (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            plan_path TEXT NOT NULL UNIQUE,
+            base_dir TEXT NOT NULL,
+            created_at INTEGER NOT NULL,
+            moved_count INTEGER NOT NULL DEFAULT 0,
+            status INTEGER NOT NULL DEFAULT 0
+        );
+        CREATE INDEX IF NOT EXISTS idx_undo_runs_status ON undo_runs(status, id);
+    )";
+
+    char* error_msg = nullptr;
+    if (sqlite3_exec(db_, schema_sql, nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        log_error(std::string("Failed to create undo index schema: ") + (error_msg ? error_msg : ""));
+        sqlite3_free(error_msg);
+        return;
+    }
+
+    if (version < kSchemaVersion) {
+        needs_import_ = true;
+        const std::string pragma = "PRAGMA user_version = " + std::to_string(kSchemaVersion) + ";";
+        sqlite3_exec(db_, pragma.c_str(), nullptr, nullptr, nullptr);
+    }
+}
+
+bool UndoRunIndex::add_run(const Run& run)
+{
+    if (!db_) {
+        return false;
+    }
+    auto stmt = prepare_statement(db_,
+        "INSERT OR REPLACE INTO undo_runs (plan_path, base_dir, created_at, moved_count, status) "
+        "VALUES (?, ?, ?, ?, ?);");
+    if (!stmt) {
+        log_error(std::string("Failed to prepare undo run insert: ") + sqlite3_errmsg(db_));
+        return false;
+    }
+    sqlite3_bind_text(stmt.get(), 1, run.plan_path.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt.get(), 2, run.base_dir.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt.get(), 3, run.created_at);
+    sqlite3_bind_int64(stmt.get(), 4, run.moved_count);
+    sqlite3_bind_int(stmt.get(), 5, static_cast<int>(run.status));
+    return sqlite3_step(stmt.get()) == SQLITE_DONE;
+}
+
+bool UndoRunIndex::set_status(const std::string& plan_path, Status status, std::optional<std::int64_t> moved_count)
+{
+    if (!db_) {
+        return false;
+    }
+    auto stmt = prepare_statement(db_,
+        "UPDATE undo_runs SET status = ?, moved_count = COALESCE(?, moved_count) WHERE plan_path = ?;");
+    if (!stmt) {
+        return false;
+    }
+    sqlite3_bind_int(stmt.get(), 1, static_cast<int>(status));
+    if (moved_count) {
+        sqlite3_bind_int64(stmt.get(), 2, *moved_count);
+    } else {
+        sqlite3_bind_null(stmt.get(), 2);
+    }
+    sqlite3_bind_text(stmt.get(), 3, plan_path.c_str(), -1, SQLITE_TRANSIENT);
+    return sqlite3_step(stmt.get()) == SQLITE_DONE;
+}
+
+bool UndoRunIndex::remove_run(const std::string& plan_path)
+{
+    if (!db_) {
+        return false;
+    }
+    auto stmt = prepare_statement(db_, "DELETE FROM undo_runs WHERE plan_path = ?;");
+    if (!stmt) {
+        return false;
+    }
+    sqlite3_bind_text(stmt.get(), 1, plan_path.c_str(), -1, SQLITE_TRANSIENT);
+    return sqlite3_step(stmt.get()) == SQLITE_DONE;
+}
+
+std::optional<UndoRunIndex::Run> UndoRunIndex::latest_run() const
+{
+    if (!db_) {
+        return std::nullopt;
+    }
+    auto stmt = prepare_statement(db_,
+        "SELECT id, plan_path, base_dir, created_at, moved_count, status FROM undo_runs "
+        "WHERE status = 1 ORDER BY id DESC LIMIT 1;");
+    if (!stmt || sqlite3_step(stmt.get()) != SQLITE_ROW) {
+        return std::nullopt;
+    }
+    return read_run(stmt.get());
+}
+
+std::vector<UndoRunIndex::Run> UndoRunIndex::list_runs(std::size_t limit) const
+{
+    std::vector<Run> runs;
+    if (!db_) {
+        return runs;
+    }
+    auto stmt = prepare_statement(db_,
+        "SELECT id, plan_path, base_dir, created_at, moved_count, status FROM undo_runs "
+        "ORDER BY id DESC LIMIT ?;");
+    if (!stmt) {
+        return runs;
+    }
+    sqlite3_bind_int64(stmt.get(), 1, static_cast<sqlite3_int64>(limit));
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        runs.push_back(read_run(stmt.get()));
+    }
+    return runs;
+}
+
+std::vector<UndoRunIndex::Run> UndoRunIndex::runs_with_status(Status status) const
+{
+    std::vector<Run> runs;
+    if (!db_) {
+        return runs;
+    }
+    auto stmt = prepare_statement(db_,
+        "SELECT id, plan_path, base_dir, created_at, moved_count, status FROM undo_runs "
+        "WHERE status = ? ORDER BY id ASC;");
+    if (!stmt) {
+        return runs;
+    }
+    sqlite3_bind_int(stmt.get(), 1, static_cast<int>(status));
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        runs.push_back(read_run(stmt.get()));
+    }
+    return runs;
+}
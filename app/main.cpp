@@ -1,3 +1,4 @@
+#include "AsyncHttpEngine.hpp"
 #include "EmbeddedEnv.hpp"
 #include "Logger.hpp"
 #include "MainApp.hpp"
@@ -36,10 +37,10 @@ using SetProcessDpiAwarenessFn = HRESULT (WINAPI *)(int); // 2 = PROCESS_PER_MON
 #endif
 
 
-bool initialize_loggers()
+bool initialize_loggers(bool console_requested, bool development_mode)
 {
     try {
-        Logger::setup_loggers();
+        Logger::setup_loggers(LogOptions::from_environment(console_requested, development_mode));
         return true;
     } catch (const std::exception &e) {
         if (auto logger = Logger::get_logger("core_logger")) {
@@ -258,12 +259,23 @@ int main(int argc, char **argv) {
     attach_console_if_requested(parsed.console_log);
 #endif
 
-    if (!initialize_loggers()) {
+    if (!initialize_loggers(parsed.console_log, parsed.development_mode)) {
         return EXIT_FAILURE;
     }
+    // Declared first so it runs last: queued log lines are written before the process exits.
+    struct LoggerShutdown {
+        ~LoggerShutdown()
+        {
+            Logger::shutdown();
+        }
+    } logger_shutdown;
     curl_global_init(CURL_GLOBAL_DEFAULT);
     struct CurlCleanup {
-        ~CurlCleanup() { curl_global_cleanup(); }
+        ~CurlCleanup()
+        {
+            AsyncHttpEngine::shutdown_shared();
+            curl_global_cleanup();
+        }
     } curl_cleanup;
 
     #ifdef _WIN32
@@ -10,7 +10,7 @@
  *   provider_smoke --provider cloud --base-url https://example.com --health
  * 
  * Environment Variables:
- *   OLLAMA_API_KEY - Required for cloud provider
+ *   OLLAMA_API_KEY - Required for a cloud provider outside the local network
  *   OLLAMA_BASE_URL - Optional override for local provider base URL
  *   OLLAMA_CLOUD_URL - Optional override for cloud provider base URL
  */
@@ -23,6 +23,7 @@
 #include <cstring>
 #include <memory>
 #include <cstdlib>
+#include <vector>
 
 void print_usage(const char* program_name) {
     std::cout << "Usage: " << program_name << " [OPTIONS]\n\n"
@@ -81,7 +82,7 @@ int main(int argc, char* argv[]) {
 
     if (provider_type == "local") {
         if (base_url.empty()) {
-            base_url = get_env_or("OLLAMA_BASE_URL", "http://localhost:11434");
+            base_url = get_env_or("OLLAMA_BASE_URL", LocalOllamaProvider::kDefaultBaseUrl);
         }
         std::cout << "Provider: Local Ollama\n";
         std::cout << "Base URL: " << base_url << "\n\n";
@@ -96,12 +97,13 @@ int main(int argc, char* argv[]) {
         }
         std::cout << "Provider: Ollama Cloud\n";
         std::cout << "Base URL: " << base_url << "\n";
-        
-        auto cloud = std::make_unique<OllamaCloudProvider>(base_url);
-        if (!cloud->has_api_key()) {
-            std::cerr << "Warning: OLLAMA_API_KEY not set\n";
-        } else {
+
+        const std::string api_key = get_env_or("OLLAMA_API_KEY", "");
+        auto cloud = std::make_unique<OllamaCloudProvider>(api_key, base_url, "");
+        if (!api_key.empty()) {
             std::cout << "API Key: (set)\n";
+        } else if (cloud->requires_api_key()) {
+            std::cerr << "Warning: OLLAMA_API_KEY not set\n";
         }
         std::cout << "\n";
         provider = std::move(cloud);
@@ -113,43 +115,40 @@ int main(int argc, char* argv[]) {
 
     if (check_health) {
         std::cout << "Checking health...\n";
-        HealthResult health = provider->check_health();
-        if (health.ok) {
-            std::cout << "Status: OK\n";
-        } else {
-            std::cout << "Status: FAILED\n";
-            std::cout << "Error: " << health.message << "\n";
-            if (health.http_code > 0) {
-                std::cout << "HTTP Code: " << health.http_code << "\n";
-            }
-            return 1;
+        switch (provider->check_health()) {
+            case ProviderHealth::Healthy:
+                std::cout << "Status: OK\n";
+                break;
+            case ProviderHealth::Degraded:
+                std::cout << "Status: DEGRADED (the server answered with an error)\n";
+                return 1;
+            default:
+                std::cout << "Status: FAILED (unreachable, or the API key is missing or rejected)\n";
+                return 1;
         }
     }
 
     if (list_models) {
         std::cout << "Fetching models...\n";
-        ListModelsResult result = provider->list_models();
-        if (!result.ok) {
-            std::cout << "Error: " << result.error_message << "\n";
-            return 1;
-        }
+        const std::vector<ModelInfo> models = provider->list_models();
 
-        std::cout << "\nModels (" << result.models.size() << "):\n";
+        std::cout << "\nModels (" << models.size() << "):\n";
         std::cout << std::string(60, '-') << "\n";
-        
-        for (const auto& model : result.models) {
-            std::cout << "  " << model.display_name() << "\n";
-            if (!model.family.empty()) {
-                std::cout << "    Family: " << model.family << "\n";
+
+        for (const auto& model : models) {
+            std::cout << "  " << model.name;
+            if (!model.description.empty()) {
+                std::cout << " (" << model.description << ")";
             }
+            std::cout << "\n";
             if (model.size_bytes > 0) {
                 double size_gb = static_cast<double>(model.size_bytes) / (1024.0 * 1024.0 * 1024.0);
                 std::cout << "    Size: " << std::fixed << size_gb << " GB\n";
             }
         }
-        
-        if (result.models.empty()) {
-            std::cout << "  (no models found)\n";
+
+        if (models.empty()) {
+            std::cout << "  (no models found; see the log for errors)\n";
         }
     }
 
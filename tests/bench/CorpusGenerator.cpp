@@ -0,0 +1,218 @@
+#include "CorpusGenerator.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+#include <unordered_set>
+
+namespace {
+
+constexpr std::uintmax_t KiB = 1024;
+constexpr std::uintmax_t MiB = 1024 * KiB;
+
+struct Kind {
+    int weight;
+    std::array<std::string_view, 5> extensions;
+    std::uintmax_t min_size;
+    std::uintmax_t max_size;
+};
+
+enum KindIndex { Photo, Screenshot, Document, Installer, Archive, Music, Video, Code, Ebook, Misc, KindCount };
+
+// Weights are per mille of the files.
+constexpr std::array<Kind, KindCount> kKinds{{
+    {200, {".jpg", ".jpg", ".jpeg", ".heic", ".png"}, 800 * KiB, 12 * MiB},
+    {100, {".png", ".png", ".png", ".jpg", ".png"}, 80 * KiB, 4 * MiB},
+    {200, {".pdf", ".pdf", ".docx", ".xlsx", ".txt"}, 8 * KiB, 6 * MiB},
+    {80, {".exe", ".msi", ".dmg", ".deb", ".AppImage"}, 10 * MiB, 600 * MiB},
+    {70, {".zip", ".zip", ".tar.gz", ".7z", ".rar"}, 200 * KiB, 900 * MiB},
+    {100, {".mp3", ".mp3", ".flac", ".m4a", ".ogg"}, 2 * MiB, 60 * MiB},
+    {70, {".mp4", ".mp4", ".mov", ".mkv", ".webm"}, 20 * MiB, 4096 * MiB},
+    {100, {".py", ".cpp", ".js", ".json", ".csv"}, 1 * KiB, 800 * KiB},
+    {60, {".epub", ".pdf", ".mobi", ".epub", ".azw3"}, 300 * KiB, 40 * MiB},
+    {20, {".bin", ".dat", ".tmp", ".log", ".iso"}, 1 * KiB, 100 * MiB},
+}};
+
+constexpr std::array<std::string_view, 24> kWords{
+    "budget", "report", "holiday", "project", "draft", "final", "notes", "summary",
+    "contract", "meeting", "resume", "invoice", "roadmap", "design", "photos", "backup",
+    "client", "quarterly", "tax", "lecture", "recipe", "travel", "family", "release"};
+constexpr std::array<std::string_view, 12> kVendors{
+    "ACME", "Contoso", "Initech", "Globex", "Umbrella", "Hooli",
+    "Stark", "Wayne", "Tyrell", "Soylent", "Cyberdyne", "Vandelay"};
+constexpr std::array<std::string_view, 12> kApps{
+    "vlc", "firefox", "gimp", "blender", "obs-studio", "libreoffice",
+    "vscode", "zoom", "steam", "krita", "audacity", "thunderbird"};
+constexpr std::array<std::string_view, 10> kArtists{
+    "Nils Frahm", "Bonobo", "Khruangbin", "Tycho", "Air", "Portishead",
+    "Massive Attack", "Caribou", "Floating Points", "Jon Hopkins"};
+constexpr std::array<std::string_view, 4> kArchitectures{"x64", "win64", "arm64", "x86_64"};
+
+std::string two_digits(std::size_t value)
+{
+    char buffer[8];
+    std::snprintf(buffer, sizeof(buffer), "%02zu", value % 100);
+    return buffer;
+}
+
+std::string capitalized(std::string_view word)
+{
+    std::string text(word);
+    if (!text.empty() && text[0] >= 'a' && text[0] <= 'z') {
+        text[0] = static_cast<char>(text[0] - 'a' + 'A');
+    }
+    return text;
+}
+
+} // namespace
+
+CorpusGenerator::CorpusGenerator(std::uint64_t seed)
+    : state_(seed)
+{
+}
+
+std::uint64_t CorpusGenerator::next()
+{
+    // splitmix64: the standard distributions differ between library vendors, this does not.
+    std::uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+std::size_t CorpusGenerator::pick(std::size_t bound)
+{
+    return static_cast<std::size_t>(next() % bound);
+}
+
+std::vector<CorpusGenerator::Item> CorpusGenerator::generate(std::size_t count)
+{
+    std::vector<Item> items;
+    items.reserve(count);
+    std::unordered_set<std::string> taken;
+    taken.reserve(count);
+
+    const auto word = [this]() { return std::string(kWords[pick(kWords.size())]); };
+    const auto date = [this](std::string_view separator) {
+        return std::to_string(2015 + pick(11)) + std::string(separator) + two_digits(1 + pick(12)) +
+               std::string(separator) + two_digits(1 + pick(28));
+    };
+    const auto time = [this](std::string_view separator) {
+        return two_digits(pick(24)) + std::string(separator) + two_digits(pick(60)) + std::string(separator) +
+               two_digits(pick(60));
+    };
+
+    for (std::size_t index = 0; index < count; ++index) {
+        Item item;
+        std::string extension;
+        if (pick(50) == 0) {
+            item.directory = true;
+            item.name = pick(2) == 0
+                ? capitalized(word()) + " " + word() + " " + std::to_string(2015 + pick(11))
+                : std::string(kArtists[pick(kArtists.size())]) + " - " + capitalized(word());
+        } else {
+            std::size_t roll = pick(1000);
+            std::size_t kind_index = 0;
+            while (kind_index + 1 < kKinds.size() && roll >= static_cast<std::size_t>(kKinds[kind_index].weight)) {
+                roll -= static_cast<std::size_t>(kKinds[kind_index].weight);
+                ++kind_index;
+            }
+            const Kind& kind = kKinds[kind_index];
+            extension = std::string(kind.extensions[pick(kind.extensions.size())]);
+
+            switch (kind_index) {
+            case Photo:
+                item.name = "IMG_" + date("") + "_" + time("");
+                break;
+            case Screenshot:
+                item.name = "Screenshot " + date("-") + " at " + time(".");
+                break;
+            case Document:
+                item.name = pick(3) == 0
+                    ? "Invoice_" + date("-").substr(0, 7) + "_" + std::string(kVendors[pick(kVendors.size())])
+                    : word() + "-" + word() + "-v" + std::to_string(1 + pick(6));
+                break;
+            case Installer:
+                item.name = std::string(kApps[pick(kApps.size())]) + "-" + std::to_string(pick(20)) + "." +
+                            std::to_string(pick(10)) + "." + std::to_string(pick(30)) + "-" +
+                            std::string(kArchitectures[pick(kArchitectures.size())]);
+                break;
+            case Archive:
+                item.name = word() + "_" + word() + "_" + date("");
+                break;
+            case Music:
+                item.name = std::string(kArtists[pick(kArtists.size())]) + " - " + two_digits(1 + pick(14)) + " " +
+                            capitalized(word()) + " " + word();
+                break;
+            case Video:
+                item.name = "VID_" + date("") + "_" + time("");
+                break;
+            case Code:
+                item.name = word() + "_" + word();
+                break;
+            case Ebook:
+                item.name = capitalized(word()) + " of the " + capitalized(word()) + " (" +
+                            std::to_string(1950 + pick(75)) + ")";
+                break;
+            default:
+                item.name = "download (" + std::to_string(pick(40)) + ")";
+                break;
+            }
+
+            // Log-uniform between the bounds: many small files, a few large ones.
+            const double unit = static_cast<double>(next() >> 11) / static_cast<double>(1ULL << 53);
+            const double low = std::log(static_cast<double>(kind.min_size));
+            const double high = std::log(static_cast<double>(kind.max_size));
+            item.size_bytes = static_cast<std::uintmax_t>(std::exp(low + unit * (high - low)));
+        }
+
+        if (!taken.insert(item.name + extension).second) {
+            // Browsers number repeated downloads the same way.
+            for (std::size_t copy = 1;; ++copy) {
+                std::string candidate = item.name + " (" + std::to_string(copy) + ")" + extension;
+                if (taken.insert(candidate).second) {
+                    item.name = std::move(candidate);
+                    extension.clear();
+                    break;
+                }
+            }
+        }
+        item.name += extension;
+        items.push_back(std::move(item));
+    }
+    return items;
+}
+
+std::size_t CorpusGenerator::materialize(const std::filesystem::path& root, const std::vector<Item>& items)
+{
+    std::size_t created = 0;
+    for (const auto& item : items) {
+        const std::filesystem::path path = root / Utils::utf8_to_path(item.name);
+        std::error_code ec;
+        if (item.directory) {
+            if (std::filesystem::create_directory(path, ec)) {
+                std::ofstream(path / "readme.txt") << item.name << '\n';
+                ++created;
+            }
+            continue;
+        }
+        {
+            std::ofstream out(path, std::ios::binary);
+            if (!out) {
+                continue;
+            }
+            // A few real bytes so fingerprints differ between files.
+            out << item.name;
+        }
+        std::filesystem::resize_file(path, std::max<std::uintmax_t>(item.size_bytes, item.name.size()), ec);
+        if (!ec) {
+            ++created;
+        }
+    }
+    return created;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Builds a synthetic download folder for the benchmarks: camera shots, screenshots, invoices,
+// installers, archives, music and source files in roughly the mix a real Downloads folder has,
+// with sizes drawn per kind. The same seed always yields the same names and sizes. Files are
+// created sparse, so a million-entry corpus costs inodes rather than disk space.
+class CorpusGenerator {
+public:
+    struct Item {
+        std::string name;
+        std::uintmax_t size_bytes{0};
+        bool directory{false};
+    };
+
+    explicit CorpusGenerator(std::uint64_t seed = 0x5eed);
+
+    // `count` entries with unique names; about one in fifty is a directory.
+    std::vector<Item> generate(std::size_t count);
+    // Creates the items under `root`, which must exist. Returns the number created.
+    static std::size_t materialize(const std::filesystem::path& root, const std::vector<Item>& items);
+
+private:
+    std::uint64_t next();
+    std::size_t pick(std::size_t bound);
+
+    std::uint64_t state_;
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "ILLMClient.hpp"
+#include "JsonWriter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <thread>
+#include <utility>
+
+// Stands in for a model in the benchmarks. The label depends only on the file name, so every
+// run asks for and stores the same categories; `latency` is slept per request to model the
+// model's own cost. One reply in `drift_every` uses a variant spelling ("Document : Repotrs") so
+// the fuzzy resolver and the consistency pass have something to do. The consistency prompt is
+// answered by moving every listed item back to its canonical label.
+class MockLLMClient : public ILLMClient {
+public:
+    struct Options {
+        std::chrono::microseconds latency{0};
+        unsigned drift_every{10};
+    };
+
+    MockLLMClient() = default;
+    explicit MockLLMClient(Options options)
+        : options_(options)
+    {
+    }
+
+    std::string categorize_file(const std::string& file_name,
+                                const std::string&,
+                                FileType file_type,
+                                const std::string&) override
+    {
+        wait();
+        requests_.fetch_add(1, std::memory_order_relaxed);
+        auto label = file_type == FileType::Directory
+            ? std::pair<std::string, std::string>{"Folders", "Projects"}
+            : canonical_label(file_name);
+        if (options_.drift_every > 0 && fnv1a(file_name) % options_.drift_every == 0) {
+            label = drifted(label);
+        }
+        return label.first + " : " + label.second;
+    }
+
+    std::string complete_prompt(const std::string& prompt, int) override
+    {
+        wait();
+        requests_.fetch_add(1, std::memory_order_relaxed);
+        std::string entries;
+        for (std::size_t at = prompt.find("- id: "); at != std::string::npos; at = prompt.find("- id: ", at + 1)) {
+            const std::size_t begin = at + 6;
+            const std::string id = prompt.substr(begin, prompt.find(',', begin) - begin);
+            const auto label = canonical_label(id.substr(id.find_last_of("/\\") + 1));
+            std::string entry;
+            JsonWriter(entry).begin_object()
+                .key("id").value(id)
+                .key("category").value(label.first)
+                .key("subcategory").value(label.second)
+                .end_object();
+            entries += (entries.empty() ? "" : ",") + entry;
+        }
+        return "{\"harmonized\":[" + entries + "]}";
+    }
+
+    void set_prompt_logging_enabled(bool) override {}
+
+    std::size_t request_count() const { return requests_.load(std::memory_order_relaxed); }
+
+    static std::pair<std::string, std::string> canonical_label(const std::string& file_name)
+    {
+        const std::size_t dot = file_name.find_last_of('.');
+        std::string extension = dot == std::string::npos ? std::string() : file_name.substr(dot + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        const auto is = [&extension](std::initializer_list<const char*> list) {
+            return std::find(list.begin(), list.end(), extension) != list.end();
+        };
+
+        if (is({"jpg", "jpeg", "heic", "png"})) {
+            return {"Images", file_name.rfind("Screenshot", 0) == 0 ? "Screenshots" : "Photos"};
+        }
+        if (is({"pdf", "docx", "xlsx", "txt"})) {
+            return {"Documents", file_name.rfind("Invoice", 0) == 0 ? "Invoices" : "Reports"};
+        }
+        if (is({"exe", "msi", "dmg", "deb", "appimage"})) {
+            return {"Software", "Installers"};
+        }
+        if (is({"zip", "gz", "7z", "rar", "iso"})) {
+            return {"Archives", "Compressed"};
+        }
+        if (is({"mp3", "flac", "m4a", "ogg"})) {
+            return {"Music", "Tracks"};
+        }
+        if (is({"mp4", "mov", "mkv", "webm"})) {
+            return {"Videos", "Recordings"};
+        }
+        if (is({"py", "cpp", "js", "json", "csv"})) {
+            return {"Development", "Source Code"};
+        }
+        if (is({"epub", "mobi", "azw3"})) {
+            return {"Books", "Ebooks"};
+        }
+        return {"Miscellaneous", "Other"};
+    }
+
+    // FNV-1a, so the drifting names are the same with every standard library.
+    static std::uint64_t fnv1a(const std::string& text)
+    {
+        std::uint64_t hash = 0xcbf29ce484222325ULL;
+        for (unsigned char c : text) {
+            hash = (hash ^ c) * 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    // The variant spelling a drifting reply uses: "Documents : Reports" becomes "Document : Repotrs".
+    static std::pair<std::string, std::string> drifted(const std::pair<std::string, std::string>& label)
+    {
+        std::string category = label.first;
+        if (category.size() > 4 && category.back() == 's') {
+            category.pop_back();
+        }
+        std::string subcategory = label.second;
+        if (subcategory.size() > 5) {
+            std::swap(subcategory[subcategory.size() - 2], subcategory[subcategory.size() - 3]);
+        }
+        return {category, subcategory};
+    }
+
+private:
+    void wait() const
+    {
+        if (options_.latency.count() > 0) {
+            std::this_thread::sleep_for(options_.latency);
+        }
+    }
+
+    Options options_{};
+    std::atomic<std::size_t> requests_{0};
+};
@@ -0,0 +1,422 @@
+/*
+ * End-to-end benchmarks
+ *
+ * Runs the sorting pipeline on generated corpora with a mock model and writes the timings as
+ * JSON, so runs on the same machine can be compared from one commit to the next.
+ *
+ * Usage:
+ *   ai_file_sorter_bench [--sizes 1000,100000] [--latency-us 0] [--sample 5000]
+ *                        [--output bench.json] [--work-dir DIR] [--keep]
+ *
+ * Each corpus size runs: corpus generation, FileScanner, DatabaseManager inserts (one by one
+ * and batched), lookups and fuzzy category resolution, CategorizationService with an empty
+ * and a warm cache, the consistency pass, the move executor with its journal, and undo.
+ * Single-row inserts, categorization and the consistency pass see at most --sample entries:
+ * each row insert is its own transaction and each mock request its own thread, so they are
+ * measured per item rather than run over a million entries.
+ */
+
+#include "CategorizationService.hpp"
+#include "ConsistencyPassService.hpp"
+#include "CorpusGenerator.hpp"
+#include "DatabaseManager.hpp"
+#include "FileFingerprint.hpp"
+#include "FileScanner.hpp"
+#include "JsonWriter.hpp"
+#include "Metrics.hpp"
+#include "MockLLMClient.hpp"
+#include "MovableCategorizedFile.hpp"
+#include "MoveJournal.hpp"
+#include "Settings.hpp"
+#include "UndoManager.hpp"
+#include "Utils.hpp"
+
+#include <QCoreApplication>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Options {
+    std::vector<std::size_t> sizes{1000, 100000};
+    std::chrono::microseconds latency{0};
+    std::size_t sample_items{5000};
+    std::string output;
+    fs::path work_dir;
+    bool keep{false};
+};
+
+struct Result {
+    std::string benchmark;
+    std::size_t corpus_size{0};
+    std::size_t items{0};
+    double seconds{0.0};
+    std::string stages_json;
+};
+
+void print_usage(const char* program_name)
+{
+    std::cout << "Usage: " << program_name << " [OPTIONS]\n\n"
+              << "Options:\n"
+              << "  --sizes <n,n,...>     Corpus sizes to run (default 1000,100000)\n"
+              << "  --latency-us <us>     Mock model latency per request (default 0)\n"
+              << "  --sample <n>          Entries used for row inserts and the mock model (default 5000)\n"
+              << "  --output <file>       Write the results as JSON\n"
+              << "  --work-dir <dir>      Where corpora are generated (default: system temp)\n"
+              << "  --keep                Keep the generated corpora\n"
+              << "  --help                Show this help message\n";
+}
+
+std::vector<std::size_t> parse_sizes(const std::string& text)
+{
+    std::vector<std::size_t> sizes;
+    std::size_t begin = 0;
+    while (begin <= text.size()) {
+        const std::size_t end = std::min(text.find(',', begin), text.size());
+        const std::string part = text.substr(begin, end - begin);
+        if (!part.empty()) {
+            sizes.push_back(static_cast<std::size_t>(std::strtoull(part.c_str(), nullptr, 10)));
+        }
+        begin = end + 1;
+    }
+    sizes.erase(std::remove(sizes.begin(), sizes.end(), std::size_t{0}), sizes.end());
+    return sizes;
+}
+
+// Times `body`, which returns the number of items it processed, together with the stage metrics
+// the production code records along the way.
+template <typename Body>
+Result measure(const std::string& name, std::size_t corpus_size, Body&& body)
+{
+    Metrics::instance().reset();
+    const auto start = std::chrono::steady_clock::now();
+    const std::size_t items = body();
+    const auto end = std::chrono::steady_clock::now();
+
+    Result result;
+    result.benchmark = name;
+    result.corpus_size = corpus_size;
+    result.items = items;
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.stages_json = Metrics::instance().to_json();
+
+    std::printf("%-30s %9zu items %10.3f s %12.0f items/s\n",
+                name.c_str(), items, result.seconds,
+                result.seconds > 0.0 ? static_cast<double>(items) / result.seconds : 0.0);
+    std::fflush(stdout);
+    return result;
+}
+
+std::string file_type_code(FileType type)
+{
+    return type == FileType::Directory ? "D" : "F";
+}
+
+std::time_t mtime_of(const fs::path& path)
+{
+    std::error_code ec;
+    const auto ftime = fs::last_write_time(path, ec);
+    if (ec) {
+        return 0;
+    }
+    const auto sys = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+        ftime - fs::file_time_type::clock::now() + std::chrono::system_clock::now());
+    return std::chrono::system_clock::to_time_t(sys);
+}
+
+void run_size(std::size_t size, const Options& options, Settings& settings, std::vector<Result>& results)
+{
+    const fs::path root = options.work_dir / ("corpus-" + std::to_string(size));
+    std::error_code ec;
+    fs::remove_all(root, ec);
+    const fs::path inbox = root / "inbox";
+    fs::create_directories(inbox);
+    fs::create_directories(root / "db");
+    fs::create_directories(root / "db-llm");
+    const std::string dir_path = inbox.generic_string();
+
+    std::printf("\n== %zu entries in %s\n", size, dir_path.c_str());
+
+    std::vector<CorpusGenerator::Item> corpus;
+    results.push_back(measure("corpus_generate", size, [&]() {
+        corpus = CorpusGenerator().generate(size);
+        return CorpusGenerator::materialize(inbox, corpus);
+    }));
+
+    std::vector<FileEntry> entries;
+    results.push_back(measure("file_scanner", size, [&]() {
+        entries = FileScanner().get_directory_entries(dir_path, FileScanOptions::Files | FileScanOptions::Directories);
+        return entries.size();
+    }));
+    // Directory order differs between file systems; the rest of the run should not.
+    std::sort(entries.begin(), entries.end(),
+              [](const FileEntry& a, const FileEntry& b) { return a.file_name < b.file_name; });
+
+    // Evenly spaced, so the sample keeps the corpus mix rather than the names starting with 'A'.
+    std::vector<FileEntry> sample;
+    const std::size_t stride = std::max<std::size_t>(1, entries.size() / std::max<std::size_t>(1, options.sample_items));
+    for (std::size_t index = 0; index < entries.size() && sample.size() < options.sample_items; index += stride) {
+        sample.push_back(entries[index]);
+    }
+
+    {
+        DatabaseManager db((root / "db").string());
+        std::map<std::pair<std::string, std::string>, DatabaseManager::ResolvedCategory> labels;
+        const auto label_for = [&](const FileEntry& entry) -> const DatabaseManager::ResolvedCategory& {
+            const auto label = entry.type == FileType::Directory
+                ? std::pair<std::string, std::string>{"Folders", "Projects"}
+                : MockLLMClient::canonical_label(entry.file_name);
+            auto it = labels.find(label);
+            if (it == labels.end()) {
+                it = labels.emplace(label, db.resolve_category(label.first, label.second)).first;
+            }
+            return it->second;
+        };
+
+        results.push_back(measure("db_insert", size, [&]() {
+            std::size_t written = 0;
+            for (const auto& entry : sample) {
+                written += db.insert_or_update_file_with_categorization(
+                    entry.file_name, file_type_code(entry.type), dir_path, label_for(entry), false) ? 1 : 0;
+            }
+            return written;
+        }));
+
+        results.push_back(measure("db_insert_batched", size, [&]() {
+            std::vector<DatabaseManager::CategorizationUpdate> updates;
+            updates.reserve(entries.size());
+            for (const auto& entry : entries) {
+                const auto& resolved = label_for(entry);
+                updates.push_back({entry.file_name, file_type_code(entry.type), dir_path, resolved, false,
+                                   resolved.taxonomy_id});
+            }
+            return db.apply_categorization_updates(updates) ? updates.size() : 0;
+        }));
+
+        results.push_back(measure("db_lookup", size, [&]() {
+            std::size_t found = 0;
+            for (const auto& entry : entries) {
+                found += db.get_categorization_from_db(entry.file_name, entry.type).empty() ? 0 : 1;
+            }
+            return found;
+        }));
+
+        results.push_back(measure("db_resolve_fuzzy", size, [&]() {
+            std::size_t resolved = 0;
+            for (const auto& entry : entries) {
+                const auto label = MockLLMClient::drifted(MockLLMClient::canonical_label(entry.file_name));
+                resolved += db.resolve_category(label.first, label.second).taxonomy_id > 0 ? 1 : 0;
+            }
+            return resolved;
+        }));
+    }
+
+    DatabaseManager llm_db((root / "db-llm").string());
+    CategorizationService service(settings, llm_db, nullptr);
+    const MockLLMClient::Options mock_options{options.latency, 10};
+    const auto factory = [&mock_options]() { return std::make_unique<MockLLMClient>(mock_options); };
+    std::atomic<bool> stop{false};
+
+    std::vector<CategorizedFile> categorized;
+    results.push_back(measure("categorization_service", size, [&]() {
+        categorized = service.categorize_entries(sample, true, stop, nullptr, nullptr, nullptr, factory);
+        return categorized.size();
+    }));
+    results.push_back(measure("categorization_service_cached", size, [&]() {
+        return service.categorize_entries(sample, true, stop, nullptr, nullptr, nullptr, factory).size();
+    }));
+
+    results.push_back(measure("consistency_pass", size, [&]() {
+        ConsistencyPassService consistency(llm_db, nullptr);
+        consistency.set_max_parallel(std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<CategorizedFile> new_items;
+        consistency.run(categorized, new_items, factory, stop, nullptr);
+        return categorized.size();
+    }));
+
+    // Moves every entry into its category folder the way the categorization dialog does:
+    // intents are journaled per batch before the renames, results recorded after them.
+    UndoManager undo((root / "undo").string());
+    QString plan_path;
+    std::size_t moved = 0;
+    results.push_back(measure("move_executor", size, [&]() {
+        auto journal = undo.begin_run(dir_path, nullptr);
+        if (!journal) {
+            return std::size_t{0};
+        }
+        plan_path = QString::fromStdString(journal->path());
+        constexpr std::size_t kBatch = 512;
+        for (std::size_t first = 0; first < entries.size(); first += kBatch) {
+            const std::size_t last = std::min(entries.size(), first + kBatch);
+            std::vector<MovableCategorizedFile> files;
+            std::vector<MoveJournal::Intent> intents;
+            for (std::size_t index = first; index < last; ++index) {
+                const auto& entry = entries[index];
+                const auto label = entry.type == FileType::Directory
+                    ? std::pair<std::string, std::string>{"Folders", "Projects"}
+                    : MockLLMClient::canonical_label(entry.file_name);
+                files.emplace_back(dir_path, label.first, label.second, entry.file_name);
+                const auto paths = files.back().preview_move_paths(true);
+                intents.push_back({paths.source, paths.destination, label.first, label.second, SortMode::Move});
+            }
+            const auto first_seq = journal->append_intents(intents);
+            for (std::size_t index = 0; index < files.size(); ++index) {
+                auto& file = files[index];
+                file.create_cat_dirs(true);
+                const auto outcome = file.place_file(true, SortMode::Move);
+                if (!first_seq) {
+                    continue;
+                }
+                if (outcome != MovableCategorizedFile::PlaceResult::Placed) {
+                    journal->record_failed(*first_seq + index);
+                    continue;
+                }
+                const fs::path destination = Utils::utf8_to_path(intents[index].destination);
+                std::error_code size_ec;
+                const auto size_bytes = fs::is_directory(destination) ? 0 : fs::file_size(destination, size_ec);
+                journal->record_moved(*first_seq + index, size_ec ? 0 : size_bytes, mtime_of(destination),
+                                      FileFingerprint::partial(destination).value_or(0));
+                ++moved;
+            }
+        }
+        undo.finish_run(std::move(journal), static_cast<std::int64_t>(moved));
+        return moved;
+    }));
+
+    results.push_back(measure("undo", size, [&]() {
+        if (plan_path.isEmpty()) {
+            return std::size_t{0};
+        }
+        const auto undone = undo.undo_plan(plan_path);
+        if (static_cast<std::size_t>(undone.restored) != moved) {
+            std::fprintf(stderr, "undo restored %d of %zu moved entries\n", undone.restored, moved);
+        }
+        return static_cast<std::size_t>(undone.restored);
+    }));
+
+    if (!options.keep) {
+        fs::remove_all(root, ec);
+    }
+}
+
+std::string results_json(const Options& options, const std::vector<Result>& results)
+{
+    char timestamp[32];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    std::string text;
+    JsonWriter writer(text);
+    writer.begin_object()
+        .key("schema").value(1)
+        .key("timestamp").value(timestamp)
+        .key("hardware_threads").value(std::thread::hardware_concurrency())
+        .key("mock_latency_us").value(static_cast<std::int64_t>(options.latency.count()))
+        .key("sample_items").value(options.sample_items)
+        .key("results").begin_array();
+    for (const auto& result : results) {
+        writer.begin_object()
+            .key("benchmark").value(result.benchmark)
+            .key("corpus_size").value(result.corpus_size)
+            .key("items").value(result.items)
+            .key("seconds").value(result.seconds)
+            .key("items_per_second").value(result.seconds > 0.0 ? static_cast<double>(result.items) / result.seconds : 0.0)
+            .key("metrics").raw(result.stages_json)
+            .end_object();
+    }
+    writer.end_array().end_object();
+    text += '\n';
+    return text;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (std::strcmp(argv[i], "--sizes") == 0 && has_value) {
+            options.sizes = parse_sizes(argv[++i]);
+        } else if (std::strcmp(argv[i], "--latency-us") == 0 && has_value) {
+            options.latency = std::chrono::microseconds(std::strtoll(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--sample") == 0 && has_value) {
+            options.sample_items = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--output") == 0 && has_value) {
+            options.output = argv[++i];
+        } else if (std::strcmp(argv[i], "--work-dir") == 0 && has_value) {
+            options.work_dir = Utils::utf8_to_path(argv[++i]);
+        } else if (std::strcmp(argv[i], "--keep") == 0) {
+            options.keep = true;
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << "\n\n";
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.sizes.empty()) {
+        std::cerr << "No corpus sizes given\n";
+        return 1;
+    }
+
+    QCoreApplication app(argc, argv);
+    const bool temporary_work_dir = options.work_dir.empty();
+    if (temporary_work_dir) {
+        options.work_dir = fs::temp_directory_path() /
+            ("aifs-bench-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    }
+    fs::create_directories(options.work_dir);
+
+    // Keeps the user's settings, whitelists and categorization cache out of the measurements.
+    const std::string config_dir = (options.work_dir / "config").string();
+#ifdef _WIN32
+    _putenv_s("AI_FILE_SORTER_CONFIG_DIR", config_dir.c_str());
+#else
+    setenv("AI_FILE_SORTER_CONFIG_DIR", config_dir.c_str(), 1);
+#endif
+    Settings settings;
+    settings.load();
+
+    std::vector<Result> results;
+    for (const std::size_t size : options.sizes) {
+        run_size(size, options, settings, results);
+    }
+
+    const std::string json = results_json(options, results);
+    if (options.output.empty()) {
+        std::cout << '\n' << json;
+    } else {
+        std::ofstream out(Utils::utf8_to_path(options.output), std::ios::binary);
+        out << json;
+        if (!out) {
+            std::cerr << "Could not write " << options.output << '\n';
+            return 1;
+        }
+        std::printf("\nWrote %s\n", options.output.c_str());
+    }
+
+    if (temporary_work_dir && !options.keep) {
+        std::error_code ec;
+        fs::remove_all(options.work_dir, ec);
+    }
+    return 0;
+}
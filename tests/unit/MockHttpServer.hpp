@@ -0,0 +1,229 @@
+#pragma once
+
+#ifndef _WIN32
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Minimal HTTP/1.1 server on 127.0.0.1 for exercising the network code without a real endpoint.
+// Connections are kept alive and served on their own thread, so tests can count how many
+// connections a client opened as well as how many requests it sent.
+class MockHttpServer {
+public:
+    struct Request {
+        std::string method;
+        std::string path;
+        std::map<std::string, std::string> headers; // lower-case names
+        std::string body;
+    };
+
+    struct Reply {
+        int status{200};
+        std::string body;
+        std::string content_type{"application/json"};
+        // Extra response headers, e.g. Content-Range.
+        std::vector<std::pair<std::string, std::string>> headers;
+        // When set, the body is ignored and these are sent with chunked encoding, one write each.
+        std::vector<std::string> chunks;
+        std::chrono::milliseconds chunk_delay{0};
+    };
+
+    using Handler = std::function<Reply(const Request&)>;
+
+    explicit MockHttpServer(Handler handler)
+        : handler_(std::move(handler))
+    {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        ::listen(listen_fd_, 64);
+        socklen_t length = sizeof(address);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length);
+        port_ = ntohs(address.sin_port);
+        accept_thread_ = std::thread([this]() { accept_loop(); });
+    }
+
+    ~MockHttpServer()
+    {
+        stop_ = true;
+        accept_thread_.join();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (int fd : client_fds_) {
+                ::shutdown(fd, SHUT_RDWR);
+            }
+        }
+        for (auto& thread : client_threads_) {
+            thread.join();
+        }
+        for (int fd : client_fds_) {
+            ::close(fd);
+        }
+        ::close(listen_fd_);
+    }
+
+    MockHttpServer(const MockHttpServer&) = delete;
+    MockHttpServer& operator=(const MockHttpServer&) = delete;
+
+    std::string base_url() const { return "http://127.0.0.1:" + std::to_string(port_); }
+    int connection_count() const { return connections_.load(); }
+    int request_count() const { return requests_.load(); }
+
+private:
+    void accept_loop()
+    {
+        while (!stop_) {
+            pollfd descriptor{listen_fd_, POLLIN, 0};
+            if (::poll(&descriptor, 1, 50) <= 0) {
+                continue;
+            }
+            const int client = ::accept(listen_fd_, nullptr, nullptr);
+            if (client < 0) {
+                continue;
+            }
+            ++connections_;
+            std::lock_guard<std::mutex> lock(mutex_);
+            client_fds_.push_back(client);
+            client_threads_.emplace_back([this, client]() { serve(client); });
+        }
+    }
+
+    static bool send_all(int fd, const std::string& data)
+    {
+        std::size_t sent = 0;
+        while (sent < data.size()) {
+            const ssize_t written = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0) {
+                return false;
+            }
+            sent += static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    static std::string lower(std::string value)
+    {
+        std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) {
+            return static_cast<char>(std::tolower(c));
+        });
+        return value;
+    }
+
+    void serve(int fd)
+    {
+        // The descriptor is closed by the destructor, after every connection thread has finished.
+        std::string buffer;
+        char chunk[4096];
+        while (!stop_) {
+            std::size_t header_end = buffer.find("\r\n\r\n");
+            while (header_end == std::string::npos) {
+                const ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (received <= 0) {
+                    return;
+                }
+                buffer.append(chunk, static_cast<std::size_t>(received));
+                header_end = buffer.find("\r\n\r\n");
+            }
+
+            Request request;
+            const std::string head = buffer.substr(0, header_end);
+            std::size_t line_end = head.find("\r\n");
+            const std::string request_line = head.substr(0, line_end);
+            const std::size_t first_space = request_line.find(' ');
+            const std::size_t second_space = request_line.find(' ', first_space + 1);
+            request.method = request_line.substr(0, first_space);
+            request.path = request_line.substr(first_space + 1, second_space - first_space - 1);
+            while (line_end != std::string::npos && line_end < head.size()) {
+                const std::size_t next = head.find("\r\n", line_end + 2);
+                const std::string line = head.substr(line_end + 2, next == std::string::npos ? std::string::npos
+                                                                                              : next - line_end - 2);
+                const std::size_t colon = line.find(':');
+                if (colon != std::string::npos) {
+                    std::string value = line.substr(colon + 1);
+                    value.erase(0, value.find_first_not_of(' '));
+                    request.headers[lower(line.substr(0, colon))] = value;
+                }
+                line_end = next;
+            }
+
+            std::size_t content_length = 0;
+            if (const auto it = request.headers.find("content-length"); it != request.headers.end()) {
+                content_length = static_cast<std::size_t>(std::strtoul(it->second.c_str(), nullptr, 10));
+            }
+            while (buffer.size() < header_end + 4 + content_length) {
+                const ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (received <= 0) {
+                    return;
+                }
+                buffer.append(chunk, static_cast<std::size_t>(received));
+            }
+            request.body = buffer.substr(header_end + 4, content_length);
+            buffer.erase(0, header_end + 4 + content_length);
+            ++requests_;
+
+            const Reply reply = handler_(request);
+            std::string response = "HTTP/1.1 " + std::to_string(reply.status) + " OK\r\n" +
+                                   "Content-Type: " + reply.content_type + "\r\n";
+            for (const auto& [name, value] : reply.headers) {
+                response += name + ": " + value + "\r\n";
+            }
+            if (reply.chunks.empty()) {
+                response += "Content-Length: " + std::to_string(reply.body.size()) + "\r\n\r\n" + reply.body;
+                if (!send_all(fd, response)) {
+                    break;
+                }
+                continue;
+            }
+
+            response += "Transfer-Encoding: chunked\r\n\r\n";
+            bool sent = send_all(fd, response);
+            for (const auto& piece : reply.chunks) {
+                if (!sent) {
+                    break;
+                }
+                std::this_thread::sleep_for(reply.chunk_delay);
+                char size_line[32];
+                std::snprintf(size_line, sizeof(size_line), "%zx\r\n", piece.size());
+                sent = send_all(fd, size_line + piece + "\r\n");
+            }
+            if (!sent || !send_all(fd, "0\r\n\r\n")) {
+                break;
+            }
+        }
+    }
+
+    Handler handler_;
+    int listen_fd_{-1};
+    int port_{0};
+    std::atomic<bool> stop_{false};
+    std::atomic<int> connections_{0};
+    std::atomic<int> requests_{0};
+    std::thread accept_thread_;
+    std::mutex mutex_;
+    std::vector<int> client_fds_;
+    std::vector<std::thread> client_threads_;
+};
+
+#endif // !_WIN32
@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+#include "AsyncHttpEngine.hpp"
+#include "MockHttpServer.hpp"
+
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+
+namespace {
+
+MockHttpServer::Reply slow_reply(std::chrono::milliseconds delay)
+{
+    MockHttpServer::Reply reply;
+    reply.chunks = {"late"};
+    reply.chunk_delay = delay;
+    return reply;
+}
+
+} // namespace
+
+TEST_CASE("AsyncHttpEngine completes many concurrent requests on one thread") {
+    MockHttpServer server([](const MockHttpServer::Request& request) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        MockHttpServer::Reply reply;
+        reply.body = request.body;
+        return reply;
+    });
+
+    AsyncHttpEngine engine;
+    std::vector<std::future<HttpTransport::Response>> responses;
+    for (int i = 0; i < 32; ++i) {
+        HttpTransport::Request request;
+        request.method = HttpTransport::Method::Post;
+        request.url = server.base_url() + "/v1/chat/completions";
+        request.body = std::to_string(i);
+        responses.push_back(engine.fetch(std::move(request)));
+    }
+
+    for (int i = 0; i < 32; ++i) {
+        const auto response = responses[static_cast<std::size_t>(i)].get();
+        REQUIRE(response.ok());
+        CHECK(response.body == std::to_string(i));
+    }
+    CHECK(server.request_count() == 32);
+    CHECK(server.connection_count() <= static_cast<int>(AsyncHttpEngine::kMaxConnectionsPerHost));
+}
+
+TEST_CASE("AsyncHttpEngine cancels an in-flight request") {
+    MockHttpServer server([](const MockHttpServer::Request&) { return slow_reply(std::chrono::milliseconds(1000)); });
+
+    AsyncHttpEngine engine;
+    HttpTransport::Request request;
+    request.url = server.base_url() + "/slow";
+    AsyncHttpEngine::RequestId id = 0;
+    auto future = engine.fetch(request, {}, &id);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    engine.cancel(id);
+
+    REQUIRE(future.wait_for(std::chrono::milliseconds(500)) == std::future_status::ready);
+    const auto response = future.get();
+    CHECK_FALSE(response.ok());
+    CHECK(response.error == "Cancelled");
+}
+
+TEST_CASE("AsyncHttpEngine fails a request once its deadline passes") {
+    MockHttpServer server([](const MockHttpServer::Request&) { return slow_reply(std::chrono::milliseconds(1000)); });
+
+    AsyncHttpEngine engine;
+    HttpTransport::Request request;
+    request.url = server.base_url() + "/slow";
+    AsyncHttpEngine::Options options;
+    options.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(150);
+    auto future = engine.fetch(request, options);
+
+    REQUIRE(future.wait_for(std::chrono::milliseconds(800)) == std::future_status::ready);
+    const auto response = future.get();
+    CHECK_FALSE(response.ok());
+    CHECK_FALSE(response.error.empty());
+}
+
+TEST_CASE("AsyncHttpEngine fails pending requests on shutdown") {
+    MockHttpServer server([](const MockHttpServer::Request&) { return slow_reply(std::chrono::milliseconds(1000)); });
+
+    AsyncHttpEngine engine;
+    HttpTransport::Request request;
+    request.url = server.base_url() + "/slow";
+    auto future = engine.fetch(request);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    engine.shutdown();
+
+    REQUIRE(future.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready);
+    CHECK_FALSE(future.get().ok());
+
+    const auto rejected = engine.fetch(request).get();
+    CHECK_FALSE(rejected.ok());
+}
+
+#endif // !_WIN32
@@ -147,8 +147,50 @@ TEST_CASE("CategorizationDialog undo restores moved files") {
 
     REQUIRE(std::filesystem::exists(source));
     REQUIRE_FALSE(std::filesystem::exists(destination));
+    REQUIRE_FALSE(std::filesystem::exists(base / file.category));
     REQUIRE_FALSE(dialog.test_undo_enabled());
 }
+
+TEST_CASE("CategorizationDialog replaces duplicate copies with hard links") {
+    EnvVarGuard platform_guard("QT_QPA_PLATFORM", "offscreen");
+    QtAppContext qt_context;
+
+    TempDir temp_dir;
+    const std::filesystem::path base = temp_dir.path();
+    std::ofstream(base / "invoice.pdf") << "same contents";
+    std::ofstream(base / "invoice (1).pdf") << "same contents";
+    // The replaced copy goes to the trash; keep that inside the test directory.
+    TempDir data_home;
+    EnvVarGuard data_home_guard("XDG_DATA_HOME", data_home.path().string());
+
+    auto make_entry = [&](const std::string& name) {
+        CategorizedFile file;
+        file.file_path = base.string();
+        file.file_name = name;
+        file.type = FileType::File;
+        file.category = "Docs";
+        file.subcategory = "Invoices";
+        return file;
+    };
+
+    TempDir undo_dir_for_dialog;
+    CategorizationDialog dialog(nullptr, true, undo_dir_for_dialog.path().string());
+    dialog.test_set_entries({make_entry("invoice.pdf"), make_entry("invoice (1).pdf")});
+    dialog.test_set_duplicate_action(DuplicateAction::HardLink);
+    dialog.test_trigger_confirm();
+
+    const std::filesystem::path sorted = base / "Docs" / "Invoices" / "invoice.pdf";
+    REQUIRE(std::filesystem::exists(sorted));
+    REQUIRE_FALSE(std::filesystem::exists(base / "Docs" / "Invoices" / "invoice (1).pdf"));
+    REQUIRE(std::filesystem::exists(base / "invoice (1).pdf"));
+    CHECK(std::filesystem::equivalent(sorted, base / "invoice (1).pdf"));
+
+    // Undo drops the link and brings the trashed copy back as a file of its own.
+    dialog.test_trigger_undo();
+    REQUIRE(std::filesystem::exists(base / "invoice.pdf"));
+    REQUIRE(std::filesystem::exists(base / "invoice (1).pdf"));
+    CHECK_FALSE(std::filesystem::equivalent(base / "invoice.pdf", base / "invoice (1).pdf"));
+}
 #endif
 
 #endif // !_WIN32
@@ -0,0 +1,156 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ConsistencyPassService.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<CategorizedFile> make_items(std::size_t count)
+{
+    std::vector<CategorizedFile> items;
+    for (std::size_t index = 0; index < count; ++index) {
+        items.push_back(CategorizedFile{"/data/inbox", "file_" + std::to_string(index) + ".pdf",
+                                        FileType::File, "Documents", "Reports", 0});
+    }
+    return items;
+}
+
+std::vector<const CategorizedFile*> pointers(const std::vector<CategorizedFile>& items)
+{
+    std::vector<const CategorizedFile*> result;
+    for (const auto& item : items) {
+        result.push_back(&item);
+    }
+    return result;
+}
+
+bool selected(const std::vector<const CategorizedFile*>& items, const std::string& file_name)
+{
+    for (const auto* item : items) {
+        if (item->file_name == file_name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::size_t estimate(const std::string& text)
+{
+    return (text.size() + 3) / 4;
+}
+
+std::size_t covered(const std::vector<ConsistencyPassService::ChunkRange>& chunks)
+{
+    std::size_t next = 0;
+    for (const auto& chunk : chunks) {
+        if (chunk.begin != next || chunk.end <= chunk.begin) {
+            return 0;
+        }
+        next = chunk.end;
+    }
+    return next;
+}
+
+} // namespace
+
+TEST_CASE("Consistency chunks grow with the context window") {
+    const auto storage = make_items(200);
+    const auto items = pointers(storage);
+    const auto small = ConsistencyPassService::plan_chunks(items, "[]", 1024, estimate);
+    const auto large = ConsistencyPassService::plan_chunks(items, "[]", 32768, estimate);
+
+    CHECK(covered(small) == items.size());
+    CHECK(covered(large) == items.size());
+    CHECK(small.size() > large.size());
+    for (const auto& chunk : large) {
+        CHECK(chunk.end - chunk.begin <= ConsistencyPassService::kMaxChunkItems);
+        CHECK(chunk.max_tokens > 0);
+    }
+}
+
+TEST_CASE("Consistency chunks leave room for a large taxonomy") {
+    const auto storage = make_items(60);
+    const auto items = pointers(storage);
+    const std::string taxonomy(4000, 'x');
+
+    const auto without = ConsistencyPassService::plan_chunks(items, "[]", 2048, estimate);
+    const auto with = ConsistencyPassService::plan_chunks(items, taxonomy, 2048, estimate);
+    CHECK(with.size() > without.size());
+
+    // A taxonomy larger than the context still yields one item per prompt rather than none.
+    const auto overflow = ConsistencyPassService::plan_chunks(items, std::string(20000, 'x'), 2048, estimate);
+    CHECK(overflow.size() == items.size());
+    CHECK(covered(overflow) == items.size());
+}
+
+TEST_CASE("Delta consistency pass skips settled items") {
+    auto items = make_items(10);
+    const auto none = ConsistencyPassService::select_drifting_items(items, {});
+    CHECK(none.empty());
+
+    const std::vector<CategorizedFile> new_items{items[3]};
+    const auto fresh = ConsistencyPassService::select_drifting_items(items, new_items);
+    REQUIRE(fresh.size() == 1);
+    CHECK(fresh.front()->file_name == "file_3.pdf");
+}
+
+TEST_CASE("Delta consistency pass picks labels that drift from common ones") {
+    auto items = make_items(12);
+    items[0].category = "Document";
+    items[1].subcategory = "Reprots";
+    items[2].subcategory = "Report";
+    items[3].subcategory = "Invoices";
+    items[4].subcategory = "Invoices";
+    items[5].category = "Images";
+    items[5].subcategory = "Photos";
+
+    const auto drifting = ConsistencyPassService::select_drifting_items(items, {});
+    CHECK(selected(drifting, "file_0.pdf"));
+    CHECK(selected(drifting, "file_1.pdf"));
+    CHECK(selected(drifting, "file_2.pdf"));
+    // A label that occurs only once is worth a second look even without a similar one.
+    CHECK(selected(drifting, "file_5.pdf"));
+    CHECK_FALSE(selected(drifting, "file_3.pdf"));
+    CHECK_FALSE(selected(drifting, "file_4.pdf"));
+    CHECK_FALSE(selected(drifting, "file_6.pdf"));
+    CHECK(drifting.size() == 4);
+}
+
+TEST_CASE("Consistency taxonomy context favours labels related to the chunk") {
+    std::vector<CategorizedFile> items{
+        CategorizedFile{"/data/inbox", "invoice_march_2024.pdf", FileType::File, "Finance", "Invoices", 0},
+        CategorizedFile{"/data/inbox", "holiday_photo.jpg", FileType::File, "Images", "Travel", 0},
+    };
+    const std::vector<DatabaseManager::TaxonomyLabel> taxonomy{
+        {"Music", "Albums", 90},
+        {"Software", "Installers", 80},
+        {"Images", "Travel", 1},
+        {"Finance", "Receipts", 5},
+        {"Documents", "Invoice Scans", 3},
+        {"Images", "Photo Albums", 2},
+        {"Videos", "Movies", 70},
+    };
+
+    const auto selected = ConsistencyPassService::select_relevant_taxonomy(pointers(items), taxonomy, 4);
+    REQUIRE(selected.size() == 4);
+    // An item's own label comes first however rarely it is used.
+    CHECK(selected[0] == std::make_pair(std::string("Images"), std::string("Travel")));
+    const auto contains = [&selected](const char* category, const char* subcategory) {
+        return std::find(selected.begin(), selected.end(),
+                         std::make_pair(std::string(category), std::string(subcategory))) != selected.end();
+    };
+    CHECK(contains("Finance", "Receipts"));
+    CHECK(contains("Documents", "Invoice Scans"));
+    CHECK(contains("Images", "Photo Albums"));
+    CHECK_FALSE(contains("Music", "Albums"));
+
+    // Unrelated entries fill the remaining places, most used first.
+    const auto padded = ConsistencyPassService::select_relevant_taxonomy(pointers(items), taxonomy, 6);
+    REQUIRE(padded.size() == 6);
+    CHECK(padded[4].first == "Music");
+    CHECK(padded[5].first == "Software");
+
+    CHECK(ConsistencyPassService::select_relevant_taxonomy(pointers(items), taxonomy, 100).size() == taxonomy.size());
+}
@@ -0,0 +1,192 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ConsistencyPassService.hpp"
+#include "DatabaseManager.hpp"
+#include "ILLMClient.hpp"
+#include "TestHelpers.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Moves every item the prompt lists into Documents / Reports.
+class HarmonizingClient : public ILLMClient {
+public:
+    std::string categorize_file(const std::string&, const std::string&, FileType, const std::string&) override
+    {
+        return {};
+    }
+
+    std::string complete_prompt(const std::string& prompt, int) override
+    {
+        std::string entries;
+        for (std::size_t at = prompt.find("- id: "); at != std::string::npos; at = prompt.find("- id: ", at + 1)) {
+            const std::size_t begin = at + 6;
+            const std::string id = prompt.substr(begin, prompt.find(',', begin) - begin);
+            entries += entry_json(id, entries.empty());
+        }
+        return "{\"harmonized\":[" + entries + "]}";
+    }
+
+    void set_prompt_logging_enabled(bool) override {}
+
+private:
+    static std::string entry_json(const std::string& id, bool first)
+    {
+        return std::string(first ? "" : ",") + "{\"id\":\"" + id +
+               "\",\"category\":\"Documents\",\"subcategory\":\"Reports\"}";
+    }
+};
+
+// Answers like HarmonizingClient, but also relabels an item the prompt did not list.
+class StrayIdClient : public HarmonizingClient {
+public:
+    explicit StrayIdClient(std::string stray_id)
+        : stray_id(std::move(stray_id))
+    {
+    }
+
+    std::string complete_prompt(const std::string& prompt, int max_tokens) override
+    {
+        std::string reply = HarmonizingClient::complete_prompt(prompt, max_tokens);
+        reply.insert(reply.size() - 2, ",{\"id\":\"" + stray_id + "\",\"category\":\"Images\",\"subcategory\":\"Stray\"}");
+        return reply;
+    }
+
+private:
+    std::string stray_id;
+};
+
+std::vector<CategorizedFile> seed(DatabaseManager& db, const std::string& dir)
+{
+    std::vector<CategorizedFile> items;
+    const std::vector<std::pair<std::string, std::string>> labels{
+        {"Documents", "Reports"}, {"Documents", "Reports"}, {"Document", "Report"}, {"Docs", "Reprots"}};
+    for (std::size_t index = 0; index < labels.size(); ++index) {
+        const auto resolved = db.resolve_category(labels[index].first, labels[index].second);
+        const std::string name = "report_" + std::to_string(index) + ".pdf";
+        db.insert_or_update_file_with_categorization(name, "F", dir, resolved, false);
+        items.push_back(CategorizedFile{dir, name, FileType::File, resolved.category, resolved.subcategory,
+                                        resolved.taxonomy_id});
+    }
+    return items;
+}
+
+std::size_t count_label(const std::vector<CategorizedFile>& items, const std::string& subcategory)
+{
+    std::size_t count = 0;
+    for (const auto& item : items) {
+        count += item.subcategory == subcategory ? 1 : 0;
+    }
+    return count;
+}
+
+} // namespace
+
+TEST_CASE("Consistency dry run reports changes without saving them") {
+    TempDir base_dir;
+    DatabaseManager db(base_dir.path().string());
+    const std::string dir = (base_dir.path() / "inbox").generic_string();
+    auto items = seed(db, dir);
+    std::vector<CategorizedFile> new_items;
+    std::atomic<bool> stop{false};
+
+    ConsistencyPassService service(db, nullptr);
+    service.set_dry_run(true);
+    const auto changes = service.run(items, new_items,
+                                     []() { return std::make_unique<HarmonizingClient>(); }, stop, nullptr);
+
+    // The database may have merged some spellings already; only real relabellings are reported.
+    const std::size_t stray = items.size() - count_label(items, "Reports");
+    CHECK(stray > 0);
+    REQUIRE(changes.size() == stray);
+    for (const auto& change : changes) {
+        CHECK(change.to_category == "Documents");
+        CHECK(change.to_subcategory == "Reports");
+        CHECK(change.from_subcategory != "Reports");
+    }
+    CHECK(count_label(db.get_categorized_files(dir), "Reports") == count_label(items, "Reports"));
+
+    REQUIRE(service.apply_changes(changes, items, new_items, nullptr));
+    CHECK(count_label(items, "Reports") == items.size());
+    const auto stored = db.get_categorized_files(dir);
+    CHECK(count_label(stored, "Reports") == stored.size());
+
+    // Frequencies are recounted for the labels files moved to and away from.
+    for (const auto& label : db.get_taxonomy_labels()) {
+        const bool target = label.category == "Documents" && label.subcategory == "Reports";
+        CHECK(label.frequency == (target ? static_cast<int>(items.size()) : 0));
+    }
+}
+
+TEST_CASE("Consistency pass saves each chunk as it completes") {
+    TempDir base_dir;
+    DatabaseManager db(base_dir.path().string());
+    const std::string dir = (base_dir.path() / "inbox").generic_string();
+    auto items = seed(db, dir);
+    std::vector<CategorizedFile> new_items;
+    std::atomic<bool> stop{false};
+
+    ConsistencyPassService service(db, nullptr);
+    const auto changes = service.run(items, new_items,
+                                     []() { return std::make_unique<HarmonizingClient>(); }, stop, nullptr);
+
+    CHECK_FALSE(changes.empty());
+    CHECK(count_label(items, "Reports") == items.size());
+    const auto stored = db.get_categorized_files(dir);
+    CHECK(count_label(stored, "Reports") == stored.size());
+}
+
+TEST_CASE("Consistency pass keeps the stored confidence of relabeled files") {
+    TempDir base_dir;
+    DatabaseManager db(base_dir.path().string());
+    const std::string dir = (base_dir.path() / "inbox").generic_string();
+    auto items = seed(db, dir);
+    auto resolved = db.resolve_category("Docs", "Reprots");
+    resolved.confidence = 0.8;
+    db.insert_or_update_file_with_categorization("report_3.pdf", "F", dir, resolved, false);
+    std::vector<CategorizedFile> new_items;
+    std::atomic<bool> stop{false};
+
+    ConsistencyPassService service(db, nullptr);
+    service.run(items, new_items, []() { return std::make_unique<HarmonizingClient>(); }, stop, nullptr);
+
+    for (const auto& entry : db.get_categorized_files(dir)) {
+        if (entry.file_name == "report_3.pdf") {
+            CHECK(entry.subcategory == "Reports");
+            REQUIRE(entry.confidence.has_value());
+            CHECK(*entry.confidence == 0.8);
+        }
+    }
+}
+
+TEST_CASE("Consistency pass ignores replies about items outside the chunk") {
+    TempDir base_dir;
+    DatabaseManager db(base_dir.path().string());
+    const std::string dir = (base_dir.path() / "inbox").generic_string();
+    auto items = seed(db, dir);
+    // A well-populated label that delta mode leaves out of every chunk.
+    const auto photos = db.resolve_category("Images", "Photos");
+    for (int index = 0; index < 3; ++index) {
+        const std::string name = "photo_" + std::to_string(index) + ".jpg";
+        db.insert_or_update_file_with_categorization(name, "F", dir, photos, false);
+        items.push_back(CategorizedFile{dir, name, FileType::File, photos.category, photos.subcategory,
+                                        photos.taxonomy_id});
+    }
+    std::vector<CategorizedFile> new_items;
+    std::atomic<bool> stop{false};
+
+    ConsistencyPassService service(db, nullptr);
+    service.set_delta_mode(true);
+    const std::string stray_id = dir + "/photo_0.jpg";
+    service.run(items, new_items, [&]() { return std::make_unique<StrayIdClient>(stray_id); }, stop, nullptr);
+
+    CHECK(count_label(items, "Photos") == 3);
+    CHECK(count_label(db.get_categorized_files(dir), "Photos") == 3);
+    for (const auto& label : db.get_taxonomy_labels()) {
+        CHECK(label.subcategory != "Stray");
+    }
+}
@@ -0,0 +1,73 @@
+#include <catch2/catch_test_macros.hpp>
+#include "DatabaseManager.hpp"
+#include "DuplicateFinder.hpp"
+#include "TestHelpers.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+void write_file(const std::filesystem::path& path, const std::string& contents) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary) << contents;
+}
+
+} // namespace
+
+TEST_CASE("DuplicateFinder groups files by content") {
+    TempDir dir;
+    const auto base = dir.path();
+    const std::string large(64 * 1024, 'a');
+    std::string large_variant = large;
+    large_variant[large.size() / 2] = 'b';
+
+    write_file(base / "report.pdf", large);
+    write_file(base / "report (1).pdf", large);
+    write_file(base / "draft.pdf", large_variant);
+    write_file(base / "note.txt", "hello");
+    write_file(base / "note copy.txt", "hello");
+    write_file(base / "other.txt", "a different size");
+    write_file(base / "empty-a.txt", "");
+    write_file(base / "empty-b.txt", "");
+
+    const std::vector<std::filesystem::path> files{
+        base / "note.txt", base / "report.pdf", base / "draft.pdf", base / "other.txt",
+        base / "report (1).pdf", base / "note copy.txt", base / "empty-a.txt", base / "empty-b.txt",
+        base / "missing.txt"};
+
+    TempDir config_dir;
+    DatabaseManager db(config_dir.path().string());
+    // The second pass is answered from the hash cache and must agree with the first.
+    for (int pass = 0; pass < 2; ++pass) {
+        const auto groups = DuplicateFinder(&db, 2).find_groups(files);
+        REQUIRE(groups.size() == 2);
+        CHECK(groups[0] == DuplicateFinder::Group{base / "note.txt", base / "note copy.txt"});
+        CHECK(groups[1] == DuplicateFinder::Group{base / "report.pdf", base / "report (1).pdf"});
+    }
+
+    // A file with a unique size is never read, so nothing is cached for it.
+    const auto cached = db.get_file_hashes({(base / "report.pdf").string(), (base / "other.txt").string()});
+    REQUIRE(cached.count((base / "report.pdf").string()) == 1);
+    CHECK(cached.at((base / "report.pdf").string()).full != 0);
+    CHECK(cached.count((base / "other.txt").string()) == 0);
+}
+
+TEST_CASE("DuplicateFinder compares the bytes before calling files the same") {
+    TempDir dir;
+    const auto base = dir.path();
+    const std::string large(200 * 1024, 'a');
+    std::string late_difference = large;
+    late_difference[large.size() - 10] = 'b';
+
+    write_file(base / "a.bin", large);
+    write_file(base / "b.bin", large);
+    write_file(base / "c.bin", late_difference);
+    write_file(base / "short.bin", large.substr(1));
+
+    CHECK(DuplicateFinder::same_contents(base / "a.bin", base / "b.bin"));
+    CHECK_FALSE(DuplicateFinder::same_contents(base / "a.bin", base / "c.bin"));
+    CHECK_FALSE(DuplicateFinder::same_contents(base / "a.bin", base / "short.bin"));
+    CHECK_FALSE(DuplicateFinder::same_contents(base / "a.bin", base / "missing.bin"));
+}
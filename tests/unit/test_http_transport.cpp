@@ -0,0 +1,51 @@
+#include <catch2/catch_test_macros.hpp>
+#include "HttpTransport.hpp"
+#include "MockHttpServer.hpp"
+
+#ifndef _WIN32
+
+TEST_CASE("HttpTransport keeps the connection open between requests") {
+    MockHttpServer server([](const MockHttpServer::Request& request) {
+        MockHttpServer::Reply reply;
+        reply.body = request.method + " " + request.path + " " + request.body;
+        return reply;
+    });
+
+    auto& transport = HttpTransport::shared();
+    HttpTransport::Request get;
+    get.url = server.base_url() + "/api/tags";
+    const auto first = transport.perform(get);
+    REQUIRE(first.ok());
+    CHECK(first.status == 200);
+    CHECK(first.body == "GET /api/tags ");
+
+    HttpTransport::Request post;
+    post.method = HttpTransport::Method::Post;
+    post.url = server.base_url() + "/v1/chat/completions";
+    post.headers = {"Content-Type: application/json"};
+    post.body = R"({"model":"test"})";
+    for (int i = 0; i < 3; ++i) {
+        const auto response = transport.perform(post);
+        REQUIRE(response.ok());
+        CHECK(response.body == R"(POST /v1/chat/completions {"model":"test"})");
+    }
+
+    CHECK(server.request_count() == 4);
+    CHECK(server.connection_count() == 1);
+}
+
+TEST_CASE("HttpTransport reports transport failures") {
+    std::string url;
+    {
+        MockHttpServer server([](const MockHttpServer::Request&) { return MockHttpServer::Reply{}; });
+        url = server.base_url() + "/unreachable";
+    }
+    HttpTransport::Request request;
+    request.url = url;
+    request.timeout_seconds = 2;
+    const auto response = HttpTransport::shared().perform(request);
+    CHECK_FALSE(response.ok());
+    CHECK(response.status == 0);
+}
+
+#endif // !_WIN32
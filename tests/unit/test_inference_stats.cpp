@@ -0,0 +1,59 @@
+#include <catch2/catch_test_macros.hpp>
+#include "InferenceStats.hpp"
+
+#include <string>
+
+namespace {
+
+InferenceSample sample(int prompt_tokens, double prompt_ms, int generated, double eval_ms, int kv_used)
+{
+    InferenceSample s;
+    s.prompt_tokens = prompt_tokens;
+    s.prompt_eval_ms = prompt_ms;
+    s.generated_tokens = generated;
+    s.eval_ms = eval_ms;
+    s.kv_cells_used = kv_used;
+    s.kv_cells_total = 2048;
+    s.gpu_layers = 20;
+    s.model_layers = 28;
+    return s;
+}
+
+} // namespace
+
+TEST_CASE("Inference totals sum requests and keep the peak KV usage") {
+    auto& stats = InferenceStats::instance();
+    stats.reset();
+    CHECK(InferenceStats::describe(stats.totals()).empty());
+
+    stats.add(sample(300, 150.0, 10, 200.0, 310));
+    stats.add(sample(500, 250.0, 30, 600.0, 530));
+    stats.add(sample(100, 100.0, 10, 200.0, 110));
+
+    const auto totals = stats.totals();
+    CHECK(totals.requests == 3);
+    CHECK(totals.prompt_tokens == 900);
+    CHECK(totals.generated_tokens == 50);
+    CHECK(totals.prompt_tokens_per_second() == 1800.0);
+    CHECK(totals.generated_tokens_per_second() == 50.0);
+    CHECK(totals.kv_peak_used == 530);
+
+    const std::string line = InferenceStats::describe(totals);
+    CHECK(line.find("3 request(s)") != std::string::npos);
+    CHECK(line.find("1800.0 tok/s") != std::string::npos);
+    CHECK(line.find("KV cache peak 530/2048 (26%)") != std::string::npos);
+    CHECK(line.find("GPU layers 20/28") != std::string::npos);
+
+    stats.reset();
+    CHECK(stats.totals().requests == 0);
+}
+
+TEST_CASE("GPU layer settings are described for CPU-only and automatic offload") {
+    InferenceStats::Totals totals;
+    totals.requests = 1;
+    totals.gpu_layers = 0;
+    CHECK(InferenceStats::describe(totals).find("GPU layers CPU only") != std::string::npos);
+    totals.gpu_layers = -1;
+    totals.model_layers = 32;
+    CHECK(InferenceStats::describe(totals).find("GPU layers auto of 32") != std::string::npos);
+}
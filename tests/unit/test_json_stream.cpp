@@ -0,0 +1,93 @@
+#include <catch2/catch_test_macros.hpp>
+#include "JsonView.hpp"
+#include "JsonWriter.hpp"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+TEST_CASE("JsonWriter escapes quotes, backslashes and control characters") {
+    std::string out;
+    JsonWriter json(out);
+    json.begin_object()
+        .key("text").value(std::string("a\"b\\c\nd\te\x01" "f\x1f"))
+        .key("utf8").value("Caf\xC3\xA9")
+        .end_object();
+
+    CHECK(out == "{\"text\":\"a\\\"b\\\\c\\nd\\te\\u0001f\\u001f\",\"utf8\":\"Caf\xC3\xA9\"}");
+}
+
+TEST_CASE("JsonWriter separates members and nested containers") {
+    std::string out = "prefix:";
+    JsonWriter json(out);
+    json.begin_object()
+        .key("n").value(3)
+        .key("u").value(std::size_t{7})
+        .key("d").value(0.5)
+        .key("b").value(false)
+        .key("nan").value(std::nan(""))
+        .key("list").begin_array().value(1).begin_object().end_object().value("x").end_array()
+        .key("raw").raw("{\"k\":[1,2]}")
+        .end_object();
+
+    CHECK(out == "prefix:{\"n\":3,\"u\":7,\"d\":0.5,\"b\":false,\"nan\":null,"
+                 "\"list\":[1,{},\"x\"],\"raw\":{\"k\":[1,2]}}");
+}
+
+TEST_CASE("JsonView reads nested fields in place") {
+    const std::string body = R"( {"choices": [ {"message": {"role": "assistant",
+        "content": "Line\nwith \"quotes\" é 😀"}, "index": 0} ],
+        "usage": {"total_tokens": 42, "ratio": -1.5e2}, "ok": true, "none": null} )";
+
+    const JsonView root = JsonView::parse(body);
+    REQUIRE(root.is_object());
+    const JsonView message = root["choices"][0]["message"];
+    CHECK(message["role"].string_or("") == "assistant");
+    CHECK(message["content"].string_or("") == "Line\nwith \"quotes\" \xC3\xA9 \xF0\x9F\x98\x80");
+    CHECK(root["usage"]["total_tokens"].as_number() == 42.0);
+    CHECK(root["usage"]["ratio"].as_number() == -150.0);
+    CHECK(root["ok"].as_bool() == true);
+    CHECK(root["none"].kind() == JsonView::Kind::Null);
+
+    CHECK_FALSE(root["missing"].valid());
+    CHECK_FALSE(root["choices"][3].valid());
+    CHECK_FALSE(root["usage"][0].valid());
+    CHECK_FALSE(root["ok"].as_string());
+    CHECK(root["choices"][0]["index"].raw() == "0");
+}
+
+TEST_CASE("JsonView iterates array elements") {
+    const std::string text = R"([{"token":"a","logprob":-0.5},{"token":"b","logprob":-1}, 3])";
+    std::vector<std::string> tokens;
+    double sum = 0.0;
+    JsonView::parse(text).for_each_element([&](const JsonView& element) {
+        if (element.is_object()) {
+            tokens.push_back(element["token"].string_or(""));
+            sum += element["logprob"].as_number().value_or(0.0);
+        }
+    });
+    CHECK(tokens == std::vector<std::string>{"a", "b"});
+    CHECK(sum == -1.5);
+}
+
+TEST_CASE("JsonView rejects malformed documents") {
+    for (const char* text : {"", "{", "{\"a\":}", "[1,]", "{\"a\" 1}", "\"unterminated",
+                             "\"bad \\x escape\"", "01", "1.", "tru", "{} trailing", "\"raw\ttab\""}) {
+        INFO(text);
+        CHECK_FALSE(JsonView::parse(text).valid());
+    }
+    CHECK(JsonView::parse("  [] ").is_array());
+}
+
+TEST_CASE("JsonWriter output reads back through JsonView") {
+    std::string out;
+    JsonWriter(out).begin_object()
+        .key("we\"ird").value("va\\lue\r\n")
+        .key("n").value(-12)
+        .end_object();
+
+    const JsonView root = JsonView::parse(out);
+    REQUIRE(root.is_object());
+    CHECK(root["we\"ird"].string_or("") == "va\\lue\r\n");
+    CHECK(root["n"].as_number() == -12.0);
+}
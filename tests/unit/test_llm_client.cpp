@@ -0,0 +1,115 @@
+#include <catch2/catch_test_macros.hpp>
+#include "LLMClient.hpp"
+
+#ifdef _WIN32
+    #include <json/json.h>
+#elif __APPLE__
+    #include <json/json.h>
+#else
+    #include <jsoncpp/json/json.h>
+#endif
+
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+Json::Value parse_json(const std::string& text)
+{
+    Json::CharReaderBuilder reader;
+    Json::Value root;
+    std::istringstream stream(text);
+    std::string errors;
+    Json::parseFromStream(reader, stream, &root, &errors);
+    return root;
+}
+
+std::string write_json(const Json::Value& value)
+{
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    return Json::writeString(writer, value);
+}
+
+std::string completion(const std::string& content,
+                       const std::vector<std::pair<std::string, double>>& tokens = {})
+{
+    Json::Value root;
+    root["choices"][0]["message"]["role"] = "assistant";
+    root["choices"][0]["message"]["content"] = content;
+    if (!tokens.empty()) {
+        Json::Value list(Json::arrayValue);
+        for (const auto& [text, logprob] : tokens) {
+            Json::Value token;
+            token["token"] = text;
+            token["logprob"] = logprob;
+            list.append(token);
+        }
+        root["choices"][0]["logprobs"]["content"] = list;
+    }
+    return write_json(root);
+}
+
+} // namespace
+
+TEST_CASE("LLMClient categorization body requests a JSON schema reply") {
+    const std::string body = LLMClient::make_categorization_body("gpt-4o-mini", "Categorize file: a.pdf");
+    CHECK(body.find('\n') == std::string::npos);
+
+    const Json::Value root = parse_json(body);
+    const Json::Value& format = root["response_format"];
+    CHECK(format["type"].asString() == "json_schema");
+    CHECK(format["json_schema"]["strict"].asBool());
+    const Json::Value& properties = format["json_schema"]["schema"]["properties"];
+    CHECK(properties.isMember("category"));
+    CHECK(properties.isMember("subcategory"));
+    CHECK(properties.isMember("confidence"));
+    CHECK_FALSE(root.isMember("logprobs"));
+
+    const Json::Value with_logprobs =
+        parse_json(LLMClient::make_categorization_body("gpt-4o-mini", "Categorize file: a.pdf", true));
+    CHECK(with_logprobs["logprobs"].asBool());
+}
+
+TEST_CASE("LLMClient uses the model's own confidence without logprobs") {
+    const std::string reply = LLMClient::category_reply_from_response(
+        completion(R"({"category":"Documents","subcategory":"Invoices","confidence":0.82})"));
+
+    const auto parsed = LLMClient::parse_category_reply(reply);
+    REQUIRE(parsed);
+    CHECK(parsed->category == "Documents");
+    CHECK(parsed->subcategory == "Invoices");
+    REQUIRE(parsed->confidence);
+    CHECK(std::abs(*parsed->confidence - 0.82) < 1e-9);
+}
+
+TEST_CASE("LLMClient derives confidence from the label token logprobs") {
+    const std::string content = R"({"category":"Documents","subcategory":"Invoices","confidence":0.99})";
+    const std::vector<std::pair<std::string, double>> tokens = {
+        {"{\"", 0.0}, {"category", 0.0}, {"\":\"", 0.0},
+        {"Documents", -0.1},
+        {"\",\"", 0.0}, {"sub", 0.0}, {"category", 0.0}, {"\":\"", 0.0},
+        {"Inv", -0.2}, {"oices", -0.3},
+        {"\",\"", 0.0}, {"confidence", -5.0}, {"\":", 0.0}, {"0", 0.0}, {".", 0.0}, {"99", -4.0}, {"}", 0.0},
+    };
+
+    const auto parsed = LLMClient::parse_category_reply(
+        LLMClient::category_reply_from_response(completion(content, tokens)));
+    REQUIRE(parsed);
+    REQUIRE(parsed->confidence);
+    CHECK(std::abs(*parsed->confidence - std::exp(-0.6)) < 1e-9);
+}
+
+TEST_CASE("LLMClient leaves plain category lines to the caller") {
+    CHECK_FALSE(LLMClient::parse_category_reply("Documents : Invoices"));
+    CHECK_FALSE(LLMClient::parse_category_reply(""));
+}
+
+TEST_CASE("LLMClient reports refusals as errors") {
+    Json::Value root;
+    root["choices"][0]["message"]["content"] = Json::nullValue;
+    root["choices"][0]["message"]["refusal"] = "I can't help with that.";
+    CHECK_THROWS_AS(LLMClient::category_reply_from_response(write_json(root)), std::runtime_error);
+}
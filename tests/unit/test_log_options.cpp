@@ -0,0 +1,54 @@
+#include <catch2/catch_test_macros.hpp>
+#include "Logger.hpp"
+#include "TestHelpers.hpp"
+
+TEST_CASE("Log options default to async info logging with every log file") {
+    EnvVarGuard level("AI_FILE_SORTER_LOG_LEVEL", std::nullopt);
+    EnvVarGuard console("AI_FILE_SORTER_LOG_CONSOLE", "0");
+    EnvVarGuard files("AI_FILE_SORTER_LOG_FILES", std::nullopt);
+    EnvVarGuard async("AI_FILE_SORTER_LOG_ASYNC", std::nullopt);
+    EnvVarGuard overflow("AI_FILE_SORTER_LOG_OVERFLOW", std::nullopt);
+
+    const auto options = LogOptions::from_environment(false, false);
+    CHECK(options.level == spdlog::level::info);
+    CHECK_FALSE(options.console);
+    CHECK(options.async);
+    CHECK(options.file_sinks == std::set<std::string>{"core", "db", "ui"});
+    CHECK(options.overflow == LogOptions::Overflow::DropOldest);
+    CHECK(options.flush_level == spdlog::level::warn);
+
+    CHECK(LogOptions::from_environment(false, true).level == spdlog::level::debug);
+}
+
+TEST_CASE("Log options follow the environment") {
+    EnvVarGuard level("AI_FILE_SORTER_LOG_LEVEL", "warn");
+    EnvVarGuard console("AI_FILE_SORTER_LOG_CONSOLE", "1");
+    EnvVarGuard files("AI_FILE_SORTER_LOG_FILES", "core,bogus");
+    EnvVarGuard async("AI_FILE_SORTER_LOG_ASYNC", "0");
+    EnvVarGuard queue("AI_FILE_SORTER_LOG_QUEUE", "1024");
+    EnvVarGuard overflow("AI_FILE_SORTER_LOG_OVERFLOW", "block");
+
+    const auto options = LogOptions::from_environment(false, true);
+    CHECK(options.level == spdlog::level::warn);
+    CHECK(options.console);
+    CHECK(options.file_sinks == std::set<std::string>{"core"});
+    CHECK_FALSE(options.async);
+    CHECK(options.queue_size == 1024);
+    CHECK(options.overflow == LogOptions::Overflow::Block);
+
+    EnvVarGuard none("AI_FILE_SORTER_LOG_FILES", "none");
+    CHECK(LogOptions::from_environment(false, false).file_sinks.empty());
+}
+
+TEST_CASE("Log options ignore an unknown log level") {
+    EnvVarGuard level("AI_FILE_SORTER_LOG_LEVEL", "verbose");
+
+    CHECK(LogOptions::from_environment(false, false).level == spdlog::level::info);
+    CHECK(LogOptions::from_environment(false, true).level == spdlog::level::debug);
+
+    EnvVarGuard upper("AI_FILE_SORTER_LOG_LEVEL", "WARNING");
+    CHECK(LogOptions::from_environment(false, false).level == spdlog::level::warn);
+
+    EnvVarGuard off("AI_FILE_SORTER_LOG_LEVEL", "off");
+    CHECK(LogOptions::from_environment(false, false).level == spdlog::level::off);
+}
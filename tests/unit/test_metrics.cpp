@@ -0,0 +1,109 @@
+#include <catch2/catch_test_macros.hpp>
+#include "JsonView.hpp"
+#include "Metrics.hpp"
+#include "TestHelpers.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+void record_ns(Metrics::Stage stage, std::chrono::nanoseconds duration)
+{
+    const auto start = Metrics::Clock::now();
+    Metrics::instance().record(stage, start, start + duration);
+}
+
+struct MetricsReset {
+    MetricsReset() { Metrics::instance().reset(); }
+    ~MetricsReset()
+    {
+        Metrics::instance().reset();
+        Metrics::instance().set_tracing_enabled(false);
+        Metrics::instance().set_report_directory({});
+    }
+};
+
+} // namespace
+
+TEST_CASE("Histogram buckets keep values within a sixteenth of their size") {
+    for (std::uint64_t value : {0ULL, 15ULL, 16ULL, 1000ULL, 123456789ULL, 1ULL << 40}) {
+        const auto index = Metrics::bucket_index(value);
+        REQUIRE(index < Metrics::kBucketCount);
+        const auto approx = Metrics::bucket_value(index);
+        const auto error = approx > value ? approx - value : value - approx;
+        CHECK(error * 16 <= value + 16);
+    }
+    CHECK(Metrics::bucket_index(UINT64_MAX) == Metrics::kBucketCount - 1);
+    CHECK(Metrics::bucket_index(1000) < Metrics::bucket_index(2000));
+}
+
+TEST_CASE("Stage summaries report counts and quantiles") {
+    MetricsReset guard;
+    for (int ms = 1; ms <= 100; ++ms) {
+        record_ns(Metrics::Stage::Decode, std::chrono::milliseconds(ms));
+    }
+    const auto summary = Metrics::instance().summary(Metrics::Stage::Decode);
+    CHECK(summary.count == 100);
+    CHECK(summary.total_ns == 5050ULL * 1000 * 1000);
+    CHECK(summary.min_ns == 1000ULL * 1000);
+    CHECK(summary.max_ns == 100ULL * 1000 * 1000);
+    CHECK(summary.p50_ns > 47ULL * 1000 * 1000);
+    CHECK(summary.p50_ns < 53ULL * 1000 * 1000);
+    CHECK(summary.p99_ns > 94ULL * 1000 * 1000);
+    CHECK(Metrics::instance().summary(Metrics::Stage::Scan).count == 0);
+}
+
+TEST_CASE("Concurrent recording loses no samples") {
+    MetricsReset guard;
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 10000; ++i) {
+                Metrics::Timer timer(Metrics::Stage::ResolveCategory);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CHECK(Metrics::instance().summary(Metrics::Stage::ResolveCategory).count == 40000);
+}
+
+TEST_CASE("Reports are written as JSON, Prometheus text and a Chrome trace") {
+    MetricsReset guard;
+    TempDir tmp;
+    const auto directory = (tmp.path() / "metrics").string();
+    auto& metrics = Metrics::instance();
+    metrics.set_tracing_enabled(true);
+    metrics.set_report_directory(directory);
+
+    record_ns(Metrics::Stage::PromptEval, 20ms);
+    record_ns(Metrics::Stage::DbWrite, 2ms);
+
+    const std::string json_text = metrics.to_json();
+    const JsonView json = JsonView::parse(json_text);
+    CHECK(json["stages"]["prompt_eval"]["count"].as_number() == 1.0);
+    CHECK(json["stages"]["move"]["count"].as_number() == 0.0);
+
+    const std::string prometheus = metrics.to_prometheus();
+    CHECK(prometheus.find("aifs_stage_duration_seconds_count{stage=\"db_write\"} 1") != std::string::npos);
+    CHECK(prometheus.find("# TYPE aifs_stage_duration_seconds summary") != std::string::npos);
+
+    const std::string trace_text = metrics.to_chrome_trace();
+    const JsonView trace = JsonView::parse(trace_text);
+    REQUIRE(trace.is_object());
+    CHECK(trace["traceEvents"][0]["name"].string_or("") == "prompt_eval");
+    CHECK(trace["traceEvents"][0]["dur"].as_number() == 20000.0);
+    CHECK(trace["traceEvents"][1]["ph"].string_or("") == "X");
+
+    REQUIRE(metrics.flush());
+    CHECK(std::filesystem::exists(std::filesystem::path(directory) / "metrics.json"));
+    CHECK(std::filesystem::exists(std::filesystem::path(directory) / "metrics.prom"));
+    CHECK(std::filesystem::exists(std::filesystem::path(directory) / "trace.json"));
+}
@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ModelStore.hpp"
+#include "TestHelpers.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+constexpr std::uint64_t kGiB = 1024ULL * 1024 * 1024;
+
+std::string write_file(const std::filesystem::path& path, const std::string& contents)
+{
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream out(path, std::ios::binary);
+    out << contents;
+    return path.string();
+}
+
+ModelStore::Record variant(const std::string& quantization, std::uint64_t size)
+{
+    ModelStore::Record record;
+    record.path = "/models/llama-" + quantization + ".gguf";
+    record.quantization = quantization;
+    record.family = "llama";
+    record.size = size;
+    return record;
+}
+
+} // namespace
+
+TEST_CASE("Quantization and family are read from GGUF file names") {
+    CHECK(ModelStore::quantization_from_name("Llama-3.2-3B-Instruct-Q4_K_M.gguf") == "Q4_K_M");
+    CHECK(ModelStore::quantization_from_name("mistral-7b-instruct-v0.2.Q8_0.gguf") == "Q8_0");
+    CHECK(ModelStore::quantization_from_name("phi-3-mini-iq4_xs.gguf") == "IQ4_XS");
+    CHECK(ModelStore::quantization_from_name("model-f16.gguf") == "F16");
+    CHECK(ModelStore::quantization_from_name("custom-model.gguf").empty());
+
+    CHECK(ModelStore::family_from_name("Llama-3.2-3B-Instruct-Q4_K_M.gguf") == "llama-3.2-3b-instruct");
+    CHECK(ModelStore::family_from_name("/models/Llama-3.2-3B-Instruct-Q8_0.gguf") == "llama-3.2-3b-instruct");
+    CHECK(ModelStore::family_from_name("mistral-7b-instruct-v0.2.Q8_0.gguf") == "mistral-7b-instruct-v0.2");
+
+    CHECK(ModelStore::bits_per_weight("q4_k_m") > ModelStore::bits_per_weight("Q3_K_M"));
+    CHECK(ModelStore::bits_per_weight("unknown") == 0.0);
+}
+
+TEST_CASE("The chooser prefers the best variant that fits the GPU, then memory") {
+    const std::vector<ModelStore::Record> variants{
+        variant("Q8_0", 8 * kGiB), variant("Q4_K_M", 4 * kGiB), variant("Q3_K_M", 3 * kGiB)};
+
+    MemoryBudget large_gpu{32 * kGiB, 16 * kGiB};
+    CHECK(ModelStore::choose_variant(variants, large_gpu)->quantization == "Q8_0");
+
+    MemoryBudget small_gpu{32 * kGiB, 6 * kGiB};
+    CHECK(ModelStore::choose_variant(variants, small_gpu)->quantization == "Q4_K_M");
+
+    MemoryBudget cpu_only{16 * kGiB, 0};
+    CHECK(ModelStore::choose_variant(variants, cpu_only)->quantization == "Q8_0");
+
+    MemoryBudget tight{4 * kGiB, 0};
+    CHECK(ModelStore::choose_variant(variants, tight)->quantization == "Q3_K_M");
+
+    MemoryBudget too_small{kGiB, 0};
+    CHECK(ModelStore::choose_variant(variants, too_small)->quantization == "Q3_K_M");
+
+    CHECK_FALSE(ModelStore::choose_variant({}, large_gpu).has_value());
+}
+
+TEST_CASE("Registered models persist and duplicates in the store become hard links") {
+    TempDir tmp;
+    const auto root = tmp.path() / "models";
+    const auto first = write_file(root / "llama-Q4_K_M.gguf", "same weights");
+    const auto second = write_file(root / "copy" / "llama-Q4_K_M.gguf", "same weights");
+    const auto outside = write_file(tmp.path() / "custom" / "llama-Q4_K_M.gguf", "same weights");
+
+    {
+        ModelStore store(root.string());
+        const auto record = store.register_model(first, "https://example.com/llama-Q4_K_M.gguf");
+        REQUIRE(record.has_value());
+        CHECK(record->quantization == "Q4_K_M");
+        CHECK(record->family == "llama");
+        CHECK(record->digest.size() == 64);
+
+        REQUIRE(store.register_model(second).has_value());
+        REQUIRE(store.register_model(outside).has_value());
+        CHECK(store.find_by_digest(record->digest).size() == 3);
+        CHECK_FALSE(store.register_model((root / "missing.gguf").string()).has_value());
+    }
+
+#ifndef _WIN32
+    CHECK(std::filesystem::hard_link_count(first) == 2);
+    CHECK(std::filesystem::hard_link_count(outside) == 1);
+#endif
+
+    ModelStore reloaded(root.string());
+    CHECK(reloaded.records().size() == 3);
+    const auto record = reloaded.find_by_path(first);
+    REQUIRE(record.has_value());
+    CHECK(record->source == "https://example.com/llama-Q4_K_M.gguf");
+}
+
+TEST_CASE("A model path resolves to the variant that fits the budget") {
+    TempDir tmp;
+    const auto root = tmp.path() / "models";
+    const auto large = write_file(root / "llama-Q8_0.gguf", std::string(4096, 'a'));
+    const auto small = write_file(root / "llama-Q4_K_M.gguf", std::string(2048, 'b'));
+
+    ModelStore store(root.string());
+    REQUIRE(store.register_model(large).has_value());
+    REQUIRE(store.register_model(small).has_value());
+
+    CHECK(store.resolve_for_budget(large, MemoryBudget{16 * kGiB, 0}) == store.find_by_path(large)->path);
+    CHECK(store.resolve_for_budget(small, MemoryBudget{16 * kGiB, 0}) == store.find_by_path(large)->path);
+
+    const auto unknown = write_file(tmp.path() / "other.gguf", "x");
+    CHECK(store.resolve_for_budget(unknown, MemoryBudget{16 * kGiB, 0}) == unknown);
+}
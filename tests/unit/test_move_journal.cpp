@@ -0,0 +1,365 @@
+#include <catch2/catch_test_macros.hpp>
+#include "FileFingerprint.hpp"
+#include "MovableCategorizedFile.hpp"
+#include "MoveJournal.hpp"
+#include "UndoManager.hpp"
+#include "TestHelpers.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+void write_file(const std::filesystem::path& path, const std::string& contents) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary) << contents;
+}
+
+} // namespace
+
+TEST_CASE("MoveJournal round-trips intents and results") {
+    TempDir journal_dir;
+    std::string path;
+    {
+        auto journal = MoveJournal::create(journal_dir.path().string(), "/base", nullptr);
+        REQUIRE(journal);
+        const auto first = journal->append_intents({{"/base/a.txt", "/base/Docs/a.txt"},
+                                                    {"/base/b.txt", "/base/Docs/b.txt"}});
+        REQUIRE(first);
+        CHECK(*first == 0);
+        REQUIRE(journal->record_moved(0, 42, 1700000000));
+        REQUIRE(journal->record_failed(1));
+        REQUIRE(journal->mark_complete());
+        path = journal->path();
+    }
+
+    REQUIRE(MoveJournal::is_journal_file(path));
+    const auto contents = MoveJournal::read(path);
+    REQUIRE(contents);
+    CHECK(contents->base_dir == "/base");
+    CHECK(contents->complete);
+    REQUIRE(contents->records.size() == 2);
+    CHECK(contents->records[0].state == MoveJournal::State::Moved);
+    CHECK(contents->records[0].size_bytes == 42);
+    CHECK(contents->records[0].mtime == 1700000000);
+    CHECK(contents->records[1].state == MoveJournal::State::Failed);
+}
+
+TEST_CASE("MoveJournal ignores a torn trailing record") {
+    TempDir journal_dir;
+    std::string path;
+    {
+        auto journal = MoveJournal::create(journal_dir.path().string(), "/base", nullptr);
+        REQUIRE(journal);
+        REQUIRE(journal->append_intents({{"/base/a.txt", "/base/Docs/a.txt"}}));
+        path = journal->path();
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out.write("\x03\x20\x00", 3);
+    }
+
+    const auto contents = MoveJournal::read(path);
+    REQUIRE(contents);
+    CHECK_FALSE(contents->complete);
+    REQUIRE(contents->records.size() == 1);
+    CHECK(contents->records[0].state == MoveJournal::State::Pending);
+
+    auto reopened = MoveJournal::open_existing(path, nullptr);
+    REQUIRE(reopened);
+    CHECK(reopened->intent_count() == 1);
+    REQUIRE(reopened->mark_complete());
+    reopened.reset();
+
+    const auto completed = MoveJournal::read(path);
+    REQUIRE(completed);
+    CHECK(completed->complete);
+}
+
+TEST_CASE("UndoManager resumes and undoes interrupted journals") {
+    TempDir undo_dir;
+    TempDir base_dir;
+    const auto moved_source = base_dir.path() / "moved.txt";
+    const auto moved_destination = base_dir.path() / "Docs" / "moved.txt";
+    const auto pending_source = base_dir.path() / "pending.txt";
+    const auto pending_destination = base_dir.path() / "Docs" / "pending.txt";
+    write_file(moved_destination, "already moved");
+    write_file(pending_source, "not yet moved");
+
+    std::string path;
+    {
+        auto journal = MoveJournal::create(undo_dir.path().string(), base_dir.path().string(), nullptr);
+        REQUIRE(journal);
+        REQUIRE(journal->append_intents({{moved_source.string(), moved_destination.string()},
+                                         {pending_source.string(), pending_destination.string()}}));
+        path = journal->path();
+        // Simulate a crash: neither result record nor the completion record is written.
+    }
+
+    UndoManager manager(undo_dir.path().string());
+    const auto interrupted = manager.interrupted_journal_paths();
+    REQUIRE(interrupted.size() == 1);
+
+    const auto resumed = manager.resume_interrupted(interrupted.front(), nullptr);
+    CHECK(resumed.completed == 2);
+    CHECK(resumed.failed == 0);
+    CHECK(std::filesystem::exists(pending_destination));
+    CHECK_FALSE(std::filesystem::exists(pending_source));
+    CHECK(manager.interrupted_journal_paths().empty());
+
+    const auto latest = manager.latest_plan_path();
+    REQUIRE(latest);
+    const auto undone = manager.undo_plan(*latest);
+    CHECK(undone.restored == 2);
+    CHECK(std::filesystem::exists(moved_source));
+    CHECK(std::filesystem::exists(pending_source));
+}
+
+TEST_CASE("MoveJournal streams records with their final state") {
+    TempDir journal_dir;
+    std::string path;
+    {
+        auto journal = MoveJournal::create(journal_dir.path().string(), "/base", nullptr);
+        REQUIRE(journal);
+        REQUIRE(journal->append_intents({{"/base/a.txt", "/base/Docs/a.txt", "Docs", "Text"},
+                                         {"/base/b.png", "/base/Images/b.png", "Images", ""},
+                                         {"/base/c.txt", "/base/Docs/c.txt", "Docs", ""}}));
+        REQUIRE(journal->record_moved(0, 1, 1));
+        REQUIRE(journal->record_failed(1));
+        REQUIRE(journal->mark_complete());
+        path = journal->path();
+    }
+
+    std::vector<MoveJournal::Record> records;
+    MoveJournal::Summary summary;
+    REQUIRE(MoveJournal::for_each_record(path, [&](const MoveJournal::Record& record) {
+        records.push_back(record);
+        return true;
+    }, &summary));
+
+    CHECK(summary.complete);
+    CHECK(summary.intent_count == 3);
+    CHECK(summary.moved_count == 1);
+    REQUIRE(records.size() == 3);
+    CHECK(records[0].category == "Docs");
+    CHECK(records[0].subcategory == "Text");
+    CHECK(records[0].state == MoveJournal::State::Moved);
+    CHECK(records[1].state == MoveJournal::State::Failed);
+    CHECK(records[2].state == MoveJournal::State::Pending);
+}
+
+TEST_CASE("UndoManager indexes runs and undoes a single category") {
+    TempDir undo_dir;
+    TempDir base_dir;
+    const auto doc_source = base_dir.path() / "report.txt";
+    const auto doc_destination = base_dir.path() / "Docs" / "report.txt";
+    const auto image_source = base_dir.path() / "photo.png";
+    const auto image_destination = base_dir.path() / "Images" / "photo.png";
+    write_file(doc_destination, "report");
+    write_file(image_destination, "photo");
+
+    UndoManager manager(undo_dir.path().string());
+    CHECK_FALSE(manager.latest_plan_path());
+
+    auto journal = manager.begin_run(base_dir.path().string(), nullptr);
+    REQUIRE(journal);
+    const auto first = journal->append_intents({{doc_source.string(), doc_destination.string(), "Docs", ""},
+                                                {image_source.string(), image_destination.string(), "Images", ""}});
+    REQUIRE(first);
+    REQUIRE(journal->record_moved(*first, 0, 0));
+    REQUIRE(journal->record_moved(*first + 1, 0, 0));
+    const QString plan_path = QString::fromStdString(journal->path());
+    CHECK_FALSE(manager.latest_plan_path());
+    manager.finish_run(std::move(journal), 2);
+
+    const auto latest = manager.latest_plan_path();
+    REQUIRE(latest);
+    CHECK(*latest == plan_path);
+    const auto runs = manager.list_runs(10);
+    REQUIRE(runs.size() == 1);
+    CHECK(runs.front().moved_count == 2);
+
+    const auto categories = manager.categories_in_plan(plan_path);
+    REQUIRE(categories.size() == 2);
+    CHECK(categories[0].first == "Docs");
+    CHECK(categories[1].first == "Images");
+
+    UndoManager::UndoOptions options;
+    options.categories = {"Images"};
+    const auto partial = manager.undo_plan(plan_path, options);
+    CHECK(partial.restored == 1);
+    CHECK(std::filesystem::exists(image_source));
+    CHECK(std::filesystem::exists(doc_destination));
+
+    // Undoing the whole run afterwards restores what is left without reporting the earlier partial undo.
+    const auto rest = manager.undo_plan(plan_path);
+    CHECK(rest.restored == 1);
+    CHECK(rest.skipped == 0);
+    CHECK(std::filesystem::exists(doc_source));
+    CHECK_FALSE(std::filesystem::exists(base_dir.path() / "Docs"));
+    CHECK_FALSE(std::filesystem::exists(base_dir.path() / "Images"));
+    CHECK(std::filesystem::exists(base_dir.path()));
+}
+
+TEST_CASE("UndoManager discards runs that moved nothing") {
+    TempDir undo_dir;
+    UndoManager manager(undo_dir.path().string());
+    auto journal = manager.begin_run("/base", nullptr);
+    REQUIRE(journal);
+    const std::filesystem::path path = journal->path();
+    manager.finish_run(std::move(journal), 0);
+
+    CHECK_FALSE(std::filesystem::exists(path));
+    CHECK(manager.list_runs(10).empty());
+}
+
+TEST_CASE("UndoManager verifies content fingerprints before restoring") {
+    TempDir undo_dir;
+    TempDir base_dir;
+    const auto source = base_dir.path() / "notes.txt";
+    const auto destination = base_dir.path() / "Docs" / "notes.txt";
+    write_file(destination, "original contents");
+    const auto fingerprint = FileFingerprint::partial(destination);
+    REQUIRE(fingerprint);
+
+    UndoManager manager(undo_dir.path().string());
+    auto journal = manager.begin_run(base_dir.path().string(), nullptr);
+    REQUIRE(journal);
+    const auto first = journal->append_intents({{source.string(), destination.string(), "Docs", ""}});
+    REQUIRE(first);
+    REQUIRE(journal->record_moved(*first, 0, 0, *fingerprint));
+    const QString plan_path = QString::fromStdString(journal->path());
+    manager.finish_run(std::move(journal), 1);
+
+    write_file(destination, "modified contents");
+    const auto verified = manager.undo_plan(plan_path);
+    CHECK(verified.restored == 0);
+    CHECK(verified.skipped == 1);
+    CHECK(std::filesystem::exists(destination));
+
+    UndoManager::UndoOptions options;
+    options.verify_contents = false;
+    const auto unverified = manager.undo_plan(plan_path, options);
+    CHECK(unverified.restored == 1);
+    CHECK(std::filesystem::exists(source));
+}
+
+TEST_CASE("UndoManager removes links from a link-mode run and keeps the originals") {
+    TempDir undo_dir;
+    TempDir root;
+    const auto base = root.path() / "library";
+    const auto source = base / "notes.txt";
+    write_file(source, "notes");
+    const std::filesystem::path mirror = MovableCategorizedFile::link_mirror_root(base.string());
+    CHECK(mirror == root.path() / "library (sorted)");
+    const auto link = mirror / "Docs" / "notes.txt";
+    std::filesystem::create_directories(link.parent_path());
+    REQUIRE(MovableCategorizedFile::create_link(source, link, SortMode::HardLink));
+    REQUIRE(MovableCategorizedFile::is_link_to(link, source, SortMode::HardLink));
+
+    UndoManager manager(undo_dir.path().string());
+    auto journal = manager.begin_run(base.string(), nullptr);
+    REQUIRE(journal);
+    const auto first = journal->append_intents(
+        {{source.string(), link.string(), "Docs", "", SortMode::HardLink}});
+    REQUIRE(first);
+    REQUIRE(journal->record_moved(*first, 5, 0));
+    const QString plan_path = QString::fromStdString(journal->path());
+    manager.finish_run(std::move(journal), 1);
+
+    const auto result = manager.undo_plan(plan_path);
+    CHECK(result.restored == 1);
+    CHECK(result.skipped == 0);
+    CHECK(std::filesystem::exists(source));
+    CHECK_FALSE(std::filesystem::exists(link));
+    CHECK_FALSE(std::filesystem::exists(mirror / "Docs"));
+    CHECK(std::filesystem::exists(mirror));
+}
+
+TEST_CASE("UndoManager restores a duplicate that was replaced by a hard link") {
+    TempDir undo_dir;
+    TempDir base_dir;
+    TempDir trash_dir;
+    const auto kept = base_dir.path() / "Docs" / "report.txt";
+    const auto copy = base_dir.path() / "report (1).txt";
+    const auto trashed = trash_dir.path() / "report (1).txt";
+    write_file(kept, "report");
+    write_file(trashed, "report");
+    std::filesystem::create_hard_link(kept, copy);
+
+    UndoManager manager(undo_dir.path().string());
+    auto journal = manager.begin_run(base_dir.path().string(), nullptr);
+    REQUIRE(journal);
+    // Journaled the way the categorization dialog does: the copy's trip to the trash, whose
+    // location is only known once it happened, then the link.
+    const auto first = journal->append_intents(
+        {{copy.string(), "", "Docs", "", SortMode::Move},
+         {kept.string(), copy.string(), "Docs", "", SortMode::HardLink}});
+    REQUIRE(first);
+    REQUIRE(journal->record_moved(*first, 6, 0, 0, trashed.string()));
+    REQUIRE(journal->record_moved(*first + 1, 6, 0));
+    const QString plan_path = QString::fromStdString(journal->path());
+    manager.finish_run(std::move(journal), 2);
+
+    const auto undone = manager.undo_plan(plan_path);
+    CHECK(undone.restored == 2);
+    CHECK(undone.skipped == 0);
+    REQUIRE(std::filesystem::exists(copy));
+    CHECK_FALSE(std::filesystem::equivalent(copy, kept));
+    CHECK_FALSE(std::filesystem::exists(trashed));
+    // The kept copy stays where the sort put it.
+    CHECK(std::filesystem::exists(kept));
+}
+
+TEST_CASE("UndoManager resumes a duplicate whose trash move has no result") {
+    TempDir undo_dir;
+    TempDir base_dir;
+    const auto kept = base_dir.path() / "Docs" / "report.txt";
+    const auto copy = base_dir.path() / "report (1).txt";
+    const auto other_kept = base_dir.path() / "Docs" / "notes.txt";
+    const auto other_copy = base_dir.path() / "notes (1).txt";
+    write_file(kept, "report");
+    write_file(other_kept, "notes");
+    write_file(other_copy, "notes");
+
+    std::string path;
+    {
+        auto journal = MoveJournal::create(undo_dir.path().string(), base_dir.path().string(), nullptr);
+        REQUIRE(journal);
+        // The first copy went to the trash before the crash, the second one did not.
+        REQUIRE(journal->append_intents({{copy.string(), "", "Docs", "", SortMode::Move},
+                                         {kept.string(), copy.string(), "Docs", "", SortMode::HardLink},
+                                         {other_copy.string(), "", "Docs", "", SortMode::Move},
+                                         {other_kept.string(), other_copy.string(), "Docs", "", SortMode::HardLink}}));
+        path = journal->path();
+    }
+
+    UndoManager manager(undo_dir.path().string());
+    const auto resumed = manager.resume_interrupted(QString::fromStdString(path), nullptr);
+    // The trashed copy's place is taken by the link; the untouched copy stays as it was.
+    CHECK(resumed.completed == 1);
+    CHECK(resumed.failed == 3);
+    REQUIRE(std::filesystem::exists(copy));
+    CHECK(std::filesystem::equivalent(copy, kept));
+    REQUIRE(std::filesystem::exists(other_copy));
+    CHECK_FALSE(std::filesystem::equivalent(other_copy, other_kept));
+
+    std::vector<MoveJournal::Record> records;
+    REQUIRE(MoveJournal::for_each_record(path, [&](const MoveJournal::Record& record) {
+        records.push_back(record);
+        return true;
+    }));
+    REQUIRE(records.size() == 4);
+    CHECK(records[0].state == MoveJournal::State::Failed);
+    CHECK(records[1].state == MoveJournal::State::Moved);
+    CHECK(records[2].state == MoveJournal::State::Failed);
+    CHECK(records[3].state == MoveJournal::State::Failed);
+
+    // Undo drops the link; the copy itself has to come back from the trash by hand.
+    const auto undone = manager.undo_plan(QString::fromStdString(path));
+    CHECK(undone.restored == 1);
+    CHECK(undone.skipped == 0);
+    CHECK_FALSE(std::filesystem::exists(copy));
+    CHECK(std::filesystem::exists(other_copy));
+}
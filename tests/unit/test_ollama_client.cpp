@@ -0,0 +1,191 @@
+#include <catch2/catch_test_macros.hpp>
+#include "OllamaClient.hpp"
+#include "MockHttpServer.hpp"
+
+#ifdef _WIN32
+    #include <json/json.h>
+#elif __APPLE__
+    #include <json/json.h>
+#else
+    #include <jsoncpp/json/json.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+
+namespace {
+
+Json::Value parse_body(const std::string& body)
+{
+    Json::CharReaderBuilder reader;
+    Json::Value root;
+    std::istringstream stream(body);
+    std::string errors;
+    Json::parseFromStream(reader, stream, &root, &errors);
+    return root;
+}
+
+MockHttpServer::Reply chat_reply(const std::string& content)
+{
+    Json::Value root;
+    root["message"]["role"] = "assistant";
+    root["message"]["content"] = content;
+    root["done"] = true;
+    Json::StreamWriterBuilder writer;
+    MockHttpServer::Reply reply;
+    reply.body = Json::writeString(writer, root);
+    return reply;
+}
+
+} // namespace
+
+TEST_CASE("OllamaClient sends a schema-constrained chat request") {
+    Json::Value captured;
+    std::string path;
+    MockHttpServer server([&](const MockHttpServer::Request& request) {
+        path = request.path;
+        captured = parse_body(request.body);
+        return chat_reply(R"({"category": "Images", "subcategory": "Screenshots"})");
+    });
+
+    OllamaClient client(server.base_url() + "/", "llama3.2");
+    client.set_keep_alive("1h");
+    const std::string result = client.categorize_file("shot.png", "/tmp/shot.png", FileType::File, "");
+
+    CHECK(result == "Images : Screenshots");
+    CHECK(path == "/api/chat");
+    CHECK(captured["model"].asString() == "llama3.2");
+    CHECK(captured["keep_alive"].asString() == "1h");
+    CHECK(captured["stream"].asBool());
+    CHECK(captured["format"]["type"].asString() == "object");
+    CHECK(captured["format"]["properties"].isMember("subcategory"));
+    REQUIRE(captured["messages"].size() == 2);
+    CHECK(captured["messages"][1]["content"].asString().find("shot.png") != std::string::npos);
+}
+
+TEST_CASE("OllamaClient stops reading a streamed reply once the category object is complete") {
+    MockHttpServer server([](const MockHttpServer::Request&) {
+        MockHttpServer::Reply reply;
+        reply.content_type = "application/x-ndjson";
+        reply.chunk_delay = std::chrono::milliseconds(100);
+        reply.chunks = {
+            "{\"message\":{\"role\":\"assistant\",\"content\":\"{\\\"category\\\": \\\"Ima\"},\"done\":false}\n",
+            "{\"message\":{\"role\":\"assistant\",\"content\":\"ges\\\", \\\"subcategory\\\": \\\"Photos\\\"}\"},\"done\":false}\n",
+        };
+        for (int i = 0; i < 20; ++i) {
+            reply.chunks.push_back("{\"message\":{\"role\":\"assistant\",\"content\":\" and more\"},\"done\":false}\n");
+        }
+        reply.chunks.push_back("{\"message\":{\"role\":\"assistant\",\"content\":\"\"},\"done\":true}\n");
+        return reply;
+    });
+
+    OllamaClient client(server.base_url(), "llama3.2");
+    const auto started = std::chrono::steady_clock::now();
+    const std::string result = client.categorize_file("beach.jpg", "", FileType::File, "");
+    const auto elapsed = std::chrono::steady_clock::now() - started;
+
+    CHECK(result == "Images : Photos");
+    CHECK(elapsed < std::chrono::seconds(1));
+}
+
+TEST_CASE("OllamaClient limits concurrent requests to max_parallel") {
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+    MockHttpServer server([&](const MockHttpServer::Request&) {
+        const int now = ++active;
+        int expected = peak.load();
+        while (now > expected && !peak.compare_exchange_weak(expected, now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+        --active;
+        return chat_reply(R"({"category": "Documents", "subcategory": "Reports"})");
+    });
+
+    OllamaClient client(server.base_url(), "llama3.2");
+    client.set_max_parallel(2);
+    std::vector<std::future<std::string>> results;
+    for (int i = 0; i < 6; ++i) {
+        results.push_back(client.categorize_file_async("report" + std::to_string(i) + ".pdf", "", FileType::File, ""));
+    }
+    for (auto& result : results) {
+        CHECK(result.get() == "Documents : Reports");
+    }
+
+    CHECK(server.request_count() == 6);
+    CHECK(peak.load() == 2);
+    CHECK(server.connection_count() <= 2);
+}
+
+TEST_CASE("OllamaClient cancels a request when its token is cancelled") {
+    std::atomic<int> started{0};
+    MockHttpServer server([&](const MockHttpServer::Request& request) {
+        ++started;
+        if (request.body.find("slow.pdf") != std::string::npos) {
+            std::this_thread::sleep_for(std::chrono::seconds(2));
+        }
+        return chat_reply(R"({"category": "Documents", "subcategory": "Reports"})");
+    });
+
+    OllamaClient client(server.base_url(), "llama3.2");
+    client.set_max_parallel(1);
+    auto slow_cancel = std::make_shared<LLMCancelToken>();
+    auto slow = client.categorize_file_async("slow.pdf", "", FileType::File, "", slow_cancel);
+    auto queued_cancel = std::make_shared<LLMCancelToken>();
+    auto queued = client.categorize_file_async("queued.pdf", "", FileType::File, "", queued_cancel);
+    auto next = client.categorize_file_async("next.pdf", "", FileType::File, "");
+    while (started.load() == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    queued_cancel->cancel();
+    slow_cancel->cancel();
+    CHECK_THROWS_AS(slow.get(), std::runtime_error);
+    CHECK_THROWS_AS(queued.get(), std::runtime_error);
+    // The freed slot goes to the next request rather than the cancelled one.
+    CHECK(next.get() == "Documents : Reports");
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+}
+
+TEST_CASE("OllamaClient surfaces server errors") {
+    MockHttpServer server([](const MockHttpServer::Request&) {
+        MockHttpServer::Reply reply;
+        reply.status = 404;
+        reply.body = R"({"error": "model \"missing\" not found"})";
+        return reply;
+    });
+
+    OllamaClient client(server.base_url(), "missing");
+    REQUIRE_THROWS_AS(client.complete_prompt("{}", 16), std::runtime_error);
+}
+
+TEST_CASE("OllamaClient reports a plain-text refusal as an authentication error") {
+    MockHttpServer server([](const MockHttpServer::Request&) {
+        MockHttpServer::Reply reply;
+        reply.status = 401;
+        reply.body = "Unauthorized";
+        return reply;
+    });
+
+    OllamaClient client(server.base_url(), "llama3", "wrong-key");
+    try {
+        client.complete_prompt("{}", 16);
+        FAIL("expected an exception");
+    } catch (const std::runtime_error& ex) {
+        CHECK(std::string(ex.what()).find("Authentication Error") != std::string::npos);
+    }
+}
+
+TEST_CASE("OllamaClient passes through replies that are not category objects") {
+    CHECK(OllamaClient::format_category_reply("Music : Albums") == "Music : Albums");
+    CHECK(OllamaClient::format_category_reply(R"({"category": "Music"})") == "Music");
+}
+
+#endif // !_WIN32
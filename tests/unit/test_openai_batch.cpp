@@ -0,0 +1,185 @@
+#include <catch2/catch_test_macros.hpp>
+#include "CategorizationService.hpp"
+#include "DatabaseManager.hpp"
+#include "MockHttpServer.hpp"
+#include "OpenAIBatchClient.hpp"
+#include "Settings.hpp"
+#include "TestHelpers.hpp"
+
+#ifdef _WIN32
+    #include <json/json.h>
+#elif __APPLE__
+    #include <json/json.h>
+#else
+    #include <jsoncpp/json/json.h>
+#endif
+
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+
+namespace {
+
+// Stands in for the Files and Batch endpoints. The batch stays in progress for the first
+// status check and then completes, answering every uploaded request with `reply`.
+class FakeBatchApi {
+public:
+    explicit FakeBatchApi(std::string reply)
+        : reply_(std::move(reply)),
+          server_([this](const MockHttpServer::Request& request) { return handle(request); })
+    {}
+
+    std::string base_url() const { return server_.base_url() + "/v1"; }
+    std::vector<std::string> uploaded_lines() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return uploaded_lines_;
+    }
+
+private:
+    static std::string json_reply(const Json::Value& value)
+    {
+        Json::StreamWriterBuilder writer;
+        writer["indentation"] = "";
+        return Json::writeString(writer, value);
+    }
+
+    MockHttpServer::Reply handle(const MockHttpServer::Request& request)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        MockHttpServer::Reply reply;
+        Json::Value body(Json::objectValue);
+        if (request.method == "POST" && request.path == "/v1/files") {
+            const std::size_t start = request.body.find("\r\n\r\n", request.body.find("name=\"file\"")) + 4;
+            const std::size_t end = request.body.rfind("\r\n--");
+            std::istringstream lines(request.body.substr(start, end - start));
+            for (std::string line; std::getline(lines, line);) {
+                if (!line.empty()) {
+                    uploaded_lines_.push_back(line);
+                }
+            }
+            body["id"] = "file-in";
+        } else if (request.method == "POST" && request.path == "/v1/batches") {
+            body["id"] = "batch_1";
+            body["status"] = "validating";
+        } else if (request.path == "/v1/batches/batch_1") {
+            ++status_checks_;
+            body["id"] = "batch_1";
+            body["status"] = status_checks_ == 1 ? "in_progress" : "completed";
+            body["request_counts"]["total"] = static_cast<int>(uploaded_lines_.size());
+            if (status_checks_ > 1) {
+                body["output_file_id"] = "file-out";
+            }
+        } else if (request.path == "/v1/files/file-out/content") {
+            // Lines are split across chunks to exercise the streaming reader.
+            std::string output;
+            for (const auto& line : uploaded_lines_) {
+                Json::Value input;
+                std::istringstream stream(line);
+                Json::CharReaderBuilder reader;
+                std::string errors;
+                Json::parseFromStream(reader, stream, &input, &errors);
+                Json::Value result(Json::objectValue);
+                result["custom_id"] = input["custom_id"];
+                result["response"]["status_code"] = 200;
+                result["response"]["body"]["choices"][0]["message"]["content"] = reply_;
+                output += json_reply(result) + "\n";
+            }
+            const std::size_t middle = output.size() / 2;
+            reply.chunks = {output.substr(0, middle), output.substr(middle)};
+            return reply;
+        } else {
+            reply.status = 404;
+            body["error"]["message"] = "unknown path " + request.path;
+        }
+        reply.body = json_reply(body);
+        return reply;
+    }
+
+    std::string reply_;
+    mutable std::mutex mutex_;
+    std::vector<std::string> uploaded_lines_;
+    int status_checks_{0};
+    MockHttpServer server_;
+};
+
+} // namespace
+
+TEST_CASE("OpenAIBatchClient uploads, polls and streams batch results") {
+    FakeBatchApi api("Documents : Invoices");
+    OpenAIBatchClient client("test-key", api.base_url());
+
+    const std::string jsonl =
+        OpenAIBatchClient::make_request_line("0", R"({"model":"gpt-4o-mini","messages":[]})") + "\n" +
+        OpenAIBatchClient::make_request_line("1", R"({"model":"gpt-4o-mini","messages":[]})") + "\n";
+    const std::string file_id = client.upload_batch_file(jsonl, "batch.jsonl");
+    CHECK(file_id == "file-in");
+    REQUIRE(api.uploaded_lines().size() == 2);
+
+    const auto created = client.create_batch(file_id);
+    CHECK(created.id == "batch_1");
+    CHECK_FALSE(created.finished());
+    CHECK_FALSE(client.get_batch("batch_1").finished());
+    const auto done = client.get_batch("batch_1");
+    REQUIRE(done.succeeded());
+
+    std::vector<OpenAIBatchClient::ResultLine> results;
+    client.download_lines(done.output_file_id, [&](const std::string& line) {
+        if (auto parsed = OpenAIBatchClient::parse_result_line(line)) {
+            results.push_back(*parsed);
+        }
+    });
+    REQUIRE(results.size() == 2);
+    CHECK(results[0].custom_id == "0");
+    CHECK(results[1].custom_id == "1");
+    CHECK(results[1].status_code == 200);
+    CHECK(results[1].content == "Documents : Invoices");
+
+    CHECK_THROWS_AS(client.get_batch("missing"), std::runtime_error);
+}
+
+TEST_CASE("CategorizationService submits a batch and stores its results on a later run") {
+    TempDir base_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", base_dir.path().string());
+    Settings settings;
+    settings.set_remote_api_key("test-key");
+    DatabaseManager db(settings.get_config_dir());
+    CategorizationService service(settings, db, nullptr);
+    FakeBatchApi api("Documents : Invoices");
+    OpenAIBatchClient client("test-key", api.base_url());
+
+    const std::string dir = (base_dir.path() / "inbox").string();
+    const std::vector<FileEntry> files = {
+        {dir + "/invoice-001.pdf", "invoice-001.pdf", FileType::File},
+        {dir + "/invoice-002.pdf", "invoice-002.pdf", FileType::File},
+        {dir + "/2024/receipt.pdf", "receipt.pdf", FileType::File},
+    };
+
+    const auto batch_ids = service.submit_remote_batch(client, files, nullptr);
+    REQUIRE(batch_ids == std::vector<std::string>{"batch_1"});
+    CHECK(api.uploaded_lines().size() == 3);
+    // Items in subfolders of a recursive scan count as pending for the scanned folder.
+    CHECK(db.get_pending_batch_file_names(dir).size() == 3);
+    CHECK(db.get_pending_batch_file_names(dir + "/").size() == 3);
+    CHECK(db.get_pending_batch_file_names(dir + "/2024").size() == 1);
+    CHECK(db.get_pending_batch_file_names(dir + "-old").empty());
+
+    // A restart only needs the database: the first check sees the batch still running.
+    DatabaseManager reopened(settings.get_config_dir());
+    CategorizationService resumed(settings, reopened, nullptr);
+    CHECK(resumed.collect_remote_batches(client, nullptr) == 0);
+    CHECK(resumed.collect_remote_batches(client, nullptr) == 3);
+
+    const auto stored = reopened.get_categorized_files(dir);
+    REQUIRE(stored.size() == 2);
+    CHECK(stored[0].category == "Documents");
+    CHECK(stored[0].subcategory == "Invoices");
+    CHECK(reopened.get_open_batch_jobs().empty());
+    CHECK(reopened.get_pending_batch_file_names(dir).empty());
+}
+
+#endif // !_WIN32
@@ -2,6 +2,8 @@
 #include "IProvider.hpp"
 #include "OpenAIProvider.hpp"
 #include "LocalProvider.hpp"
+#include "LocalOllamaProvider.hpp"
+#include "MockHttpServer.hpp"
 #include "OllamaCloudProvider.hpp"
 #include "ProviderFactory.hpp"
 #include "Settings.hpp"
@@ -86,36 +88,114 @@ TEST_CASE("LocalProvider model listing") {
 
 TEST_CASE("OllamaCloudProvider basic properties") {
     OllamaCloudProvider provider("test_key", "https://api.ollama.com", "llama3");
-    
+
     REQUIRE(provider.get_name() == "Ollama Cloud");
     REQUIRE(provider.requires_api_key());
-    REQUIRE(provider.supports_model_listing()); // Will be implemented in future PR
+    REQUIRE(provider.supports_model_listing());
+}
+
+TEST_CASE("OllamaCloudProvider needs no API key on the local network") {
+    CHECK(OllamaCloudProvider::is_local_endpoint("http://localhost:11434"));
+    CHECK(OllamaCloudProvider::is_local_endpoint("http://127.0.0.1:11434/"));
+    CHECK(OllamaCloudProvider::is_local_endpoint("http://[::1]:11434"));
+    CHECK(OllamaCloudProvider::is_local_endpoint("http://192.168.1.20:11434"));
+    CHECK(OllamaCloudProvider::is_local_endpoint("http://gpu-box.local:11434"));
+    CHECK(OllamaCloudProvider::is_local_endpoint("http://ollama:11434"));
+    CHECK_FALSE(OllamaCloudProvider::is_local_endpoint("https://ollama.com"));
+    CHECK_FALSE(OllamaCloudProvider::is_local_endpoint("https://172.32.0.1"));
+    CHECK_FALSE(OllamaCloudProvider::is_local_endpoint(""));
+
+    CHECK_FALSE(OllamaCloudProvider("", "http://localhost:11434", "llama3").requires_api_key());
+    CHECK_FALSE(LocalOllamaProvider().requires_api_key());
 }
 
 TEST_CASE("OllamaCloudProvider health check") {
-    SECTION("With API key and URL") {
-        OllamaCloudProvider provider("test_key", "https://api.ollama.com", "llama3");
-        auto health = provider.check_health();
-        REQUIRE(health != ProviderHealth::Unavailable);
-    }
-    
-    SECTION("Without API key") {
+    SECTION("Without API key on a hosted server") {
         OllamaCloudProvider provider("", "https://api.ollama.com", "llama3");
-        auto health = provider.check_health();
-        REQUIRE(health == ProviderHealth::Unavailable);
+        REQUIRE(provider.check_health() == ProviderHealth::Unavailable);
     }
-    
+
     SECTION("Without base URL") {
         OllamaCloudProvider provider("test_key", "", "llama3");
-        auto health = provider.check_health();
-        REQUIRE(health == ProviderHealth::Unavailable);
+        REQUIRE(provider.check_health() == ProviderHealth::Unavailable);
+    }
+
+#ifndef _WIN32
+    SECTION("Local server without a key") {
+        std::string authorization = "unset";
+        MockHttpServer server([&](const MockHttpServer::Request& request) {
+            const auto header = request.headers.find("authorization");
+            authorization = header == request.headers.end() ? "" : header->second;
+            MockHttpServer::Reply reply;
+            reply.body = request.path == "/api/tags" ? R"({"models": []})" : "";
+            reply.status = request.path == "/api/tags" ? 200 : 404;
+            return reply;
+        });
+        OllamaCloudProvider provider("", server.base_url(), "llama3");
+        REQUIRE(provider.check_health() == ProviderHealth::Healthy);
+        CHECK(authorization.empty());
+    }
+
+    SECTION("Rejected key") {
+        MockHttpServer server([](const MockHttpServer::Request&) {
+            MockHttpServer::Reply reply;
+            reply.status = 401;
+            reply.body = R"({"error": "unauthorized"})";
+            return reply;
+        });
+        OllamaCloudProvider provider("bad_key", server.base_url(), "llama3");
+        REQUIRE(provider.check_health() == ProviderHealth::Unavailable);
+    }
+
+    SECTION("Unreachable server") {
+        std::string base_url;
+        {
+            MockHttpServer server([](const MockHttpServer::Request&) { return MockHttpServer::Reply{}; });
+            base_url = server.base_url();
+        }
+        OllamaCloudProvider provider("", base_url, "llama3");
+        REQUIRE(provider.check_health() == ProviderHealth::Unavailable);
     }
+#endif
 }
 
-TEST_CASE("OllamaCloudProvider client creation throws") {
-    // Stub implementation should throw until fully implemented
-    OllamaCloudProvider provider("test_key", "https://api.ollama.com", "llama3");
-    REQUIRE_THROWS_AS(provider.create_client(), std::runtime_error);
+#ifndef _WIN32
+TEST_CASE("OllamaCloudProvider lists the server's models") {
+    std::string authorization;
+    MockHttpServer server([&](const MockHttpServer::Request& request) {
+        const auto header = request.headers.find("authorization");
+        authorization = header == request.headers.end() ? "" : header->second;
+        MockHttpServer::Reply reply;
+        reply.body = R"({"models": [
+            {"name": "llama3.2:3b", "model": "llama3.2:3b", "size": 2019393189,
+             "details": {"parameter_size": "3.2B", "quantization_level": "Q4_K_M"}},
+            {"name": "nomic-embed-text:latest", "size": 274302450, "details": {}}
+        ]})";
+        return reply;
+    });
+
+    OllamaCloudProvider provider("secret", server.base_url(), "llama3.2:3b");
+    const auto models = provider.list_models();
+    REQUIRE(models.size() == 2);
+    CHECK(models[0].id == "llama3.2:3b");
+    CHECK(models[0].description == "3.2B, Q4_K_M");
+    CHECK(models[0].size_bytes == 2019393189u);
+    CHECK(models[1].name == "nomic-embed-text:latest");
+    CHECK(models[1].description.empty());
+    CHECK(authorization == "Bearer secret");
+}
+#endif
+
+TEST_CASE("OllamaCloudProvider client creation") {
+    SECTION("Creates a chat client when a model is set") {
+        OllamaCloudProvider provider("test_key", "https://api.ollama.com", "llama3");
+        REQUIRE(provider.create_client() != nullptr);
+    }
+
+    SECTION("Throws without a model") {
+        OllamaCloudProvider provider("test_key", "https://api.ollama.com", "");
+        REQUIRE_THROWS_AS(provider.create_client(), std::runtime_error);
+    }
 }
 
 TEST_CASE("ProviderFactory creates correct provider types") {
@@ -0,0 +1,71 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ProviderHealthMonitor.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+template <typename Predicate>
+bool wait_until(Predicate predicate)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("CircuitBreaker opens after repeated failures and lets one trial through after the cooldown") {
+    using namespace std::chrono_literals;
+    CircuitBreaker breaker(3, 10s);
+    const auto start = CircuitBreaker::Clock::now();
+
+    breaker.record_failure(start);
+    breaker.record_failure(start);
+    CHECK(breaker.allow(start));
+    breaker.record_failure(start);
+    CHECK(breaker.state() == CircuitBreaker::State::Open);
+    CHECK_FALSE(breaker.allow(start + 5s));
+
+    CHECK(breaker.allow(start + 11s));
+    CHECK(breaker.state() == CircuitBreaker::State::HalfOpen);
+    CHECK_FALSE(breaker.allow(start + 11s));
+    breaker.record_failure(start + 12s);
+    CHECK_FALSE(breaker.allow(start + 13s));
+
+    CHECK(breaker.allow(start + 23s));
+    breaker.record_success();
+    CHECK(breaker.state() == CircuitBreaker::State::Closed);
+    CHECK(breaker.allow(start + 23s));
+}
+
+TEST_CASE("ProviderHealthMonitor checks in the background and caches the result") {
+    std::atomic<int> probes{0};
+    std::atomic<bool> up{false};
+    ProviderHealthMonitor monitor(std::chrono::hours(1));
+    CHECK(monitor.status("ollama") == ProviderHealth::Unknown);
+
+    monitor.watch("ollama", [&]() {
+        ++probes;
+        return up ? ProviderHealth::Healthy : ProviderHealth::Unavailable;
+    });
+    REQUIRE(wait_until([&]() { return monitor.status("ollama") == ProviderHealth::Unavailable; }));
+
+    // Within the TTL the cached answer is served without probing again.
+    up = true;
+    for (int i = 0; i < 10; ++i) {
+        CHECK(monitor.status("ollama") == ProviderHealth::Unavailable);
+    }
+    CHECK(probes == 1);
+
+    monitor.invalidate("ollama");
+    REQUIRE(wait_until([&]() { return monitor.status("ollama") == ProviderHealth::Healthy; }));
+    CHECK(probes == 2);
+}
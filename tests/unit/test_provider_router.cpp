@@ -0,0 +1,169 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ProviderRouter.hpp"
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Replies are consumed in order; "!" makes the call throw. Prompts are echoed unless the next
+// reply is "!".
+class ScriptedClient : public ILLMClient {
+public:
+    explicit ScriptedClient(std::shared_ptr<std::deque<std::string>> replies)
+        : replies_(std::move(replies)) {}
+
+    std::string categorize_file(const std::string&, const std::string&, FileType, const std::string&) override
+    {
+        const std::string reply = replies_->front();
+        replies_->pop_front();
+        if (reply == "!") {
+            throw std::runtime_error("route down");
+        }
+        return reply;
+    }
+    std::string complete_prompt(const std::string& prompt, int) override
+    {
+        if (!replies_->empty() && replies_->front() == "!") {
+            replies_->pop_front();
+            throw std::runtime_error("route down");
+        }
+        return "echo " + prompt;
+    }
+    void set_prompt_logging_enabled(bool) override {}
+
+private:
+    std::shared_ptr<std::deque<std::string>> replies_;
+};
+
+class ScriptedProvider : public IProvider {
+public:
+    explicit ScriptedProvider(std::vector<std::string> replies)
+        : replies_(std::make_shared<std::deque<std::string>>(replies.begin(), replies.end())) {}
+
+    std::string get_name() const override { return "Scripted"; }
+    ProviderHealth check_health() const override { return ProviderHealth::Healthy; }
+    std::vector<ModelInfo> list_models() const override { return {}; }
+    std::unique_ptr<ILLMClient> create_client() override
+    {
+        ++created;
+        return std::make_unique<ScriptedClient>(replies_);
+    }
+    bool requires_api_key() const override { return false; }
+    bool supports_model_listing() const override { return false; }
+
+    int created{0};
+
+private:
+    std::shared_ptr<std::deque<std::string>> replies_;
+};
+
+std::string categorize(ProviderRouter& router)
+{
+    return router.categorize_file("report.pdf", "/tmp/report.pdf", FileType::File, "");
+}
+
+} // namespace
+
+TEST_CASE("ProviderRouter accepts readable and confident replies") {
+    CHECK(ProviderRouter::accepts("Documents : Reports", 0.6));
+    CHECK(ProviderRouter::accepts(R"({"category":"Documents","subcategory":"Reports","confidence":0.9})", 0.6));
+    CHECK_FALSE(ProviderRouter::accepts(R"({"category":"Documents","subcategory":"Reports","confidence":0.4})", 0.6));
+    CHECK_FALSE(ProviderRouter::accepts("I am not sure.", 0.6));
+    CHECK_FALSE(ProviderRouter::accepts(" : Reports", 0.6));
+}
+
+TEST_CASE("ProviderRouter only escalates the files the cheap route cannot settle") {
+    ProviderRouter router(0.6);
+    auto small = std::make_unique<ScriptedProvider>(std::vector<std::string>{
+        "Documents : Reports", "no idea", R"({"category":"Images","subcategory":"Photos","confidence":0.3})"});
+    auto large = std::make_unique<ScriptedProvider>(std::vector<std::string>{
+        "Archives : Backups", R"({"category":"Images","subcategory":"Screens","confidence":0.2})"});
+    ScriptedProvider* large_ptr = large.get();
+    router.add_route("small", std::move(small), false);
+    router.add_route("large", std::move(large), true);
+
+    CHECK(categorize(router) == "Documents : Reports");
+    CHECK(large_ptr->created == 0);
+
+    CHECK(categorize(router) == "Archives : Backups");
+    // Neither route is confident enough: the more confident answer wins.
+    CHECK(categorize(router) == R"({"category":"Images","subcategory":"Photos","confidence":0.3})");
+
+    const auto stats = router.stats();
+    REQUIRE(stats.size() == 2);
+    CHECK(stats[0].requests == 3);
+    CHECK(stats[0].accepted == 1);
+    CHECK(stats[0].escalated == 2);
+    CHECK(stats[1].requests == 2);
+    CHECK(stats[1].accepted == 1);
+    CHECK(stats[1].remote);
+    CHECK(router.format_stats().find("large (remote): 2 request(s)") != std::string::npos);
+}
+
+TEST_CASE("ProviderRouter moves past failing routes and rethrows when all fail") {
+    ProviderRouter router(0.6);
+    router.add_route("broken", std::make_unique<ScriptedProvider>(std::vector<std::string>{"!", "!"}), false);
+    router.add_route("backup", std::make_unique<ScriptedProvider>(std::vector<std::string>{"Music : Albums", "!"}), true);
+
+    CHECK(categorize(router) == "Music : Albums");
+    CHECK_THROWS_AS(categorize(router), std::runtime_error);
+    CHECK(router.stats()[0].failed == 2);
+    CHECK(router.complete_prompt("hi", 10) == "echo hi");
+}
+
+TEST_CASE("ProviderRouter stops calling a route that keeps failing") {
+    ProviderRouter router(0.6);
+    auto dead = std::make_unique<ScriptedProvider>(std::vector<std::string>{"!", "!", "!"});
+    router.add_route("dead", std::move(dead), true);
+    router.add_route("local", std::make_unique<ScriptedProvider>(
+                                  std::vector<std::string>(10, "Documents : Reports")), false);
+
+    for (int i = 0; i < 10; ++i) {
+        CHECK(categorize(router) == "Documents : Reports");
+    }
+
+    const auto stats = router.stats();
+    CHECK(stats[0].requests == 3);
+    CHECK(stats[0].failed == 3);
+    CHECK(stats[0].skipped == 7);
+    CHECK(stats[1].accepted == 10);
+}
+
+TEST_CASE("ProviderRouter skips a route whose health probe reports it down") {
+    ProviderRouter router(0.6);
+    router.add_route("down", std::make_unique<ScriptedProvider>(std::vector<std::string>{"Wrong : Answer"}), true,
+                     []() { return ProviderHealth::Unavailable; });
+    router.add_route("up", std::make_unique<ScriptedProvider>(std::vector<std::string>(50, "Music : Albums")), false);
+
+    // The first check runs in the background; once it has finished the route is passed over.
+    std::string reply;
+    for (int i = 0; i < 50 && reply != "Music : Albums"; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        reply = categorize(router);
+    }
+    CHECK(reply == "Music : Albums");
+    CHECK(router.stats()[0].skipped >= 1);
+}
+
+TEST_CASE("ProviderRouter falls back to a weaker route when a prompt fails") {
+    ProviderRouter router(0.6);
+    router.add_route("local", std::make_unique<ScriptedProvider>(std::vector<std::string>{}), false);
+    router.add_route("dead", std::make_unique<ScriptedProvider>(std::vector<std::string>(10, "!")), true);
+
+    for (int i = 0; i < 10; ++i) {
+        CHECK(router.complete_prompt("hi", 10) == "echo hi");
+    }
+
+    // The breaker stops sending prompts to the dead route after a few failures.
+    const auto stats = router.stats();
+    CHECK(stats[1].requests == 3);
+    CHECK(stats[1].failed == 3);
+    CHECK(stats[1].skipped == 7);
+    CHECK(stats[0].requests == 10);
+}
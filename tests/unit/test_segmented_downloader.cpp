@@ -0,0 +1,204 @@
+#include <catch2/catch_test_macros.hpp>
+#include "MockHttpServer.hpp"
+#include "SegmentedDownloader.hpp"
+#include "TestHelpers.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <set>
+#include <string>
+
+#ifndef _WIN32
+
+namespace {
+
+std::string make_payload(std::size_t size)
+{
+    std::string payload(size, '\0');
+    std::uint32_t state = 12345;
+    for (auto& byte : payload) {
+        state = state * 1103515245u + 12345u;
+        byte = static_cast<char>(state >> 24);
+    }
+    return payload;
+}
+
+std::string read_file(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Serves `payload` with Range support and records the start of every range it was asked for.
+// Ranges starting at `failing_offset` get a 500 while `fail` is set.
+class RangeServer {
+public:
+    explicit RangeServer(std::string payload)
+        : payload_(std::move(payload)),
+          server_([this](const MockHttpServer::Request& request) { return handle(request); })
+    {}
+
+    std::string url() const { return server_.base_url() + "/model.gguf"; }
+    std::multiset<long long> requested_offsets() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return offsets_;
+    }
+    void fail_range_at(long long offset) { failing_offset_ = offset; }
+    void stop_failing() { failing_offset_ = -1; }
+
+private:
+    MockHttpServer::Reply handle(const MockHttpServer::Request& request)
+    {
+        MockHttpServer::Reply reply;
+        reply.content_type = "application/octet-stream";
+        const auto range = request.headers.find("range");
+        if (range == request.headers.end()) {
+            reply.body = payload_;
+            return reply;
+        }
+        // "bytes=<first>-<last>"
+        const std::string spec = range->second.substr(range->second.find('=') + 1);
+        const long long first = std::atoll(spec.c_str());
+        const long long last = std::atoll(spec.c_str() + spec.find('-') + 1);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            offsets_.insert(first);
+        }
+        if (first == failing_offset_.load()) {
+            reply.status = 500;
+            return reply;
+        }
+        reply.status = 206;
+        reply.body = payload_.substr(static_cast<std::size_t>(first), static_cast<std::size_t>(last - first + 1));
+        reply.headers.emplace_back("Content-Range", "bytes " + spec + "/" + std::to_string(payload_.size()));
+        return reply;
+    }
+
+    std::string payload_;
+    mutable std::mutex mutex_;
+    std::multiset<long long> offsets_;
+    std::atomic<long long> failing_offset_{-1};
+    MockHttpServer server_;
+};
+
+SegmentedDownloader::Options small_segments(std::string sha256 = {})
+{
+    SegmentedDownloader::Options options;
+    options.segments = 4;
+    options.min_segment_bytes = 64 * 1024;
+    options.expected_sha256 = std::move(sha256);
+    options.max_attempts = 2;
+    return options;
+}
+
+} // namespace
+
+TEST_CASE("Segments cover the file and respect the minimum size") {
+    const auto segments = SegmentedDownloader::plan_segments(1000, 4, 100);
+    REQUIRE(segments.size() == 4);
+    CHECK(segments.front().begin == 0);
+    CHECK(segments.back().end == 1000);
+    for (std::size_t index = 1; index < segments.size(); ++index) {
+        CHECK(segments[index].begin == segments[index - 1].end);
+    }
+    CHECK(SegmentedDownloader::plan_segments(150, 4, 100).size() == 1);
+    CHECK(SegmentedDownloader::plan_segments(0, 4, 100).empty());
+}
+
+TEST_CASE("Segmented download fetches ranges in parallel and verifies the digest") {
+    TempDir tmp;
+    const std::string payload = make_payload(1024 * 1024 + 123);
+    const auto source = (tmp.path() / "source.bin").string();
+    {
+        std::ofstream out(source, std::ios::binary);
+        out << payload;
+    }
+    const std::string digest = SegmentedDownloader::sha256_file(source);
+
+    RangeServer server(payload);
+    const auto destination = (tmp.path() / "model.gguf").string();
+    SegmentedDownloader downloader(server.url(), destination, small_segments(digest));
+
+    std::atomic<bool> cancel{false};
+    long long last_reported = 0;
+    REQUIRE(downloader.run(static_cast<long long>(payload.size()),
+                           [&](long long done, long long) { last_reported = done; }, cancel));
+
+    CHECK(read_file(destination) == payload);
+    CHECK(last_reported == static_cast<long long>(payload.size()));
+    CHECK(server.requested_offsets().size() == 4);
+    CHECK_FALSE(SegmentedDownloader::has_partial_download(destination));
+}
+
+TEST_CASE("Segmented download resumes only the unfinished segments") {
+    TempDir tmp;
+    const std::string payload = make_payload(512 * 1024);
+    RangeServer server(payload);
+    const auto destination = (tmp.path() / "model.gguf").string();
+    const auto planned = SegmentedDownloader::plan_segments(static_cast<long long>(payload.size()), 4, 64 * 1024);
+    REQUIRE(planned.size() == 4);
+
+    std::atomic<bool> cancel{false};
+    server.fail_range_at(planned[2].begin);
+    {
+        SegmentedDownloader first(server.url(), destination, small_segments());
+        CHECK_THROWS_AS(first.run(static_cast<long long>(payload.size()), nullptr, cancel), std::runtime_error);
+    }
+    CHECK(SegmentedDownloader::has_partial_download(destination));
+
+    server.stop_failing();
+    const auto before = server.requested_offsets();
+    SegmentedDownloader second(server.url(), destination, small_segments());
+    REQUIRE(second.run(static_cast<long long>(payload.size()), nullptr, cancel));
+
+    CHECK(read_file(destination) == payload);
+    const auto after = server.requested_offsets();
+    // Only the failed segment was asked for again.
+    CHECK(after.size() == before.size() + 1);
+    CHECK(after.count(planned[2].begin) == before.count(planned[2].begin) + 1);
+    CHECK_FALSE(SegmentedDownloader::has_partial_download(destination));
+}
+
+TEST_CASE("Segmented download rejects a file with the wrong digest") {
+    TempDir tmp;
+    const std::string payload = make_payload(256 * 1024);
+    RangeServer server(payload);
+    const auto destination = (tmp.path() / "model.gguf").string();
+    SegmentedDownloader downloader(server.url(), destination, small_segments(std::string(64, '0')));
+
+    std::atomic<bool> cancel{false};
+    CHECK_THROWS_AS(downloader.run(static_cast<long long>(payload.size()), nullptr, cancel), std::runtime_error);
+    CHECK_FALSE(std::filesystem::exists(destination));
+    CHECK_FALSE(SegmentedDownloader::has_partial_download(destination));
+}
+
+TEST_CASE("Segmented download reports a failing transfer setup instead of terminating") {
+    TempDir tmp;
+    const std::string payload = make_payload(256 * 1024);
+    RangeServer server(payload);
+    const auto destination = (tmp.path() / "model.gguf").string();
+    SegmentedDownloader downloader(server.url(), destination, small_segments());
+    downloader.set_curl_setup([](void*) { throw std::runtime_error("no CA bundle"); });
+
+    std::atomic<bool> cancel{false};
+    CHECK_THROWS_AS(downloader.run(static_cast<long long>(payload.size()), nullptr, cancel), std::runtime_error);
+    CHECK(SegmentedDownloader::has_partial_download(destination));
+}
+
+TEST_CASE("SHA-256 of a known input") {
+    TempDir tmp;
+    const auto path = (tmp.path() / "abc.txt").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "abc";
+    }
+    CHECK(SegmentedDownloader::sha256_file(path) ==
+          "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
+
+#endif // !_WIN32
@@ -0,0 +1,44 @@
+#include <catch2/catch_test_macros.hpp>
+#include "StreamingReply.hpp"
+
+#include <string>
+#include <vector>
+
+TEST_CASE("LineBuffer joins lines split across chunks") {
+    LineBuffer buffer;
+    std::vector<std::string> lines;
+    const LineBuffer::LineCallback collect = [&lines](std::string_view line) {
+        lines.emplace_back(line);
+        return true;
+    };
+
+    CHECK(buffer.feed("data: {\"a\"", collect));
+    CHECK(lines.empty());
+    CHECK(buffer.feed(":1}\r\n\r\ndata: [DO", collect));
+    CHECK(buffer.feed("NE]\nlast", collect));
+    CHECK(buffer.finish(collect));
+
+    CHECK(lines == std::vector<std::string>{"data: {\"a\":1}", "", "data: [DONE]", "last"});
+}
+
+TEST_CASE("LineBuffer stops when the receiver has what it needs") {
+    LineBuffer buffer;
+    int seen = 0;
+    const LineBuffer::LineCallback stop_at_second = [&seen](std::string_view) { return ++seen < 2; };
+
+    CHECK_FALSE(buffer.feed("one\ntwo\nthree\n", stop_at_second));
+    CHECK(seen == 2);
+}
+
+TEST_CASE("Category replies are complete at the closing brace or the end of the line") {
+    CHECK(complete_category_reply_length("") == 0);
+    CHECK(complete_category_reply_length("{\"category\":\"Docs\",\"subcategory\":\"Inv") == 0);
+    CHECK(complete_category_reply_length("{\"category\":\"a}b\",\"x\":[1]}") == 26);
+
+    const std::string reply = "{\"category\":\"Docs\",\"subcategory\":\"Invoices\"}";
+    CHECK(complete_category_reply_length(reply + "\nHere is why...") == reply.size());
+
+    CHECK(complete_category_reply_length("Documents : Invoices") == 0);
+    CHECK(complete_category_reply_length("Documents : Invoices\nBecause") == 20);
+    CHECK(complete_category_reply_length("Sure!\nDocuments : Invoices\n") == 0);
+}
@@ -58,6 +58,7 @@ struct UiTranslatorTestHarness {
     QAction* copy_action = new QAction(&window);
     QAction* cut_action = new QAction(&window);
     QAction* undo_last_run_action = new QAction(&window);
+    QAction* undo_history_action = new QAction(&window);
     QAction* paste_action = new QAction(&window);
     QAction* delete_action = new QAction(&window);
     QAction* toggle_explorer_action = new QAction(&window);
@@ -164,6 +165,7 @@ struct UiTranslatorTestHarness {
                 copy_action,
                 cut_action,
                 undo_last_run_action,
+                undo_history_action,
                 paste_action,
                 delete_action,
                 toggle_explorer_action,